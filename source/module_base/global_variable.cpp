@@ -70,6 +70,9 @@ int DIAGO_PROC = 0;
 int PW_DIAG_NMAX = 30;
 int DIAGO_CG_PREC = 1; // mohan add 2012-03-31
 int PW_DIAG_NDIM = 4;
+std::string PW_DIAG_PRECOND = "default";
+int PW_DIAG_NDEGREE = 8;
+int PW_DIAG_NLANCZOS = 10;
 double PW_DIAG_THR = 1.0e-2;
 int NB2D = 1;
 
@@ -87,8 +90,12 @@ bool GAMMA_ONLY_PW = 0; // mohan add 2012-06-05
 int T_IN_H = 1; // mohan add 2010-11-28
 int VL_IN_H = 1;
 int VNL_IN_H = 1;
+bool NONLOCAL_REAL_SPACE = false;
+double PW_VKB_CACHE = 1024.0;
+double LCAO_SK_CACHE = 1024.0;
 int VH_IN_H = 1;
 int VION_IN_H = 1;
+double ECUT_XC = 0.0;
 int ZEEMAN_IN_H = 1;
 double STRESS_THR = 0.5; // LiuXh add 20180515 liuyu update 2023-05-10
 
@@ -215,6 +222,7 @@ double eb_k = 80.0;
 double tau = 1.0798 * 1e-5;
 double sigma_k = 0.6;
 double nc_k = 0.00037;
+std::string sol_solver = "cg";
 
 bool dft_plus_u = false; //DFTU control
 
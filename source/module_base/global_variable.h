@@ -82,6 +82,9 @@ extern int DIAGO_PROC; // 12.1 number of processors used to diag.
 extern int PW_DIAG_NMAX; // 13
 extern int DIAGO_CG_PREC; // 13.1
 extern int PW_DIAG_NDIM; // 14
+extern std::string PW_DIAG_PRECOND; // preconditioner of davidson, default or tpa
+extern int PW_DIAG_NDEGREE; // degree of the Chebyshev filter of chfsi
+extern int PW_DIAG_NLANCZOS; // number of Lanczos steps of chfsi
 extern double PW_DIAG_THR; // 15 pw_diag_thr
 extern int NB2D; // 16.5 dividsion of 2D_matrix.
 
@@ -99,8 +102,12 @@ extern bool GAMMA_ONLY_PW; // mohan add 2012-06-05
 extern int T_IN_H; // 23, calculate T in H or not.
 extern int VL_IN_H; // 24, calculate Vl in H or not.
 extern int VNL_IN_H; // 25, calculate Vnl in H or not.
+extern bool NONLOCAL_REAL_SPACE; // apply Vnl on the real space grid in PW.
+extern double PW_VKB_CACHE; // memory budget in MB of the vkb cache in PW.
+extern double LCAO_SK_CACHE; // memory budget in MB of the decomposed S(k) kept by the LCAO solvers.
 extern int VH_IN_H; // 26, calculate Vh in H or not.
 extern int VION_IN_H; // 28, calculate Vion_loc in H or not.
+extern double ECUT_XC; // cutoff (Ry) of the smooth grid for xc, 0: xc on the grid of rho
 extern double STRESS_THR; // LiuXh add 20180515
 
 extern int ocp;
@@ -242,6 +249,7 @@ extern double eb_k;
 extern double tau;
 extern double sigma_k;
 extern double nc_k;
+extern std::string sol_solver;
 
 // DFTU control
 extern bool dft_plus_u;
@@ -273,6 +281,7 @@ extern std::string of_kernel_file; // The name of WT kernel file.
 extern std::string device_flag;
 //==========================================================
 // precision flags added by denghui
+// single, double, or mixed: single precision in the first scf steps
 //==========================================================
 extern std::string precision_flag;
 
@@ -257,6 +257,10 @@ void matrix::operator+=(const matrix & m)
 	assert( nc==m.nc );
 	const int size=nc*nr;
 	const double * const c_in = m.c;
+	// e.g. potentials on the real space grid
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1024) if(size > 65536)
+#endif
 	for( int i = 0; i < size; ++i ) 
 		c[i] += c_in[i];
 }
@@ -373,3 +373,65 @@ void Parallel_Global::divide_pools(void)
     return;
 }
 #endif
+
+// bands [start, start + num) of the band group igroup
+static void band_slice(const int &nbands, const int &igroup, int &start, int &num)
+{
+	num = nbands / GlobalV::NSTOGROUP;
+	start = num * igroup;
+	if (igroup < nbands % GlobalV::NSTOGROUP)
+	{
+		++num;
+		start += igroup;
+	}
+	else
+	{
+		start += nbands % GlobalV::NSTOGROUP;
+	}
+}
+
+bool Parallel_Global::ks_band_groups(void)
+{
+	// in sdft, the band groups share the stochastic orbitals instead;
+	// in ksdft only chfsi works on band slices, dav and cg keep bndpar = 1
+	return GlobalV::NSTOGROUP > 1 && GlobalV::ESOLVER_TYPE == "ksdft" && GlobalV::KS_SOLVER == "chfsi";
+}
+
+void Parallel_Global::divide_bands(const int &nbands, int &start, int &num)
+{
+	band_slice(nbands, GlobalV::MY_STOGROUP, start, num);
+	return;
+}
+
+#ifdef __MPI
+template <typename T>
+static void gather_bands_world(T *mat, const int &nbands, const int &ld, MPI_Datatype type)
+{
+	std::vector<int> counts(GlobalV::NSTOGROUP);
+	std::vector<int> displs(GlobalV::NSTOGROUP);
+	for (int ig = 0; ig < GlobalV::NSTOGROUP; ++ig)
+	{
+		int start = 0, num = 0;
+		band_slice(nbands, ig, start, num);
+		counts[ig] = num * ld;
+		displs[ig] = start * ld;
+	}
+	MPI_Allgatherv(MPI_IN_PLACE, 0, type, mat, counts.data(), displs.data(), type, PARAPW_WORLD);
+}
+#endif
+
+void Parallel_Global::gather_bands(std::complex<double> *mat, const int &nbands, const int &ld)
+{
+#ifdef __MPI
+	gather_bands_world(mat, nbands, ld, MPI_DOUBLE_COMPLEX);
+#endif
+	return;
+}
+
+void Parallel_Global::gather_bands(std::complex<float> *mat, const int &nbands, const int &ld)
+{
+#ifdef __MPI
+	gather_bands_world(mat, nbands, ld, MPI_C_FLOAT_COMPLEX);
+#endif
+	return;
+}
@@ -49,6 +49,20 @@ namespace Parallel_Global
 
 	void init_pools();
 	void divide_pools(void);
+
+	//-------------------------------------------
+	// band groups (bndpar) of Kohn-Sham DFT in
+	// plane waves with ks_solver = chfsi:
+	// psi is kept by every group,
+	// and each group works on its own slice of
+	// bands [start, start + num). The slices of
+	// all groups are put together by gather_bands.
+	//-------------------------------------------
+	bool ks_band_groups(void);
+	void divide_bands(const int &nbands, int &start, int &num);
+	// mat is nbands columns with leading dimension ld
+	void gather_bands(std::complex<double> *mat, const int &nbands, const int &ld);
+	void gather_bands(std::complex<float> *mat, const int &nbands, const int &ld);
 }
 
 
@@ -15,7 +15,7 @@ extern "C"
 
 	void pdpotrf_(char *uplo, int *n, double *a, int *ia, int *ja, int *desca, int *info);
 //	void pzpotrf_(char *uplo, int *n, double _Complex *a, int *ia, int *ja, int *desca, int *info);
-	void pzpotrf_(char *uplo, int *n, std::complex<double> *a, int *ia, int *ja, int *desca, int *info);
+	void pzpotrf_(const char *uplo, const int *n, std::complex<double> *a, const int *ia, const int *ja, const int *desca, int *info);
 
 	void pdtran_(int *m , int *n ,
 		double *alpha , double *a , int *ia , int *ja , int *desca ,
@@ -86,6 +86,24 @@ extern "C"
 		const double* abstol, int* m, int* nz, double* w, const double*orfac, std::complex<double>* Z, const int* iz, const int* jz, const int*descz,
 		std::complex<double>* work, int* lwork, double* rwork, int* lrwork, int*iwork, int*liwork, int* ifail, int*iclustr, double*gap, int* info);
 
+	void pzhegst_(const int* ibtype, const char* uplo, const int* n,
+		std::complex<double>* A, const int* ia, const int* ja, const int* desca,
+		const std::complex<double>* B, const int* ib, const int* jb, const int* descb,
+		double* scale, int* info);
+	void pzheevx_(const char* jobz, const char* range, const char* uplo,
+		const int* n, std::complex<double>* A, const int* ia, const int* ja, const int*desca,
+		const double* vl, const double* vu, const int* il, const int* iu,
+		const double* abstol, int* m, int* nz, double* w, const double*orfac, std::complex<double>* Z, const int* iz, const int* jz, const int*descz,
+		std::complex<double>* work, int* lwork, double* rwork, int* lrwork, int*iwork, int*liwork, int* ifail, int*iclustr, double*gap, int* info);
+	void pztrsm_(const char *side, const char *uplo, const char *transa, const char *diag, const int *m, const int *n,
+		const std::complex<double> *alpha, const std::complex<double> *a, const int *ia, const int *ja, const int *desca,
+		std::complex<double> *b, const int *ib, const int *jb, const int *descb);
+
+	void pzgetrs_(
+		const char *trans, const int *n, const int *nrhs,
+		const std::complex<double> *A, const int *ia, const int *ja, const int *desca, const int *ipiv,
+		std::complex<double> *B, const int *ib, const int *jb, const int *descb, int *info);
+
 	void pzgetri_(
 		const int *n, 
 		const std::complex<double> *A, const int *ia, const int *ja, const int *desca,
@@ -145,6 +163,15 @@ public:
 		pzgetrf_(&M, &N, A, &IA, &JA, DESCA, ipiv, info);
 	}
 
+	static inline
+	void getrs(
+		const char trans, const int n, const int nrhs,
+		const std::complex<double> *A, const int ia, const int ja, const int *desca, const int *ipiv,
+		std::complex<double> *B, const int ib, const int jb, const int *descb, int *info)
+	{
+		pzgetrs_(&trans, &n, &nrhs, A, &ia, &ja, desca, ipiv, B, &ib, &jb, descb, info);
+	}
+
 	static inline
 	void getri(
 		const int n, 
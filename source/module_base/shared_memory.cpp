@@ -0,0 +1,150 @@
+#include "shared_memory.h"
+#include "memory.h"
+#include "tool_quit.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace ModuleBase
+{
+
+Shared_Memory::Shared_Memory()
+{
+}
+
+Shared_Memory::~Shared_Memory()
+{
+    this->free();
+}
+
+#ifdef __MPI
+double* Shared_Memory::allocate(const std::string& name, const size_t n, MPI_Comm comm)
+{
+    this->free();
+
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &this->node_comm_);
+    MPI_Comm_rank(this->node_comm_, &this->node_rank_);
+    MPI_Comm_size(this->node_comm_, &this->node_size_);
+
+    // leaders of different nodes talk to each other in leader_comm_
+    const int color = (this->node_rank_ == 0) ? 0 : MPI_UNDEFINED;
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_split(comm, color, rank, &this->leader_comm_);
+
+    // only the node leader owns memory, the others map its segment
+    const MPI_Aint bytes = (this->node_rank_ == 0) ? static_cast<MPI_Aint>(n * sizeof(double)) : 0;
+    double* base = nullptr;
+    MPI_Win_allocate_shared(bytes, sizeof(double), MPI_INFO_NULL, this->node_comm_, &base, &this->win_);
+    if (this->node_rank_ != 0)
+    {
+        MPI_Aint size_query = 0;
+        int disp_unit = 0;
+        MPI_Win_shared_query(this->win_, 0, &size_query, &disp_unit, &base);
+    }
+    if (n > 0 && base == nullptr)
+    {
+        ModuleBase::WARNING_QUIT("Shared_Memory::allocate", "fail to allocate shared memory for " + name);
+    }
+    this->data_ = base;
+    this->size_ = n;
+
+    // a passive epoch is kept open during the whole lifetime of the window
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, this->win_);
+    if (this->node_rank_ == 0 && n > 0)
+    {
+        std::memset(this->data_, 0, n * sizeof(double));
+    }
+    this->sync();
+
+    if (this->node_rank_ == 0)
+    {
+        ModuleBase::Memory::record(name, sizeof(double) * n);
+    }
+    return this->data_;
+}
+#else
+double* Shared_Memory::allocate(const std::string& name, const size_t n)
+{
+    this->free();
+    this->buffer_.assign(n, 0.0);
+    this->data_ = this->buffer_.data();
+    this->size_ = n;
+    ModuleBase::Memory::record(name, sizeof(double) * n);
+    return this->data_;
+}
+#endif
+
+void Shared_Memory::free()
+{
+#ifdef __MPI
+    // global objects may be destructed after MPI_Finalize,
+    // the segment is released by MPI itself in that case
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (finalized)
+    {
+        this->win_ = MPI_WIN_NULL;
+        this->leader_comm_ = MPI_COMM_NULL;
+        this->node_comm_ = MPI_COMM_NULL;
+    }
+    if (this->win_ != MPI_WIN_NULL)
+    {
+        MPI_Win_unlock_all(this->win_);
+        MPI_Win_free(&this->win_);
+    }
+    if (this->leader_comm_ != MPI_COMM_NULL)
+    {
+        MPI_Comm_free(&this->leader_comm_);
+    }
+    if (this->node_comm_ != MPI_COMM_NULL)
+    {
+        MPI_Comm_free(&this->node_comm_);
+    }
+#else
+    std::vector<double>().swap(this->buffer_);
+#endif
+    this->data_ = nullptr;
+    this->size_ = 0;
+    this->node_rank_ = 0;
+    this->node_size_ = 1;
+}
+
+void Shared_Memory::sync()
+{
+#ifdef __MPI
+    if (this->win_ == MPI_WIN_NULL)
+    {
+        return;
+    }
+    MPI_Win_sync(this->win_);
+    MPI_Barrier(this->node_comm_);
+    MPI_Win_sync(this->win_);
+#endif
+}
+
+void Shared_Memory::reduce_nodes()
+{
+#ifdef __MPI
+    this->sync();
+    if (this->leader_comm_ != MPI_COMM_NULL)
+    {
+        int nnode = 1;
+        MPI_Comm_size(this->leader_comm_, &nnode);
+        if (nnode > 1)
+        {
+            // MPI counts are int
+            const size_t chunk = INT_MAX / 2;
+            for (size_t start = 0; start < this->size_; start += chunk)
+            {
+                const int count = static_cast<int>(std::min(chunk, this->size_ - start));
+                MPI_Allreduce(MPI_IN_PLACE, this->data_ + start, count, MPI_DOUBLE, MPI_SUM, this->leader_comm_);
+            }
+        }
+    }
+    this->sync();
+#endif
+}
+
+} // namespace ModuleBase
@@ -0,0 +1,86 @@
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#ifdef __MPI
+#include "mpi.h"
+#endif
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ModuleBase
+{
+
+/**
+ * @brief Read-only tables that are identical on every process are placed
+ * once per node in a MPI-3 shared window instead of being replicated.
+ *
+ * The processes of one node are grouped by MPI_COMM_TYPE_SHARED, the first
+ * process of each node (the node leader) owns the segment and the others
+ * map it. Without MPI the storage falls back to a private buffer.
+ *
+ * Usage:
+ *   allocate() -> every process fills its own part of data() -> sync()
+ *   -> reduce_nodes() if different nodes filled different parts.
+ *
+ * The memory is recorded through ModuleBase::Memory on the node leaders only,
+ * so that the log reflects what the node really consumes.
+ */
+class Shared_Memory
+{
+  public:
+    Shared_Memory();
+    ~Shared_Memory();
+
+    Shared_Memory(const Shared_Memory&) = delete;
+    Shared_Memory& operator=(const Shared_Memory&) = delete;
+
+#ifdef __MPI
+    /**
+     * @brief allocate n doubles shared by the processes of comm on the same node,
+     * must be called by all processes of comm. The array is set to zero.
+     *
+     * @param name name recorded in ModuleBase::Memory
+     * @param n number of doubles
+     * @param comm communicator of the processes that share the data
+     */
+    double* allocate(const std::string& name, const size_t n, MPI_Comm comm = MPI_COMM_WORLD);
+#else
+    double* allocate(const std::string& name, const size_t n);
+#endif
+
+    /// release the segment, collective in the communicator used by allocate
+    void free();
+
+    /// make the writes of all processes of the node visible to each other
+    void sync();
+
+    /// sum data() over the node leaders and make the result visible on every process
+    void reduce_nodes();
+
+    double* data() const { return this->data_; }
+    size_t size() const { return this->size_; }
+
+    /// rank and number of processes inside the node
+    int node_rank() const { return this->node_rank_; }
+    int node_size() const { return this->node_size_; }
+
+  private:
+    double* data_ = nullptr;
+    size_t size_ = 0;
+    int node_rank_ = 0;
+    int node_size_ = 1;
+
+#ifdef __MPI
+    MPI_Comm node_comm_ = MPI_COMM_NULL;   // processes on the same node
+    MPI_Comm leader_comm_ = MPI_COMM_NULL; // node leaders
+    MPI_Win win_ = MPI_WIN_NULL;
+#else
+    std::vector<double> buffer_;
+#endif
+};
+
+} // namespace ModuleBase
+
+#endif
@@ -5,6 +5,7 @@
 #include "module_base/parallel_global.h"
 #include <complex>
 #include <string>
+#include <vector>
 #include <cstring>
 
 /************************************************
@@ -20,6 +21,11 @@
  *   iii. Parallel_Global::MyProd(std::complex<double> *in,std::complex<double> *inout,int *len,MPI_Datatype *dptr);
  *   iv. Parallel_Global::init_pools();
  *   v. Parallel_Global::divide_pools(void);
+ *   vi. Parallel_Global::ks_band_groups(), only for chfsi of ksdft
+ *   vii. Parallel_Global::divide_bands(), the band slices of the groups
+ *   are contiguous, cover all bands and differ by at most one band
+ *   viii. Parallel_Global::gather_bands(), each rank as one band group,
+ *   including uneven nbands and empty slices
  */
 
 TEST(ParaGlobal,SplitGrid)
@@ -135,6 +141,88 @@ TEST(ParaGlobal, DividePools)
     EXPECT_EQ(MPI_COMM_WORLD != PARAPW_WORLD, true);
 }
 
+TEST(ParaGlobal, KsBandGroups)
+{
+    GlobalV::NSTOGROUP = 2;
+    GlobalV::ESOLVER_TYPE = "ksdft";
+    GlobalV::KS_SOLVER = "chfsi";
+    EXPECT_TRUE(Parallel_Global::ks_band_groups());
+    GlobalV::KS_SOLVER = "dav";
+    EXPECT_FALSE(Parallel_Global::ks_band_groups());
+    GlobalV::KS_SOLVER = "cg";
+    EXPECT_FALSE(Parallel_Global::ks_band_groups());
+    GlobalV::ESOLVER_TYPE = "sdft";
+    GlobalV::KS_SOLVER = "chfsi";
+    EXPECT_FALSE(Parallel_Global::ks_band_groups());
+    GlobalV::ESOLVER_TYPE = "ksdft";
+    GlobalV::NSTOGROUP = 1;
+    EXPECT_FALSE(Parallel_Global::ks_band_groups());
+}
+
+TEST(ParaGlobal, DivideBands)
+{
+    for (int ngroup = 1; ngroup <= 5; ++ngroup)
+    {
+        GlobalV::NSTOGROUP = ngroup;
+        for (int nbands = 0; nbands <= 11; ++nbands)
+        {
+            int end = 0;
+            for (int ig = 0; ig < ngroup; ++ig)
+            {
+                GlobalV::MY_STOGROUP = ig;
+                int start = -1, num = -1;
+                Parallel_Global::divide_bands(nbands, start, num);
+                EXPECT_EQ(start, end);
+                // the first nbands % ngroup groups take one more band
+                EXPECT_EQ(num, nbands / ngroup + (ig < nbands % ngroup ? 1 : 0));
+                end = start + num;
+            }
+            EXPECT_EQ(end, nbands);
+        }
+    }
+}
+
+TEST(ParaGlobal, GatherBands)
+{
+    // every rank is one band group
+    int nproc = 1, rank = 0;
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    GlobalV::NSTOGROUP = nproc;
+    GlobalV::MY_STOGROUP = rank;
+    PARAPW_WORLD = MPI_COMM_WORLD;
+
+    const int ld = 5;
+    // 7 is not divisible by 2, 3 or 4, and 2 leaves empty slices with more than 2 ranks
+    for (int nbands: {7, 2, 8})
+    {
+        int start = 0, num = 0;
+        Parallel_Global::divide_bands(nbands, start, num);
+        std::vector<std::complex<double>> mat(nbands * ld, std::complex<double>(-1.0, -1.0));
+        std::vector<std::complex<float>> matf(nbands * ld, std::complex<float>(-1.0, -1.0));
+        for (int ib = start; ib < start + num; ++ib)
+        {
+            for (int i = 0; i < ld; ++i)
+            {
+                mat[ib * ld + i] = std::complex<double>(ib, i);
+                matf[ib * ld + i] = std::complex<float>(ib, i);
+            }
+        }
+        Parallel_Global::gather_bands(mat.data(), nbands, ld);
+        Parallel_Global::gather_bands(matf.data(), nbands, ld);
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            for (int i = 0; i < ld; ++i)
+            {
+                EXPECT_EQ(mat[ib * ld + i], std::complex<double>(ib, i));
+                EXPECT_EQ(matf[ib * ld + i], std::complex<float>(ib, i));
+            }
+        }
+    }
+    GlobalV::NSTOGROUP = 1;
+    GlobalV::MY_STOGROUP = 0;
+}
+
 int main(int argc, char **argv)
 {
 
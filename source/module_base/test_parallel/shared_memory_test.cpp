@@ -0,0 +1,94 @@
+#ifdef __MPI
+#include "mpi.h"
+#include "gtest/gtest.h"
+#include "module_base/shared_memory.h"
+
+/************************************************
+ *  unit test of class Shared_Memory
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Allocate:
+ *     - the segment is zero-initialized and the same
+ *       address is seen by all processes of a node
+ *   - ReduceNodes:
+ *     - each process writes its own part, after
+ *       reduce_nodes() every process sees the whole array
+ *   - Free:
+ *     - the segment can be released and allocated again
+ */
+
+class SharedMemoryTest : public testing::Test
+{
+  protected:
+    int nproc = 1;
+    int rank = 0;
+    void SetUp() override
+    {
+        MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    }
+};
+
+TEST_F(SharedMemoryTest, Allocate)
+{
+    ModuleBase::Shared_Memory shm;
+    const size_t n = 100;
+    double* data = shm.allocate("SharedMemoryTest", n);
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(shm.size(), n);
+    EXPECT_GE(shm.node_rank(), 0);
+    EXPECT_LT(shm.node_rank(), shm.node_size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        EXPECT_DOUBLE_EQ(data[i], 0.0);
+    }
+
+    // the node leader writes, the others read the same segment
+    shm.sync();
+    if (shm.node_rank() == 0)
+    {
+        data[n - 1] = 3.0;
+    }
+    shm.sync();
+    EXPECT_DOUBLE_EQ(data[n - 1], 3.0);
+}
+
+TEST_F(SharedMemoryTest, ReduceNodes)
+{
+    ModuleBase::Shared_Memory shm;
+    const size_t n = 10 * nproc;
+    double* data = shm.allocate("SharedMemoryTest", n);
+    for (size_t i = rank; i < n; i += nproc)
+    {
+        data[i] = static_cast<double>(i);
+    }
+    shm.reduce_nodes();
+    for (size_t i = 0; i < n; ++i)
+    {
+        EXPECT_DOUBLE_EQ(data[i], static_cast<double>(i));
+    }
+}
+
+TEST_F(SharedMemoryTest, Free)
+{
+    ModuleBase::Shared_Memory shm;
+    shm.allocate("SharedMemoryTest", 10);
+    shm.free();
+    EXPECT_EQ(shm.data(), nullptr);
+    EXPECT_EQ(shm.size(), 0);
+    double* data = shm.allocate("SharedMemoryTest", 20);
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(shm.size(), 20);
+}
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return result;
+}
+#endif
@@ -5,6 +5,8 @@
 #include <stdexcept>
 #include "module_base/memory.h"
 #include "module_base/timer.h"
+#include "module_base/global_variable.h"
+#include <vector>
 
 //double ORB_table_alpha::dr = -1.0;
 
@@ -249,6 +251,16 @@ void ORB_table_alpha::init_Table_Alpha(
 
 	assert(ntype > 0);
 
+	// one (T1, Opair, L) row of Table_DSR, offset is the position of its
+	// overlap part in table_buffer_, the derivative part follows right after it.
+	struct Table_Row
+	{
+		int T1, L1, N1, L2, N2, L, rmesh;
+		bool nonzero;
+		size_t offset;
+	};
+	std::vector<Table_Row> rows;
+
 	// (1) allocate 1st dimension ( overlap, derivative)
 	this->Table_DSR = new double ****[2];
 	// (2) allocate 2nd dimension ( overlap, derivative)
@@ -288,7 +300,6 @@ void ORB_table_alpha::init_Table_Alpha(
 		this->Table_DSR[0][T1] = new double **[pairs_chi];
 		this->Table_DSR[1][T1] = new double **[pairs_chi];
 
-		const double Rcut1 = orb.Phi[T1].getRcut();
 		for (int L1 = 0; L1 < Lmax1 + 1; L1++)
 		{
 			for (int N1 = 0; N1 < orb.Phi[T1].getNchi(L1); N1++)
@@ -322,38 +333,60 @@ void ORB_table_alpha::init_Table_Alpha(
 
 						for (int L = 0; L < L2plus1; L++)
 						{
-							//Allocation
-							this->Table_DSR[0][T1][Opair][L] = new double[rmesh];
-							this->Table_DSR[1][T1][Opair][L] = new double[rmesh];
+							//for those L whose Gaunt Coefficients = 0,
+							//every element in Table_DSR stays zero
+							const bool nonzero = !((L > AL) || (L < SL) || ((L - SL) % 2 == 1));
+							rows.push_back({T1, L1, N1, L2, N2, L, rmesh, nonzero, memory_cost});
 							memory_cost += 2 * rmesh;
-
-							//for those L whose Gaunt Coefficients = 0, we
-							//assign every element in Table_DSR as zero
-							if ((L > AL) || (L < SL) || ((L - SL) % 2 == 1))
-							{
-								ModuleBase::GlobalFunc::ZEROS(Table_DSR[0][T1][Opair][L], rmesh);
-								ModuleBase::GlobalFunc::ZEROS(Table_DSR[1][T1][Opair][L], rmesh);
-
-								continue;
-							}
-
-							this->cal_S_PhiAlpha_R(
-								pSB, // mohan add 2021-03-06
-								L,
-								orb.Phi[T1].PhiLN(L1, N1),
-								orb.Alpha[0].PhiLN(L2, N2), // mohan update 2011-03-07
-								rmesh,
-								this->Table_DSR[0][T1][Opair][L],
-								this->Table_DSR[1][T1][Opair][L]);
 						} // end L2plus1
 					}	  // end N2
 				}		  // end L2
 			}			  // end N1
 		}				  // end L1
 	}					  // end T1
-	table_allocated = true;
 
-	ModuleBase::Memory::record("ORB::Table_DSR", sizeof(double) * memory_cost);
+	// allocate the arena once per node and hang the rows on the index
+	double* buffer = this->table_buffer_.allocate("ORB::Table_DSR", memory_cost);
+	std::vector<int> tasks;
+	for (int irow = 0; irow < static_cast<int>(rows.size()); ++irow)
+	{
+		const Table_Row &row = rows[irow];
+		const int Opair = this->DS_Opair(row.T1, row.L1, row.L2, row.N1, row.N2);
+		this->Table_DSR[0][row.T1][Opair][row.L] = buffer + row.offset;
+		this->Table_DSR[1][row.T1][Opair][row.L] = buffer + row.offset + row.rmesh;
+		if (row.nonzero)
+		{
+			tasks.push_back(irow);
+		}
+	}
+
+	// every process calculates a part of the radial tables,
+	// the rows of one process are shared among the threads.
+	std::vector<int> my_tasks;
+	for (int itask = GlobalV::MY_RANK; itask < static_cast<int>(tasks.size()); itask += GlobalV::NPROC)
+	{
+		my_tasks.push_back(tasks[itask]);
+	}
+
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int it = 0; it < static_cast<int>(my_tasks.size()); ++it)
+	{
+		const Table_Row &row = rows[my_tasks[it]];
+		this->cal_S_PhiAlpha_R(
+			pSB, // mohan add 2021-03-06
+			row.L,
+			orb.Phi[row.T1].PhiLN(row.L1, row.N1),
+			orb.Alpha[0].PhiLN(row.L2, row.N2), // mohan update 2011-03-07
+			row.rmesh,
+			buffer + row.offset,
+			buffer + row.offset + row.rmesh);
+	}
+
+	// rows calculated on other processes are zero, a sum collects the tables.
+	this->table_buffer_.reduce_nodes();
+	table_allocated = true;
 
 	//	OUT(GlobalV::ofs_running,"allocate non-local potential matrix","Done");
 	ModuleBase::timer::tick("ORB_table_alpha", "init_Table_Alpha");
@@ -370,7 +403,6 @@ void ORB_table_alpha::_destroy_table() {
 	for (int itable = 0; itable != 2; ++itable) {
 
 		for (int ielem = 0; ielem < ntype; ielem++) {
-			int lmax_now = std::max(lmax_[ielem], lmax_d_);
 			int nchipair = nchi_pairs_[ielem];
 
 			// mohan fix bug 2011-03-30
@@ -379,9 +411,6 @@ void ORB_table_alpha::_destroy_table() {
 			}
 
 			for (int ipair = 0; ipair < nchipair; ++ipair) {
-				for (int l = 0; l < 2 * lmax_now + 1; ++l) {
-					delete[] Table_DSR[itable][ielem][ipair][l];
-				}
 				delete[] Table_DSR[itable][ielem][ipair];
 			}
 			delete[] Table_DSR[itable][ielem];
@@ -390,6 +419,8 @@ void ORB_table_alpha::_destroy_table() {
 	}
 	delete[] Table_DSR;
 	Table_DSR = nullptr;
+	// the radial functions themselves live in table_buffer_
+	this->table_buffer_.free();
 	table_allocated = false;
 	return;
 }
@@ -397,42 +428,8 @@ void ORB_table_alpha::_destroy_table() {
 
 void ORB_table_alpha::Destroy_Table_Alpha(LCAO_Orbitals &orb)
 {
-	if (!table_allocated)
-	{
-		return;
-	}
-
-	const int ntype = orb.get_ntype();
-	for (int ir = 0; ir < 2; ir++)
-	{
-		for (int T1 = 0; T1 < ntype; T1++)
-		{
-			const int Lmax1 = orb.Phi[T1].getLmax();
-			const int Lmax2 = orb.Alpha[0].getLmax();
-			const int lmax_now = std::max(Lmax1, Lmax2);
-			const int pairs = orb.Phi[T1].getTotal_nchi() * orb.Alpha[0].getTotal_nchi();
-
-			// mohan fix bug 2011-03-30
-			if (pairs == 0)
-			{
-				continue;
-			}
-
-			for (int dim2 = 0; dim2 < pairs; dim2++)
-			{
-				for (int L = 0; L < 2 * lmax_now + 1; L++)
-				{
-					delete[] Table_DSR[ir][T1][dim2][L];
-				}
-				delete[] Table_DSR[ir][T1][dim2];
-			}
-			delete[] Table_DSR[ir][T1];
-		}
-		delete[] Table_DSR[ir];
-	}
-	delete[] Table_DSR;
-    Table_DSR = nullptr;
-	table_allocated = false;
+	// the sizes of the index have been recorded in init_Table_Alpha
+	this->_destroy_table();
 	return;
 }
 
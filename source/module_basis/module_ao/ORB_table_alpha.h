@@ -5,6 +5,7 @@
 #include "ORB_read.h" 
 #include "module_base/sph_bessel_recursive.h"
 #include "module_base/intarray.h"
+#include "module_base/shared_memory.h"
 
 //caoyu add 2021-03-17
 
@@ -22,7 +23,8 @@ public:
 		const double &dR_in,
 		const double &dk_in);
 
-	/// overlap between lcao basis phi and descriptor basis alpha
+	/// overlap between lcao basis phi and descriptor basis alpha,
+	/// the nested pointers are only an index, the rows are stored in table_buffer_
 	double *****Table_DSR;
 
 	bool table_allocated;
@@ -81,6 +83,10 @@ private:
 	std::vector<int> lmax_;
 	std::vector<int> nchi_pairs_;
 
+	// contiguous storage of all the rows of Table_DSR,
+	// shared by the processes of one node
+	ModuleBase::Shared_Memory table_buffer_;
+
 	// automatically deallocate Table_DSR using lmax_d_, lmax_ & nchi_pairs_
 	// called by destructor
 	void _destroy_table();
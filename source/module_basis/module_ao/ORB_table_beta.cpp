@@ -4,6 +4,8 @@
 #include "module_base/math_integral.h"
 #include "module_base/memory.h"
 #include "module_base/timer.h"
+#include "module_base/global_variable.h"
+#include <vector>
 
 double ORB_table_beta::dr = -1.0;
 
@@ -230,6 +232,17 @@ void ORB_table_beta::init_Table_Beta(
 	ModuleBase::TITLE("ORB_table_beta", "init_Table_Beta");
 	ModuleBase::timer::tick("ORB_table_beta", "init_Table_Beta");
 
+	// one (T1, T2, L1, N1, nb, L) row with nonzero Gaunt coefficients,
+	// offset is the position of its overlap part in table_buffer_,
+	// the derivative part follows right after it.
+	struct Table_Task
+	{
+		int T1, T2, L1, N1, nb, L, rmesh;
+		size_t offset;
+	};
+	std::vector<Table_Task> tasks;
+	std::vector<size_t> offsets;
+
 	// (1) allocate 1st dimension ( overlap, derivative)
 	this->Table_NR = new double****[2];
 	// (2) allocate 2nd dimension ( overlap, derivative)
@@ -293,41 +306,85 @@ void ORB_table_beta::init_Table_Beta(
 							
 						for (int L=0; L < T12_2Lplus1 ; L++)
 						{
-							//Allocation
-							this->Table_NR[0][Tpair][Opair][L] = new double[rmesh];
-							this->Table_NR[1][Tpair][Opair][L] = new double[rmesh];
+							offsets.push_back(memory_cost);
 							memory_cost += rmesh * 2;
 
-							//for those L whose Gaunt Coefficients = 0, we
-							//assign every element in Table_NR as zero
+							//for those L whose Gaunt Coefficients = 0,
+							//every element in Table_NR stays zero
 							if ((L > AL) || (L < SL) || ((L-SL) % 2 == 1)) 
 							{
-								ModuleBase::GlobalFunc::ZEROS (Table_NR[0][Tpair][Opair][L], rmesh);
-								ModuleBase::GlobalFunc::ZEROS (Table_NR[1][Tpair][Opair][L], rmesh);
-								
 								continue;
 							}
 
 							assert(nb < nproj_[T2]);	
-
-							this->cal_VNL_PhiBeta_R(
-								pSB, // mohan add 2021-03-06
-								L,
-                                phi_[T1].PhiLN(L1,N1),
-                                beta_[T2].Proj[nb], // mohan update 2011-03-07
-                                rmesh,
-								this->Table_NR[0][Tpair][Opair][L],
-								this->Table_NR[1][Tpair][Opair][L]);
+							tasks.push_back({T1, T2, L1, N1, nb, L, rmesh, offsets.back()});
 						}// end T12_2Lplus1
 					}// end L2
 				}// end N1
 			}// end L1
 		}// end T2
 	}// end T1
-	destroy_nr = true;
 
-	ModuleBase::Memory::record("ORB::Table_NR",sizeof(double) * memory_cost);
+	// allocate the arena once per node and hang the rows on the index,
+	// the rows are visited in the same order as above
+	double* buffer = this->table_buffer_.allocate("ORB::Table_NR", memory_cost);
+	size_t irow = 0;
+	for (int T1 = 0;  T1 < ntype ; T1++)
+	{
+		for (int T2 = 0 ; T2 < ntype ; T2++)
+		{
+			const int Tpair=this->NL_Tpair(T1,T2);
+			const int pairs_chi = phi_[T1].getTotal_nchi() * nproj_[T2];
+			if(pairs_chi == 0)continue;
+			const int T12_2Lplus1 = this->NL_L2plus1(T1,T2);
+			for (int L1 = 0; L1 < phi_[T1].getLmax() + 1; L1++)
+			{
+				for (int N1 = 0; N1 < phi_[T1].getNchi(L1); N1++)
+				{
+					for (int nb = 0; nb < nproj_[T2]; nb ++)
+					{
+						const int Opair = this->NL_Opair(Tpair,L1,N1,nb);
+						const int rmesh = this->get_rmesh(phi_[T1].getRcut(), beta_[T2].Proj[nb].getRcut());
+						for (int L=0; L < T12_2Lplus1 ; L++)
+						{
+							double* row = buffer + offsets[irow++];
+							this->Table_NR[0][Tpair][Opair][L] = row;
+							this->Table_NR[1][Tpair][Opair][L] = row + rmesh;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// every process calculates a part of the radial tables,
+	// the rows of one process are shared among the threads.
+	std::vector<int> my_tasks;
+	for (int itask = GlobalV::MY_RANK; itask < static_cast<int>(tasks.size()); itask += GlobalV::NPROC)
+	{
+		my_tasks.push_back(itask);
+	}
 
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int it = 0; it < static_cast<int>(my_tasks.size()); ++it)
+	{
+		const Table_Task &task = tasks[my_tasks[it]];
+		double* row = buffer + task.offset;
+		this->cal_VNL_PhiBeta_R(
+			pSB, // mohan add 2021-03-06
+			task.L,
+			phi_[task.T1].PhiLN(task.L1,task.N1),
+			beta_[task.T2].Proj[task.nb], // mohan update 2011-03-07
+			task.rmesh,
+			row,
+			row + task.rmesh);
+	}
+
+	// rows calculated on other processes are zero, a sum collects the tables.
+	this->table_buffer_.reduce_nodes();
+	destroy_nr = true;
 
 //	OUT(GlobalV::ofs_running,"allocate non-local potential matrix","Done");
 	ModuleBase::timer::tick("ORB_table_beta", "init_Table_Beta");
@@ -349,17 +406,12 @@ void ORB_table_beta::Destroy_Table_Beta(
 			for(int T2=0; T2<ntype; T2++)
 			{
 				const int Tpair = this->NL_Tpair(T1,T2); 
-				const int L2plus1 = this->NL_L2plus1(T1,T2);
 				const int pairs = phi_[T1].getTotal_nchi() * nproj_[T2]; 
 
 				// mohan fix bug 2011-03-30
 				if(pairs ==0) continue;
 				for(int dim2=0; dim2<pairs; dim2++)
 				{
-					for(int L=0; L<L2plus1; L++)
-					{
-						delete[] Table_NR[ir][Tpair][dim2][L];
-					}
 					delete[] Table_NR[ir][Tpair][dim2];
 				}
 				delete[] Table_NR[ir][Tpair];
@@ -368,6 +420,9 @@ void ORB_table_beta::Destroy_Table_Beta(
 		delete[] Table_NR[ir];
 	}
 	delete[] Table_NR;
+	// the radial functions themselves live in table_buffer_
+	this->table_buffer_.free();
+	destroy_nr = false;
 	return;
 }
 
@@ -5,6 +5,7 @@
 #include "ORB_atomic_lm.h" // use Numerical_Orbital_Lm
 #include "module_base/sph_bessel_recursive.h" // use ModuleBase::Sph_Bessel_Recursive
 #include "module_base/intarray.h"
+#include "module_base/shared_memory.h"
 
 class ORB_table_beta
 {
@@ -21,6 +22,8 @@ class ORB_table_beta
 		const double &dR_in,
 		const double &dk_in);
 
+	// the nested pointers are only an index, the rows of
+	// <phi|beta> and its derivative are stored in table_buffer_
 	double***** Table_NR;
 	bool destroy_nr;
 	
@@ -83,5 +86,9 @@ class ORB_table_beta
 	double *r;
 	double *rab;
 	double *kab;	
+
+	// contiguous storage of all the rows of Table_NR,
+	// shared by the processes of one node
+	ModuleBase::Shared_Memory table_buffer_;
 };
 #endif
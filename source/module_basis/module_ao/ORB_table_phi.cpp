@@ -4,6 +4,8 @@
 #include "module_base/memory.h"
 #include "module_base/constants.h"
 #include "module_base/timer.h"
+#include "module_base/global_variable.h"
+#include <cstdint>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -401,6 +403,20 @@ void ORB_table_phi::init_Table(LCAO_Orbitals &orb)
 		nchi_tot_[ielem] = orb.Phi[ielem].getTotal_nchi();
 	}
 
+	// all radial functions are stored in one contiguous block (table_arena_),
+	// Table_SR and Table_TR only keep the pointers into it as the index.
+	// each (Tpair, Opair, L) owns 4 rows: SR, dSR, TR, dTR, the length of
+	// every row is padded so that each row starts at a 64-byte boundary.
+	struct Table_Task
+	{
+		int T1, T2, L1, N1, L2, N2, L;
+		int rmesh;
+		size_t offset;
+	};
+	std::vector<Table_Task> tasks;
+	std::vector<size_t> offsets;
+	const size_t align = 8;
+
 	// init 1st dimension
 	this->Table_SR = new double****[2];
 	this->Table_TR = new double****[2];
@@ -455,10 +471,8 @@ void ORB_table_phi::init_Table(LCAO_Orbitals &orb)
 
 			const int rmesh = this->get_rmesh( Rcut1, Rcut2);
 			assert( rmesh < this->Rmesh );
-#ifdef __ORBITAL
-			ModuleBase::GlobalFunc::MAKE_DIR("Table_SR0");
-			ModuleBase::GlobalFunc::MAKE_DIR("Table_TR0");
-#endif
+			const size_t stride = (rmesh + align - 1) / align * align;
+
 			for (int L1 = 0; L1 < Lmax1 + 1; L1++)
 			{
 				for (int N1 = 0; N1 < orb.Phi[T1].getNchi(L1); N1++)
@@ -483,52 +497,16 @@ void ORB_table_phi::init_Table(LCAO_Orbitals &orb)
 
 							for (int L=0; L < L2plus1 ; L++)
 							{
-								//Allocation
-								Table_SR[0][Tpair][Opair][L] = new double[rmesh];
-								Table_SR[1][Tpair][Opair][L] = new double[rmesh];
-								Table_TR[0][Tpair][Opair][L] = new double[rmesh];
-								Table_TR[1][Tpair][Opair][L] = new double[rmesh];
-
-								memory_cost += rmesh * 4;
+								offsets.push_back(memory_cost);
+								memory_cost += stride * 4;
 
-								//for those L whose Gaunt Coefficients = 0, we
-								//assign every element in Table_SR or Table_TR as zero
+								//for those L whose Gaunt Coefficients = 0,
+								//every element in Table_SR or Table_TR stays zero
 								if ((L > AL) || (L < SL) || ((L-SL) % 2 == 1))
 								{
-									ModuleBase::GlobalFunc::ZEROS (Table_SR[0][Tpair][Opair][L], rmesh);
-									ModuleBase::GlobalFunc::ZEROS (Table_SR[1][Tpair][Opair][L], rmesh);
-									ModuleBase::GlobalFunc::ZEROS (Table_TR[0][Tpair][Opair][L], rmesh);
-									ModuleBase::GlobalFunc::ZEROS (Table_TR[1][Tpair][Opair][L], rmesh);
-
 									continue;
 								}
-
-								this->cal_ST_Phi12_R(1,L,
-										orb.Phi[T1].PhiLN(L1,N1),
-										orb.Phi[T2].PhiLN(L2,N2),
-										rmesh,
-										Table_SR[0][Tpair][Opair][L],
-										Table_SR[1][Tpair][Opair][L]);
-
-								this->cal_ST_Phi12_R(2,L,
-										orb.Phi[T1].PhiLN(L1,N1),
-										orb.Phi[T2].PhiLN(L2,N2),
-										rmesh,
-										Table_TR[0][Tpair][Opair][L],
-										Table_TR[1][Tpair][Opair][L]);
-
-#ifdef __ORBITAL
-								int plot_length = 20;
-
-								std::stringstream ss_sr;
-								ss_sr << "Table_SR0/"<<Tpair<<Opair<<L<<".dat";
-								std::string filename1 = ss_sr.str();
-								plot_table(filename1,plot_length,Table_SR[0][Tpair][Opair][L]);
-								std::stringstream ss_tr;
-								ss_tr << "Table_TR0/"<<Tpair<<Opair<<L<<".dat";
-								std::string filename2 = ss_tr.str();
-								plot_table(filename2,plot_length,Table_TR[0][Tpair][Opair][L]);
-#endif
+								tasks.push_back({T1, T2, L1, N1, L2, N2, L, rmesh, offsets.back()});
 							}//end m
 						}
 					}//end jl
@@ -537,65 +515,104 @@ void ORB_table_phi::init_Table(LCAO_Orbitals &orb)
 		}// end jt
 	}// end it
 
-	overlap_table_allocated = true;
-	kinetic_table_allocated = true;
-	ModuleBase::Memory::record("ORB::Table_SR&TR", sizeof(double) * memory_cost);
+	// allocate the arena once per node and hang the rows on the index
+	double* buffer = this->table_buffer_.allocate("ORB::Table_SR&TR", memory_cost + align);
+	const size_t shift = (align - reinterpret_cast<std::uintptr_t>(buffer) / sizeof(double) % align) % align;
+	this->table_arena_ = buffer + shift;
 
-	ModuleBase::timer::tick("ORB_table_phi", "init_Table");
-	return;
-}
-
-
-void ORB_table_phi::Destroy_Table(LCAO_Orbitals &orb)
-{
-	if(!overlap_table_allocated && !kinetic_table_allocated) return;
-
-	const int ntype = orb.get_ntype();
-	int dim1 = 0;
-	for (int ir = 0; ir < 2; ir++)
+	size_t irow = 0;
+	for (int T1 = 0;  T1 < ntype ; T1++)
 	{
-    	for (int T1 = 0; T1 < ntype; T1++)
+		for (int T2 = T1 ; T2 < ntype ; T2++)
 		{
-			// Notice !! T2 start from T1
-			// means that T2 >= T1
-    	    for (int T2 = T1; T2 < ntype; T2++)
-        	{
-				const int Lmax1 = orb.Phi[T1].getLmax();
-				const int Lmax2 = orb.Phi[T2].getLmax();
-				const int lmax_now = std::max(Lmax1, Lmax2);
-				const int pairs = orb.Phi[T1].getTotal_nchi() * orb.Phi[T2].getTotal_nchi();
-
-				for (int dim2 = 0; dim2 < pairs; dim2++)
+			const int Tpair=this->OV_Tpair(T1,T2);
+			const int L2plus1 = 2*std::max(orb.Phi[T1].getLmax(), orb.Phi[T2].getLmax()) + 1;
+			const int rmesh = this->get_rmesh(orb.Phi[T1].getRcut(), orb.Phi[T2].getRcut());
+			const size_t stride = (rmesh + align - 1) / align * align;
+			const int pairs_chi = orb.Phi[T1].getTotal_nchi() * orb.Phi[T2].getTotal_nchi();
+			for (int Opair = 0; Opair < pairs_chi; ++Opair)
+			{
+				for (int L = 0; L < L2plus1; ++L)
 				{
-					for (int L = 0; L < 2*lmax_now + 1; L++)
-					{
-						if(overlap_table_allocated) delete [] Table_SR[ir][dim1][dim2][L];
-						if(kinetic_table_allocated) delete [] Table_TR[ir][dim1][dim2][L];
-                	}
-                	if(overlap_table_allocated) delete [] Table_SR[ir][dim1][dim2];
-					if(kinetic_table_allocated) delete [] Table_TR[ir][dim1][dim2];
+					double* row = this->table_arena_ + offsets[irow++];
+					Table_SR[0][Tpair][Opair][L] = row;
+					Table_SR[1][Tpair][Opair][L] = row + stride;
+					Table_TR[0][Tpair][Opair][L] = row + 2 * stride;
+					Table_TR[1][Tpair][Opair][L] = row + 3 * stride;
 				}
-            	if(overlap_table_allocated) delete [] Table_SR[ir][dim1];
-				if(kinetic_table_allocated) delete [] Table_TR[ir][dim1];
-            	dim1++;
-
 			}
-        }
+		}
+	}
 
-		dim1 = 0;
-		if(overlap_table_allocated) delete [] Table_SR[ir];
-		if(kinetic_table_allocated) delete [] Table_TR[ir];
+	// every process calculates a part of the radial tables,
+	// the (pair, L) tasks of one process are shared among the threads.
+	std::vector<int> my_tasks;
+	for (int itask = GlobalV::MY_RANK; itask < static_cast<int>(tasks.size()); itask += GlobalV::NPROC)
+	{
+		my_tasks.push_back(itask);
 	}
 
-	if(overlap_table_allocated) delete[] Table_SR;
-	if(kinetic_table_allocated) delete[] Table_TR;
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int it = 0; it < static_cast<int>(my_tasks.size()); ++it)
+	{
+		const Table_Task &task = tasks[my_tasks[it]];
+		const size_t stride = (task.rmesh + align - 1) / align * align;
+		double* row = this->table_arena_ + task.offset;
+
+		this->cal_ST_Phi12_R(1,task.L,
+				orb.Phi[task.T1].PhiLN(task.L1,task.N1),
+				orb.Phi[task.T2].PhiLN(task.L2,task.N2),
+				task.rmesh,
+				row,
+				row + stride);
+
+		this->cal_ST_Phi12_R(2,task.L,
+				orb.Phi[task.T1].PhiLN(task.L1,task.N1),
+				orb.Phi[task.T2].PhiLN(task.L2,task.N2),
+				task.rmesh,
+				row + 2 * stride,
+				row + 3 * stride);
+	}
 
-	Table_SR = nullptr;
-	Table_TR = nullptr;
+	// processes of one node write different rows of the same segment,
+	// rows calculated on other nodes are zero, so a sum collects the tables.
+	this->table_buffer_.reduce_nodes();
 
-	overlap_table_allocated = false;
-	kinetic_table_allocated = false;
+#ifdef __ORBITAL
+	ModuleBase::GlobalFunc::MAKE_DIR("Table_SR0");
+	ModuleBase::GlobalFunc::MAKE_DIR("Table_TR0");
+	for (const Table_Task &task : tasks)
+	{
+		const int Tpair = this->OV_Tpair(task.T1, task.T2);
+		const int Opair = this->OV_Opair(Tpair, task.L1, task.L2, task.N1, task.N2);
+		const int L = task.L;
+		int plot_length = 20;
+
+		std::stringstream ss_sr;
+		ss_sr << "Table_SR0/"<<Tpair<<Opair<<L<<".dat";
+		std::string filename1 = ss_sr.str();
+		plot_table(filename1,plot_length,Table_SR[0][Tpair][Opair][L]);
+		std::stringstream ss_tr;
+		ss_tr << "Table_TR0/"<<Tpair<<Opair<<L<<".dat";
+		std::string filename2 = ss_tr.str();
+		plot_table(filename2,plot_length,Table_TR[0][Tpair][Opair][L]);
+	}
+#endif
 
+	overlap_table_allocated = true;
+	kinetic_table_allocated = true;
+
+	ModuleBase::timer::tick("ORB_table_phi", "init_Table");
+	return;
+}
+
+
+void ORB_table_phi::Destroy_Table(LCAO_Orbitals &orb)
+{
+	// the sizes of the index have been recorded in init_Table
+	this->_destroy_table();
 	return;
 }
 
@@ -605,7 +622,8 @@ void ORB_table_phi::_destroy_table() {
 		return;
 	}
 
-	// below is almost the same as Destroy_Table
+	// only the index is made of nested arrays,
+	// the radial functions themselves live in table_buffer_
 	int dim1 = 0;
 	for (int ir = 0; ir < 2; ir++)
 	{
@@ -615,40 +633,29 @@ void ORB_table_phi::_destroy_table() {
 			// means that T2 >= T1
 			for (int T2 = T1; T2 < ntype; T2++)
 			{
-				//const int Lmax1 = orb.Phi[T1].getLmax();
-				//const int Lmax2 = orb.Phi[T2].getLmax();
-				const int Lmax1 = lmax_[T1];
-				const int Lmax2 = lmax_[T2];
-
-				const int lmax_now = std::max(Lmax1, Lmax2);
-
-				//const int pairs = orb.Phi[T1].getTotal_nchi() * orb.Phi[T2].getTotal_nchi();
 				const int pairs = nchi_tot_[T1] * nchi_tot_[T2];
 
 				for (int dim2 = 0; dim2 < pairs; dim2++)
 				{
-					for (int L = 0; L < 2*lmax_now + 1; L++)
-					{
-						if(overlap_table_allocated) delete [] Table_SR[ir][dim1][dim2][L];
-						if(kinetic_table_allocated) delete [] Table_TR[ir][dim1][dim2][L];
-					}
-					if(overlap_table_allocated) delete [] Table_SR[ir][dim1][dim2];
-					if(kinetic_table_allocated) delete [] Table_TR[ir][dim1][dim2];
+					delete [] Table_SR[ir][dim1][dim2];
+					delete [] Table_TR[ir][dim1][dim2];
 				}
-				if(overlap_table_allocated) delete [] Table_SR[ir][dim1];
-				if(kinetic_table_allocated) delete [] Table_TR[ir][dim1];
+				delete [] Table_SR[ir][dim1];
+				delete [] Table_TR[ir][dim1];
 				dim1++;
-
 			}
-        }
+		}
 
 		dim1 = 0;
-		if(overlap_table_allocated) delete [] Table_SR[ir];
-		if(kinetic_table_allocated) delete [] Table_TR[ir];
+		delete [] Table_SR[ir];
+		delete [] Table_TR[ir];
 	}
 
-	if(overlap_table_allocated) delete[] Table_SR;
-	if(kinetic_table_allocated) delete[] Table_TR;
+	delete[] Table_SR;
+	delete[] Table_TR;
+
+	this->table_buffer_.free();
+	this->table_arena_ = nullptr;
 
 	overlap_table_allocated = false;
 	kinetic_table_allocated = false;
@@ -5,6 +5,7 @@
 #include "ORB_atomic_lm.h"
 #include "module_base/sph_bessel_recursive.h"
 #include "module_base/intarray.h"
+#include "module_base/shared_memory.h"
 #include <set>
 
 class ORB_table_phi
@@ -39,6 +40,9 @@ class ORB_table_phi
 	 * (4) Max angular momentum: L.
 	 *
 	 * (5) Distance between atoms: R.
+	 *
+	 * The nested pointers are only an index, the radial functions
+	 * are stored contiguously in table_buffer_.
 	 */
 	double***** Table_SR;
 	double***** Table_TR;
@@ -154,7 +158,13 @@ class ORB_table_phi
 	std::vector<int> lmax_; // lmax of each element
 	std::vector<int> nchi_tot_; // total nchi of each element
 
-	// automatically deallocate Table_DSR using lmax_d_, lmax_ & nchi_pairs_
+	// contiguous storage of all the rows of Table_SR and Table_TR, shared by
+	// the processes of one node; table_arena_ is the 64-byte aligned start
+	// inside table_buffer_
+	ModuleBase::Shared_Memory table_buffer_;
+	double* table_arena_ = nullptr;
+
+	// automatically deallocate Table_SR & Table_TR using lmax_ & nchi_tot_
 	// called by destructor
 	void _destroy_table();
 
@@ -26,6 +26,10 @@
  * - Destroy_Table
  *   deallocate the table allocated in init_Table.
  *
+ * - init_Table (content)
+ *   the tables distributed over processes & threads agree with
+ *   a direct call to cal_ST_Phi12_R.
+ *
  * - _destroy_table
  *   same as Destroy_Table, but does not need input arguments and is automatically
  *   called by the destructor.
@@ -285,6 +289,37 @@ TEST_F(OrbTablePhiTest, AutoDestroyTable) {
 	EXPECT_EQ(otp.Table_TR, nullptr);
 }
 
+TEST_F(OrbTablePhiTest, TableAgreesWithDirectIntegral) {
+	otp.allocate(ntype_, lmax_, lcao_.get_kmesh(), Rmax_, dR_, dk_);
+	init_sph_bessel();
+	otp.init_OV_Tpair(lcao_);
+	otp.init_OV_Opair(lcao_);
+	otp.init_Table(lcao_);
+
+	// O 2p-1 & O 1d-0, L = 1 & 3 have non-zero Gaunt coefficients, L = 2 does not
+	int T = 1;
+	int Tpair = otp.OV_Tpair(T, T);
+	int Opair = otp.OV_Opair(Tpair, 1, 2, 1, 0);
+	int rmesh = otp.get_rmesh(lcao_.Phi[T].getRcut(), lcao_.Phi[T].getRcut());
+
+	std::vector<double> rs(rmesh), drs(rmesh), ts(rmesh), dts(rmesh);
+	for (int L : {1, 3}) {
+		otp.cal_ST_Phi12_R(1, L, lcao_.Phi[T].PhiLN(1,1), lcao_.Phi[T].PhiLN(2,0), rmesh, rs.data(), drs.data());
+		otp.cal_ST_Phi12_R(2, L, lcao_.Phi[T].PhiLN(1,1), lcao_.Phi[T].PhiLN(2,0), rmesh, ts.data(), dts.data());
+		for (int ir = 0; ir != rmesh; ++ir) {
+			EXPECT_DOUBLE_EQ(otp.Table_SR[0][Tpair][Opair][L][ir], rs[ir]);
+			EXPECT_DOUBLE_EQ(otp.Table_SR[1][Tpair][Opair][L][ir], drs[ir]);
+			EXPECT_DOUBLE_EQ(otp.Table_TR[0][Tpair][Opair][L][ir], ts[ir]);
+			EXPECT_DOUBLE_EQ(otp.Table_TR[1][Tpair][Opair][L][ir], dts[ir]);
+		}
+	}
+
+	for (int ir = 0; ir != rmesh; ++ir) {
+		EXPECT_DOUBLE_EQ(otp.Table_SR[0][Tpair][Opair][2][ir], 0.0);
+		EXPECT_DOUBLE_EQ(otp.Table_TR[1][Tpair][Opair][2][ir], 0.0);
+	}
+}
+
 
 TEST_F(OrbTablePhiTest, GetRmesh) {
 
@@ -34,16 +34,17 @@ void FFT::clear()
 	this->cleanFFT();
 	if(z_auxg!=nullptr) {fftw_free(z_auxg); z_auxg = nullptr;}
 	if(z_auxr!=nullptr) {fftw_free(z_auxr); z_auxr = nullptr;}
+	if(z_auxp!=nullptr) {fftw_free(z_auxp); z_auxp = nullptr;}
 	d_rspace = nullptr;
 #if defined(__CUDA) || defined(__ROCM)
     if (this->device == "gpu") {
-        if (this->precision == "single") {
+        if (this->precision != "double") {
             if (c_auxr_3d != nullptr) {
                 delmem_cd_op()(gpu_ctx, c_auxr_3d);
                 c_auxr_3d = nullptr;
             }
         }
-        else {
+        if (this->precision != "single") {
             if (z_auxr_3d != nullptr) {
                 delmem_zd_op()(gpu_ctx, z_auxr_3d);
                 z_auxr_3d = nullptr;
@@ -52,7 +53,7 @@ void FFT::clear()
     }
 #endif // defined(__CUDA) || defined(__ROCM)
 #if defined(__ENABLE_FLOAT_FFTW)
-    if (this->precision == "single") {
+    if (this->precision != "double") {
         this->cleanfFFT();
         if (c_auxg != nullptr) {
             fftw_free(c_auxg);
@@ -62,6 +63,10 @@ void FFT::clear()
             fftw_free(c_auxr);
             c_auxr = nullptr;
         }
+        if (c_auxp != nullptr) {
+            fftw_free(c_auxp);
+            c_auxp = nullptr;
+        }
         s_rspace = nullptr;
     }
 #endif // defined(__ENABLE_FLOAT_FFTW)
@@ -91,30 +96,41 @@ void FFT:: initfft(int nx_in, int ny_in, int nz_in, int lixy_in, int rixy_in, in
 	const int nrxx = this->nxy * this->nplane;
 	const int nsz = this->nz * this->ns;
 	int maxgrids = (nsz > nrxx) ? nsz : nrxx;
+	// sticks of this proc. are divided into chunks of nsc sticks, the last one may be smaller
+	this->nsc = (this->pipelined() && this->ns > 0) ? (this->ns + this->nchunk - 1) / this->nchunk : 0;
 	if(!this->mpifft)
 	{
 		z_auxg  = (std::complex<double> *) fftw_malloc(sizeof(fftw_complex) * maxgrids);
 		z_auxr  = (std::complex<double> *) fftw_malloc(sizeof(fftw_complex) * maxgrids);
 		ModuleBase::Memory::record("FFT::grid", 2 * sizeof(fftw_complex) * maxgrids);
+		if(this->pipelined())
+		{
+			z_auxp  = (std::complex<double> *) fftw_malloc(sizeof(fftw_complex) * maxgrids);
+			ModuleBase::Memory::record("FFT::grid_p", sizeof(fftw_complex) * maxgrids);
+		}
 		d_rspace = (double *) z_auxg;
         // auxr_3d = static_cast<std::complex<double> *>(
         //     fftw_malloc(sizeof(fftw_complex) * (this->nx * this->ny * this->nz)));
 #if defined(__CUDA) || defined(__ROCM)
         if (this->device == "gpu") {
-            if (this->precision == "single") {
+            if (this->precision != "double") {
                 resmem_cd_op()(gpu_ctx, this->c_auxr_3d, this->nx * this->ny * this->nz);
             }
-            else {
+            if (this->precision != "single") {
                 resmem_zd_op()(gpu_ctx, this->z_auxr_3d, this->nx * this->ny * this->nz);
             }
         }
 #endif // defined(__CUDA) || defined(__ROCM)
 #if defined(__ENABLE_FLOAT_FFTW)
-        if (this->precision == "single") {
+        if (this->precision != "double") {
             c_auxg  = (std::complex<float> *) fftw_malloc(sizeof(fftwf_complex) * maxgrids);
             c_auxr  = (std::complex<float> *) fftw_malloc(sizeof(fftwf_complex) * maxgrids);
 			ModuleBase::Memory::record("FFT::grid_s", 2 * sizeof(fftwf_complex) * maxgrids);
             s_rspace = (float *) c_auxg;
+            if (this->pipelined()) {
+                c_auxp = (std::complex<float> *) fftw_malloc(sizeof(fftwf_complex) * maxgrids);
+                ModuleBase::Memory::record("FFT::grid_ps", sizeof(fftwf_complex) * maxgrids);
+            }
         }
 #endif // defined(__ENABLE_FLOAT_FFTW)
 	}
@@ -131,7 +147,7 @@ void FFT:: setupFFT()
 	{
 		this->initplan();
 #if defined(__ENABLE_FLOAT_FFTW)
-        if (this->precision == "single") {
+        if (this->precision != "double") {
             this->initplanf();
         }
 #endif // defined(__ENABLE_FLOAT_FFTW)
@@ -166,6 +182,27 @@ void FFT :: initplan()
 						(fftw_complex*) z_auxg,  &this->nz,  1,  this->nz,
 						(fftw_complex*) z_auxg,  &this->nz,  1,  this->nz,  FFTW_BACKWARD,  FFTW_MEASURE);
 
+	// chunks start at any stick, so the plans should not depend on the alignment
+	if(this->nsc > 0)
+	{
+		this->planzfor_chunk = fftw_plan_many_dft(     1,    &this->nz,  this->nsc,  
+						(fftw_complex*) z_auxg,  &this->nz,  1,  this->nz,
+						(fftw_complex*) z_auxg,  &this->nz,  1,  this->nz,  FFTW_FORWARD,  FFTW_MEASURE | FFTW_UNALIGNED);
+		this->planzbac_chunk = fftw_plan_many_dft(     1,    &this->nz,  this->nsc,  
+						(fftw_complex*) z_auxg,  &this->nz,  1,  this->nz,
+						(fftw_complex*) z_auxg,  &this->nz,  1,  this->nz,  FFTW_BACKWARD,  FFTW_MEASURE | FFTW_UNALIGNED);
+		int nrest = this->ns % this->nsc;
+		if(nrest > 0)
+		{
+			this->planzfor_rest = fftw_plan_many_dft(     1,    &this->nz,  nrest,  
+						(fftw_complex*) z_auxg,  &this->nz,  1,  this->nz,
+						(fftw_complex*) z_auxg,  &this->nz,  1,  this->nz,  FFTW_FORWARD,  FFTW_MEASURE | FFTW_UNALIGNED);
+			this->planzbac_rest = fftw_plan_many_dft(     1,    &this->nz,  nrest,  
+						(fftw_complex*) z_auxg,  &this->nz,  1,  this->nz,
+						(fftw_complex*) z_auxg,  &this->nz,  1,  this->nz,  FFTW_BACKWARD,  FFTW_MEASURE | FFTW_UNALIGNED);
+		}
+	}
+
 	//---------------------------------------------------------
 	//                              2 D - XY
 	//---------------------------------------------------------
@@ -239,14 +276,14 @@ void FFT :: initplan()
 
 #if defined(__CUDA) || defined(__ROCM)
     if (this->device == "gpu") {
-        if (this->precision == "single") {
+        if (this->precision != "double") {
         #if defined(__CUDA)
             cufftPlan3d(&c_handle, this->nx, this->ny, this->nz, CUFFT_C2C);
         #elif defined(__ROCM)
             hipfftPlan3d(&c_handle, this->nx, this->ny, this->nz, HIPFFT_C2C);
         #endif
         }
-        else {
+        if (this->precision != "single") {
         #if defined(__CUDA)
             cufftPlan3d(&z_handle, this->nx, this->ny, this->nz, CUFFT_Z2Z);
         #elif defined(__ROCM)
@@ -277,6 +314,26 @@ void FFT :: initplanf()
 	this->planfzbac = fftwf_plan_many_dft(     1,    &this->nz,  this->ns,  
 						(fftwf_complex*) c_auxg,  &this->nz,  1,  this->nz,
 						(fftwf_complex*) c_auxg,  &this->nz,  1,  this->nz,  FFTW_BACKWARD,  FFTW_MEASURE);
+
+	if(this->nsc > 0)
+	{
+		this->planfzfor_chunk = fftwf_plan_many_dft(     1,    &this->nz,  this->nsc,  
+						(fftwf_complex*) c_auxg,  &this->nz,  1,  this->nz,
+						(fftwf_complex*) c_auxg,  &this->nz,  1,  this->nz,  FFTW_FORWARD,  FFTW_MEASURE | FFTW_UNALIGNED);
+		this->planfzbac_chunk = fftwf_plan_many_dft(     1,    &this->nz,  this->nsc,  
+						(fftwf_complex*) c_auxg,  &this->nz,  1,  this->nz,
+						(fftwf_complex*) c_auxg,  &this->nz,  1,  this->nz,  FFTW_BACKWARD,  FFTW_MEASURE | FFTW_UNALIGNED);
+		int nrest = this->ns % this->nsc;
+		if(nrest > 0)
+		{
+			this->planfzfor_rest = fftwf_plan_many_dft(     1,    &this->nz,  nrest,  
+						(fftwf_complex*) c_auxg,  &this->nz,  1,  this->nz,
+						(fftwf_complex*) c_auxg,  &this->nz,  1,  this->nz,  FFTW_FORWARD,  FFTW_MEASURE | FFTW_UNALIGNED);
+			this->planfzbac_rest = fftwf_plan_many_dft(     1,    &this->nz,  nrest,  
+						(fftwf_complex*) c_auxg,  &this->nz,  1,  this->nz,
+						(fftwf_complex*) c_auxg,  &this->nz,  1,  this->nz,  FFTW_BACKWARD,  FFTW_MEASURE | FFTW_UNALIGNED);
+		}
+	}
 	//---------------------------------------------------------
 	//                              2 D
 	//---------------------------------------------------------
@@ -348,6 +405,16 @@ void FFT:: cleanFFT()
 	if(destroyp==true) return;
 	fftw_destroy_plan(planzfor);
 	fftw_destroy_plan(planzbac);
+	if(this->nsc > 0)
+	{
+		fftw_destroy_plan(planzfor_chunk);
+		fftw_destroy_plan(planzbac_chunk);
+		if(this->ns % this->nsc > 0)
+		{
+			fftw_destroy_plan(planzfor_rest);
+			fftw_destroy_plan(planzbac_rest);
+		}
+	}
 	if(this->xprime)
 	{
 		fftw_destroy_plan(planyfor);
@@ -384,14 +451,14 @@ void FFT:: cleanFFT()
     // fftw_destroy_plan(this->plan3dbackward);
 #if defined(__CUDA) || defined(__ROCM)
     if (this->device == "gpu") {
-        if (this->precision == "single") {
+        if (this->precision != "double") {
         #if defined(__CUDA)
             cufftDestroy(c_handle);
         #elif defined(__ROCM)
             hipfftDestroy(c_handle);
         #endif
         }
-        else {
+        if (this->precision != "single") {
         #if defined(__CUDA)
             cufftDestroy(z_handle);
         #elif defined(__ROCM)
@@ -409,6 +476,16 @@ void FFT:: cleanfFFT()
 	if(destroypf==true) return;
 	fftwf_destroy_plan(planfzfor);
 	fftwf_destroy_plan(planfzbac);
+	if(this->nsc > 0)
+	{
+		fftwf_destroy_plan(planfzfor_chunk);
+		fftwf_destroy_plan(planfzbac_chunk);
+		if(this->ns % this->nsc > 0)
+		{
+			fftwf_destroy_plan(planfzfor_rest);
+			fftwf_destroy_plan(planfzbac_rest);
+		}
+	}
 	if(this->xprime)
 	{
 		fftwf_destroy_plan(planfyfor);
@@ -478,6 +555,50 @@ void FFT::fftzbac(std::complex<double>* in, std::complex<double>* out) const
 	fftw_execute_dft(this->planzbac,(fftw_complex *)in, (fftw_complex *)out);
 }
 
+template <>
+void FFT::fftzfor_chunk(std::complex<float>* in, std::complex<float>* out, const int ichunk) const
+{
+#if defined(__ENABLE_FLOAT_FFTW)
+    const int is0 = ichunk * this->nsc;
+    if (this->nsc == 0 || is0 >= this->ns) return;
+    fftwf_plan plan = (is0 + this->nsc <= this->ns) ? this->planfzfor_chunk : this->planfzfor_rest;
+    fftwf_execute_dft(plan, (fftwf_complex *)(in + is0 * this->nz), (fftwf_complex *)(out + is0 * this->nz));
+#else
+    ModuleBase::WARNING_QUIT("fft", "Please compile ABACUS using the ENABLE_FLOAT_FFTW flag!");
+#endif // defined(__ENABLE_FLOAT_FFTW)
+}
+
+template <>
+void FFT::fftzfor_chunk(std::complex<double>* in, std::complex<double>* out, const int ichunk) const
+{
+    const int is0 = ichunk * this->nsc;
+    if (this->nsc == 0 || is0 >= this->ns) return;
+    fftw_plan plan = (is0 + this->nsc <= this->ns) ? this->planzfor_chunk : this->planzfor_rest;
+    fftw_execute_dft(plan, (fftw_complex *)(in + is0 * this->nz), (fftw_complex *)(out + is0 * this->nz));
+}
+
+template <>
+void FFT::fftzbac_chunk(std::complex<float>* in, std::complex<float>* out, const int ichunk) const
+{
+#if defined(__ENABLE_FLOAT_FFTW)
+    const int is0 = ichunk * this->nsc;
+    if (this->nsc == 0 || is0 >= this->ns) return;
+    fftwf_plan plan = (is0 + this->nsc <= this->ns) ? this->planfzbac_chunk : this->planfzbac_rest;
+    fftwf_execute_dft(plan, (fftwf_complex *)(in + is0 * this->nz), (fftwf_complex *)(out + is0 * this->nz));
+#else
+    ModuleBase::WARNING_QUIT("fft", "Please compile ABACUS using the ENABLE_FLOAT_FFTW flag!");
+#endif // defined(__ENABLE_FLOAT_FFTW)
+}
+
+template <>
+void FFT::fftzbac_chunk(std::complex<double>* in, std::complex<double>* out, const int ichunk) const
+{
+    const int is0 = ichunk * this->nsc;
+    if (this->nsc == 0 || is0 >= this->ns) return;
+    fftw_plan plan = (is0 + this->nsc <= this->ns) ? this->planzbac_chunk : this->planzbac_rest;
+    fftw_execute_dft(plan, (fftw_complex *)(in + is0 * this->nz), (fftw_complex *)(out + is0 * this->nz));
+}
+
 template <>
 void FFT::fftxyfor(std::complex<float>* in, std::complex<float>* out) const
 {
@@ -811,6 +932,17 @@ std::complex<double>* FFT::get_auxg_data() const
     return this->z_auxg;
 }
 
+template <>
+std::complex<float>* FFT::get_auxp_data() const
+{
+    return this->c_auxp;
+}
+template <>
+std::complex<double>* FFT::get_auxp_data() const
+{
+    return this->z_auxp;
+}
+
 #if defined(__CUDA) || defined(__ROCM)
 template <>
 std::complex<float>* FFT::get_auxr_3d_data() const
@@ -832,4 +964,8 @@ void FFT::set_precision(std::string precision_) {
     this->precision = std::move(precision_);
 }
 
+void FFT::set_nchunk(const int nchunk_in) {
+    this->nchunk = (nchunk_in > 1) ? nchunk_in : 1;
+}
+
 } // namespace ModulePW
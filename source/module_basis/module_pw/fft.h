@@ -59,6 +59,11 @@ public:
     void fftzfor(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out) const;
     template <typename FPTYPE>
     void fftzbac(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out) const;
+    // z-FFT of the ichunk-th chunk of sticks, used by the pipelined exchange of PW_Basis
+    template <typename FPTYPE>
+    void fftzfor_chunk(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out, const int ichunk) const;
+    template <typename FPTYPE>
+    void fftzbac_chunk(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out, const int ichunk) const;
     template <typename FPTYPE>
     void fftxyfor(std::complex<FPTYPE>* in, std::complex<FPTYPE>* out) const;
     template <typename FPTYPE>
@@ -95,6 +100,16 @@ public:
 	int ns=0; //number of sticks
 	int nplane=0; //number of x-y planes
 	int nproc=1; // number of proc.
+	int nchunk=1; // number of chunks of sticks in the pipelined exchange, 1: blocking exchange
+	int nsc=0; // number of sticks in a full chunk on this proc.
+
+	// split the exchange between sticks and planes into nchunk pieces, it should be called before initfft
+	void set_nchunk(const int nchunk_in);
+	// z-FFTs of one chunk of sticks overlap with the exchange of the others
+	bool pipelined() const
+	{
+		return this->nchunk > 1 && this->nproc > 1;
+	}
 
     template <typename FPTYPE>
     FPTYPE* get_rspace_data() const;
@@ -104,6 +119,9 @@ public:
     std::complex<FPTYPE>* get_auxg_data() const;
     template <typename FPTYPE>
     std::complex<FPTYPE>* get_auxr_3d_data() const;
+    // buffer of the pipelined exchange, (nplane, nstot)
+    template <typename FPTYPE>
+    std::complex<FPTYPE>* get_auxp_data() const;
 
   private:
     bool gamma_only = false;
@@ -122,6 +140,11 @@ public:
 	fftw_plan planxc2r;
 	fftw_plan planyr2c;
 	fftw_plan planyc2r;
+	// z-FFTs of a full chunk of nsc sticks and of the last chunk with the rest of the sticks
+	fftw_plan planzfor_chunk;
+	fftw_plan planzbac_chunk;
+	fftw_plan planzfor_rest;
+	fftw_plan planzbac_rest;
 //	fftw_plan plan3dforward;
 //	fftw_plan plan3dbackward;
 
@@ -147,6 +170,10 @@ public:
 	fftwf_plan planfxc2r;
 	fftwf_plan planfyr2c;
 	fftwf_plan planfyc2r;
+	fftwf_plan planfzfor_chunk;
+	fftwf_plan planfzbac_chunk;
+	fftwf_plan planfzfor_rest;
+	fftwf_plan planfzbac_rest;
 #endif // defined(__ENABLE_FLOAT_FFTW)
 
     mutable std::complex<float>* c_auxr_3d = nullptr;  // fft space
@@ -154,6 +181,8 @@ public:
 
     mutable std::complex<float>*c_auxg = nullptr, *c_auxr = nullptr;  // fft space,
     mutable std::complex<double>*z_auxg = nullptr, *z_auxr = nullptr; // fft space
+    mutable std::complex<float>* c_auxp = nullptr;  // pipelined exchange space
+    mutable std::complex<double>* z_auxp = nullptr; // pipelined exchange space
 
     mutable float* s_rspace = nullptr;  // real number space for r, [nplane * nx *ny]
     mutable double* d_rspace = nullptr; // real number space for r, [nplane * nx *ny]
@@ -1,5 +1,6 @@
 #include "pw_basis.h"
 
+#include <algorithm>
 #include <utility>
 #include "module_base/mymath.h"
 #include "module_base/timer.h"
@@ -233,4 +234,18 @@ void PW_Basis::set_precision(std::string precision_) {
     this->precision = std::move(precision_);
 }
 
+void PW_Basis::set_fft_nchunk(const int nchunk_in)
+{
+    this->ft.set_nchunk(nchunk_in);
+}
+
+void PW_Basis::chunk_sticks(const int ip, const int ichunk, int& start, int& num) const
+{
+    // the same division as FFT::nsc on the ip-th proc.
+    const int nstip = this->nst_per[ip];
+    const int nsc = (nstip + this->ft.nchunk - 1) / this->ft.nchunk;
+    start = std::min(nstip, ichunk * nsc);
+    num = std::min(nstip, start + nsc) - start;
+}
+
 }
\ No newline at end of file
@@ -274,6 +274,17 @@ public:
     template <typename T>
     void gathers_scatterp(std::complex<T>* in, std::complex<T>* out) const;
 
+    // gatherp_scatters followed by z-FFTs, pipelined by chunks of sticks when ft.pipelined()
+    template <typename T>
+    void gatherp_scatters_fftzfor(std::complex<T>* in, std::complex<T>* out) const;
+
+    // z-FFTs followed by gathers_scatterp, pipelined by chunks of sticks when ft.pipelined()
+    template <typename T>
+    void fftzbac_gathers_scatterp(std::complex<T>* in, std::complex<T>* out) const;
+
+    // sticks [start, start + num) of the ip-th proc. in the ichunk-th chunk of the pipelined exchange
+    void chunk_sticks(const int ip, const int ichunk, int& start, int& num) const;
+
   public:
     //get fftixy2is;
     void getfftixy2is(int * fftixy2is) const;
@@ -284,6 +295,8 @@ public:
 
     void set_device(std::string device_);
     void set_precision(std::string precision_);
+    // number of chunks of sticks in the exchange of FFT, it should be called before setuptransform
+    void set_fft_nchunk(const int nchunk_in);
 
 protected:
     std::string device = "cpu";
@@ -1,5 +1,7 @@
 #include "pw_basis_k.h"
 
+#include <cassert>
+#include <cmath>
 #include <utility>
 #include "module_base/constants.h"
 #include "module_base/timer.h"
@@ -20,15 +22,16 @@ PW_Basis_K::~PW_Basis_K()
     delete[] igl2isz_k;
     delete[] igl2ig_k;
     delete[] gk2;
+    delete[] gk2_precond;
     delete[] ig2ixyz_k_;
 #if defined(__CUDA) || defined(__ROCM)
     if (this->device == "gpu") {
-        if (this->precision == "single") {
+        if (this->precision != "double") {
             delmem_sd_op()(gpu_ctx, this->s_kvec_c);
             delmem_sd_op()(gpu_ctx, this->s_gcar);
             delmem_sd_op()(gpu_ctx, this->s_gk2);
         }
-        else {
+        if (this->precision != "single") {
             delmem_dd_op()(gpu_ctx, this->d_gcar);
             delmem_dd_op()(gpu_ctx, this->d_gk2);
         }
@@ -38,7 +41,7 @@ PW_Basis_K::~PW_Basis_K()
     }
     else {
 #endif
-        if (this->precision == "single") {
+        if (this->precision != "double") {
             delmem_sh_op()(cpu_ctx, this->s_kvec_c);
             delmem_sh_op()(cpu_ctx, this->s_gcar);
             delmem_sh_op()(cpu_ctx, this->s_gk2);
@@ -94,7 +97,7 @@ void PW_Basis_K:: initparameters(
     this->distribution_type = distribution_type_in;
 #if defined(__CUDA) || defined(__ROCM)
     if (this->device == "gpu") {
-        if (this->precision == "single") {
+        if (this->precision != "double") {
             resmem_sd_op()(gpu_ctx, this->s_kvec_c, this->nks * 3);
             castmem_d2s_h2d_op()(gpu_ctx, cpu_ctx, this->s_kvec_c, reinterpret_cast<double *>(&this->kvec_c[0][0]), this->nks * 3);
         }
@@ -103,7 +106,7 @@ void PW_Basis_K:: initparameters(
     }
     else {
 #endif
-        if (this->precision == "single") {
+        if (this->precision != "double") {
             resmem_sh_op()(cpu_ctx, this->s_kvec_c, this->nks * 3);
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_kvec_c, reinterpret_cast<double *>(&this->kvec_c[0][0]), this->nks * 3);
         }
@@ -189,10 +192,13 @@ void PW_Basis_K::collect_local_pw()
 {
     if(this->npwk_max <= 0) return;
     delete[] gk2;
+    delete[] gk2_precond;
     delete[] gcar;
     this->gk2 = new double[this->npwk_max * this->nks];
+    this->gk2_precond = new double[this->npwk_max * this->nks];
     this->gcar = new ModuleBase::Vector3<double>[this->npwk_max * this->nks];
     ModuleBase::Memory::record("PW_B_K::gk2", sizeof(double) * this->npwk_max * this->nks);
+    ModuleBase::Memory::record("PW_B_K::gk2_precond", sizeof(double) * this->npwk_max * this->nks);
     ModuleBase::Memory::record("PW_B_K::gcar", sizeof(ModuleBase::Vector3<double>) * this->npwk_max * this->nks);
 
     ModuleBase::Vector3<double> f;
@@ -216,17 +222,20 @@ void PW_Basis_K::collect_local_pw()
 
             this->gk2[ik * npwk_max + igl] = (f+kv) * (this->GGT * (f+kv));
             this->gcar[ik * npwk_max + igl] = f * this->G;
+
+            const double g2kin = this->gk2[ik * npwk_max + igl] * this->tpiba2;
+            this->gk2_precond[ik * npwk_max + igl] = 1 + g2kin + std::sqrt(1 + (g2kin - 1) * (g2kin - 1));
         }
     }
 #if defined(__CUDA) || defined(__ROCM)
     if (this->device == "gpu") {
-        if (this->precision == "single") {
+        if (this->precision != "double") {
             resmem_sd_op()(gpu_ctx, this->s_gk2, this->npwk_max * this->nks);
             resmem_sd_op()(gpu_ctx, this->s_gcar, this->npwk_max * this->nks * 3);
             castmem_d2s_h2d_op()(gpu_ctx, cpu_ctx, this->s_gk2, this->gk2, this->npwk_max * this->nks);
             castmem_d2s_h2d_op()(gpu_ctx, cpu_ctx, this->s_gcar, reinterpret_cast<double *>(&this->gcar[0][0]), this->npwk_max * this->nks * 3);
         }
-        else {
+        if (this->precision != "single") {
             resmem_dd_op()(gpu_ctx, this->d_gk2, this->npwk_max * this->nks);
             resmem_dd_op()(gpu_ctx, this->d_gcar, this->npwk_max * this->nks * 3);
             syncmem_d2d_h2d_op()(gpu_ctx, cpu_ctx, this->d_gk2, this->gk2, this->npwk_max * this->nks);
@@ -235,13 +244,13 @@ void PW_Basis_K::collect_local_pw()
     }
     else {
 #endif
-        if (this->precision == "single") {
+        if (this->precision != "double") {
             resmem_sh_op()(cpu_ctx, this->s_gk2, this->npwk_max * this->nks, "PW_B_K::s_gk2");
             resmem_sh_op()(cpu_ctx, this->s_gcar, this->npwk_max * this->nks * 3, "PW_B_K::s_gcar");
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_gk2, this->gk2, this->npwk_max * this->nks);
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_gcar, reinterpret_cast<double *>(&this->gcar[0][0]), this->npwk_max * this->nks * 3);
         }
-        else {
+        if (this->precision != "single") {
             this->d_gcar = reinterpret_cast<double *>(&this->gcar[0][0]);
             this->d_gk2 = this->gk2;
         }
@@ -274,6 +283,11 @@ double& PW_Basis_K::getgk2(const int ik, const int igl) const
     return this->gk2[ik * this->npwk_max + igl];
 }
 
+double& PW_Basis_K::getgk2_precond(const int ik, const int igl) const
+{
+    return this->gk2_precond[ik * this->npwk_max + igl];
+}
+
 ModuleBase::Vector3<double>& PW_Basis_K::getgcar(const int ik, const int igl) const
 {
     return this->gcar[ik * this->npwk_max + igl];
@@ -330,6 +344,27 @@ void PW_Basis_K::get_ig2ixyz_k()
 #endif
 }
 
+template <typename FPTYPE>
+void PW_Basis_K::scale_gamma(std::complex<FPTYPE>* psig, const int ik, const FPTYPE factor) const
+{
+    assert(this->gamma_only == true);
+    const int startig = ik * this->npwk_max;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1024)
+#endif
+    for (int igl = 0; igl < this->npwk[ik]; ++igl)
+    {
+        const int ixy = this->is2fftixy[this->igl2isz_k[igl + startig] / this->nz];
+        const bool plane = this->xprime ? (ixy / this->fftny == 0) : (ixy % this->fftny == 0);
+        if (!plane)
+        {
+            psig[igl] *= factor;
+        }
+    }
+}
+template void PW_Basis_K::scale_gamma<float>(std::complex<float>* psig, const int ik, const float factor) const;
+template void PW_Basis_K::scale_gamma<double>(std::complex<double>* psig, const int ik, const double factor) const;
+
 template <>
 float * PW_Basis_K::get_kvec_c_data() const {
     return this->s_kvec_c;
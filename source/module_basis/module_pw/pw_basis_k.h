@@ -88,6 +88,9 @@ public:
     int *ig2ixyz_k_=nullptr;
 
     double *gk2=nullptr; // modulus (G+K)^2 of G vectors [npwk_max*nks]
+    // preconditioner 1 + x + sqrt(1 + (x-1)^2) of x = (G+K)^2 * tpiba2 for the iterative diagonalization,
+    // it only depends on the basis, so it is built together with gk2 [npwk_max*nks]
+    double *gk2_precond=nullptr;
 
     //collect gdirect, gcar, gg
     void collect_local_pw();
@@ -145,6 +148,8 @@ private:
     //operator:
     //get (G+K)^2:
     double& getgk2(const int ik, const int igl) const;
+    //get the preconditioner of (G+K)^2
+    double& getgk2_precond(const int ik, const int igl) const;
     //get G
     ModuleBase::Vector3<double>& getgcar(const int ik, const int igl) const;
     //get G-direct
@@ -156,6 +161,16 @@ private:
     //get igl2ig_k or igk(ik,ig) in older ABACUS
     int& getigl2ig(const int ik, const int igl) const;
 
+    /**
+     * @brief multiply the gamma_only coefficients off the plane gx = 0 (gy = 0 if !xprime) by factor
+     * @details A gamma_only wave function is real, only half of its G sphere is kept. Stored with the
+     *          coefficients off that plane multiplied by sqrt(2), the real part of the plain dot product of
+     *          two wave functions is their overlap over the full sphere, so the solvers can keep using zgemm.
+     *          factor = sqrt(2) takes coefficients into this convention and 1/sqrt(2) takes them back.
+     */
+    template <typename FPTYPE>
+    void scale_gamma(std::complex<FPTYPE>* psig, const int ik, const FPTYPE factor) const;
+
     template <typename FPTYPE> FPTYPE * get_gk2_data() const;
     template <typename FPTYPE> FPTYPE * get_gcar_data() const;
     template <typename FPTYPE> FPTYPE * get_kvec_c_data() const;
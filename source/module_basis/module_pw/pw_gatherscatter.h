@@ -2,6 +2,8 @@
 #include "module_base/global_function.h"
 #include "module_base/timer.h"
 #include "typeinfo"
+
+#include <vector>
 namespace ModulePW
 {
 /**
@@ -181,4 +183,186 @@ void PW_Basis::gathers_scatterp(std::complex<T>* in, std::complex<T>* out) const
 
 
 
+/**
+ * @brief gather planes and scatter sticks, and then do the forward z-FFTs of the sticks
+ * @details When ft.pipelined(), the exchange is split into ft.nchunk chunks of sticks by MPI_Ialltoallv,
+ *          and the z-FFTs of one chunk are done while the following chunks are still on the way.
+ * @param in: (nplane,fftny,fftnx)
+ * @param out: (nz,nst)
+ * @note in and out should be in different places
+ * @note in[] will be changed
+ */
+template <typename T>
+void PW_Basis::gatherp_scatters_fftzfor(std::complex<T>* in, std::complex<T>* out) const
+{
+    if (!this->ft.pipelined())
+    {
+        this->gatherp_scatters(in, out);
+        this->ft.fftzfor(out, out);
+        return;
+    }
+#ifdef __MPI
+    ModuleBase::timer::tick(this->classname, "gatherp_scatters");
+    std::complex<T>* auxp = this->ft.get_auxp_data<T>();
+    //change (nplane fftnxy) to (nplane,nstot)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int istot = 0; istot < nstot; ++istot)
+    {
+        int ixy = this->istot2ixy[istot];
+        std::complex<T>* outp = &auxp[istot * nplane];
+        std::complex<T>* inp = &in[ixy * nplane];
+        for (int iz = 0; iz < nplane; ++iz)
+        {
+            outp[iz] = inp[iz];
+        }
+    }
+
+    // post the exchange of all chunks: sticks of the ip-th proc. in the chunk are sent to it,
+    // and (numz[ip], sticks of this proc. in the chunk) are received from it
+    const MPI_Datatype type = (typeid(T) == typeid(double)) ? MPI_DOUBLE_COMPLEX : MPI_COMPLEX;
+    const int nchunk = this->ft.nchunk;
+    std::vector<int> counts(4 * nchunk * this->poolnproc);
+    std::vector<MPI_Request> requests(nchunk);
+    for (int ic = 0; ic < nchunk; ++ic)
+    {
+        int* sendcount = &counts[4 * ic * this->poolnproc];
+        int* senddispl = sendcount + this->poolnproc;
+        int* recvcount = senddispl + this->poolnproc;
+        int* recvdispl = recvcount + this->poolnproc;
+        int start = 0, num = 0;
+        this->chunk_sticks(this->poolrank, ic, start, num);
+        for (int ip = 0; ip < this->poolnproc; ++ip)
+        {
+            int startip = 0, numip = 0;
+            this->chunk_sticks(ip, ic, startip, numip);
+            sendcount[ip] = numip * nplane;
+            senddispl[ip] = startr[ip] + startip * nplane;
+            recvcount[ip] = num * numz[ip];
+            recvdispl[ip] = startg[ip] + start * numz[ip];
+        }
+        MPI_Ialltoallv(auxp, sendcount, senddispl, type, in, recvcount, recvdispl, type, this->pool_world, &requests[ic]);
+    }
+
+    for (int ic = 0; ic < nchunk; ++ic)
+    {
+        MPI_Wait(&requests[ic], MPI_STATUS_IGNORE);
+        int start = 0, num = 0;
+        this->chunk_sticks(this->poolrank, ic, start, num);
+        // change (numz[ip],ns, poolnproc) to (nz,ns) for the sticks of this chunk
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
+        for (int ip = 0; ip < this->poolnproc; ++ip)
+        {
+            for (int is = start; is < start + num; ++is)
+            {
+                int nzip = this->numz[ip];
+                std::complex<T>* outp = &out[is * nz + startz[ip]];
+                std::complex<T>* inp = &in[startg[ip] + is * nzip];
+                for (int izip = 0; izip < nzip; ++izip)
+                {
+                    outp[izip] = inp[izip];
+                }
+            }
+        }
+        this->ft.fftzfor_chunk(out, out, ic);
+    }
+    ModuleBase::timer::tick(this->classname, "gatherp_scatters");
+#endif
+    return;
+}
+
+/**
+ * @brief do the backward z-FFTs of the sticks, and then gather sticks and scatter planes
+ * @details When ft.pipelined(), the z-FFTs of the next chunk of sticks are done while the
+ *          previous chunks are exchanged by MPI_Ialltoallv.
+ * @param in: (nz,nst)
+ * @param out: (nplane,fftny,fftnx)
+ * @note in and out should be in different places
+ * @note in[] will be changed
+ */
+template <typename T>
+void PW_Basis::fftzbac_gathers_scatterp(std::complex<T>* in, std::complex<T>* out) const
+{
+    if (!this->ft.pipelined())
+    {
+        this->ft.fftzbac(in, in);
+        this->gathers_scatterp(in, out);
+        return;
+    }
+#ifdef __MPI
+    ModuleBase::timer::tick(this->classname, "gathers_scatterp");
+    std::complex<T>* auxp = this->ft.get_auxp_data<T>();
+    const MPI_Datatype type = (typeid(T) == typeid(double)) ? MPI_DOUBLE_COMPLEX : MPI_COMPLEX;
+    const int nchunk = this->ft.nchunk;
+    std::vector<int> counts(4 * nchunk * this->poolnproc);
+    std::vector<MPI_Request> requests(nchunk);
+    for (int ic = 0; ic < nchunk; ++ic)
+    {
+        this->ft.fftzbac_chunk(in, in, ic);
+        int start = 0, num = 0;
+        this->chunk_sticks(this->poolrank, ic, start, num);
+        // change (nz,ns) to (numz[ip],ns, poolnproc) for the sticks of this chunk
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
+        for (int ip = 0; ip < this->poolnproc; ++ip)
+        {
+            for (int is = start; is < start + num; ++is)
+            {
+                int nzip = this->numz[ip];
+                std::complex<T>* outp = &out[startg[ip] + is * nzip];
+                std::complex<T>* inp = &in[is * nz + startz[ip]];
+                for (int izip = 0; izip < nzip; ++izip)
+                {
+                    outp[izip] = inp[izip];
+                }
+            }
+        }
+
+        int* sendcount = &counts[4 * ic * this->poolnproc];
+        int* senddispl = sendcount + this->poolnproc;
+        int* recvcount = senddispl + this->poolnproc;
+        int* recvdispl = recvcount + this->poolnproc;
+        for (int ip = 0; ip < this->poolnproc; ++ip)
+        {
+            int startip = 0, numip = 0;
+            this->chunk_sticks(ip, ic, startip, numip);
+            sendcount[ip] = num * numz[ip];
+            senddispl[ip] = startg[ip] + start * numz[ip];
+            recvcount[ip] = numip * nplane;
+            recvdispl[ip] = startr[ip] + startip * nplane;
+        }
+        MPI_Ialltoallv(out, sendcount, senddispl, type, auxp, recvcount, recvdispl, type, this->pool_world, &requests[ic]);
+    }
+    MPI_Waitall(nchunk, requests.data(), MPI_STATUSES_IGNORE);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 4096/sizeof(T))
+#endif
+    for (int i = 0; i < this->nrxx; ++i)
+    {
+        out[i] = std::complex<T>(0, 0);
+    }
+    //change (nplane,nstot) to (nplane fftnxy)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int istot = 0; istot < nstot; ++istot)
+    {
+        int ixy = this->istot2ixy[istot];
+        std::complex<T>* outp = &out[ixy * nplane];
+        std::complex<T>* inp = &auxp[istot * nplane];
+        for (int iz = 0; iz < nplane; ++iz)
+        {
+            outp[iz] = inp[iz];
+        }
+    }
+    ModuleBase::timer::tick(this->classname, "gathers_scatterp");
+#endif
+    return;
+}
+
 }
\ No newline at end of file
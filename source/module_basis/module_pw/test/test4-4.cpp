@@ -202,6 +202,13 @@ TEST_F(PWTEST,test4_4)
             EXPECT_NEAR(pwtest.getgpluskcar(ik,igl).norm2(), ((pwtest.getgdirect(ik,igl) + kvec_d[ik]) * G).norm2(), 1e-8);
         }
 
+        //check getgk2_precond(ik,ig)
+        for(int igl = 0 ; igl < npwk; ++igl)
+        {
+            const double g2kin = pwtest.getgk2(ik,igl) * pwtest.tpiba2;
+            EXPECT_NEAR(pwtest.getgk2_precond(ik,igl), 1 + g2kin + sqrt(1 + (g2kin - 1) * (g2kin - 1)), 1e-8);
+        }
+
         //check igl2ig
         for(int igl = 0; igl < npwk ; ++igl)
         {        
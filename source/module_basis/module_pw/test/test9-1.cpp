@@ -0,0 +1,80 @@
+//---------------------------------------------
+// TEST for FFT with the pipelined exchange
+//---------------------------------------------
+#include "../pw_basis_k.h"
+#ifdef __MPI
+#include "test_tool.h"
+#include "module_base/parallel_global.h"
+#include "mpi.h"
+#endif
+#include "module_base/constants.h"
+#include "module_base/global_function.h"
+#include "pw_test.h"
+
+using namespace std;
+TEST_F(PWTEST,test9_1)
+{
+    cout<<"dividemthd 1, gamma_only: off, 2 kpoints, check pipelined exchange of fft"<<endl;
+    ModulePW::PW_Basis_K pwtest(device_flag, "double");
+    ModulePW::PW_Basis_K pwpipe(device_flag, "double");
+    ModuleBase::Matrix3 latvec(1, 1, 0, 0, 2, 0, 0, 0, 2);
+    const double lat0 = 2;
+    const double wfcecut = 10;
+    const int nks = 2;
+    ModuleBase::Vector3<double> *kvec_d = new ModuleBase::Vector3<double>[nks];
+    kvec_d[0].set(0,0,0.5);
+    kvec_d[1].set(0.5,0.5,0.5);
+    //--------------------------------------------------
+#ifdef __MPI
+    pwtest.initmpi(nproc_in_pool, rank_in_pool, POOL_WORLD);
+    pwpipe.initmpi(nproc_in_pool, rank_in_pool, POOL_WORLD);
+#endif
+    // more chunks than sticks on some processors
+    pwpipe.set_fft_nchunk(3);
+    pwtest.initgrids(lat0,latvec,4*wfcecut);
+    pwtest.initparameters(false,wfcecut,nks,kvec_d);
+    pwtest.setuptransform();
+    pwtest.collect_local_pw();
+    pwpipe.initgrids(lat0,latvec,4*wfcecut);
+    pwpipe.initparameters(false,wfcecut,nks,kvec_d);
+    pwpipe.setuptransform();
+    pwpipe.collect_local_pw();
+    EXPECT_EQ(pwpipe.ft.pipelined(), nproc_in_pool > 1);
+
+    const int nrxx = pwtest.nrxx;
+    complex<double> * rhor1 = new complex<double> [nrxx];
+    complex<double> * rhor2 = new complex<double> [nrxx];
+    for(int ik = 0; ik < nks; ++ik)
+    {
+        const int npwk = pwtest.npwk[ik];
+        ASSERT_EQ(pwpipe.npwk[ik], npwk);
+        complex<double> * rhog1 = new complex<double> [npwk];
+        complex<double> * rhog2 = new complex<double> [npwk];
+        for(int ig = 0 ; ig < npwk ; ++ig)
+        {
+            rhog1[ig] = 1.0/(pwtest.getgk2(ik,ig)+1) + ModuleBase::IMAG_UNIT / (abs(pwtest.getgdirect(ik,ig).x+1) + 1);
+        }
+
+        pwtest.recip2real(rhog1,rhor1,ik);
+        pwpipe.recip2real(rhog1,rhor2,ik);
+        for(int ir = 0 ; ir < nrxx ; ++ir)
+        {
+            EXPECT_NEAR(rhor1[ir].real(),rhor2[ir].real(),1e-10);
+            EXPECT_NEAR(rhor1[ir].imag(),rhor2[ir].imag(),1e-10);
+        }
+
+        pwtest.real2recip(rhor1,rhog1,ik);
+        pwpipe.real2recip(rhor1,rhog2,ik);
+        for(int ig = 0 ; ig < npwk ; ++ig)
+        {
+            EXPECT_NEAR(rhog1[ig].real(),rhog2[ig].real(),1e-10);
+            EXPECT_NEAR(rhog1[ig].imag(),rhog2[ig].imag(),1e-10);
+        }
+        delete[] rhog1;
+        delete[] rhog2;
+    }
+
+    delete[] rhor1;
+    delete[] rhor2;
+    delete[] kvec_d;
+}
@@ -0,0 +1,86 @@
+//---------------------------------------------
+// TEST for scale_gamma of gamma_only wave functions
+//---------------------------------------------
+#include "../pw_basis_k.h"
+#ifdef __MPI
+#include "test_tool.h"
+#include "module_base/parallel_global.h"
+#include "mpi.h"
+#endif
+#include "module_base/constants.h"
+#include "module_base/global_function.h"
+#include "pw_test.h"
+
+using namespace std;
+TEST_F(PWTEST,test9_2)
+{
+    cout<<"dividemthd 1, gamma_only: on, xprime: true/false, check scale_gamma"<<endl;
+    ModuleBase::Matrix3 latvec(1, 1, 0, 0, 2, 0, 0, 0, 2);
+    const double lat0 = 2;
+    const double wfcecut = 10;
+    const int nks = 1;
+    ModuleBase::Vector3<double> *kvec_d = new ModuleBase::Vector3<double>[nks];
+    kvec_d[0].set(0,0,0);
+    for(int ixp = 0 ; ixp < 2 ; ++ixp)
+    {
+        const bool xprime = (ixp == 0);
+        ModulePW::PW_Basis_K pwtest(device_flag, "double");
+        //--------------------------------------------------
+#ifdef __MPI
+        pwtest.initmpi(nproc_in_pool, rank_in_pool, POOL_WORLD);
+#endif
+        pwtest.initgrids(lat0,latvec,4*wfcecut);
+        pwtest.initparameters(true,wfcecut,nks,kvec_d,1,xprime);
+        pwtest.setuptransform();
+        pwtest.collect_local_pw();
+
+        const int nrxx = pwtest.nrxx;
+        const int npwk = pwtest.npwk[0];
+        const int nxyz = pwtest.nxyz;
+        double * psir = new double [nrxx];
+        complex<double> * psig = new complex<double> [npwk];
+        complex<double> * psig0 = new complex<double> [npwk];
+        for(int ir = 0 ; ir < nrxx ; ++ir)
+        {
+            psir[ir] = sin(double(ir + rank_in_pool)) + 0.5;
+        }
+        pwtest.real2recip(psir,psig,0);
+        // band-limited real function of psig
+        pwtest.recip2real(psig,psir,0);
+
+        double normr = 0;
+        for(int ir = 0 ; ir < nrxx ; ++ir)
+        {
+            normr += psir[ir] * psir[ir];
+        }
+        normr /= nxyz;
+
+        for(int ig = 0 ; ig < npwk ; ++ig)
+        {
+            psig0[ig] = psig[ig];
+        }
+        pwtest.scale_gamma(psig, 0, sqrt(2.0));
+        double normg = 0;
+        for(int ig = 0 ; ig < npwk ; ++ig)
+        {
+            normg += norm(psig[ig]);
+        }
+#ifdef __MPI
+        MPI_Allreduce(MPI_IN_PLACE, &normr, 1, MPI_DOUBLE, MPI_SUM, POOL_WORLD);
+        MPI_Allreduce(MPI_IN_PLACE, &normg, 1, MPI_DOUBLE, MPI_SUM, POOL_WORLD);
+#endif
+        // the plain sum over the half sphere is the norm of the real function
+        EXPECT_NEAR(normr, normg, 1e-8);
+
+        pwtest.scale_gamma(psig, 0, 1.0/sqrt(2.0));
+        for(int ig = 0 ; ig < npwk ; ++ig)
+        {
+            EXPECT_NEAR(psig0[ig].real(),psig[ig].real(),1e-10);
+            EXPECT_NEAR(psig0[ig].imag(),psig[ig].imag(),1e-10);
+        }
+        delete[] psir;
+        delete[] psig;
+        delete[] psig0;
+    }
+    delete[] kvec_d;
+}
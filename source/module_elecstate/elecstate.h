@@ -110,10 +110,8 @@ class ElecState
     void cal_converged();
     void cal_energies(const int type);
 #ifdef __EXX
-#ifdef __LCAO
     void set_exx(const double& Eexx);
     void set_exx(const std::complex<double>& Eexx);
-#endif //__LCAO
 #endif //__EXX
  
     double get_hartree_energy();
@@ -4,7 +4,6 @@ namespace elecstate
 {
 
 #ifdef __EXX
-#ifdef __LCAO
 /// @brief calculation if converged
 /// @date Peize Lin add 2016-12-03
 void ElecState::set_exx(const double& Eexx)
@@ -27,7 +26,6 @@ void ElecState::set_exx(const std::complex<double>& Eexx)
     }
     return;
 }
-#endif //__LCAO
 #endif //__EXX
 
 }
\ No newline at end of file
@@ -275,6 +275,14 @@ void ElecState::print_etot(const bool converged,
     {
         label = "DA";
     }
+    else if (ks_solver_type == "chfsi")
+    {
+        label = "CF";
+    }
+    else if (ks_solver_type == "lobpcg")
+    {
+        label = "LB";
+    }
     else if (ks_solver_type == "scalapack_gvx")
     {
         label = "GV";
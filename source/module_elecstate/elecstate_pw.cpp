@@ -2,10 +2,15 @@
 
 #include "elecstate_getters.h"
 #include "module_base/constants.h"
+#include "module_base/parallel_global.h"
 #include "module_base/parallel_reduce.h"
 #include "module_base/timer.h"
 #include "module_psi/kernels/device.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace elecstate {
 
 template<typename FPTYPE, typename Device>
@@ -27,6 +32,8 @@ ElecStatePW<FPTYPE, Device>::~ElecStatePW()
     }
     delmem_complex_op()(this->ctx, this->wfcr);
     delmem_complex_op()(this->ctx, this->wfcr_another_spin);
+    delmem_complex_op()(this->ctx, this->wfcr_block);
+    delmem_var_op()(this->ctx, this->w_block);
 }
 
 template<typename FPTYPE, typename Device>
@@ -56,6 +63,12 @@ void ElecStatePW<FPTYPE, Device>::init_rho_data()
     }
     resmem_complex_op()(this->ctx, this->wfcr, this->basis->nmaxgr, "ElecSPW::wfcr");
     resmem_complex_op()(this->ctx, this->wfcr_another_spin, this->charge->nrxx, "ElecSPW::wfcr_a");
+    if (GlobalV::NSPIN != 4)
+    {
+        this->nbatch_rho = std::max(1, std::min(8, GlobalV::NBANDS));
+        resmem_complex_op()(this->ctx, this->wfcr_block, this->nbatch_rho * this->charge->nrxx, "ElecSPW::wfcr_b");
+        resmem_var_op()(this->ctx, this->w_block, this->nbatch_rho);
+    }
     this->init_rho = true;
 }
 
@@ -98,6 +111,20 @@ void ElecStatePW<FPTYPE, Device>::psiToRho(const psi::Psi<std::complex<FPTYPE>,
             }
         }
     }
+#ifdef __MPI
+    // sum the contributions of all band groups by one reduction
+    if (Parallel_Global::ks_band_groups())
+    {
+        for (int is = 0; is < GlobalV::NSPIN; ++is)
+        {
+            MPI_Allreduce(MPI_IN_PLACE, this->charge->rho[is], this->charge->nrxx, MPI_DOUBLE, MPI_SUM, PARAPW_WORLD);
+            if (get_xc_func_type() == 3)
+            {
+                MPI_Allreduce(MPI_IN_PLACE, this->charge->kin_r[is], this->charge->nrxx, MPI_DOUBLE, MPI_SUM, PARAPW_WORLD);
+            }
+        }
+    }
+#endif
     this->parallelK();
     ModuleBase::timer::tick("ElecStatePW", "psiToRho");
 }
@@ -146,12 +173,19 @@ void ElecStatePW<FPTYPE, Device>::rhoBandK(const psi::Psi<std::complex<FPTYPE>,
         current_spin = this->klist->isk[ik];
     }
     int nbands = psi.get_nbands();
+    // with band groups, each group only sums its own slice of bands, see psiToRho
+    int start_band = 0;
+    if (Parallel_Global::ks_band_groups())
+    {
+        Parallel_Global::divide_bands(psi.get_nbands(), start_band, nbands);
+    }
+    nbands += start_band;
     const double threshold = ModuleBase::threshold_wg * this->wg(ik, 0);
     //  here we compute the band energy: the sum of the eigenvalues
     if (GlobalV::NSPIN == 4)
     {
         int npwx = npw / 2;
-        for (int ibnd = 0; ibnd < nbands; ibnd++)
+        for (int ibnd = start_band; ibnd < nbands; ibnd++)
         {
             ///
             /// only occupied band should be calculated.
@@ -171,9 +205,49 @@ void ElecStatePW<FPTYPE, Device>::rhoBandK(const psi::Psi<std::complex<FPTYPE>,
             elecstate_pw_op()(this->ctx, GlobalV::DOMAG, GlobalV::DOMAG_Z, this->charge->nrxx, w1, this->rho, this->wfcr, this->wfcr_another_spin);
         }
     }
+    else if (this->basis->gamma_only)
+    {
+        // gamma_only: psi is real, one c2r transform per band (CPU only), see PW_Basis_K::scale_gamma
+        const FPTYPE sqrt2 = std::sqrt(static_cast<FPTYPE>(2.0));
+        FPTYPE* psir = reinterpret_cast<FPTYPE*>(this->wfcr_another_spin);
+        FPTYPE* rho_spin = this->rho[current_spin];
+        for (int ibnd = start_band; ibnd < nbands; ibnd++)
+        {
+            if (this->wg(ik, ibnd) < threshold) {
+                continue;
+            }
+            const auto w1 = static_cast<FPTYPE>(this->wg(ik, ibnd) / get_ucell_omega());
+            for (int ig = 0; ig < npw; ig++)
+            {
+                this->wfcr[ig] = psi(ibnd, ig);
+            }
+            this->basis->scale_gamma(this->wfcr, ik, static_cast<FPTYPE>(1.0) / sqrt2);
+            this->basis->recip2real(this->wfcr, psir, ik);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 4096 / sizeof(FPTYPE))
+#endif
+            for (int ir = 0; ir < this->charge->nrxx; ir++)
+            {
+                rho_spin[ir] += w1 * psir[ir] * psir[ir];
+            }
+        }
+    }
     else
     {
-        for (int ibnd = 0; ibnd < nbands; ibnd++)
+        // the occupied bands are transformed into wfcr_block, and each block is added to rho by one pass,
+        // instead of reading and writing the whole rho once per band
+        const int nrxx = this->charge->nrxx;
+        std::vector<FPTYPE> w_host(this->nbatch_rho);
+        int nb = 0;
+        auto add_block = [&]() {
+            if (nb == 0) {
+                return;
+            }
+            syncmem_var_h2d_op()(this->ctx, cpu_ctx, this->w_block, w_host.data(), nb);
+            elecstate_pw_op()(this->ctx, current_spin, nrxx, nb, this->w_block, this->rho, this->wfcr_block);
+            nb = 0;
+        };
+        for (int ibnd = start_band; ibnd < nbands; ibnd++)
         {
             ///
             /// only occupied band should be calculated.
@@ -182,14 +256,16 @@ void ElecStatePW<FPTYPE, Device>::rhoBandK(const psi::Psi<std::complex<FPTYPE>,
                 continue;
             }
 
-            this->basis->recip_to_real(this->ctx, &psi(ibnd,0), this->wfcr, ik);
-
             const auto w1 = static_cast<FPTYPE>(this->wg(ik, ibnd) / get_ucell_omega());
 
-            if (w1 != 0.0)
-            {
-                // replaced by denghui at 20221110
-                elecstate_pw_op()(this->ctx,  current_spin, this->charge->nrxx, w1,  this->rho,  this->wfcr);
+            if (w1 == 0.0) {
+                continue;
+            }
+
+            this->basis->recip_to_real(this->ctx, &psi(ibnd,0), this->wfcr_block + nb * nrxx, ik);
+            w_host[nb++] = w1;
+            if (nb == this->nbatch_rho) {
+                add_block();
             }
 
             // kinetic energy density
@@ -216,6 +292,7 @@ void ElecStatePW<FPTYPE, Device>::rhoBandK(const psi::Psi<std::complex<FPTYPE>,
                 }
             }
         }
+        add_block();
     }
 }
 
@@ -49,6 +49,10 @@ class ElecStatePW : public ElecState
     FPTYPE ** rho = nullptr, ** kin_r = nullptr;
     FPTYPE * rho_data = nullptr, * kin_r_data = nullptr;
     std::complex<FPTYPE> *wfcr = nullptr, *wfcr_another_spin = nullptr;
+    // occupied bands in real space (nbatch_rho, nrxx) and their weights, added to rho block by block
+    int nbatch_rho = 1;
+    std::complex<FPTYPE>* wfcr_block = nullptr;
+    FPTYPE* w_block = nullptr;
 
     using meta_op = hamilt::meta_pw_op<FPTYPE, Device>;
     using elecstate_pw_op = elecstate::elecstate_pw_op<FPTYPE, Device>;
@@ -57,6 +61,7 @@ class ElecStatePW : public ElecState
     using resmem_var_op = psi::memory::resize_memory_op<FPTYPE, Device>;
     using delmem_var_op = psi::memory::delete_memory_op<FPTYPE, Device>;
     using castmem_var_d2h_op = psi::memory::cast_memory_op<double, FPTYPE, psi::DEVICE_CPU, Device>;
+    using syncmem_var_h2d_op = psi::memory::synchronize_memory_op<FPTYPE, Device, psi::DEVICE_CPU>;
 
     using setmem_complex_op = psi::memory::set_memory_op<std::complex<FPTYPE>, Device>;
     using resmem_complex_op = psi::memory::resize_memory_op<std::complex<FPTYPE>, Device>;
@@ -56,6 +56,24 @@ __global__ void elecstate_pw(
   }
 }
 
+template<typename FPTYPE>
+__global__ void elecstate_pw_block(
+    const int spin,
+    const int nrxx,
+    const int nbatch,
+    const FPTYPE* w1,
+    FPTYPE* rho,
+    const thrust::complex<FPTYPE>* wfcr)
+{
+  int idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if(idx >= nrxx) {return;}
+  FPTYPE sum = 0;
+  for (int ib = 0; ib < nbatch; ib++) {
+    sum += w1[ib] * norm(wfcr[ib * nrxx + idx]);
+  }
+  rho[spin * nrxx + idx] += sum;
+}
+
 template <typename FPTYPE>
 void elecstate_pw_op<FPTYPE, psi::DEVICE_GPU>::operator() (
     const psi::DEVICE_GPU* ctx,
@@ -91,6 +109,23 @@ void elecstate_pw_op<FPTYPE, psi::DEVICE_GPU>::operator()(
   );
 }
 
+template <typename FPTYPE>
+void elecstate_pw_op<FPTYPE, psi::DEVICE_GPU>::operator()(
+    const psi::DEVICE_GPU* ctx,
+    const int& spin,
+    const int& nrxx,
+    const int& nbatch,
+    const FPTYPE* w1,
+    FPTYPE** rho,
+    const std::complex<FPTYPE>* wfcr)
+{
+  const int block = (nrxx + THREADS_PER_BLOCK - 1) / THREADS_PER_BLOCK;
+  elecstate_pw_block<FPTYPE><<<block, THREADS_PER_BLOCK>>>(
+    spin, nrxx, nbatch, w1, rho[0],
+    reinterpret_cast<const thrust::complex<FPTYPE>*>(wfcr)
+  );
+}
+
 template struct elecstate_pw_op<float, psi::DEVICE_GPU>;
 template struct elecstate_pw_op<double, psi::DEVICE_GPU>;
 
@@ -1,5 +1,7 @@
 #include "module_elecstate/kernels/elecstate_op.h"
 
+#include <algorithm>
+
 namespace elecstate{
 
 template <typename FPTYPE> 
@@ -80,6 +82,36 @@ struct elecstate_pw_op<FPTYPE, psi::DEVICE_CPU> {
           }
       }
     } 
+
+  void operator()(
+    const psi::DEVICE_CPU * /*ctx*/,
+    const int& spin,
+    const int& nrxx,
+    const int& nbatch,
+    const FPTYPE* w1,
+    FPTYPE** rho,
+    const std::complex<FPTYPE>* wfcr)
+    {
+      // rho is updated tile by tile, so a tile stays in cache while all bands of the block are added to it
+      const int tile = 4096 / sizeof(FPTYPE);
+      FPTYPE* rho_spin = rho[spin];
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+      for (int ir0 = 0; ir0 < nrxx; ir0 += tile)
+      {
+        const int ir1 = std::min(ir0 + tile, nrxx);
+        for (int ib = 0; ib < nbatch; ib++)
+        {
+          const FPTYPE wb = w1[ib];
+          const std::complex<FPTYPE>* wfcr_ib = wfcr + ib * nrxx;
+          for (int ir = ir0; ir < ir1; ir++)
+          {
+            rho_spin[ir] += wb * (wfcr_ib[ir].real() * wfcr_ib[ir].real() + wfcr_ib[ir].imag() * wfcr_ib[ir].imag());
+          }
+        }
+      }
+    }
 };
 
 template struct elecstate_pw_op<float, psi::DEVICE_CPU>;
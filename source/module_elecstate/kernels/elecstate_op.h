@@ -50,6 +50,27 @@ struct elecstate_pw_op {
       FPTYPE** rho,
       const std::complex<FPTYPE>* wfcr,
       const std::complex<FPTYPE>* wfcr_another_spin);
+
+  /// @brief Calculate psiToRho output for a block of bands at once, NSPIN != 4
+  ///
+  /// Input Parameters
+  /// @param ctx - which device this function runs on
+  /// @param spin - current spin
+  /// @param nrxx - number of planewaves
+  /// @param nbatch - number of bands in the block
+  /// @param weight - weights of the bands in the block, on device
+  /// @param wfcr - input array, psi of the block in real space, (nbatch, nrxx)
+  ///
+  /// Output Parameters
+  /// @param rho - electronic densities
+  void operator() (
+      const Device* ctx,
+      const int& spin,
+      const int& nrxx,
+      const int& nbatch,
+      const FPTYPE* weight,
+      FPTYPE** rho,
+      const std::complex<FPTYPE>* wfcr);
 };
 
 #if __CUDA || __UT_USE_CUDA || __ROCM || __UT_USE_ROCM
@@ -72,6 +93,15 @@ struct elecstate_pw_op<FPTYPE, psi::DEVICE_GPU> {
     FPTYPE** rho,
     const std::complex<FPTYPE>* wfcr,
     const std::complex<FPTYPE>* wfcr_another_spin);
+
+  void operator()(
+    const psi::DEVICE_GPU* ctx,
+    const int& spin,
+    const int& nrxx,
+    const int& nbatch,
+    const FPTYPE* w1,
+    FPTYPE** rho,
+    const std::complex<FPTYPE>* wfcr);
 };
 #endif
 } // namespace elecstate
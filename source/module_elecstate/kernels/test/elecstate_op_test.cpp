@@ -68,6 +68,33 @@ TEST_F(TestModuleElecstateMultiDevice, elecstate_pw_op_cpu)
     delete [] rho;
 }
 
+TEST_F(TestModuleElecstateMultiDevice, elecstate_pw_block_op_cpu)
+{
+    // a block of three bands in one pass, against the band-by-band accumulation
+    const int nbatch = 3;
+    std::vector<std::complex<double>> wfcr_block(nbatch * this->nrxx);
+    for (int ir = 0; ir < this->nrxx; ir++) {
+        wfcr_block[ir] = this->wfcr[ir];
+        wfcr_block[this->nrxx + ir] = this->wfcr_2[ir];
+        wfcr_block[2 * this->nrxx + ir] = this->wfcr_another_spin_2[ir];
+    }
+    const std::vector<double> w_block = {this->w1, this->w2, 2.0 * this->w1};
+    std::vector<double> rho_data(2 * this->nrxx, 1.0), rho_ref(2 * this->nrxx, 1.0);
+    double ** rho = new double* [2];
+    rho[0] = rho_data.data();
+    rho[1] = rho_data.data() + this->nrxx;
+    elecstate_cpu_op()(this->cpu_ctx, 1, this->nrxx, nbatch, w_block.data(), rho, wfcr_block.data());
+    rho[0] = rho_ref.data();
+    rho[1] = rho_ref.data() + this->nrxx;
+    for (int ib = 0; ib < nbatch; ib++) {
+        elecstate_cpu_op()(this->cpu_ctx, 1, this->nrxx, w_block[ib], rho, wfcr_block.data() + ib * this->nrxx);
+    }
+    for (int ii = 0; ii < rho_data.size(); ii++) {
+        EXPECT_NEAR(rho_data[ii], rho_ref[ii], 1e-12);
+    }
+    delete [] rho;
+}
+
 TEST_F(TestModuleElecstateMultiDevice, elecstate_pw_spin_op_cpu)
 {
     std::vector<double> rho_data(expected_rho_2.size(), 0);
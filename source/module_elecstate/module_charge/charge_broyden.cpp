@@ -3,6 +3,7 @@
 #include "module_base/global_variable.h"
 #include "module_base/inverse_matrix.h"
 #include "module_base/lapack_connector.h"
+#include "module_base/blas_connector.h"
 #include "module_base/parallel_reduce.h"
 #include "module_base/memory.h"
 #include "module_base/timer.h"
@@ -16,50 +17,58 @@ void Charge_Mixing::Simplified_Broyden_mixing(const int &iter,
 	//Ref: D.D. Johnson PRB 38, 12807 (1988)
 	//Here the weight w0 of the error of the inverse Jacobian is set to 0 and the weight wn of
 	//the error of each previous iteration is set to same.
+	//The history is only kept for G vectors inside the low-G sphere (all of them if mixing_lowg = 0),
+	//the components outside are mixed linearly.
 
 	// (1)
 	this->allocate_Broyden();
-	
+	this->set_broyden_weight();
+
+	const int nb = this->nbroyden;
+	const int lda = std::max(nb, 1); // a process may own no G vector inside the sphere
+	const int inc = 1;
+	// dF and dn are empty if nb = 0, so their rows are addressed from data()
+	double* F = this->dF.data() + mixing_ndim * nb; // the last row stores the current residual
+	double* n = this->dn.data() + mixing_ndim * nb; // and the current input density
+	this->gather_lowg(chr->rhog, F);
+	this->gather_lowg(chr->rhog_save, n);
+
 	int iter_used = std::min(iter-1, mixing_ndim);
 	int ipos = iter-2 - int((iter-2)/mixing_ndim) * mixing_ndim;
 	if(iter > 1)
 	{
+		double* dFi = this->dF.data() + ipos * nb;
+		double* dni = this->dn.data() + ipos * nb;
+		std::vector<double> wdF(nb);
 #ifdef _OPENMP
-#pragma omp parallel for collapse(2) schedule(static, 128)
+#pragma omp parallel for schedule(static, 512)
 #endif
-		for(int is=0; is<GlobalV::NSPIN; is++)
+		for(int i = 0; i < nb; ++i)
 		{
-			for(int ig = 0 ; ig < this->rhopw->npw; ++ig)
-			{
-				dF[ipos][is][ig] -= chr->rhog[is][ig];
-				dn[ipos][is][ig] -= chr->rhog_save[is][ig];
-			}
+			dFi[i] -= F[i];
+			dni[i] -= n[i];
+			wdF[i] = this->broyden_weight[i] * dFi[i];
 		}
-	}
-#ifdef _OPENMP
-#pragma omp parallel for collapse(2) schedule(static, 128)
-#endif
-	for(int is=0; is<GlobalV::NSPIN; is++)
-	{
-		for(int ig = 0 ; ig < this->rhopw->npw; ++ig)
+		// only the row of ipos is changed since last step
+		std::vector<double> overlap(iter_used);
+		const double one = 1.0, zero = 0.0;
+		dgemv_("T", &nb, &iter_used, &one, this->dF.data(), &lda, wdF.data(), &inc, &zero, overlap.data(), &inc);
+		Parallel_Reduce::reduce_double_pool(overlap.data(), iter_used);
+		for(int i = 0; i < iter_used; ++i)
 		{
-			dF[mixing_ndim][is][ig] = chr->rhog[is][ig];
-			dn[mixing_ndim][is][ig] = chr->rhog_save[is][ig];
+			this->dFdF(ipos, i) = overlap[i];
+			this->dFdF(i, ipos) = overlap[i];
 		}
 	}
-	
+
 	if(iter_used > 0)
 	{
 		this->beta.create(iter_used, iter_used,false);
 		for(int i = 0; i < iter_used; ++i)
 		{
-			for(int j = i; j < iter_used; ++j)
+			for(int j = 0; j < iter_used; ++j)
 			{
-				beta(i,j) = rhog_dot_product( this->dF[i], this->dF[j] );
-				if(j != i)
-				{
-					beta(j,i)=beta(i,j);
-				}
+				beta(i,j) = this->dFdF(i,j);
 			}
 		}
 		double * work = new double [iter_used];
@@ -77,48 +86,47 @@ void Charge_Mixing::Simplified_Broyden_mixing(const int &iter,
 				beta(i,j) = beta(j,i);
 			}
 		}
-		for(int i = 0 ; i < iter_used ; ++i)
+
+		// work = <dF_i|F>
+		std::vector<double> wF(nb);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 512)
+#endif
+		for(int i = 0; i < nb; ++i)
 		{
-			work[i] = rhog_dot_product( this->dF[i], chr->rhog );
+			wF[i] = this->broyden_weight[i] * F[i];
 		}
+		const double one = 1.0, zero = 0.0, mone = -1.0;
+		dgemv_("T", &nb, &iter_used, &one, this->dF.data(), &lda, wF.data(), &inc, &zero, work, &inc);
+		Parallel_Reduce::reduce_double_pool(work, iter_used);
+
+		std::vector<double> gamma(iter_used, 0.0);
 		for(int i = 0 ; i < iter_used ; ++i)
 		{
-			double gamma0 = 0;
 			for(int j = 0; j < iter_used ; ++j)
 			{
-				gamma0 += beta(i,j) * work[j];
+				gamma[i] += beta(i,j) * work[j];
 			}
-#ifdef _OPENMP
-#pragma omp parallel for collapse(2) schedule(static, 512)
-#endif
-			for(int is=0; is<GlobalV::NSPIN; is++)
-			{
-				for(int ig = 0 ; ig < this->rhopw->npw; ++ig)
-				{
-					chr->rhog[is][ig] -= gamma0 * dF[i][is][ig];
-					chr->rhog_save[is][ig] -= gamma0 * dn[i][is][ig];
-				}
-			}
-			
 		}
+		// F -= sum_i gamma_i dF_i, n -= sum_i gamma_i dn_i
+		std::vector<double> Fnew(F, F + nb);
+		std::vector<double> nnew(n, n + nb);
+		dgemv_("N", &nb, &iter_used, &mone, this->dF.data(), &lda, gamma.data(), &inc, &one, Fnew.data(), &inc);
+		dgemv_("N", &nb, &iter_used, &mone, this->dn.data(), &lda, gamma.data(), &inc, &one, nnew.data(), &inc);
+		this->scatter_lowg(Fnew.data(), chr->rhog);
+		this->scatter_lowg(nnew.data(), chr->rhog_save);
+
 		delete[] work;
 		delete[] iwork;
 	}
 	int inext = iter-1 - int((iter-1)/mixing_ndim) * mixing_ndim;
-	
-#ifdef _OPENMP
-#pragma omp parallel for collapse(2) schedule(static, 128)
-#endif
-	for(int is=0; is<GlobalV::NSPIN; is++)
+
+	for(int i = 0; i < nb; ++i)
 	{
-		for(int ig = 0 ; ig < this->rhopw->npw; ++ig)
-		{
-			dF[inext][is][ig] = dF[mixing_ndim][is][ig];
-			dn[inext][is][ig] = dn[mixing_ndim][is][ig];
-		}
+		this->dF[inext * nb + i] = F[i];
+		this->dn[inext * nb + i] = n[i];
 	}
 
-
 	for(int is=0; is<GlobalV::NSPIN; is++)
 	{
 #ifdef _OPENMP
@@ -138,22 +146,41 @@ void Charge_Mixing::allocate_Broyden()
 {
 	if(!initb)
 	{
-		int npdim = mixing_ndim + 1; // another array is used for temporarily store
-		this->dF = new std::complex<double>**[npdim];
-		this->dn = new std::complex<double>**[npdim];
-		
-		for (int i=0; i<npdim; i++)
+		// G vectors inside the low-G sphere, mixing_lowg is in Angstrom^-1 as mixing_gg0
+		this->ig_lowg.clear();
+		double gg_lowg = -1.0; // all G vectors
+		if(this->mixing_lowg > 0.0)
 		{
-			dF[i] = new std::complex<double>*[GlobalV::NSPIN]; 
-			dn[i] = new std::complex<double>*[GlobalV::NSPIN]; 
-			for (int is=0; is<GlobalV::NSPIN; is++)
+			gg_lowg = std::pow(this->mixing_lowg * 0.529177 / GlobalC::ucell.tpiba, 2);
+			// the history is singular if the sphere contains too few G vectors
+			double nlowg = 0;
+			for(int ig = 0; ig < this->rhopw->npw; ++ig)
+			{
+				if(this->rhopw->gg[ig] > 1e-8 && this->rhopw->gg[ig] <= gg_lowg) nlowg += 1;
+			}
+			Parallel_Reduce::reduce_double_pool(nlowg);
+			if(nlowg < mixing_ndim)
 			{
-				dF[i][is] = new std::complex<double>[this->rhopw->npw];
-				dn[i][is] = new std::complex<double>[this->rhopw->npw];
+				ModuleBase::WARNING("Charge_Mixing", "too few G vectors inside mixing_lowg, all G vectors are kept in the Broyden history");
+				gg_lowg = -1.0;
 			}
 		}
-		ModuleBase::Memory::record("ChgMix::dF", sizeof(std::complex<double>) * GlobalV::NSPIN*npdim*this->rhopw->npw);
-		ModuleBase::Memory::record("ChgMix::dn", sizeof(std::complex<double>) * GlobalV::NSPIN*npdim*this->rhopw->npw);
+		for(int ig = 0; ig < this->rhopw->npw; ++ig)
+		{
+			if(gg_lowg < 0.0 || this->rhopw->gg[ig] <= gg_lowg)
+			{
+				this->ig_lowg.push_back(ig);
+			}
+		}
+		this->nbroyden = 2 * GlobalV::NSPIN * this->ig_lowg.size();
+
+		int npdim = mixing_ndim + 1; // another array is used for temporarily store
+		this->dF.assign(npdim * this->nbroyden, 0.0);
+		this->dn.assign(npdim * this->nbroyden, 0.0);
+		this->broyden_weight.resize(this->nbroyden);
+		this->dFdF.create(mixing_ndim, mixing_ndim);
+		ModuleBase::Memory::record("ChgMix::dF", sizeof(double) * npdim * this->nbroyden);
+		ModuleBase::Memory::record("ChgMix::dn", sizeof(double) * npdim * this->nbroyden);
 		this->initb = true;
 	}
 
@@ -164,18 +191,120 @@ void Charge_Mixing::deallocate_Broyden()
 {
     if (initb)
 	{
-		for (int i=0; i<mixing_ndim+1; ++i)
+		std::vector<double>().swap(this->dF);
+		std::vector<double>().swap(this->dn);
+		std::vector<double>().swap(this->broyden_weight);
+		std::vector<int>().swap(this->ig_lowg);
+		this->nbroyden = 0;
+        this->initb = false;
+	}
+}
+
+// The vector of the Broyden history is (Re, Im) of the low-G components of
+// rho (NSPIN = 1), rho_up + rho_dw, rho_up - rho_dw (NSPIN = 2) or rho, m_x, m_y, m_z (NSPIN = 4),
+// in which rhog_dot_product becomes a diagonal metric.
+void Charge_Mixing::gather_lowg(const std::complex<double>* const* rhog, double* out) const
+{
+	const int nlow = this->ig_lowg.size();
+	for(int is = 0; is < GlobalV::NSPIN; ++is)
+	{
+		double* outs = out + 2 * is * nlow;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 512)
+#endif
+		for(int i = 0; i < nlow; ++i)
 		{
-			for(int is = 0 ; is < GlobalV::NSPIN ; ++is)
+			const int ig = this->ig_lowg[i];
+			std::complex<double> c = rhog[is][ig];
+			if(GlobalV::NSPIN == 2)
 			{
-				delete[] dF[i][is];
-				delete[] dn[i][is];
+				c = (is == 0) ? rhog[0][ig] + rhog[1][ig] : rhog[0][ig] - rhog[1][ig];
 			}
-			delete[] dF[i];
-			delete[] dn[i];
+			outs[2 * i] = c.real();
+			outs[2 * i + 1] = c.imag();
 		}
-		delete[] dF;
-		delete[] dn;
-        this->initb = false;
 	}
-}
\ No newline at end of file
+}
+
+void Charge_Mixing::scatter_lowg(const double* in, std::complex<double>** rhog) const
+{
+	const int nlow = this->ig_lowg.size();
+	if(GlobalV::NSPIN == 2)
+	{
+		const double* tot = in;
+		const double* mag = in + 2 * nlow;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 512)
+#endif
+		for(int i = 0; i < nlow; ++i)
+		{
+			const int ig = this->ig_lowg[i];
+			rhog[0][ig] = 0.5 * std::complex<double>(tot[2 * i] + mag[2 * i], tot[2 * i + 1] + mag[2 * i + 1]);
+			rhog[1][ig] = 0.5 * std::complex<double>(tot[2 * i] - mag[2 * i], tot[2 * i + 1] - mag[2 * i + 1]);
+		}
+		return;
+	}
+	for(int is = 0; is < GlobalV::NSPIN; ++is)
+	{
+		const double* ins = in + 2 * is * nlow;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 512)
+#endif
+		for(int i = 0; i < nlow; ++i)
+		{
+			rhog[is][this->ig_lowg[i]] = std::complex<double>(ins[2 * i], ins[2 * i + 1]);
+		}
+	}
+}
+
+// the diagonal metric of rhog_dot_product in the basis of gather_lowg
+void Charge_Mixing::set_broyden_weight()
+{
+	const int nlow = this->ig_lowg.size();
+	const double fac = ModuleBase::e2 * ModuleBase::FOUR_PI / GlobalC::ucell.tpiba2;
+	const double fac2 = ModuleBase::e2 * ModuleBase::FOUR_PI / (ModuleBase::TWO_PI * ModuleBase::TWO_PI);
+	const double gamma_fac = this->rhopw->gamma_only ? 2.0 : 1.0;
+	const int ig0 = this->rhopw->ig_gge0;
+	const bool magnetic = (GlobalV::NSPIN == 4) && (GlobalV::DOMAG || GlobalV::DOMAG_Z);
+
+	for(int is = 0; is < GlobalV::NSPIN; ++is)
+	{
+		for(int i = 0; i < nlow; ++i)
+		{
+			const int ig = this->ig_lowg[i];
+			const double gg = this->rhopw->gg[ig];
+			double w = 0.0;
+			if(GlobalV::NSPIN == 1 || (GlobalV::NSPIN == 4 && !magnetic))
+			{
+				if(is == 0 && gg >= 1e-8) w = fac / gg;
+			}
+			else if(GlobalV::NSPIN == 2)
+			{
+				if(is == 0)
+				{
+					if(gg >= 1e-8) w = fac / gg * gamma_fac;
+				}
+				else
+				{
+					w = fac2 * gamma_fac;
+					if(ig == 0) w += fac2;
+				}
+			}
+			else
+			{
+				if(is == 0)
+				{
+					if(ig != ig0) w = fac / gg;
+				}
+				else
+				{
+					if(ig != ig0) w = fac2 * gamma_fac;
+					else if(ig0 > 0) w = fac2;
+				}
+			}
+			w *= GlobalC::ucell.omega * 0.5;
+			this->broyden_weight[2 * is * nlow + 2 * i] = w;
+			this->broyden_weight[2 * is * nlow + 2 * i + 1] = w;
+		}
+	}
+}
@@ -31,7 +31,8 @@ void Charge_Mixing::set_mixing
     const double &mixing_beta_in,
     const int &mixing_ndim_in,
 	const double &mixing_gg0_in,
-	const bool &mixing_tau_in
+	const bool &mixing_tau_in,
+	const double &mixing_lowg_in
 )
 {
     this->mixing_mode = mixing_mode_in;
@@ -39,11 +40,16 @@ void Charge_Mixing::set_mixing
     this->mixing_ndim = mixing_ndim_in;
 	this->mixing_gg0 = mixing_gg0_in; //mohan add 2014-09-27
 	this->mixing_tau = mixing_tau_in;
+	this->mixing_lowg = mixing_lowg_in;
 
 	if(mixing_tau && mixing_mode == "broyden")
 	{
 		GlobalV::ofs_running << "Note : mixing_tau has only been implemented for plain and pulay mixing" << std::endl;
 	}
+	if(mixing_lowg > 0 && mixing_mode != "broyden")
+	{
+		GlobalV::ofs_running << "Note : mixing_lowg has only been implemented for broyden mixing" << std::endl;
+	}
 
     return;
 }
@@ -365,7 +371,7 @@ double Charge_Mixing::rhog_dot_product(
 {
     ModuleBase::TITLE("Charge_Mixing","rhog_dot_product");
 	ModuleBase::timer::tick("Charge_Mixing","rhog_dot_product");
-    static const double fac = ModuleBase::e2 * ModuleBase::FOUR_PI / GlobalC::ucell.tpiba2;
+    const double fac = ModuleBase::e2 * ModuleBase::FOUR_PI / GlobalC::ucell.tpiba2;
     static const double fac2 = ModuleBase::e2 * ModuleBase::FOUR_PI / (ModuleBase::TWO_PI * ModuleBase::TWO_PI);
 
     double sum = 0.0;
@@ -404,7 +410,7 @@ double Charge_Mixing::rhog_dot_product(
 			}
 			sum *= fac;
 
-			if(GlobalV::GAMMA_ONLY_PW)
+			if(this->rhopw->gamma_only)
 			{
 				sum *= 2.0;
 			}
@@ -426,7 +432,7 @@ double Charge_Mixing::rhog_dot_product(
 			mag *= fac2;
 
 			//if(GlobalV::GAMMA_ONLY_PW);
-			if(GlobalV::GAMMA_ONLY_PW)			// Peize Lin delete ; 2020.01.31
+			if(this->rhopw->gamma_only)			// Peize Lin delete ; 2020.01.31
 			{
 				mag *= 2.0;
 			}
@@ -460,7 +466,7 @@ double Charge_Mixing::rhog_dot_product(
 					(conj( rhog1[3][ig0])*rhog2[3][ig0]).real());
 			}
 			double fac3 = fac2;
-			if(GlobalV::GAMMA_ONLY_PW)
+			if(this->rhopw->gamma_only)
 			{
 				fac3 *= 2.0;
 			}
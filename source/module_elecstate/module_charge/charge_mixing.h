@@ -15,6 +15,8 @@
 #include "module_base/matrix.h"
 #include "module_cell/unitcell.h"
 #include "charge.h"
+
+#include <vector>
 class Charge_Mixing
 {
 	public:
@@ -30,7 +32,8 @@ class Charge_Mixing
         const double &mixing_beta_in,
         const int &mixing_ndim_in,
 		const double &mixing_gg0_in,
-		const bool &mixing_tau_in
+		const bool &mixing_tau_in,
+		const double &mixing_lowg_in
     );//mohan add mixing_gg0_in 2014-09-27
 
 	void need_auto_set();
@@ -72,6 +75,7 @@ class Charge_Mixing
     int mixing_ndim;
 	double mixing_gg0; //mohan add 2014-09-27
 	bool mixing_tau;
+	double mixing_lowg = 0.0; // radius (Angstrom^-1) of the low-G sphere kept in the Broyden history, 0: all G
 
     bool new_e_iteration;
 
@@ -138,8 +142,19 @@ class Charge_Mixing
 
 	ModuleBase::matrix beta; // (dstep, dstep)
 
-	std::complex<double>*** dF; // dF(i) = rhog(i) - rhog_save(i), (GlobalV::NSPIN, rstep, rhopw->npw)
-	std::complex<double>*** dn; // dn(i) = rhog(i+1) - rhog(i), (GlobalV::NSPIN, rstep, rhopw->npw)
+	// The history only keeps the G vectors inside the low-G sphere. Each step is one row of nbroyden
+	// = 2 * NSPIN * ig_lowg.size() doubles, and the rows are a ring buffer of (mixing_ndim + 1) rows,
+	// the last one for temporary storage.
+	std::vector<int> ig_lowg; // local index of G vectors inside the low-G sphere
+	int nbroyden = 0;
+	std::vector<double> dF; // dF(i) = rhog(i) - rhog_save(i)
+	std::vector<double> dn; // dn(i) = rhog(i+1) - rhog(i)
+	std::vector<double> broyden_weight; // metric of rhog_dot_product in this basis, dim = nbroyden
+	ModuleBase::matrix dFdF; // <dF_i|dF_j>, only the row of the newest dF is updated each step
+
+	void gather_lowg(const std::complex<double>* const* rhog, double* out) const;
+	void scatter_lowg(const double* in, std::complex<double>** rhog) const;
+	void set_broyden_weight();
 
 	private: 
 	bool autoset = false;
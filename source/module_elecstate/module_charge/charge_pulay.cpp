@@ -155,6 +155,12 @@ void Charge_Mixing::reset()		// Peize Lin add 2018-11-01
             this->deallocate_Broyden();
         }
     }
+    // the G vectors inside the low-G sphere depend on the cell,
+    // which changes between the ionic steps of relax and md
+    else if (this->mixing_mode == "broyden" && this->mixing_lowg > 0.0)
+    {
+        this->deallocate_Broyden();
+    }
 }
 
 void Charge_Mixing::set_rhopw(ModulePW::PW_Basis* rhopw_in)
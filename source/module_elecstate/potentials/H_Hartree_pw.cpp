@@ -44,28 +44,8 @@ ModuleBase::matrix H_Hartree_pw::v_hartree(const UnitCell &cell,
     //=======================================================
     // calculate hartree potential in G-space (NB: V(G=0)=0 )
     //=======================================================
-
-    double ehart = 0.0;
-
     std::vector<std::complex<double>> vh_g(rho_basis->npw);
-#ifdef _OPENMP
-#pragma omp parallel for reduction(+:ehart)
-#endif
-    for (int ig = 0; ig < rho_basis->npw; ig++)
-    {
-        if (rho_basis->gg[ig] >= 1.0e-8) // LiuXh 20180410
-        {
-            const double fac = ModuleBase::e2 * ModuleBase::FOUR_PI / (cell.tpiba2 * rho_basis->gg[ig]);
-
-            ehart += (conj(Porter[ig]) * Porter[ig]).real() * fac;
-            vh_g[ig] = fac * Porter[ig];
-        }
-    }
-
-    Parallel_Reduce::reduce_double_pool(ehart);
-    ehart *= 0.5 * cell.omega;
-    // std::cout << " ehart=" << ehart << std::endl;
-    H_Hartree_pw::hartree_energy = ehart;
+    H_Hartree_pw::v_hartree_g(cell, rho_basis, Porter.data(), vh_g.data());
 
     //==========================================
     // transform hartree potential to real space
@@ -98,11 +78,36 @@ ModuleBase::matrix H_Hartree_pw::v_hartree(const UnitCell &cell,
     return v;
 } // end subroutine v_h
 
+void H_Hartree_pw::v_hartree_g(const UnitCell &cell,
+                               const ModulePW::PW_Basis *rho_basis,
+                               const std::complex<double> *rhog,
+                               std::complex<double> *vh_g)
+{
+    double ehart = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:ehart)
+#endif
+    for (int ig = 0; ig < rho_basis->npw; ig++)
+    {
+        if (rho_basis->gg[ig] >= 1.0e-8) // LiuXh 20180410
+        {
+            const double fac = ModuleBase::e2 * ModuleBase::FOUR_PI / (cell.tpiba2 * rho_basis->gg[ig]);
+
+            ehart += (conj(rhog[ig]) * rhog[ig]).real() * fac;
+            vh_g[ig] += fac * rhog[ig];
+        }
+    }
+
+    Parallel_Reduce::reduce_double_pool(ehart);
+    H_Hartree_pw::hartree_energy = 0.5 * cell.omega * ehart;
+}
+
 PotHartree::PotHartree(const ModulePW::PW_Basis* rho_basis_in)
 {
     this->rho_basis_ = rho_basis_in;
     this->dynamic_mode = true;
     this->fixed_mode = false;
+    this->recip_mode = true;
 }
 
 void PotHartree::cal_v_eff(const Charge* chg, const UnitCell* ucell, ModuleBase::matrix& v_eff)
@@ -111,4 +116,9 @@ void PotHartree::cal_v_eff(const Charge* chg, const UnitCell* ucell, ModuleBase:
     return;
 }
 
+void PotHartree::cal_v_eff_g(const UnitCell* ucell, const std::complex<double>* rhog_tot, std::complex<double>* vg)
+{
+    H_Hartree_pw::v_hartree_g(*ucell, this->rho_basis_, rhog_tot, vg);
+}
+
 } // namespace elecstate
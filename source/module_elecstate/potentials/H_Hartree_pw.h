@@ -25,6 +25,12 @@ class H_Hartree_pw
                                         const int &nspin,
                                         const double *const *const rho);
 
+    // add V_H(G) of the total charge density rhog to vh_g, and compute the Hartree energy
+    static void v_hartree_g(const UnitCell &cell,
+                            const ModulePW::PW_Basis *rho_basis,
+                            const std::complex<double> *rhog,
+                            std::complex<double> *vh_g);
+
     static int get_Z(std::string str);
 
     static void cast_C2R(std::complex<double> *src, double *dst, int dim);
@@ -60,6 +66,8 @@ class PotHartree : public PotBase
     PotHartree(const ModulePW::PW_Basis* rho_basis_in);
 
     void cal_v_eff(const Charge* chg, const UnitCell* ucell, ModuleBase::matrix& v_eff);
+
+    void cal_v_eff_g(const UnitCell* ucell, const std::complex<double>* rhog_tot, std::complex<double>* vg) override;
 };
 
 } // namespace elecstate
@@ -17,6 +17,9 @@ namespace elecstate
     c. fixed_mode should be set "true" if you want Potential class call cal_fixed_v()
     d. dynamic_mode should be set "true" if you want Potential class call cal_v_eff()
     e. rho_basis_ is needed to provide number of real space grids(nrxx) and number of spin(nspin) and FFT(real<->recip) interface
+    f. recip_mode should be set "true" if the dynamic potential is linear in the total charge density and given by
+       cal_v_eff_g() in G space, then Potential adds V(G) of all such components and does only one FFT for them
+    g. use_rhog should be set "true" if cal_v_eff() reads chg->rhog, which is then updated from chg->rho by Potential
 */
 class PotBase
 {
@@ -34,8 +37,16 @@ class PotBase
         return;
     }
 
+    // rhog_tot is the total charge density in G space, V(G) should be added to vg
+    virtual void cal_v_eff_g(const UnitCell* ucell, const std::complex<double>* rhog_tot, std::complex<double>* vg)
+    {
+        return;
+    }
+
     bool fixed_mode = 0;
     bool dynamic_mode = 0;
+    bool recip_mode = 0;
+    bool use_rhog = 0;
 
   protected:
     const ModulePW::PW_Basis* rho_basis_ = nullptr;
@@ -0,0 +1,376 @@
+#include "pot_hxc.h"
+
+#include "H_Hartree_pw.h"
+#include "module_base/timer.h"
+#include "module_base/tool_title.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace elecstate
+{
+
+PotHXC::PotHXC(const ModulePW::PW_Basis* rho_basis_in,
+               const double& ecut_xc_in,
+               double* etxc_in,
+               double* vtxc_in,
+               ModuleBase::matrix* vofk_in)
+    : vofk(vofk_in), etxc_(etxc_in), vtxc_(vtxc_in), ecut_xc(ecut_xc_in)
+{
+    this->rho_basis_ = rho_basis_in;
+    this->dynamic_mode = true;
+    this->fixed_mode = false;
+    this->use_rhog = true;
+}
+
+PotHXC::~PotHXC()
+{
+    delete this->chg_smooth;
+    delete this->smooth_basis;
+}
+
+void PotHXC::init_smooth(const int nspin)
+{
+    const ModulePW::PW_Basis* dense = this->rho_basis_;
+    if (this->smooth_basis != nullptr && this->lat0 == dense->lat0 && this->latvec == dense->latvec)
+    {
+        return;
+    }
+    ModuleBase::TITLE("PotHXC", "init_smooth");
+    this->lat0 = dense->lat0;
+    this->latvec = dense->latvec;
+
+    // the smooth sphere should be inside the dense one
+    const double ecut = std::min(this->ecut_xc, dense->ggecut * dense->tpiba2);
+    delete this->chg_smooth;
+    delete this->smooth_basis;
+    this->smooth_basis = new ModulePW::PW_Basis();
+    ModulePW::PW_Basis* smooth = this->smooth_basis;
+#ifdef __MPI
+    smooth->initmpi(dense->poolnproc, dense->poolrank, dense->pool_world);
+#endif
+    smooth->initgrids(dense->lat0, dense->latvec, ecut);
+    smooth->initparameters(false, ecut);
+    smooth->setuptransform();
+    smooth->collect_local_pw();
+    GlobalV::ofs_running << " smooth fft grid for xc: " << smooth->nx << " * " << smooth->ny << " * " << smooth->nz
+                         << std::endl;
+
+    this->chg_smooth = new Charge();
+    this->chg_smooth->set_rhopw(smooth);
+    this->chg_smooth->allocate(nspin);
+
+    // ip of the process owning each G of the smooth grid on the dense grid, and the key iz + ixy * nz of that G
+    const int nproc = dense->poolnproc;
+    std::vector<int> owner(smooth->npw), key(smooth->npw);
+    for (int ig = 0; ig < smooth->npw; ++ig)
+    {
+        int ix = static_cast<int>(std::round(smooth->gdirect[ig].x));
+        int iy = static_cast<int>(std::round(smooth->gdirect[ig].y));
+        int iz = static_cast<int>(std::round(smooth->gdirect[ig].z));
+        ix = (ix + dense->nx) % dense->nx;
+        iy = (iy + dense->ny) % dense->ny;
+        iz = (iz + dense->nz) % dense->nz;
+        const int ixy = iy + ix * dense->fftny;
+        owner[ig] = dense->fftixy2ip[ixy];
+        key[ig] = iz + ixy * dense->nz;
+        if (owner[ig] < 0)
+        {
+            // no stick on the dense grid, it is asked to this process and found nowhere
+            owner[ig] = dense->poolrank;
+            key[ig] = -1;
+        }
+    }
+
+    std::vector<int> nsend_g(nproc, 0), dsend_g(nproc, 0), nrecv_g(nproc, 0), drecv_g(nproc, 0);
+    for (int ig = 0; ig < smooth->npw; ++ig)
+    {
+        ++nsend_g[owner[ig]];
+    }
+    for (int ip = 1; ip < nproc; ++ip)
+    {
+        dsend_g[ip] = dsend_g[ip - 1] + nsend_g[ip - 1];
+    }
+    this->ig_smooth.resize(smooth->npw);
+    std::vector<int> key_send(smooth->npw);
+    std::vector<int> pos(dsend_g);
+    for (int ig = 0; ig < smooth->npw; ++ig)
+    {
+        const int i = pos[owner[ig]]++;
+        this->ig_smooth[i] = ig;
+        key_send[i] = key[ig];
+    }
+
+#ifdef __MPI
+    MPI_Alltoall(nsend_g.data(), 1, MPI_INT, nrecv_g.data(), 1, MPI_INT, dense->pool_world);
+#else
+    nrecv_g = nsend_g;
+#endif
+    for (int ip = 1; ip < nproc; ++ip)
+    {
+        drecv_g[ip] = drecv_g[ip - 1] + nrecv_g[ip - 1];
+    }
+    const int nrecv_tot = drecv_g[nproc - 1] + nrecv_g[nproc - 1];
+    std::vector<int> key_recv(nrecv_tot);
+#ifdef __MPI
+    MPI_Alltoallv(key_send.data(),
+                  nsend_g.data(),
+                  dsend_g.data(),
+                  MPI_INT,
+                  key_recv.data(),
+                  nrecv_g.data(),
+                  drecv_g.data(),
+                  MPI_INT,
+                  dense->pool_world);
+#else
+    key_recv = key_send;
+#endif
+
+    std::unordered_map<int, int> key2ig;
+    key2ig.reserve(dense->npw);
+    for (int ig = 0; ig < dense->npw; ++ig)
+    {
+        const int isz = dense->ig2isz[ig];
+        key2ig[isz % dense->nz + dense->is2fftixy[isz / dense->nz] * dense->nz] = ig;
+    }
+    this->ig_dense.resize(nrecv_tot);
+    for (int i = 0; i < nrecv_tot; ++i)
+    {
+        auto it = key2ig.find(key_recv[i]);
+        this->ig_dense[i] = (it == key2ig.end()) ? -1 : it->second;
+    }
+
+    this->nsend.resize(nproc);
+    this->dsend.resize(nproc);
+    this->nrecv.resize(nproc);
+    this->drecv.resize(nproc);
+    for (int ip = 0; ip < nproc; ++ip)
+    {
+        this->nsend[ip] = 2 * nsend_g[ip];
+        this->dsend[ip] = 2 * dsend_g[ip];
+        this->nrecv[ip] = 2 * nrecv_g[ip];
+        this->drecv[ip] = 2 * drecv_g[ip];
+    }
+}
+
+void PotHXC::dense_to_smooth(const std::complex<double>* in, std::complex<double>* out) const
+{
+    std::vector<std::complex<double>> recvbuf(this->ig_dense.size());
+    for (size_t i = 0; i < this->ig_dense.size(); ++i)
+    {
+        recvbuf[i] = (this->ig_dense[i] >= 0) ? in[this->ig_dense[i]] : 0.0;
+    }
+    std::vector<std::complex<double>> sendbuf(this->ig_smooth.size());
+#ifdef __MPI
+    MPI_Alltoallv(recvbuf.data(),
+                  this->nrecv.data(),
+                  this->drecv.data(),
+                  MPI_DOUBLE,
+                  sendbuf.data(),
+                  this->nsend.data(),
+                  this->dsend.data(),
+                  MPI_DOUBLE,
+                  this->rho_basis_->pool_world);
+#else
+    sendbuf = recvbuf;
+#endif
+    for (size_t i = 0; i < this->ig_smooth.size(); ++i)
+    {
+        out[this->ig_smooth[i]] = sendbuf[i];
+    }
+}
+
+void PotHXC::smooth_to_dense(const std::complex<double>* in, std::complex<double>* out) const
+{
+    std::vector<std::complex<double>> sendbuf(this->ig_smooth.size());
+    for (size_t i = 0; i < this->ig_smooth.size(); ++i)
+    {
+        sendbuf[i] = in[this->ig_smooth[i]];
+    }
+    std::vector<std::complex<double>> recvbuf(this->ig_dense.size());
+#ifdef __MPI
+    MPI_Alltoallv(sendbuf.data(),
+                  this->nsend.data(),
+                  this->dsend.data(),
+                  MPI_DOUBLE,
+                  recvbuf.data(),
+                  this->nrecv.data(),
+                  this->drecv.data(),
+                  MPI_DOUBLE,
+                  this->rho_basis_->pool_world);
+#else
+    recvbuf = sendbuf;
+#endif
+    ModuleBase::GlobalFunc::ZEROS(out, this->rho_basis_->npw);
+    for (size_t i = 0; i < this->ig_dense.size(); ++i)
+    {
+        if (this->ig_dense[i] >= 0)
+        {
+            out[this->ig_dense[i]] = recvbuf[i];
+        }
+    }
+}
+
+void PotHXC::cal_v_eff(const Charge* chg, const UnitCell* ucell, ModuleBase::matrix& v_eff)
+{
+    ModuleBase::TITLE("PotHXC", "cal_v_eff");
+    ModuleBase::timer::tick("PotHXC", "cal_v_eff");
+    const int nspin = v_eff.nr;
+    const ModulePW::PW_Basis* dense = this->rho_basis_;
+    if (this->ecut_xc >= dense->ggecut * dense->tpiba2)
+    {
+        // the smooth sphere would be the dense one, the same as PotHartree + PotXC
+        this->cal_v_eff_dense(chg, ucell, v_eff);
+        ModuleBase::timer::tick("PotHXC", "cal_v_eff");
+        return;
+    }
+    this->init_smooth(nspin);
+    const ModulePW::PW_Basis* smooth = this->smooth_basis;
+    const bool is_meta = (XC_Functional::get_func_type() == 3 || XC_Functional::get_func_type() == 5);
+
+    std::vector<std::complex<double>> work_d(dense->nmaxgr);
+    std::vector<std::complex<double>> work_s(smooth->npw);
+    std::vector<std::complex<double>> rhotot_g(dense->npw, 0.0);
+
+    //----------------------------------------------------------
+    // rho, rho_core and tau on the smooth grid, and the total
+    // rho in G space for Hartree
+    // chg->rhog of spin channels is given by Potential
+    //----------------------------------------------------------
+    for (int is = 0; is < nspin; ++is)
+    {
+        const std::complex<double>* rhog = work_d.data();
+        if (is == 0 || nspin == 2)
+        {
+            rhog = chg->rhog[is];
+            for (int ig = 0; ig < dense->npw; ++ig)
+            {
+                rhotot_g[ig] += rhog[ig];
+            }
+        }
+        else
+        {
+            dense->real2recip(chg->rho[is], work_d.data());
+        }
+        this->dense_to_smooth(rhog, work_s.data());
+        smooth->recip2real(work_s.data(), this->chg_smooth->rho[is]);
+        if (is_meta)
+        {
+            dense->real2recip(chg->kin_r[is], work_d.data());
+            this->dense_to_smooth(work_d.data(), work_s.data());
+            smooth->recip2real(work_s.data(), this->chg_smooth->kin_r[is]);
+        }
+    }
+    this->dense_to_smooth(chg->rhog_core, work_s.data());
+    smooth->recip2real(work_s.data(), this->chg_smooth->rho_core);
+
+    //----------------------------------------------------------
+    // Hartree potential in G space on the dense grid
+    //----------------------------------------------------------
+    std::vector<std::complex<double>> vh_g(dense->npw, 0.0);
+    H_Hartree_pw::v_hartree_g(*ucell, dense, rhotot_g.data(), vh_g.data());
+
+    //----------------------------------------------------------
+    // xc potential on the smooth grid
+    //----------------------------------------------------------
+    ModuleBase::matrix v_xc;
+    ModuleBase::matrix vofk_xc;
+    if (is_meta)
+    {
+#ifdef USE_LIBXC
+        const std::tuple<double, double, ModuleBase::matrix, ModuleBase::matrix> etxc_vtxc_v
+            = XC_Functional::v_xc_meta(smooth->nrxx, ucell->omega, ucell->tpiba, this->chg_smooth);
+        *(this->etxc_) = std::get<0>(etxc_vtxc_v);
+        *(this->vtxc_) = std::get<1>(etxc_vtxc_v);
+        v_xc = std::get<2>(etxc_vtxc_v);
+        vofk_xc = std::get<3>(etxc_vtxc_v);
+#else
+        ModuleBase::WARNING_QUIT("v_of_rho", "to use mGGA, compile with LIBXC");
+#endif
+    }
+    else
+    {
+        const std::tuple<double, double, ModuleBase::matrix> etxc_vtxc_v
+            = XC_Functional::v_xc(smooth->nrxx, this->chg_smooth, ucell);
+        *(this->etxc_) = std::get<0>(etxc_vtxc_v);
+        *(this->vtxc_) = std::get<1>(etxc_vtxc_v);
+        v_xc = std::get<2>(etxc_vtxc_v);
+    }
+
+    //----------------------------------------------------------
+    // V_xc + V_H back to the dense grid, one inverse FFT per spin
+    //----------------------------------------------------------
+    for (int is = 0; is < nspin; ++is)
+    {
+        smooth->real2recip(v_xc.c + is * v_xc.nc, work_s.data());
+        this->smooth_to_dense(work_s.data(), work_d.data());
+        if (is == 0 || nspin == 2)
+        {
+            for (int ig = 0; ig < dense->npw; ++ig)
+            {
+                work_d[ig] += vh_g[ig];
+            }
+        }
+        dense->recip2real(work_d.data(), v_eff.c + is * v_eff.nc, true);
+    }
+    if (is_meta)
+    {
+        for (int is = 0; is < nspin; ++is)
+        {
+            smooth->real2recip(vofk_xc.c + is * vofk_xc.nc, work_s.data());
+            this->smooth_to_dense(work_s.data(), work_d.data());
+            dense->recip2real(work_d.data(), this->vofk->c + is * this->vofk->nc);
+        }
+    }
+    ModuleBase::timer::tick("PotHXC", "cal_v_eff");
+}
+
+void PotHXC::cal_v_eff_dense(const Charge* chg, const UnitCell* ucell, ModuleBase::matrix& v_eff)
+{
+    const int nspin = v_eff.nr;
+    const ModulePW::PW_Basis* dense = this->rho_basis_;
+    if (XC_Functional::get_func_type() == 3 || XC_Functional::get_func_type() == 5)
+    {
+#ifdef USE_LIBXC
+        const std::tuple<double, double, ModuleBase::matrix, ModuleBase::matrix> etxc_vtxc_v
+            = XC_Functional::v_xc_meta(dense->nrxx, ucell->omega, ucell->tpiba, chg);
+        *(this->etxc_) = std::get<0>(etxc_vtxc_v);
+        *(this->vtxc_) = std::get<1>(etxc_vtxc_v);
+        v_eff += std::get<2>(etxc_vtxc_v);
+        *(this->vofk) = std::get<3>(etxc_vtxc_v);
+#else
+        ModuleBase::WARNING_QUIT("v_of_rho", "to use mGGA, compile with LIBXC");
+#endif
+    }
+    else
+    {
+        const std::tuple<double, double, ModuleBase::matrix> etxc_vtxc_v
+            = XC_Functional::v_xc(dense->nrxx, chg, ucell, true);
+        *(this->etxc_) = std::get<0>(etxc_vtxc_v);
+        *(this->vtxc_) = std::get<1>(etxc_vtxc_v);
+        v_eff += std::get<2>(etxc_vtxc_v);
+    }
+
+    std::vector<std::complex<double>> rhotot_g(dense->npw, 0.0);
+    for (int is = 0; is < (nspin == 2 ? 2 : 1); ++is)
+    {
+        for (int ig = 0; ig < dense->npw; ++ig)
+        {
+            rhotot_g[ig] += chg->rhog[is][ig];
+        }
+    }
+    std::vector<std::complex<double>> vh_g(dense->nmaxgr, 0.0);
+    H_Hartree_pw::v_hartree_g(*ucell, dense, rhotot_g.data(), vh_g.data());
+    std::vector<double> vh_r(dense->nrxx);
+    dense->recip2real(vh_g.data(), vh_r.data());
+    for (int is = 0; is < (nspin == 4 ? 1 : nspin); ++is)
+    {
+        for (int ir = 0; ir < dense->nrxx; ++ir)
+        {
+            v_eff(is, ir) += vh_r[ir];
+        }
+    }
+}
+
+} // namespace elecstate
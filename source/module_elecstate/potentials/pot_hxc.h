@@ -0,0 +1,62 @@
+#ifndef POTHXC_H
+#define POTHXC_H
+
+#include "module_hamilt_general/module_xc/xc_functional.h"
+#include "pot_base.h"
+
+#include <vector>
+
+namespace elecstate
+{
+/**
+ * PotHXC gives the Hartree and exchange-correlation potentials by the double-grid technique.
+ * 1. rho in G space on the dense grid of rho_basis is taken from Potential, where the Hartree potential is calculated;
+ * 2. the plane waves of rho inside the sphere of ecut_xc are moved to a smooth grid, where xc is evaluated;
+ * 3. V_xc(G) of the smooth grid is added to V_H(G) of the dense grid, and one inverse FFT per spin gives both.
+ * The smooth grid is set up with the same MPI distribution of rho_basis and rebuilt if the cell changes.
+ * If ecut_xc is not smaller than the cutoff of rho_basis, xc is evaluated on the dense grid as PotXC does.
+ * It replaces PotHartree and PotXC in Potential::pot_register() if ecut_xc > 0.
+ */
+class PotHXC : public PotBase
+{
+  public:
+    PotHXC(const ModulePW::PW_Basis* rho_basis_in,
+           const double& ecut_xc_in,
+           double* etxc_in,
+           double* vtxc_in,
+           ModuleBase::matrix* vofk_in = nullptr);
+    ~PotHXC();
+
+    void cal_v_eff(const Charge* chg, const UnitCell* ucell, ModuleBase::matrix& v_eff) override;
+
+    ModuleBase::matrix* vofk = nullptr;
+    double* etxc_ = nullptr;
+    double* vtxc_ = nullptr;
+
+  private:
+    double ecut_xc = 0.0; // unit in Ry
+
+    ModulePW::PW_Basis* smooth_basis = nullptr;
+    Charge* chg_smooth = nullptr; // rho, rho_core and kin_r on the smooth grid
+    double lat0 = 0.0;            // the cell for which the smooth grid is set up
+    ModuleBase::Matrix3 latvec;
+
+    // The plane waves of the smooth grid are sent to the processes owning the same G of the dense grid.
+    std::vector<int> ig_smooth; // smooth ig in the order of sending
+    std::vector<int> ig_dense;  // dense ig of the received G in the order of receiving, -1 if outside the dense sphere
+    // counts and displacements of MPI_Alltoallv in units of double
+    std::vector<int> nsend, dsend, nrecv, drecv;
+
+    // xc on the dense grid if the smooth sphere is not smaller than the dense one
+    void cal_v_eff_dense(const Charge* chg, const UnitCell* ucell, ModuleBase::matrix& v_eff);
+
+    void init_smooth(const int nspin);
+    // out[ig_s] = in[G of ig_s]
+    void dense_to_smooth(const std::complex<double>* in, std::complex<double>* out) const;
+    // out[ig_d] = in[G of ig_d] inside the smooth sphere, 0 outside
+    void smooth_to_dense(const std::complex<double>* in, std::complex<double>* out) const;
+};
+
+} // namespace elecstate
+
+#endif
@@ -22,6 +22,7 @@ class PotSurChem : public PotBase
         this->structure_factors_ = structure_factors_in;
         this->dynamic_mode = true;
         this->fixed_mode = false;
+        this->use_rhog = true;
     }
     ~PotSurChem()
     {
@@ -39,12 +40,24 @@ class PotSurChem : public PotBase
             this->allocated = true;
         }
 
+        // total charge density in G space from chg->rhog given by Potential
+        const int npw = this->rho_basis_->npw;
+        std::vector<std::complex<double>> rhog_tot(chg->rhog[0], chg->rhog[0] + npw);
+        if (v_eff.nr == 2)
+        {
+            for (int ig = 0; ig < npw; ig++)
+            {
+                rhog_tot[ig] += chg->rhog[1][ig];
+            }
+        }
+
         v_eff += this->surchem_->v_correction(*ucell,
                                               const_cast<ModulePW::PW_Basis*>(this->rho_basis_),
                                               v_eff.nr,
                                               chg->rho,
                                               this->vlocal,
-                                              this->structure_factors_);
+                                              this->structure_factors_,
+                                              rhog_tot.data());
     }
 
   private:
@@ -32,7 +32,7 @@ void PotXC::cal_v_eff(const Charge* chg, const UnitCell* ucell, ModuleBase::matr
     else
     {
         const std::tuple<double, double, ModuleBase::matrix> etxc_vtxc_v
-            = XC_Functional::v_xc(nrxx_current, chg, ucell);
+            = XC_Functional::v_xc(nrxx_current, chg, ucell, true);
         *(this->etxc_) = std::get<0>(etxc_vtxc_v);
         *(this->vtxc_) = std::get<1>(etxc_vtxc_v);
         v_eff += std::get<2>(etxc_vtxc_v);
@@ -21,6 +21,8 @@ class PotXC : public PotBase
         this->rho_basis_ = rho_basis_in;
         this->dynamic_mode = true;
         this->fixed_mode = false;
+        // chg->rhog is used in the gradient correction of GGA
+        this->use_rhog = true;
     }
 
     void cal_v_eff(const Charge* chg, const UnitCell* ucell, ModuleBase::matrix& v_eff) override;
@@ -9,6 +9,7 @@
 
 #include "module_elecstate/elecstate_getters.h"
 
+#include <algorithm>
 #include <map>
 
 namespace elecstate
@@ -40,17 +41,17 @@ Potential::~Potential()
         this->components.clear();
     }
     if (GlobalV::device_flag == "gpu") {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             delmem_sd_op()(gpu_ctx, s_v_effective);
             delmem_sd_op()(gpu_ctx, s_vofk_effective);
         }
-        else {
+        if (GlobalV::precision_flag != "single") {
             delmem_dd_op()(gpu_ctx, d_v_effective);
             delmem_dd_op()(gpu_ctx, d_vofk_effective);
         }
     }
     else {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             delmem_sh_op()(cpu_ctx, s_v_effective);
             delmem_sh_op()(cpu_ctx, s_vofk_effective);
         }
@@ -70,13 +71,22 @@ void Potential::pot_register(std::vector<std::string>& components_list)
         this->components.clear();
     }
 
+    // with a smooth grid for xc, Hartree and xc are evaluated together by PotHXC
+    const bool use_hxc = GlobalV::ECUT_XC > 0.0
+                         && std::find(components_list.begin(), components_list.end(), "hartree") != components_list.end()
+                         && std::find(components_list.begin(), components_list.end(), "xc") != components_list.end();
+
     // register components
     //---------------------------
     // mapping for register
     //---------------------------
     for (auto comp: components_list)
     {
-        PotBase* tmp = this->get_pot_type(comp);
+        if (use_hxc && comp == "hartree")
+        {
+            continue;
+        }
+        PotBase* tmp = this->get_pot_type((use_hxc && comp == "xc") ? "hxc" : comp);
         this->components.push_back(tmp);
         //        GlobalV::ofs_running << "Successful completion of Potential's registration : " << comp << std::endl;
     }
@@ -106,21 +116,21 @@ void Potential::allocate()
         ModuleBase::Memory::record("Pot::vofk", sizeof(double) * GlobalV::NSPIN * nrxx);
     }
     if (GlobalV::device_flag == "gpu") {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             resmem_sd_op()(gpu_ctx, s_v_effective, GlobalV::NSPIN * nrxx);
             resmem_sd_op()(gpu_ctx, s_vofk_effective, GlobalV::NSPIN * nrxx);
         }
-        else {
+        if (GlobalV::precision_flag != "single") {
             resmem_dd_op()(gpu_ctx, d_v_effective, GlobalV::NSPIN * nrxx);
             resmem_dd_op()(gpu_ctx, d_vofk_effective, GlobalV::NSPIN * nrxx);
         }
     }
     else {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             resmem_sh_op()(cpu_ctx, s_v_effective, GlobalV::NSPIN * nrxx, "POT::sveff");
             resmem_sh_op()(cpu_ctx, s_vofk_effective, GlobalV::NSPIN * nrxx, "POT::svofk");
         }
-        else {
+        if (GlobalV::precision_flag != "single") {
             this->d_v_effective = this->v_effective.c;
             this->d_vofk_effective = this->vofk_effective.c;
         }
@@ -141,17 +151,17 @@ void Potential::update_from_charge(const Charge* chg, const UnitCell* ucell)
     this->cal_v_eff(chg, ucell, this->v_effective);
 
     if (GlobalV::device_flag == "gpu") {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             castmem_d2s_h2d_op()(gpu_ctx, cpu_ctx, s_v_effective, this->v_effective.c, this->v_effective.nr * this->v_effective.nc);
             castmem_d2s_h2d_op()(gpu_ctx, cpu_ctx, s_vofk_effective, this->vofk_effective.c, this->vofk_effective.nr * this->vofk_effective.nc);
         }
-        else {
+        if (GlobalV::precision_flag != "single") {
             syncmem_d2d_h2d_op()(gpu_ctx, cpu_ctx, d_v_effective, this->v_effective.c, this->v_effective.nr * this->v_effective.nc);
             syncmem_d2d_h2d_op()(gpu_ctx, cpu_ctx, d_vofk_effective, this->vofk_effective.c, this->vofk_effective.nr * this->vofk_effective.nc);
         }
     }
     else {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, s_v_effective, this->v_effective.c, this->v_effective.nr * this->v_effective.nc);
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, s_vofk_effective, this->vofk_effective.c, this->vofk_effective.nr * this->vofk_effective.nc);
         }
@@ -180,27 +190,79 @@ void Potential::cal_fixed_v(double* vl_pseudo)
 void Potential::cal_v_eff(const Charge* chg, const UnitCell* ucell, ModuleBase::matrix& v_eff)
 {
     ModuleBase::TITLE("Potential", "cal_v_eff");
-    int nspin_current = this->v_effective.nr;
-    int nrxx = this->v_effective.nc;
+    const int nspin_current = v_eff.nr;
+    const int nrxx = v_eff.nc;
     ModuleBase::timer::tick("Potential", "cal_v_eff");
-    // first of all, set v_effective to zero.
-    this->v_effective.zero_out();
 
-    // add fixed potential components
-    // nspin = 2, add fixed components for all
-    // nspin = 4, add fixed components on first colomn
-    for (int i = 0; i < nspin_current; i++)
+    bool recip = false;
+    bool need_rhog = false;
+    for (size_t i = 0; i < this->components.size(); i++)
+    {
+        if (this->components[i]->dynamic_mode)
+        {
+            recip = recip || this->components[i]->recip_mode;
+            need_rhog = need_rhog || this->components[i]->recip_mode || this->components[i]->use_rhog;
+        }
+    }
+
+    // one FFT of rho for every spin channel, shared by all components
+    // nspin = 4, only the total charge density is needed
+    const int nspin0 = (nspin_current == 2) ? 2 : 1;
+    if (need_rhog)
     {
-        if (i == 0 || nspin_current == 2)
+        for (int is = 0; is < nspin0; is++)
         {
-            ModuleBase::GlobalFunc::COPYARRAY(this->v_effective_fixed.data(), this->get_effective_v(i), nrxx);
+            this->rho_basis_->real2recip(chg->rho[is], chg->rhog[is]);
         }
     }
 
-    // cal effective by every components
+    // potentials linear in the total charge density are added in G space,
+    // and brought to real space by one FFT
+    std::vector<double> v_recip;
+    if (recip)
+    {
+        const int npw = this->rho_basis_->npw;
+        std::vector<std::complex<double>> rhog_tot(chg->rhog[0], chg->rhog[0] + npw);
+        for (int is = 1; is < nspin0; is++)
+        {
+            for (int ig = 0; ig < npw; ig++)
+            {
+                rhog_tot[ig] += chg->rhog[is][ig];
+            }
+        }
+        std::vector<std::complex<double>> vg(npw, 0.0);
+        for (size_t i = 0; i < this->components.size(); i++)
+        {
+            if (this->components[i]->dynamic_mode && this->components[i]->recip_mode)
+            {
+                this->components[i]->cal_v_eff_g(ucell, rhog_tot.data(), vg.data());
+            }
+        }
+        v_recip.resize(nrxx);
+        this->rho_basis_->recip2real(vg.data(), v_recip.data());
+    }
+
+    // fixed potential and the potentials from G space in one pass
+    // nspin = 2, add them for all
+    // nspin = 4, add them on first colomn
+    const double* v_fixed = this->v_effective_fixed.data();
+    const double* v_g = recip ? v_recip.data() : nullptr;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1024)
+#endif
+    for (int ir = 0; ir < nrxx; ir++)
+    {
+        const double v = (v_g == nullptr) ? v_fixed[ir] : v_fixed[ir] + v_g[ir];
+        for (int is = 0; is < nspin_current; is++)
+        {
+            v_eff(is, ir) = (is == 0 || nspin_current == 2) ? v : 0.0;
+        }
+    }
+
+    // the other dynamic components in real space
     for (size_t i = 0; i < this->components.size(); i++)
     {
-        if (this->components[i]->dynamic_mode)
+        if (this->components[i]->dynamic_mode && !this->components[i]->recip_mode)
         {
             this->components[i]->cal_v_eff(chg, ucell, v_eff);
         }
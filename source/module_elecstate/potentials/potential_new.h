@@ -27,9 +27,13 @@ namespace elecstate
  *     e. "surchem", PotSurChem introduces surface chemistry part of potentials;
  *     f. "efield", PotEfield introduces electronic field including dipole correction part of potentials;
  *     g. "gatefield", PotGate introduces gate field part of potentials;
+ *     h. "hxc", PotHXC replaces "hartree" and "xc" if GlobalV::ECUT_XC > 0, with xc evaluated on a smooth grid;
  * 4. Func update_from_charge()
  *     a. regenerate v_effective
  *     b. if Meta-GGA is choosed, it will regenerate vofk_effective
+ *     c. rho is brought to G space once in chg->rhog, shared by components with recip_mode or use_rhog;
+ *        V(G) of components with recip_mode (e.g. "hartree") are summed and brought to real space by one FFT,
+ *        and added with the fixed potential in one pass, then the other components add to v_effective
  * 5. Func update_for_tddft()
  *     a. in principle, it should be added to components, but it related to real time(istep)
  *     b. it should be called after update_from_charge() as a compensation;
@@ -9,6 +9,7 @@
 #include "module_base/tool_title.h"
 #include "pot_local.h"
 #include "pot_surchem.hpp"
+#include "pot_hxc.h"
 #include "pot_xc.h"
 #include "potential_new.h"
 #ifdef __LCAO
@@ -33,6 +34,10 @@ PotBase* Potential::get_pot_type(const std::string& pot_type)
     {
         return new PotXC(this->rho_basis_, this->etxc_, this->vtxc_, &(this->vofk_effective));
     }
+    else if (pot_type == "hxc")
+    {
+        return new PotHXC(this->rho_basis_, GlobalV::ECUT_XC, this->etxc_, this->vtxc_, &(this->vofk_effective));
+    }
     else if (pot_type == "surchem")
     {
         return new PotSurChem(this->rho_basis_,
@@ -1,5 +1,6 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "module_base/parallel_reduce.h"
 #include "module_hamilt_general/module_xc/xc_functional.h"
 #define private public
 #include "../module_charge/charge_mixing.h"
@@ -8,6 +9,8 @@
 Magnetism::~Magnetism(){}
 Magnetism::Magnetism(){}
 int XC_Functional::get_func_type(){return 1;}
+Charge::Charge(){}
+Charge::~Charge(){}
 #ifdef __LCAO
 InfoNonlocal::InfoNonlocal(){}
 InfoNonlocal::~InfoNonlocal(){}
@@ -23,13 +26,137 @@ namespace GlobalC{
 
 /**
  * - Tested Functions:
- *   - SetMixingTest: Charge_Mixing::set_mixing(mixing_mode_in,mixing_beta_in,mixing_ndim_in,mixing_gg0_in,mixing_tau_in)
+ *   - SetMixingTest: Charge_Mixing::set_mixing(mixing_mode_in,mixing_beta_in,mixing_ndim_in,mixing_gg0_in,mixing_tau_in,mixing_lowg_in)
  *      - set the basic parameters of class charge_mixing
+ *   - LowGHistoryTest: Charge_Mixing::allocate_Broyden(), gather_lowg(), scatter_lowg(), reset()
+ *      - only G vectors inside the sphere of mixing_lowg are kept in the Broyden history
+ *      - the sphere is rebuilt after reset() for a new cell
+ *   - BroydenWeightTest: Charge_Mixing::set_broyden_weight()
+ *      - the diagonal metric in the basis of gather_lowg gives rhog_dot_product for nspin = 1, 2 and 4
+ *   - BroydenAllGTest: Charge_Mixing::Simplified_Broyden_mixing()
+ *      - with mixing_lowg = 0, the densities of a model SCF are those of the Broyden update
+ *        with rhog_dot_product on all G vectors, also after the history wraps around
  */
 
 class ChargeMixingTest : public ::testing::Test
 {
-    
+  protected:
+    ModulePW::PW_Basis pw;
+    void init_pw()
+    {
+#ifdef __MPI
+        pw.initmpi(1, 0, MPI_COMM_WORLD);
+#endif
+        ModuleBase::Matrix3 latvec(1, 0, 0, 0, 1, 0, 0, 0, 1);
+        pw.initgrids(10.0, latvec, 20.0);
+        pw.initparameters(false, 20.0);
+        pw.setuptransform();
+        pw.collect_local_pw();
+        GlobalC::ucell.tpiba = ModuleBase::TWO_PI / 10.0;
+        GlobalC::ucell.tpiba2 = GlobalC::ucell.tpiba * GlobalC::ucell.tpiba;
+        GlobalC::ucell.omega = 1000.0;
+    }
+    // smooth pseudo-random rhog of spin is, the same on any number of processes
+    std::complex<double> model_rhog(const int is, const int ig, const double phase) const
+    {
+        const ModuleBase::Vector3<double> g = pw.gcar[ig];
+        return std::complex<double>(cos(g.x + 2 * g.y + 3 * g.z + phase + is), sin(3 * g.x - g.y + phase * is))
+               / (1.0 + pw.gg[ig]);
+    }
+};
+
+// the simplified Broyden mixing with rhog_dot_product on all G vectors, the reference of BroydenAllGTest
+class RefBroyden
+{
+  public:
+    RefBroyden(const Charge_Mixing& mix_in, const int npw_in) : mix(mix_in), npw(npw_in)
+    {
+        const int nspin = GlobalV::NSPIN;
+        dF.assign(mix.mixing_ndim, std::vector<std::complex<double>>(nspin * npw));
+        dn.assign(mix.mixing_ndim, std::vector<std::complex<double>>(nspin * npw));
+    }
+    double dot(const std::vector<std::complex<double>>& a, const std::vector<std::complex<double>>& b) const
+    {
+        std::vector<const std::complex<double>*> pa(GlobalV::NSPIN), pb(GlobalV::NSPIN);
+        for (int is = 0; is < GlobalV::NSPIN; ++is)
+        {
+            pa[is] = a.data() + is * npw;
+            pb[is] = b.data() + is * npw;
+        }
+        return mix.rhog_dot_product(pa.data(), pb.data());
+    }
+    // F is the residual and n the input density, n is replaced by the next input density
+    void mix_rhog(const int iter, const std::vector<std::complex<double>>& F_in, std::vector<std::complex<double>>& n)
+    {
+        const int ndim = mix.mixing_ndim;
+        const int iter_used = std::min(iter - 1, ndim);
+        std::vector<std::complex<double>> F(F_in);
+        const std::vector<std::complex<double>> n_in(n);
+        if (iter > 1)
+        {
+            const int ipos = (iter - 2) % ndim;
+            for (size_t i = 0; i < F.size(); ++i)
+            {
+                dF[ipos][i] -= F_in[i];
+                dn[ipos][i] -= n_in[i];
+            }
+        }
+        if (iter_used > 0)
+        {
+            // solve <dF_i|dF_j> gamma_j = <dF_i|F> by Gaussian elimination
+            std::vector<std::vector<double>> a(iter_used, std::vector<double>(iter_used + 1));
+            for (int i = 0; i < iter_used; ++i)
+            {
+                for (int j = 0; j < iter_used; ++j)
+                {
+                    a[i][j] = this->dot(dF[i], dF[j]);
+                }
+                a[i][iter_used] = this->dot(dF[i], F_in);
+            }
+            for (int k = 0; k < iter_used; ++k)
+            {
+                for (int i = k + 1; i < iter_used; ++i)
+                {
+                    const double r = a[i][k] / a[k][k];
+                    for (int j = k; j <= iter_used; ++j)
+                    {
+                        a[i][j] -= r * a[k][j];
+                    }
+                }
+            }
+            std::vector<double> gamma(iter_used);
+            for (int i = iter_used - 1; i >= 0; --i)
+            {
+                double sum = a[i][iter_used];
+                for (int j = i + 1; j < iter_used; ++j)
+                {
+                    sum -= a[i][j] * gamma[j];
+                }
+                gamma[i] = sum / a[i][i];
+            }
+            for (int i = 0; i < iter_used; ++i)
+            {
+                for (size_t ig = 0; ig < F.size(); ++ig)
+                {
+                    F[ig] -= gamma[i] * dF[i][ig];
+                    n[ig] -= gamma[i] * dn[i][ig];
+                }
+            }
+        }
+        const int inext = (iter - 1) % ndim;
+        dF[inext] = F_in;
+        dn[inext] = n_in;
+        for (size_t ig = 0; ig < F.size(); ++ig)
+        {
+            n[ig] += mix.mixing_beta * F[ig];
+        }
+    }
+
+  private:
+    const Charge_Mixing& mix;
+    const int npw;
+    std::vector<std::vector<std::complex<double>>> dF;
+    std::vector<std::vector<std::complex<double>>> dn;
 };
 
 TEST_F(ChargeMixingTest,SetMixingTest)
@@ -40,12 +167,237 @@ TEST_F(ChargeMixingTest,SetMixingTest)
     int dim=1;
 	double gg0=1;
 	bool tau= true;
-    CMtest.set_mixing(mode,beta,dim,gg0,tau);
+	double lowg = 2.0;
+    CMtest.set_mixing(mode,beta,dim,gg0,tau,lowg);
     EXPECT_EQ(CMtest.mixing_mode, "1");
     EXPECT_EQ(CMtest.mixing_beta, 1.0);
     EXPECT_EQ(CMtest.mixing_ndim, 1);
     EXPECT_EQ(CMtest.mixing_gg0, 1);
     EXPECT_EQ(CMtest.mixing_tau, true);
+    EXPECT_EQ(CMtest.mixing_lowg, 2.0);
+}
+
+TEST_F(ChargeMixingTest,LowGHistoryTest)
+{
+    ModulePW::PW_Basis pw;
+#ifdef __MPI
+    pw.initmpi(1, 0, MPI_COMM_WORLD);
+#endif
+    ModuleBase::Matrix3 latvec(1, 0, 0, 0, 1, 0, 0, 0, 1);
+    pw.initgrids(10.0, latvec, 40.0);
+    pw.initparameters(false, 40.0);
+    pw.setuptransform();
+    pw.collect_local_pw();
+    GlobalC::ucell.tpiba = ModuleBase::TWO_PI / 10.0;
+    GlobalC::ucell.tpiba2 = GlobalC::ucell.tpiba * GlobalC::ucell.tpiba;
+    GlobalV::NSPIN = 2;
+
+    Charge_Mixing CMtest;
+    CMtest.set_rhopw(&pw);
+    CMtest.set_mixing("broyden", 0.4, 4, 0.0, false, 4.0);
+    CMtest.allocate_Broyden();
+    const double gg_lowg = std::pow(4.0 * 0.529177 / GlobalC::ucell.tpiba, 2);
+    EXPECT_GT(CMtest.ig_lowg.size(), 0);
+    EXPECT_LT(CMtest.ig_lowg.size(), pw.npw);
+    for (int ig: CMtest.ig_lowg)
+    {
+        EXPECT_LE(pw.gg[ig], gg_lowg);
+    }
+    EXPECT_EQ(CMtest.nbroyden, 2 * GlobalV::NSPIN * CMtest.ig_lowg.size());
+    EXPECT_EQ(CMtest.dF.size(), 5 * CMtest.nbroyden);
+
+    // gather and scatter are inverse of each other
+    std::vector<std::complex<double>> rhog0(pw.npw), rhog1(pw.npw);
+    for (int ig = 0; ig < pw.npw; ++ig)
+    {
+        rhog0[ig] = std::complex<double>(ig, 0.5 * ig);
+        rhog1[ig] = std::complex<double>(-0.3 * ig, 1.0);
+    }
+    std::complex<double>* rhog[2] = {rhog0.data(), rhog1.data()};
+    std::vector<double> vec(CMtest.nbroyden);
+    CMtest.gather_lowg(rhog, vec.data());
+    std::vector<std::complex<double>> out0(pw.npw, 0.0), out1(pw.npw, 0.0);
+    std::complex<double>* out[2] = {out0.data(), out1.data()};
+    CMtest.scatter_lowg(vec.data(), out);
+    for (int ig: CMtest.ig_lowg)
+    {
+        EXPECT_NEAR(std::abs(out0[ig] - rhog0[ig]), 0.0, 1e-12);
+        EXPECT_NEAR(std::abs(out1[ig] - rhog1[ig]), 0.0, 1e-12);
+    }
+
+    // the sphere is rebuilt for the new cell of the next ionic step
+    const int nlow = CMtest.ig_lowg.size();
+    GlobalC::ucell.tpiba = ModuleBase::TWO_PI / 12.0;
+    CMtest.reset();
+    EXPECT_FALSE(CMtest.initb);
+    CMtest.allocate_Broyden();
+    EXPECT_GT(CMtest.ig_lowg.size(), nlow);
+    GlobalC::ucell.tpiba = ModuleBase::TWO_PI / 10.0;
+
+    // too few G vectors inside the sphere, all of them are kept
+    Charge_Mixing CMsmall;
+    CMsmall.set_rhopw(&pw);
+    CMsmall.set_mixing("broyden", 0.4, 4, 0.0, false, 0.5);
+    CMsmall.allocate_Broyden();
+    EXPECT_EQ(CMsmall.ig_lowg.size(), pw.npw);
+    GlobalV::NSPIN = 1;
+}
+
+TEST_F(ChargeMixingTest,BroydenWeightTest)
+{
+    this->init_pw();
+    const int nspin_list[4] = {1, 2, 4, 4};
+    const bool domag_list[4] = {false, false, false, true};
+    for (int icase = 0; icase < 4; ++icase)
+    {
+        GlobalV::NSPIN = nspin_list[icase];
+        GlobalV::DOMAG = domag_list[icase];
+        Charge_Mixing CMtest;
+        CMtest.set_rhopw(&pw);
+        CMtest.set_mixing("broyden", 0.4, 4, 0.0, false, 0.0);
+        CMtest.allocate_Broyden();
+        CMtest.set_broyden_weight();
+
+        std::vector<std::vector<std::complex<double>>> rhog1(GlobalV::NSPIN), rhog2(GlobalV::NSPIN);
+        std::vector<std::complex<double>*> p1(GlobalV::NSPIN), p2(GlobalV::NSPIN);
+        for (int is = 0; is < GlobalV::NSPIN; ++is)
+        {
+            rhog1[is].resize(pw.npw);
+            rhog2[is].resize(pw.npw);
+            for (int ig = 0; ig < pw.npw; ++ig)
+            {
+                rhog1[is][ig] = this->model_rhog(is, ig, 0.3);
+                rhog2[is][ig] = this->model_rhog(is, ig, 1.7);
+            }
+            p1[is] = rhog1[is].data();
+            p2[is] = rhog2[is].data();
+        }
+        std::vector<double> v1(CMtest.nbroyden), v2(CMtest.nbroyden);
+        CMtest.gather_lowg(p1.data(), v1.data());
+        CMtest.gather_lowg(p2.data(), v2.data());
+        double sum = 0.0;
+        for (int i = 0; i < CMtest.nbroyden; ++i)
+        {
+            sum += CMtest.broyden_weight[i] * v1[i] * v2[i];
+        }
+        Parallel_Reduce::reduce_double_pool(sum);
+        const double ref = CMtest.rhog_dot_product(p1.data(), p2.data());
+        EXPECT_NEAR(sum, ref, 1e-12 * std::abs(ref)) << "nspin = " << GlobalV::NSPIN;
+    }
+    GlobalV::NSPIN = 1;
+    GlobalV::DOMAG = false;
+}
+
+TEST_F(ChargeMixingTest,BroydenAllGTest)
+{
+    this->init_pw();
+    const int nspin_list[3] = {1, 2, 4};
+    for (int icase = 0; icase < 3; ++icase)
+    {
+        GlobalV::NSPIN = nspin_list[icase];
+        GlobalV::DOMAG = (GlobalV::NSPIN == 4);
+        const int nspin = GlobalV::NSPIN;
+        Charge_Mixing CMtest;
+        CMtest.set_rhopw(&pw);
+        CMtest.set_mixing("broyden", 0.4, 3, 0.0, false, 0.0);
+        RefBroyden ref(CMtest, pw.npw);
+
+        Charge chr;
+        chr.rhog = new std::complex<double>*[nspin];
+        chr.rhog_save = new std::complex<double>*[nspin];
+        chr.rho = new double*[nspin];
+        for (int is = 0; is < nspin; ++is)
+        {
+            chr.rhog[is] = new std::complex<double>[pw.npw];
+            chr.rhog_save[is] = new std::complex<double>[pw.npw];
+            chr.rho[is] = new double[pw.nrxx];
+        }
+
+        // model SCF: rho_out(G) = rho_in(G) / (1 + 2 / (1 + |G|^2)) + 0.5 rho_in(G)^2 + b(G),
+        // which is nonlinear so that the history does not become singular within a few steps
+        auto residual = [&](const std::vector<std::complex<double>>& n, std::vector<std::complex<double>>& F) {
+            for (int is = 0; is < nspin; ++is)
+            {
+                for (int ig = 0; ig < pw.npw; ++ig)
+                {
+                    const double a = 1.0 / (1.0 + 2.0 / (1.0 + pw.gg[ig]));
+                    const std::complex<double> nG = n[is * pw.npw + ig];
+                    F[is * pw.npw + ig] = (a - 1.0) * nG + 0.5 * nG * nG + this->model_rhog(is, ig, 0.9);
+                }
+            }
+        };
+        std::vector<std::complex<double>> n_ref(nspin * pw.npw), F(nspin * pw.npw);
+        for (int is = 0; is < nspin; ++is)
+        {
+            for (int ig = 0; ig < pw.npw; ++ig)
+            {
+                n_ref[is * pw.npw + ig] = this->model_rhog(is, ig, 0.1);
+                chr.rhog_save[is][ig] = n_ref[is * pw.npw + ig];
+            }
+        }
+        // 3 steps more than mixing_ndim, the ring buffer of the history wraps around
+        for (int iter = 1; iter <= 6; ++iter)
+        {
+            std::vector<std::complex<double>> n(nspin * pw.npw);
+            for (int is = 0; is < nspin; ++is)
+            {
+                for (int ig = 0; ig < pw.npw; ++ig)
+                {
+                    n[is * pw.npw + ig] = chr.rhog_save[is][ig];
+                }
+            }
+            residual(n, F);
+            for (int is = 0; is < nspin; ++is)
+            {
+                for (int ig = 0; ig < pw.npw; ++ig)
+                {
+                    chr.rhog[is][ig] = F[is * pw.npw + ig];
+                }
+            }
+            CMtest.Simplified_Broyden_mixing(iter, &chr);
+
+            residual(n_ref, F);
+            ref.mix_rhog(iter, F, n_ref);
+            double maxerr = 0.0;
+            for (int is = 0; is < nspin; ++is)
+            {
+                for (int ig = 0; ig < pw.npw; ++ig)
+                {
+                    maxerr = std::max(maxerr, std::abs(chr.rhog_save[is][ig] - n_ref[is * pw.npw + ig]));
+                }
+            }
+            EXPECT_LT(maxerr, 1e-10) << "nspin = " << nspin << ", iter = " << iter;
+        }
+
+        for (int is = 0; is < nspin; ++is)
+        {
+            delete[] chr.rhog[is];
+            delete[] chr.rhog_save[is];
+            delete[] chr.rho[is];
+        }
+        delete[] chr.rhog;
+        delete[] chr.rhog_save;
+        delete[] chr.rho;
+    }
+    GlobalV::NSPIN = 1;
+    GlobalV::DOMAG = false;
 }
 
 #undef private
+
+#ifdef __MPI
+#include <mpi.h>
+#include "module_base/parallel_global.h"
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    POOL_WORLD = MPI_COMM_WORLD;
+
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+
+    MPI_Finalize();
+
+    return result;
+}
+#endif
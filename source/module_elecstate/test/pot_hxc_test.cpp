@@ -0,0 +1,194 @@
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "module_base/global_variable.h"
+#include "module_base/parallel_global.h"
+#include "module_elecstate/potentials/H_Hartree_pw.h"
+#include "module_elecstate/potentials/pot_hxc.h"
+#include "module_elecstate/potentials/pot_xc.h"
+
+// mock functions
+UnitCell::UnitCell()
+{
+}
+UnitCell::~UnitCell()
+{
+}
+Magnetism::Magnetism()
+{
+}
+Magnetism::~Magnetism()
+{
+}
+Charge::Charge()
+{
+}
+Charge::~Charge()
+{
+    if (this->rho == nullptr)
+    {
+        return;
+    }
+    for (int is = 0; is < this->nspin; ++is)
+    {
+        delete[] this->rho[is];
+        delete[] this->rhog[is];
+        delete[] this->kin_r[is];
+    }
+    delete[] this->rho;
+    delete[] this->rhog;
+    delete[] this->kin_r;
+    delete[] this->rho_core;
+    delete[] this->rhog_core;
+}
+void Charge::set_rhopw(ModulePW::PW_Basis* rhopw_in)
+{
+    this->rhopw = rhopw_in;
+}
+void Charge::allocate(const int& nspin_in)
+{
+    this->nspin = nspin_in;
+    this->nrxx = this->rhopw->nrxx;
+    this->rho = new double*[nspin];
+    this->rhog = new std::complex<double>*[nspin];
+    this->kin_r = new double*[nspin];
+    for (int is = 0; is < nspin; ++is)
+    {
+        this->rho[is] = new double[this->nrxx]();
+        this->rhog[is] = new std::complex<double>[this->rhopw->npw]();
+        this->kin_r[is] = new double[this->nrxx]();
+    }
+    this->rho_core = new double[this->nrxx]();
+    this->rhog_core = new std::complex<double>[this->rhopw->npw]();
+}
+
+/************************************************
+ *  unit test of class PotHXC
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - cal_v_eff
+ *     - with ecut_xc >= 4 * ecutwfc, v_eff, etxc and vtxc are the same as those of PotHartree + PotXC
+ *       for LDA and PBE with nspin = 1 and 2
+ */
+
+class PotHXCTest : public ::testing::TestWithParam<std::tuple<std::string, int>>
+{
+  protected:
+    const double ecutwfc = 10.0;
+    ModulePW::PW_Basis rhopw;
+    UnitCell* ucell = nullptr;
+    Charge chg;
+
+    void SetUp() override
+    {
+#ifdef __MPI
+        rhopw.initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
+#endif
+        const ModuleBase::Matrix3 latvec(1.0, 0.0, 0.0, 0.1, 1.1, 0.0, 0.0, 0.2, 0.9);
+        rhopw.initgrids(6.0, latvec, 4.0 * ecutwfc);
+        rhopw.initparameters(false, 4.0 * ecutwfc);
+        rhopw.setuptransform();
+        rhopw.collect_local_pw();
+        ucell = new UnitCell;
+        ucell->tpiba = rhopw.tpiba;
+        ucell->tpiba2 = rhopw.tpiba2;
+        ucell->omega = rhopw.omega;
+        GlobalV::DOMAG = false;
+        GlobalV::DOMAG_Z = false;
+    }
+    void TearDown() override
+    {
+        delete ucell;
+    }
+
+    // a positive density with plane waves inside the sphere of rhopw
+    void set_rho(const int nspin)
+    {
+        chg.set_rhopw(&rhopw);
+        chg.allocate(nspin);
+        std::mt19937 gen(7 + GlobalV::RANK_IN_POOL);
+        std::uniform_real_distribution<double> u(-1.0, 1.0);
+        std::vector<std::complex<double>> rhog(rhopw.npw);
+        for (int is = 0; is < nspin; ++is)
+        {
+            for (int ig = 0; ig < rhopw.npw; ++ig)
+            {
+                const double g2 = rhopw.gg[ig] * rhopw.tpiba2;
+                rhog[ig] = (g2 < 1e-8) ? 0.05 : 0.002 * std::complex<double>(u(gen), u(gen)) * std::exp(-0.1 * g2);
+            }
+            rhopw.recip2real(rhog.data(), chg.rho[is]);
+            rhopw.real2recip(chg.rho[is], chg.rhog[is]);
+        }
+        for (int ig = 0; ig < rhopw.npw; ++ig)
+        {
+            const double g2 = rhopw.gg[ig] * rhopw.tpiba2;
+            rhog[ig] = (g2 < 1e-8) ? 0.01 : 0.001 * std::complex<double>(u(gen), u(gen)) * std::exp(-0.2 * g2);
+        }
+        rhopw.recip2real(rhog.data(), chg.rho_core);
+        rhopw.real2recip(chg.rho_core, chg.rhog_core);
+    }
+};
+
+TEST_P(PotHXCTest, SameAsHartreeXC)
+{
+    const std::string xc = std::get<0>(GetParam());
+    const int nspin = std::get<1>(GetParam());
+    GlobalV::NSPIN = nspin;
+    XC_Functional::set_xc_type(xc);
+    this->set_rho(nspin);
+
+    double etxc_ref = 0.0, vtxc_ref = 0.0;
+    ModuleBase::matrix v_ref(nspin, rhopw.nrxx);
+    elecstate::PotHartree pot_h(&rhopw);
+    elecstate::PotXC pot_xc(&rhopw, &etxc_ref, &vtxc_ref);
+    pot_h.cal_v_eff(&chg, ucell, v_ref);
+    const double ehart_ref = elecstate::H_Hartree_pw::hartree_energy;
+    pot_xc.cal_v_eff(&chg, ucell, v_ref);
+
+    for (const double ecut_xc: {4.0 * ecutwfc, 5.0 * ecutwfc})
+    {
+        double etxc = 0.0, vtxc = 0.0;
+        ModuleBase::matrix v_eff(nspin, rhopw.nrxx);
+        elecstate::PotHXC pot_hxc(&rhopw, ecut_xc, &etxc, &vtxc);
+        pot_hxc.cal_v_eff(&chg, ucell, v_eff);
+
+        EXPECT_NEAR(etxc, etxc_ref, 1e-10 * std::abs(etxc_ref));
+        EXPECT_NEAR(vtxc, vtxc_ref, 1e-10 * std::abs(vtxc_ref));
+        EXPECT_NEAR(elecstate::H_Hartree_pw::hartree_energy, ehart_ref, 1e-10 * std::abs(ehart_ref));
+        double maxerr = 0.0;
+        for (int is = 0; is < nspin; ++is)
+        {
+            for (int ir = 0; ir < rhopw.nrxx; ++ir)
+            {
+                maxerr = std::max(maxerr, std::abs(v_eff(is, ir) - v_ref(is, ir)));
+            }
+        }
+        EXPECT_LT(maxerr, 1e-10) << "ecut_xc = " << ecut_xc;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(XCAndSpin,
+                         PotHXCTest,
+                         ::testing::Values(std::make_tuple("LDA", 1),
+                                           std::make_tuple("LDA", 2),
+                                           std::make_tuple("PBE", 1),
+                                           std::make_tuple("PBE", 2)));
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_split(MPI_COMM_WORLD, 0, 1, &POOL_WORLD);
+    MPI_Comm_size(POOL_WORLD, &GlobalV::NPROC_IN_POOL);
+    MPI_Comm_rank(POOL_WORLD, &GlobalV::RANK_IN_POOL);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
@@ -27,6 +27,31 @@ ModulePW::PW_Basis::PW_Basis()
 ModulePW::PW_Basis::~PW_Basis()
 {
 }
+// FFT is mocked by copying, npw = nrxx
+template <typename FPTYPE>
+void ModulePW::PW_Basis::real2recip(const FPTYPE* in,
+                                    std::complex<FPTYPE>* out,
+                                    const bool add,
+                                    const FPTYPE factor) const
+{
+    for (int i = 0; i < this->npw; i++)
+    {
+        out[i] = in[i];
+    }
+}
+template <typename FPTYPE>
+void ModulePW::PW_Basis::recip2real(const std::complex<FPTYPE>* in,
+                                    FPTYPE* out,
+                                    const bool add,
+                                    const FPTYPE factor) const
+{
+    for (int i = 0; i < this->nrxx; i++)
+    {
+        out[i] = in[i].real();
+    }
+}
+template void ModulePW::PW_Basis::real2recip<double>(const double*, std::complex<double>*, const bool, const double) const;
+template void ModulePW::PW_Basis::recip2real<double>(const std::complex<double>*, double*, const bool, const double) const;
 ModulePW::FFT::FFT()
 {
 }
@@ -79,6 +104,25 @@ PotBase* Potential::get_pot_type(const std::string& pot_type)
     return new PotBase;
 }
 
+// V(G) = 2 * rho(G) in G space
+class PotRecipMock : public PotBase
+{
+  public:
+    PotRecipMock(const ModulePW::PW_Basis* rho_basis_in)
+    {
+        this->rho_basis_ = rho_basis_in;
+        this->dynamic_mode = true;
+        this->recip_mode = true;
+    }
+    void cal_v_eff_g(const UnitCell* ucell, const std::complex<double>* rhog_tot, std::complex<double>* vg) override
+    {
+        for (int ig = 0; ig < this->rho_basis_->npw; ig++)
+        {
+            vg[ig] += 2.0 * rhog_tot[ig];
+        }
+    }
+};
+
 void Set_GlobalV_Default()
 {
     GlobalV::NSPIN = 1;
@@ -105,6 +149,8 @@ void Set_GlobalV_Default()
  *     - calculate the fixed potentials: v_effective_fixed
  *   - CalVeff: elecstate::Potential::cal_v_eff()
  *     - calculate v_effective by adding v_effective_fixed and adding the dynamic potentials
+ *   - CalVeffRecip: elecstate::Potential::cal_v_eff()
+ *     - potentials in G space share rho(G) of all spins and are added with v_effective_fixed
  *   - UpdateFromCharge: elecstate::Potential::update_from_charge()
  *     - calls cal_fixed_v and cal_v_eff to update v_effective from rho
  *   - InitPot: elecstate::Potential::init_pot()
@@ -319,6 +365,59 @@ TEST_F(PotentialNewTest, CalVeff)
     delete chg;
 }
 
+TEST_F(PotentialNewTest, CalVeffRecip)
+{
+    // construct potential
+    rhopw->nrxx = 100;
+    rhopw->npw = 100;
+    pot = new elecstate::Potential(rhopw, ucell, vloc, structure_factors, etxc, vtxc);
+    pot->components.push_back(new elecstate::PotRecipMock(rhopw));
+    for (int ir = 0; ir < rhopw->nrxx; ir++)
+    {
+        pot->v_effective_fixed[ir] = 0.1 * ir;
+    }
+    Charge* chg = new Charge;
+    chg->rho = new double*[2];
+    chg->rhog = new std::complex<double>*[2];
+    for (int is = 0; is < 2; is++)
+    {
+        chg->rho[is] = new double[rhopw->nrxx];
+        chg->rhog[is] = new std::complex<double>[rhopw->npw];
+        for (int ir = 0; ir < rhopw->nrxx; ir++)
+        {
+            chg->rho[is][ir] = 1.0 + is;
+        }
+    }
+    ModuleBase::matrix v_eff;
+    v_eff.create(2, 100);
+    pot->cal_v_eff(chg, this->ucell, v_eff);
+    for (int is = 0; is < 2; is++)
+    {
+        for (int ir = 0; ir < rhopw->nrxx; ir++)
+        {
+            EXPECT_DOUBLE_EQ(chg->rhog[is][ir].real(), 1.0 + is);
+            EXPECT_DOUBLE_EQ(v_eff(is, ir), 0.1 * ir + 6.0);
+        }
+    }
+    // nspin = 4, only the first column
+    v_eff.create(4, 100);
+    pot->cal_v_eff(chg, this->ucell, v_eff);
+    for (int ir = 0; ir < rhopw->nrxx; ir++)
+    {
+        EXPECT_DOUBLE_EQ(v_eff(0, ir), 0.1 * ir + 2.0);
+        EXPECT_DOUBLE_EQ(v_eff(1, ir), 0.0);
+        EXPECT_DOUBLE_EQ(v_eff(3, ir), 0.0);
+    }
+    for (int is = 0; is < 2; is++)
+    {
+        delete[] chg->rho[is];
+        delete[] chg->rhog[is];
+    }
+    delete[] chg->rho;
+    delete[] chg->rhog;
+    delete chg;
+}
+
 TEST_F(PotentialNewTest, UpdateFromCharge)
 {
     // construct potential
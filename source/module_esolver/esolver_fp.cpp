@@ -37,6 +37,7 @@ namespace ModuleESolver
 #ifdef __MPI
             this->pw_rho->initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
 #endif
+        this->pw_rho->set_fft_nchunk(inp.fft_nchunk);
         if (this->classname == "ESolver_OF") this->pw_rho->setfullpw(inp.of_full_pw, inp.of_full_pw_dim);
         // Initalize the plane wave basis set
         if (inp.nx * inp.ny * inp.nz == 0)
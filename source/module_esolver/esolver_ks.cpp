@@ -3,6 +3,7 @@
 #include <iostream>
 
 #include "../module_io/print_info.h"
+#include "module_base/parallel_global.h"
 #include "module_base/timer.h"
 #include "module_io/input.h"
 #include "time.h"
@@ -46,7 +47,8 @@ namespace ModuleESolver
                              INPUT.mixing_beta,
                              INPUT.mixing_ndim,
                              INPUT.mixing_gg0,
-                             INPUT.mixing_tau);
+                             INPUT.mixing_tau,
+                             INPUT.mixing_lowg);
         // using bandgap to auto set mixing_beta
         if (std::abs(INPUT.mixing_beta + 10.0) < 1e-6)
         {
@@ -109,12 +111,13 @@ namespace ModuleESolver
     #ifdef __MPI
             this->pw_wfc->initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
     #endif
+            this->pw_wfc->set_fft_nchunk(inp.fft_nchunk);
             this->pw_wfc->initgrids(inp.ref_cell_factor * ucell.lat0,
                                     ucell.latvec,
                                     this->pw_rho->nx,
                                     this->pw_rho->ny,
                                     this->pw_rho->nz);
-            this->pw_wfc->initparameters(false, inp.ecutwfc, this->kv.nks, this->kv.kvec_d.data());
+            this->pw_wfc->initparameters(GlobalV::GAMMA_ONLY_PW, inp.ecutwfc, this->kv.nks, this->kv.kvec_d.data());
 #ifdef __MPI
             if(INPUT.pw_seed > 0)    MPI_Allreduce(MPI_IN_PLACE, &this->pw_wfc->ggecut, 1, MPI_DOUBLE, MPI_MAX , MPI_COMM_WORLD);
             //qianrui add 2021-8-13 to make different kpar parameters can get the same results
@@ -253,7 +256,8 @@ namespace ModuleESolver
                 //(Different ranks should have abtained the same, but small differences always exist in practice.)
                 //Maybe in the future, density and wavefunctions should use different parallel algorithms, in which 
                 //they do not occupy all processors, for example wavefunctions uses 20 processors while density uses 10.
-                if(GlobalV::MY_STOGROUP == 0)
+                //Band groups of KS-DFT diagonalize together, so all of them have to go through here.
+                if(GlobalV::MY_STOGROUP == 0 || Parallel_Global::ks_band_groups())
                 {
                     // FPTYPE drho = this->estate.caldr2(); 
                     // EState should be used after it is constructed.
@@ -301,7 +305,7 @@ namespace ModuleESolver
                             p_chgmix->auto_set(bandgap_for_autoset, GlobalC::ucell);
                         }
                         //conv_elec = this->estate.mix_rho();
-                        p_chgmix->mix_rho(iter, pelec->charge);
+                        this->mix_density(iter);
                         //----------charge mixing done-----------
                     }
                 }
@@ -56,6 +56,8 @@ namespace ModuleESolver
         virtual void afterscf(const int istep) {};
         // <Temporary> It should be replaced by a function in Hamilt Class
         virtual void updatepot(const int istep, const int iter) {};
+        // mix the density for the next iteration, the charge density is mixed by default
+        virtual void mix_density(const int iter) { this->p_chgmix->mix_rho(iter, this->pelec->charge); }
         // choose strategy when charge density convergence achieved
         virtual bool do_after_converge(int& iter){return true;}
 
@@ -136,6 +136,11 @@ void ESolver_KS_LCAO::Init(Input& inp, UnitCell& ucell)
     {
         if (GlobalC::exx_info.info_global.cal_exx)
         {
+            // the density matrix of exx is mixed with the coefficients of charge mixing
+            if (inp.mixing_dm)
+            {
+                ModuleBase::WARNING_QUIT("ESolver_KS_LCAO", "mixing_dm is not supported for hybrid functionals");
+            }
             /* In the special "two-level" calculation case,
             first scf iteration only calculate the functional without exact exchange.
             but in "nscf" calculation, there is no need of "two-level" method. */
@@ -427,7 +432,10 @@ void ESolver_KS_LCAO::eachiterinit(const int istep, const int iter)
     // mohan add 2010-07-16
     // used for pulay mixing.
     if (iter == 1)
+    {
         this->p_chgmix->reset();
+        this->dm_mix.reset();
+    }
 
     // mohan update 2012-06-05
     this->pelec->f_en.deband_harris = this->pelec->cal_delta_eband();
@@ -606,6 +614,90 @@ void ESolver_KS_LCAO::hamilt2density(int istep, int iter, double ethr)
     // (7) calculate delta energy
     this->pelec->f_en.deband = this->pelec->cal_delta_eband();
 }
+void ESolver_KS_LCAO::mix_density(const int iter)
+{
+    if (!INPUT.mixing_dm)
+    {
+        ESolver_KS::mix_density(iter);
+        return;
+    }
+    ModuleBase::TITLE("ESolver_KS_LCAO", "mix_density");
+    ModuleBase::timer::tick("ESolver_KS_LCAO", "mix_density");
+
+    // the density matrix on the grid, from which the charge density has been integrated
+    std::vector<double*> dm(GlobalV::NSPIN, nullptr);
+    int ndm = 0;
+    if (GlobalV::GAMMA_ONLY_LOCAL)
+    {
+        ndm = this->GridT.lgd * this->GridT.lgd;
+        for (int is = 0; is < GlobalV::NSPIN && ndm > 0; ++is)
+        {
+            dm[is] = this->LOC.DM[is][0];
+        }
+    }
+    else
+    {
+        ndm = this->GridT.nnrg;
+        for (int is = 0; is < GlobalV::NSPIN && ndm > 0; ++is)
+        {
+            dm[is] = this->LOC.DM_R[is];
+        }
+    }
+
+    // in the first step, the output density matrix and charge density are taken as the input of the next step
+    if (!this->dm_mix.mix(iter,
+                          dm.data(),
+                          GlobalV::NSPIN,
+                          ndm,
+                          this->p_chgmix->get_mixing_ndim(),
+                          this->p_chgmix->get_mixing_beta()))
+    {
+        ModuleBase::timer::tick("ESolver_KS_LCAO", "mix_density");
+        return;
+    }
+
+    // only the mixed density matrix is integrated on the grid, not those of the history
+    Charge* chr_mix = this->pelec->charge;
+    for (int is = 0; is < GlobalV::NSPIN; is++)
+    {
+        ModuleBase::GlobalFunc::ZEROS(chr_mix->rho[is], chr_mix->nrxx);
+    }
+    if (GlobalV::GAMMA_ONLY_LOCAL)
+    {
+        Gint_inout inout(this->LOC.DM, chr_mix->rho, Gint_Tools::job_type::rho);
+        this->UHM.GG.cal_gint(&inout);
+    }
+    else
+    {
+        Gint_inout inout(this->LOC.DM_R, chr_mix->rho, Gint_Tools::job_type::rho);
+        this->UHM.GK.cal_gint(&inout);
+    }
+    if (XC_Functional::get_func_type() == 3 || XC_Functional::get_func_type() == 5)
+    {
+        for (int is = 0; is < GlobalV::NSPIN; is++)
+        {
+            ModuleBase::GlobalFunc::ZEROS(chr_mix->kin_r[is], chr_mix->nrxx);
+        }
+        if (GlobalV::GAMMA_ONLY_LOCAL)
+        {
+            Gint_inout inout1(this->LOC.DM, chr_mix->kin_r, Gint_Tools::job_type::tau);
+            this->UHM.GG.cal_gint(&inout1);
+        }
+        else
+        {
+            Gint_inout inout1(this->LOC.DM_R, chr_mix->kin_r, Gint_Tools::job_type::tau);
+            this->UHM.GK.cal_gint(&inout1);
+        }
+    }
+    chr_mix->renormalize_rho();
+
+    Symmetry_rho srho;
+    for (int is = 0; is < GlobalV::NSPIN; is++)
+    {
+        srho.begin(is, *chr_mix, pw_rho, GlobalC::Pgrid, this->symm);
+    }
+    ModuleBase::timer::tick("ESolver_KS_LCAO", "mix_density");
+}
 void ESolver_KS_LCAO::updatepot(const int istep, const int iter)
 {
     // print Hamiltonian and Overlap matrix
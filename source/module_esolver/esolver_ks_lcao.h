@@ -6,6 +6,7 @@
 #include "module_hamilt_lcao/hamilt_lcaodft/local_orbital_charge.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/local_orbital_wfc.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/LCAO_hamilt.h"
+#include "module_hamilt_lcao/hamilt_lcaodft/dm_mixing.h"
 #include "module_basis/module_ao/ORB_control.h"
 #ifdef __EXX
 #include "module_ri/Mix_DMk_2D.h"
@@ -38,6 +39,7 @@ namespace ModuleESolver
         virtual void beforescf(const int istep) override;
         virtual void eachiterinit(const int istep, const int iter) override;
         virtual void hamilt2density(const int istep, const int iter, const double ethr) override;
+        virtual void mix_density(const int iter) override;
         virtual void updatepot(const int istep, const int iter) override;
         virtual void eachiterfinish(const int iter) override;
         virtual void afterscf(const int istep) override;
@@ -51,6 +53,7 @@ namespace ModuleESolver
         LCAO_Hamilt UHM;
         LCAO_Matrix LM;
         Grid_Technique GridT;
+        DM_Mixing dm_mix; // used if mixing_dm
 
         // Temporarily store the stress to unify the interface with PW,
         // because it's hard to seperate force and stress calculation in LCAO.
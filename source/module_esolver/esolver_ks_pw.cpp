@@ -20,6 +20,7 @@
 #include "module_hamilt_pw/hamilt_pwdft/stress_pw.h"
 //---------------------------------------------------
 #include "module_base/memory.h"
+#include "module_base/parallel_global.h"
 #include "module_elecstate/elecstate_pw.h"
 #include "module_hamilt_general/module_vdw/vdw.h"
 #include "module_hamilt_pw/hamilt_pwdft/hamilt_pw.h"
@@ -36,6 +37,9 @@
 #include "module_io/winput.h"
 #include "module_io/write_wfc_r.h"
 #include "module_psi/kernels/device.h"
+#ifdef __EXX
+#include "module_hamilt_pw/hamilt_pwdft/operator_pw/op_exx_pw.h"
+#endif
 
 namespace ModuleESolver
 {
@@ -87,6 +91,21 @@ ESolver_KS_PW<FPTYPE, Device>::~ESolver_KS_PW()
     {
         delete reinterpret_cast<psi::Psi<std::complex<double>, Device>*>(this->__kspw_psi);
     }
+    // delete the single precision copies of mixed precision mode
+    if (this->phsol_single != nullptr)
+    {
+        delete reinterpret_cast<hsolver::HSolverPW<float, Device>*>(this->phsol_single);
+        this->phsol_single = nullptr;
+    }
+    if (this->p_hamilt_single != nullptr)
+    {
+        delete reinterpret_cast<hamilt::HamiltPW<float, Device>*>(this->p_hamilt_single);
+        this->p_hamilt_single = nullptr;
+    }
+    delete this->psi_single;
+#ifdef __EXX
+    delete this->exx_pw;
+#endif
 }
 
 template <typename FPTYPE, typename Device>
@@ -154,6 +173,11 @@ void ESolver_KS_PW<FPTYPE, Device>::Init(Input& inp, UnitCell& ucell)
 {
     ESolver_KS<FPTYPE, Device>::Init(inp, ucell);
 
+    if (this->pw_wfc->gamma_only && (XC_Functional::get_func_type() == 3 || XC_Functional::get_func_type() == 5))
+    {
+        ModuleBase::WARNING_QUIT("ESolver_KS_PW", "meta-GGA is not implemented for gamma_only in plane wave now.");
+    }
+
     // init HSolver
     if (this->phsol == nullptr)
     {
@@ -193,6 +217,20 @@ void ESolver_KS_PW<FPTYPE, Device>::Init(Input& inp, UnitCell& ucell)
     {
         this->pelec->fixed_weights(GlobalV::ocp_kb);
     }
+
+#ifdef __EXX
+    if (GlobalC::exx_info.info_global.cal_exx)
+    {
+        if (GlobalV::device_flag == "gpu")
+        {
+            ModuleBase::WARNING_QUIT("ESolver_KS_PW", "hybrid functional is not implemented on GPU in plane wave now.");
+        }
+        if (this->exx_pw == nullptr)
+        {
+            this->exx_pw = new Exx_PW(GlobalC::exx_info.info_global);
+        }
+    }
+#endif
 }
 
 template <typename FPTYPE, typename Device>
@@ -301,6 +339,24 @@ void ESolver_KS_PW<FPTYPE, Device>::beforescf(int istep)
     {
         this->p_hamilt = new hamilt::HamiltPW<FPTYPE, Device>(this->pelec->pot, this->pw_wfc, &this->kv);
     }
+#ifdef __EXX
+    // each scf starts from the semilocal functional, the exact exchange is added after it converges
+    if (GlobalC::exx_info.info_global.cal_exx)
+    {
+        if (GlobalC::ucell.atoms[0].ncpp.xc_func == "HSE" || GlobalC::ucell.atoms[0].ncpp.xc_func == "PBE0")
+        {
+            XC_Functional::set_xc_type("pbe");
+        }
+        this->exx_pw->init(this->pw_rho, this->pw_wfc, &this->kv);
+        this->exx_two_level_step = 0;
+    }
+#endif
+    // mixed precision mode starts each scf loop in single precision again
+    if (GlobalV::precision_flag == "mixed")
+    {
+        this->end_single_precision();
+        this->single_precision_done = false;
+    }
 
     //----------------------------------------------------------
     // about vdw, jiyy add vdwd3 and linpz add vdwd2
@@ -370,6 +426,44 @@ void ESolver_KS_PW<FPTYPE, Device>::othercalculation(const int istep)
     return;
 }
 
+template <typename FPTYPE, typename Device>
+bool ESolver_KS_PW<FPTYPE, Device>::do_after_converge(int& iter)
+{
+#ifdef __EXX
+    if (GlobalC::exx_info.info_global.cal_exx)
+    {
+        // no separate_loop case, scf loop only did twice:
+        // in the second scf loop, exx is updated in every iteration
+        if (!GlobalC::exx_info.info_global.separate_loop)
+        {
+            GlobalC::exx_info.info_global.hybrid_step = 1;
+        }
+        // exx converged or get max exx steps
+        if (this->exx_two_level_step == GlobalC::exx_info.info_global.hybrid_step
+            || (iter == 1 && this->exx_two_level_step != 0))
+        {
+            return true;
+        }
+        // update exx and redo scf
+        if (this->exx_two_level_step == 0)
+        {
+            XC_Functional::set_xc_type(GlobalC::ucell.atoms[0].ncpp.xc_func);
+            hamilt::Operator<std::complex<FPTYPE>, Device>* exx
+                = new hamilt::OperatorEXX<hamilt::OperatorPW<FPTYPE, Device>>(
+                    this->exx_pw,
+                    GlobalC::exx_info.info_global.hybrid_alpha);
+            this->p_hamilt->ops->add(exx);
+        }
+        this->exx_pw->cal_ace(this->psi[0], this->pelec->wg, GlobalC::ucell);
+        iter = 0;
+        std::cout << " Updating EXX and rerun SCF" << std::endl;
+        this->exx_two_level_step++;
+        return false;
+    }
+#endif
+    return true;
+}
+
 template <typename FPTYPE, typename Device>
 void ESolver_KS_PW<FPTYPE, Device>::eachiterinit(const int istep, const int iter)
 {
@@ -383,10 +477,19 @@ void ESolver_KS_PW<FPTYPE, Device>::eachiterinit(const int istep, const int iter
 
     //(2) save change density as previous charge,
     // prepared fox mixing.
-    if (GlobalV::MY_STOGROUP == 0)
+    if (GlobalV::MY_STOGROUP == 0 || Parallel_Global::ks_band_groups())
     {
         this->pelec->charge->save_rho_before_sum_band();
     }
+
+#ifdef __EXX
+    // without separate loop, the exact exchange is updated in every iteration of the second scf
+    if (GlobalC::exx_info.info_global.cal_exx && !GlobalC::exx_info.info_global.separate_loop
+        && this->exx_two_level_step && iter > 1)
+    {
+        this->exx_pw->cal_ace(this->psi[0], this->pelec->wg, GlobalC::ucell);
+    }
+#endif
 }
 
 // Temporary, it should be replaced by hsolver later.
@@ -410,9 +513,26 @@ void ESolver_KS_PW<FPTYPE, Device>::hamilt2density(const int istep, const int it
             hsolver::DiagoIterAssist<FPTYPE, Device>::need_subspace = true;
         }
 
-        hsolver::DiagoIterAssist<FPTYPE, Device>::PW_DIAG_THR = ethr;
-        hsolver::DiagoIterAssist<FPTYPE, Device>::PW_DIAG_NMAX = GlobalV::PW_DIAG_NMAX;
-        this->phsol->solve(this->p_hamilt, this->kspw_psi[0], this->pelec, GlobalV::KS_SOLVER);
+        // in mixed precision mode, diagonalize in single precision as long as
+        // the threshold can be reached, and then switch to double precision once
+        if (GlobalV::precision_flag == "mixed" && !this->single_precision_done)
+        {
+            if (ethr >= hsolver::HSolverPW<float, Device>::DIAG_ETHR_SINGLE)
+            {
+                this->hamilt2density_single(ethr);
+            }
+            else
+            {
+                GlobalV::ofs_running << " Switch to double precision, diag_ethr = " << ethr << std::endl;
+                this->end_single_precision();
+            }
+        }
+        if (GlobalV::precision_flag != "mixed" || this->single_precision_done)
+        {
+            hsolver::DiagoIterAssist<FPTYPE, Device>::PW_DIAG_THR = ethr;
+            hsolver::DiagoIterAssist<FPTYPE, Device>::PW_DIAG_NMAX = GlobalV::PW_DIAG_NMAX;
+            this->phsol->solve(this->p_hamilt, this->kspw_psi[0], this->pelec, GlobalV::KS_SOLVER);
+        }
 
         if (GlobalV::out_bandgap)
         {
@@ -432,10 +552,11 @@ void ESolver_KS_PW<FPTYPE, Device>::hamilt2density(const int istep, const int it
     }
 
     // add exx
-#ifdef __LCAO
 #ifdef __EXX
-    this->pelec->set_exx(GlobalC::exx_lip.get_exx_energy()); // Peize Lin add 2019-03-09
-#endif
+    if (GlobalC::exx_info.info_global.cal_exx)
+    {
+        this->pelec->set_exx(this->exx_pw->cal_exx_energy(this->psi[0], this->pelec->wg));
+    }
 #endif
     // calculate the delta_harris energy
     // according to new charge density.
@@ -460,6 +581,66 @@ void ESolver_KS_PW<FPTYPE, Device>::hamilt2density(const int istep, const int it
     // if (LOCAL_BASIS) xiaohui modify 2013-09-02
 }
 
+template <typename FPTYPE, typename Device>
+void ESolver_KS_PW<FPTYPE, Device>::hamilt2density_single(const double ethr)
+{
+    ModuleBase::timer::tick("ESolver_KS_PW", "hamilt2density_single");
+    if (this->p_hamilt_single == nullptr)
+    {
+        this->p_hamilt_single = new hamilt::HamiltPW<float, Device>(this->pelec->pot, this->pw_wfc, &this->kv);
+    }
+    if (this->phsol_single == nullptr)
+    {
+        auto phsol_pw = new hsolver::HSolverPW<float, Device>(this->pw_wfc, &this->wf);
+        // psi of later scf loops has been initialized by the double precision solver
+        phsol_pw->initialed_psi = reinterpret_cast<hsolver::HSolverPW<FPTYPE, Device>*>(this->phsol)->initialed_psi;
+        this->phsol_single = phsol_pw;
+    }
+    if (this->psi_single == nullptr)
+    {
+        this->psi_single = new psi::Psi<std::complex<float>, Device>(this->kspw_psi[0]);
+        ModuleBase::Memory::record("Psi_single", sizeof(std::complex<float>) * this->psi_single->size());
+    }
+
+    hsolver::DiagoIterAssist<float, Device>::need_subspace = hsolver::DiagoIterAssist<FPTYPE, Device>::need_subspace;
+    hsolver::DiagoIterAssist<float, Device>::PW_DIAG_THR = static_cast<float>(ethr);
+    hsolver::DiagoIterAssist<float, Device>::PW_DIAG_NMAX = GlobalV::PW_DIAG_NMAX;
+    // eigenvalues are written to pelec->ekb by the solver, the charge density is
+    // calculated from the double precision psi to keep the mixing accurate
+    this->phsol_single->solve(this->p_hamilt_single, this->psi_single[0], this->pelec, GlobalV::KS_SOLVER, true);
+
+    castmem_2d_s2d_op()(this->ctx,
+                        this->ctx,
+                        this->kspw_psi[0].get_pointer() - this->kspw_psi[0].get_psi_bias(),
+                        this->psi_single[0].get_pointer() - this->psi_single[0].get_psi_bias(),
+                        this->psi_single[0].size());
+    reinterpret_cast<elecstate::ElecStatePW<FPTYPE, Device>*>(this->pelec)->psiToRho(this->kspw_psi[0]);
+    ModuleBase::timer::tick("ESolver_KS_PW", "hamilt2density_single");
+}
+
+template <typename FPTYPE, typename Device>
+void ESolver_KS_PW<FPTYPE, Device>::end_single_precision()
+{
+    // psi has been solved in single precision, do not initialize it again in double precision
+    if (this->psi_single != nullptr)
+    {
+        reinterpret_cast<hsolver::HSolverPW<FPTYPE, Device>*>(this->phsol)->initialed_psi = true;
+        delete this->psi_single;
+        this->psi_single = nullptr;
+    }
+    if (this->phsol_single != nullptr)
+    {
+        delete reinterpret_cast<hsolver::HSolverPW<float, Device>*>(this->phsol_single);
+        this->phsol_single = nullptr;
+    }
+    if (this->p_hamilt_single != nullptr)
+    {
+        delete reinterpret_cast<hamilt::HamiltPW<float, Device>*>(this->p_hamilt_single);
+        this->p_hamilt_single = nullptr;
+    }
+    this->single_precision_done = true;
+}
+
 // Temporary, it should be rewritten with Hamilt class.
 template <typename FPTYPE, typename Device>
 void ESolver_KS_PW<FPTYPE, Device>::updatepot(const int istep, const int iter)
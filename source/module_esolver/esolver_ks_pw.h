@@ -2,6 +2,9 @@
 #define ESOLVER_KS_PW_H
 #include "./esolver_ks.h"
 #include "module_hamilt_pw/hamilt_pwdft/operator_pw/velocity_pw.h"
+#ifdef __EXX
+#include "module_hamilt_pw/hamilt_pwdft/exx_pw.h"
+#endif
 // #include "Basis_PW.h"
 // #include "Estate_PW.h"
 // #include "Hamilton_PW.h"
@@ -39,6 +42,7 @@ namespace ModuleESolver
         virtual void eachiterfinish(const int iter) override;
         virtual void afterscf(const int istep) override;
         virtual void othercalculation(const int istep)override;
+        virtual bool do_after_converge(int& iter) override;
 
         //temporary, this will be removed in the future;
         //Init Global class
@@ -53,7 +57,24 @@ namespace ModuleESolver
         psi::AbacusDevice_t device = {};
         psi::Psi<std::complex<FPTYPE>, Device>* kspw_psi = nullptr;
         psi::Psi<std::complex<double>, Device>* __kspw_psi = nullptr;
+
+        // mixed precision mode: the first SCF steps are diagonalized in single precision,
+        // until the required threshold drops below what single precision can reach
+        hamilt::Hamilt<float, Device>* p_hamilt_single = nullptr;
+        hsolver::HSolver<float, Device>* phsol_single = nullptr;
+        psi::Psi<std::complex<float>, Device>* psi_single = nullptr;
+        bool single_precision_done = false;
+        // diagonalize with the single precision copies and calculate the charge in double precision
+        void hamilt2density_single(const double ethr);
+        // free the single precision copies and continue in double precision
+        void end_single_precision();
+#ifdef __EXX
+        // exact exchange of hybrid functionals, the ACE projectors are built after each converged scf loop
+        Exx_PW* exx_pw = nullptr;
+        int exx_two_level_step = 0;
+#endif
         using castmem_2d_d2h_op = psi::memory::cast_memory_op<std::complex<double>, std::complex<FPTYPE>, psi::DEVICE_CPU, Device>;
+        using castmem_2d_s2d_op = psi::memory::cast_memory_op<std::complex<FPTYPE>, std::complex<float>, Device, Device>;
     };
 }  // namespace ModuleESolver
 #endif
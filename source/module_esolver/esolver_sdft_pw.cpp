@@ -54,7 +54,6 @@ void ESolver_SDFT_PW::Init(Input &inp, UnitCell &ucell)
                                                     &(sf),
                                                     &(this->pelec->f_en.etxc),
                                                     &(this->pelec->f_en.vtxc));
-        GlobalTemp::veff = &(this->pelec->pot->get_effective_v());
     }
 
     //Maybe NSPIN=2 is not considered in this ESolver, but FYI
@@ -49,12 +49,4 @@ private:
 
 }//namespace ModuleESolver
 
-//temporary setting: removed GlobalC but not breaking design philosophy
-namespace GlobalTemp
-{
-
-extern const ModuleBase::matrix* veff;
-
-}
-
 #endif
\ No newline at end of file
@@ -40,6 +40,7 @@ void ESolver_SDFT_PW::check_che(const int nche_in)
     ModuleBase::Chebyshev<double> chetest(nche_in);
     Stochastic_Iter& stoiter = ((hsolver::HSolverPW_SDFT*)phsol)->stoiter;
     Stochastic_hchi& stohchi = stoiter.stohchi;
+    stohchi.p_hamilt = this->p_hamilt;
     int ntest = 2;
     for (int ik = 0;ik < nk; ++ik)
 	{
@@ -118,6 +119,7 @@ void ESolver_SDFT_PW::sKG(const int nche_KG, const double fwhmin, const double w
     const double tpiba = GlobalC::ucell.tpiba;
     Stochastic_Iter& stoiter = ((hsolver::HSolverPW_SDFT*)phsol)->stoiter;
     Stochastic_hchi& stohchi = stoiter.stohchi;
+    stohchi.p_hamilt = this->p_hamilt;
     const int nk = kv.nks;
 
     //------------------------------------------------------------------
@@ -600,6 +602,7 @@ void ESolver_SDFT_PW:: caldos( const int nche_dos, const double sigmain, const d
     const int nk = kv.nks;
     Stochastic_Iter& stoiter = ((hsolver::HSolverPW_SDFT*)phsol)->stoiter;
     Stochastic_hchi& stohchi = stoiter.stohchi;
+    stohchi.p_hamilt = this->p_hamilt;
     const int npwx = wf.npwx;
 
     double * spolyv = nullptr;
@@ -768,10 +771,3 @@ void ESolver_SDFT_PW:: caldos( const int nche_dos, const double sigmain, const d
 }
 
 }//namespace ModuleESolver
-
-namespace GlobalTemp
-{
-
-const ModuleBase::matrix* veff;
-
-}
\ No newline at end of file
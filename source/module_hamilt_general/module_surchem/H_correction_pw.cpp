@@ -11,23 +11,31 @@ ModuleBase::matrix surchem::v_correction(const UnitCell& cell,
                                          const int& nspin,
                                          const double* const* const rho,
                                          const double* vlocal,
-                                         Structure_Factor* sf)
+                                         Structure_Factor* sf,
+                                         const complex<double>* rhog_tot)
 {
     ModuleBase::TITLE("surchem", "v_correction");
     ModuleBase::timer::tick("surchem", "v_correction");
 
-    double* Porter = new double[rho_basis->nrxx];
-    for (int i = 0; i < rho_basis->nrxx; i++)
-        Porter[i] = 0.0;
-    const int nspin0 = (nspin == 2) ? 2 : 1;
-    for (int is = 0; is < nspin0; is++)
-        for (int ir = 0; ir < rho_basis->nrxx; ir++)
-            Porter[ir] += rho[is][ir];
-
     complex<double>* Porter_g = new complex<double>[rho_basis->npw];
-    ModuleBase::GlobalFunc::ZEROS(Porter_g, rho_basis->npw);
-
-    rho_basis->real2recip(Porter, Porter_g);
+    if (rhog_tot != nullptr)
+    {
+        ModuleBase::GlobalFunc::COPYARRAY(rhog_tot, Porter_g, rho_basis->npw);
+    }
+    else
+    {
+        double* Porter = new double[rho_basis->nrxx];
+        for (int i = 0; i < rho_basis->nrxx; i++)
+            Porter[i] = 0.0;
+        const int nspin0 = (nspin == 2) ? 2 : 1;
+        for (int is = 0; is < nspin0; is++)
+            for (int ir = 0; ir < rho_basis->nrxx; ir++)
+                Porter[ir] += rho[is][ir];
+
+        ModuleBase::GlobalFunc::ZEROS(Porter_g, rho_basis->npw);
+        rho_basis->real2recip(Porter, Porter_g);
+        delete[] Porter;
+    }
 
     complex<double>* N = new complex<double>[rho_basis->npw];
     complex<double>* TOTN = new complex<double>[rho_basis->npw];
@@ -42,7 +50,6 @@ ModuleBase::matrix surchem::v_correction(const UnitCell& cell,
     v += cal_vel(cell, rho_basis, TOTN, PS_TOTN, nspin);
     v += cal_vcav(cell, rho_basis, PS_TOTN, nspin);
 
-    delete[] Porter;
     delete[] Porter_g;
     delete[] N;
     delete[] PS_TOTN;
@@ -86,13 +86,26 @@ ModuleBase::matrix surchem::cal_vel(const UnitCell& cell,
     double *tmp_Vel = new double[rho_basis->nrxx];
     ModuleBase::GlobalFunc::ZEROS(tmp_Vel, rho_basis->nrxx);
 
-    // Calculate Sol_phi with epsilon.
-    ncgsol = 0;
-    minimize_cg(cell, rho_basis, epsilon, B, Sol_phi, ncgsol);
+    if (GlobalV::sol_solver == "mg")
+    {
+        // Calculate Sol_phi with epsilon.
+        ncgsol = 0;
+        minimize_mg(cell, rho_basis, epsilon, B, Sol_phi, sol_phi_last, ncgsol);
+
+        ncgsol = 0;
+        // Calculate Sol_phi0 with epsilon0.
+        minimize_mg(cell, rho_basis, epsilon0, B, Sol_phi0, sol_phi0_last, ncgsol);
+    }
+    else
+    {
+        // Calculate Sol_phi with epsilon.
+        ncgsol = 0;
+        minimize_cg(cell, rho_basis, epsilon, B, Sol_phi, ncgsol);
 
-    ncgsol = 0;
-    // Calculate Sol_phi0 with epsilon0.
-    minimize_cg(cell, rho_basis, epsilon0, B, Sol_phi0, ncgsol);
+        ncgsol = 0;
+        // Calculate Sol_phi0 with epsilon0.
+        minimize_cg(cell, rho_basis, epsilon0, B, Sol_phi0, ncgsol);
+    }
 
     double *phi_tilda_R = new double[rho_basis->nrxx];
     double *phi_tilda_R0 = new double[rho_basis->nrxx];
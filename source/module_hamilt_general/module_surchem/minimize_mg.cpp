@@ -0,0 +1,111 @@
+#include "module_base/timer.h"
+#include "surchem.h"
+
+// Preconditioned CG for the generalized Poisson equation as minimize_cg, but preconditioned by a V-cycle of the
+// real-space multigrid and started from the solution of the last call, which changes little between SCF steps.
+void surchem::minimize_mg(const UnitCell& ucell,
+                          const ModulePW::PW_Basis* rho_basis,
+                          double* d_eps,
+                          const complex<double>* tot_N,
+                          complex<double>* phi,
+                          std::vector<complex<double>>& phi_last,
+                          int& ncgsol)
+{
+    ModuleBase::timer::tick("surchem", "minimize_mg");
+    const int npw = rho_basis->npw;
+    const int nrxx = rho_basis->nrxx;
+    const int ig0 = rho_basis->ig_gge0;
+
+    this->sol_mg.init(rho_basis);
+    this->sol_mg.set_eps(d_eps);
+
+    std::vector<complex<double>> resid(npw, 0.0);
+    std::vector<complex<double>> z(npw, 0.0);
+    std::vector<complex<double>> lp(npw, 0.0);
+    std::vector<complex<double>> d(npw, 0.0);
+    std::vector<complex<double>> gradphi_x(npw), gradphi_y(npw), gradphi_z(npw), phi_work(npw);
+    std::vector<double> r_real(nrxx), z_real(nrxx);
+
+    // z = M^{-1} resid with M ~ -div(epsilon grad)
+    auto precondition = [&]() {
+        rho_basis->recip2real(resid.data(), r_real.data());
+        this->sol_mg.vcycle(r_real.data(), z_real.data());
+        rho_basis->real2recip(z_real.data(), z.data());
+        if (ig0 >= 0)
+        {
+            z[ig0] = 0.0;
+        }
+    };
+
+    // init guess for phi: the solution of the last step, or that of the Poisson equation in vacuum
+    if (static_cast<int>(phi_last.size()) == npw)
+    {
+        for (int ig = 0; ig < npw; ig++)
+        {
+            phi[ig] = phi_last[ig];
+        }
+    }
+    else
+    {
+        ModuleBase::GlobalFunc::ZEROS(phi, npw);
+        for (int ig = 0; ig < npw; ig++)
+        {
+            if (ig == ig0)
+                continue;
+            phi[ig] = tot_N[ig] / (rho_basis->gg[ig] * ucell.tpiba2);
+        }
+    }
+
+    Leps2(ucell, rho_basis, phi, d_eps, gradphi_x.data(), gradphi_y.data(), gradphi_z.data(), phi_work.data(), lp.data());
+    for (int ig = 0; ig < npw; ig++)
+    {
+        if (ig == ig0)
+            continue;
+        resid[ig] = lp[ig] + tot_N[ig];
+    }
+    precondition();
+
+    double rinvLr = ModuleBase::GlobalFunc::ddot_real(npw, resid.data(), z.data());
+    double r2 = ModuleBase::GlobalFunc::ddot_real(npw, resid.data(), resid.data());
+    d = z;
+
+    int count = 0;
+    while (count < 20000 && sqrt(r2) > 1e-5 && sqrt(rinvLr) > 1e-10)
+    {
+        if (sqrt(r2) > 1e6)
+        {
+            std::cout << "CG ERROR!!!" << std::endl;
+            break;
+        }
+
+        Leps2(ucell, rho_basis, d.data(), d_eps, gradphi_x.data(), gradphi_y.data(), gradphi_z.data(), phi_work.data(), lp.data());
+
+        const double alpha = -rinvLr / ModuleBase::GlobalFunc::ddot_real(npw, d.data(), lp.data());
+        for (int ig = 0; ig < npw; ig++)
+        {
+            if (ig == ig0)
+                continue;
+            phi[ig] += alpha * d[ig];
+            resid[ig] += alpha * lp[ig];
+        }
+
+        precondition();
+
+        double beta = 1.0 / rinvLr;
+        rinvLr = ModuleBase::GlobalFunc::ddot_real(npw, resid.data(), z.data());
+        beta *= rinvLr;
+        for (int ig = 0; ig < npw; ig++)
+        {
+            if (ig == ig0)
+                continue;
+            d[ig] = beta * d[ig] + z[ig];
+        }
+        r2 = ModuleBase::GlobalFunc::ddot_real(npw, resid.data(), resid.data());
+
+        count++;
+    }
+
+    ncgsol = count;
+    phi_last.assign(phi, phi + npw);
+    ModuleBase::timer::tick("surchem", "minimize_mg");
+}
@@ -0,0 +1,452 @@
+#include "sol_multigrid.h"
+
+#include <algorithm>
+
+namespace
+{
+// process owning the z plane iz, only processes with planes are considered
+int owner_of_plane(const int iz, const std::vector<int>& numz, const std::vector<int>& startz)
+{
+    for (int ip = 0; ip < static_cast<int>(numz.size()); ++ip)
+    {
+        if (numz[ip] > 0 && iz >= startz[ip] && iz < startz[ip] + numz[ip])
+        {
+            return ip;
+        }
+    }
+    return 0;
+}
+} // namespace
+
+void Sol_Multigrid::init(const ModulePW::PW_Basis* rho_basis)
+{
+    this->poolrank = rho_basis->poolrank;
+#ifdef __MPI
+    this->pool_world = rho_basis->pool_world;
+#endif
+    std::vector<int> numz(rho_basis->numz, rho_basis->numz + rho_basis->poolnproc);
+    std::vector<int> startz(rho_basis->startz, rho_basis->startz + rho_basis->poolnproc);
+
+    // only the metric changes if the grid is the same, e.g. during cell relaxation
+    const bool same_grid = !this->levels.empty() && this->levels[0].nx == rho_basis->nx
+                           && this->levels[0].ny == rho_basis->ny && this->levels[0].nz == rho_basis->nz
+                           && this->levels[0].nplane == rho_basis->nplane
+                           && this->levels[0].startz == rho_basis->startz_current;
+
+    // c_ij = (b_i * b_j) * n_i * n_j, b_i: reciprocal vectors without 2pi, unit in 1/bohr
+    const ModuleBase::Matrix3& m = rho_basis->GGT;
+    const double ggt[3][3] = {{m.e11, m.e12, m.e13}, {m.e21, m.e22, m.e23}, {m.e31, m.e32, m.e33}};
+    const int n0[3] = {rho_basis->nx, rho_basis->ny, rho_basis->nz};
+    const double lat02 = rho_basis->lat0 * rho_basis->lat0;
+
+    if (same_grid)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                this->levels[0].c[i][j] = ggt[i][j] / lat02 * n0[i] * n0[j];
+            }
+        }
+        for (size_t il = 1; il < this->levels.size(); ++il)
+        {
+            const Level& fine = this->levels[il - 1];
+            const int s[3] = {fine.sx, fine.sy, fine.sz};
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    this->levels[il].c[i][j] = fine.c[i][j] / (s[i] * s[j]);
+                }
+            }
+        }
+        return;
+    }
+
+    this->levels.clear();
+    Level lv;
+    lv.nx = rho_basis->nx;
+    lv.ny = rho_basis->ny;
+    lv.nz = rho_basis->nz;
+    lv.nplane = rho_basis->nplane;
+    lv.startz = rho_basis->startz_current;
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            lv.c[i][j] = ggt[i][j] / lat02 * n0[i] * n0[j];
+        }
+    }
+
+    while (true)
+    {
+        lv.lower = owner_of_plane((lv.startz - 1 + lv.nz) % lv.nz, numz, startz);
+        lv.upper = owner_of_plane((lv.startz + lv.nplane) % lv.nz, numz, startz);
+
+        // a direction is coarsened if the number of points is even
+        lv.sx = (lv.nx % 2 == 0 && lv.nx >= 4) ? 2 : 1;
+        lv.sy = (lv.ny % 2 == 0 && lv.ny >= 4) ? 2 : 1;
+        bool even_z = (lv.nz % 2 == 0 && lv.nz >= 4);
+        for (int ip = 0; ip < static_cast<int>(numz.size()); ++ip)
+        {
+            even_z = even_z && (numz[ip] % 2 == 0);
+        }
+        lv.sz = even_z ? 2 : 1;
+
+        const int nxy = lv.nx * lv.ny;
+        lv.eps.assign(nxy * (lv.nplane + 2), 0.0);
+        lv.u.assign(nxy * (lv.nplane + 2), 0.0);
+        lv.f.assign(nxy * (lv.nplane + 2), 0.0);
+        lv.r.assign(nxy * (lv.nplane + 2), 0.0);
+        lv.diag.assign(nxy * lv.nplane, 0.0);
+        this->levels.push_back(lv);
+
+        if (lv.sx * lv.sy * lv.sz == 1)
+        {
+            break;
+        }
+
+        const int s[3] = {lv.sx, lv.sy, lv.sz};
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                lv.c[i][j] /= (s[i] * s[j]);
+            }
+        }
+        lv.nx /= lv.sx;
+        lv.ny /= lv.sy;
+        if (lv.sz == 2)
+        {
+            lv.nz /= 2;
+            lv.nplane /= 2;
+            lv.startz /= 2;
+            for (int ip = 0; ip < static_cast<int>(numz.size()); ++ip)
+            {
+                numz[ip] /= 2;
+                startz[ip] /= 2;
+            }
+        }
+    }
+
+    this->sendbuf.resize(this->levels[0].nx * this->levels[0].ny);
+    this->recvbuf.resize(this->levels[0].nx * this->levels[0].ny);
+}
+
+void Sol_Multigrid::exchange(Level& lv, std::vector<double>& v)
+{
+    const int np = lv.nplane;
+    if (np == 0)
+    {
+        return;
+    }
+    const int nxy = lv.nx * lv.ny;
+    const int st = np + 2;
+#ifdef __MPI
+    if (lv.lower != this->poolrank)
+    {
+        // first plane to the lower process, upper halo from the upper process
+        for (int ixy = 0; ixy < nxy; ++ixy)
+        {
+            this->sendbuf[ixy] = v[ixy * st + 1];
+        }
+        MPI_Sendrecv(this->sendbuf.data(), nxy, MPI_DOUBLE, lv.lower, 0,
+                     this->recvbuf.data(), nxy, MPI_DOUBLE, lv.upper, 0,
+                     this->pool_world, MPI_STATUS_IGNORE);
+        for (int ixy = 0; ixy < nxy; ++ixy)
+        {
+            v[ixy * st + np + 1] = this->recvbuf[ixy];
+        }
+        // last plane to the upper process, lower halo from the lower process
+        for (int ixy = 0; ixy < nxy; ++ixy)
+        {
+            this->sendbuf[ixy] = v[ixy * st + np];
+        }
+        MPI_Sendrecv(this->sendbuf.data(), nxy, MPI_DOUBLE, lv.upper, 1,
+                     this->recvbuf.data(), nxy, MPI_DOUBLE, lv.lower, 1,
+                     this->pool_world, MPI_STATUS_IGNORE);
+        for (int ixy = 0; ixy < nxy; ++ixy)
+        {
+            v[ixy * st] = this->recvbuf[ixy];
+        }
+        return;
+    }
+#endif
+    for (int ixy = 0; ixy < nxy; ++ixy)
+    {
+        v[ixy * st] = v[ixy * st + np];
+        v[ixy * st + np + 1] = v[ixy * st + 1];
+    }
+}
+
+void Sol_Multigrid::apply(Level& lv, bool residual)
+{
+    this->exchange(lv, lv.u);
+    const int nx = lv.nx;
+    const int ny = lv.ny;
+    const int np = lv.nplane;
+    const int st = np + 2;
+    // 1/2 of the face averages of epsilon and 1/4 of the central differences of the cross terms
+    const double c00 = 0.5 * lv.c[0][0], c11 = 0.5 * lv.c[1][1], c22 = 0.5 * lv.c[2][2];
+    const double c01 = 0.25 * lv.c[0][1], c02 = 0.25 * lv.c[0][2], c12 = 0.25 * lv.c[1][2];
+    const double* u = lv.u.data();
+    const double* e = lv.eps.data();
+    const double* f = lv.f.data();
+    double* r = lv.r.data();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int ix = 0; ix < nx; ++ix)
+    {
+        const int xs[3] = {(ix - 1 + nx) % nx, ix, (ix + 1) % nx};
+        for (int iy = 0; iy < ny; ++iy)
+        {
+            const int ys[3] = {(iy - 1 + ny) % ny, iy, (iy + 1) % ny};
+            const double* pu[3][3];
+            const double* pe[3][3];
+            for (int a = 0; a < 3; ++a)
+            {
+                for (int b = 0; b < 3; ++b)
+                {
+                    const int off = (xs[a] * ny + ys[b]) * st + 1;
+                    pu[a][b] = u + off;
+                    pe[a][b] = e + off;
+                }
+            }
+            const int off = (ix * ny + iy) * st + 1;
+            for (int k = 0; k < np; ++k)
+            {
+                const double u0 = pu[1][1][k];
+                const double e0 = pe[1][1][k];
+                double au = c00 * ((e0 + pe[2][1][k]) * (u0 - pu[2][1][k]) + (e0 + pe[0][1][k]) * (u0 - pu[0][1][k]))
+                            + c11 * ((e0 + pe[1][2][k]) * (u0 - pu[1][2][k]) + (e0 + pe[1][0][k]) * (u0 - pu[1][0][k]))
+                            + c22 * ((e0 + pe[1][1][k + 1]) * (u0 - pu[1][1][k + 1])
+                                     + (e0 + pe[1][1][k - 1]) * (u0 - pu[1][1][k - 1]));
+                au -= c01
+                      * (pe[2][1][k] * (pu[2][2][k] - pu[2][0][k]) - pe[0][1][k] * (pu[0][2][k] - pu[0][0][k])
+                         + pe[1][2][k] * (pu[2][2][k] - pu[0][2][k]) - pe[1][0][k] * (pu[2][0][k] - pu[0][0][k]));
+                au -= c02
+                      * (pe[2][1][k] * (pu[2][1][k + 1] - pu[2][1][k - 1])
+                         - pe[0][1][k] * (pu[0][1][k + 1] - pu[0][1][k - 1])
+                         + pe[1][1][k + 1] * (pu[2][1][k + 1] - pu[0][1][k + 1])
+                         - pe[1][1][k - 1] * (pu[2][1][k - 1] - pu[0][1][k - 1]));
+                au -= c12
+                      * (pe[1][2][k] * (pu[1][2][k + 1] - pu[1][2][k - 1])
+                         - pe[1][0][k] * (pu[1][0][k + 1] - pu[1][0][k - 1])
+                         + pe[1][1][k + 1] * (pu[1][2][k + 1] - pu[1][0][k + 1])
+                         - pe[1][1][k - 1] * (pu[1][2][k - 1] - pu[1][0][k - 1]));
+                r[off + k] = residual ? f[off + k] - au : au;
+            }
+        }
+    }
+}
+
+void Sol_Multigrid::smooth(Level& lv, const int nsweep)
+{
+    const int nxy = lv.nx * lv.ny;
+    const int np = lv.nplane;
+    const int st = np + 2;
+    for (int is = 0; is < nsweep; ++is)
+    {
+        this->apply(lv, true);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int ixy = 0; ixy < nxy; ++ixy)
+        {
+            for (int k = 0; k < np; ++k)
+            {
+                lv.u[ixy * st + k + 1] += this->omega * lv.r[ixy * st + k + 1] / lv.diag[ixy * np + k];
+            }
+        }
+    }
+}
+
+void Sol_Multigrid::restrict_to(const Level& fine,
+                                const std::vector<double>& vf,
+                                Level& coarse,
+                                std::vector<double>& vc)
+{
+    // full weighting, which is the transpose of the linear interpolation up to a factor
+    const double w2[3] = {0.25, 0.5, 0.25};
+    const double w1[3] = {0.0, 1.0, 0.0};
+    const double* wx = (fine.sx == 2) ? w2 : w1;
+    const double* wy = (fine.sy == 2) ? w2 : w1;
+    const double* wz = (fine.sz == 2) ? w2 : w1;
+    const int stf = fine.nplane + 2;
+    const int stc = coarse.nplane + 2;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int ix = 0; ix < coarse.nx; ++ix)
+    {
+        const int fx = fine.sx * ix;
+        const int xs[3] = {(fx - 1 + fine.nx) % fine.nx, fx, (fx + 1) % fine.nx};
+        for (int iy = 0; iy < coarse.ny; ++iy)
+        {
+            const int fy = fine.sy * iy;
+            const int ys[3] = {(fy - 1 + fine.ny) % fine.ny, fy, (fy + 1) % fine.ny};
+            for (int k = 0; k < coarse.nplane; ++k)
+            {
+                const int fk = fine.sz * k;
+                double sum = 0.0;
+                for (int a = 0; a < 3; ++a)
+                {
+                    if (wx[a] == 0.0)
+                    {
+                        continue;
+                    }
+                    for (int b = 0; b < 3; ++b)
+                    {
+                        if (wy[b] == 0.0)
+                        {
+                            continue;
+                        }
+                        const double* p = &vf[(xs[a] * fine.ny + ys[b]) * stf + fk];
+                        sum += wx[a] * wy[b] * (wz[0] * p[0] + wz[1] * p[1] + wz[2] * p[2]);
+                    }
+                }
+                vc[(ix * coarse.ny + iy) * stc + k + 1] = sum;
+            }
+        }
+    }
+}
+
+void Sol_Multigrid::prolong_add(const Level& coarse, Level& fine)
+{
+    const int stf = fine.nplane + 2;
+    const int stc = coarse.nplane + 2;
+    // (index, weight) of the coarse points interpolated to fine point i along one direction
+    auto stencil = [](const int i, const int s, const int nc, int* idx, double* w) {
+        if (s == 1)
+        {
+            idx[0] = idx[1] = i;
+            w[0] = 1.0;
+            w[1] = 0.0;
+        }
+        else if (i % 2 == 0)
+        {
+            idx[0] = idx[1] = i / 2;
+            w[0] = 1.0;
+            w[1] = 0.0;
+        }
+        else
+        {
+            idx[0] = (i - 1) / 2;
+            idx[1] = (nc > 0) ? ((i + 1) / 2) % nc : (i + 1) / 2;
+            w[0] = w[1] = 0.5;
+        }
+    };
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int ix = 0; ix < fine.nx; ++ix)
+    {
+        int xi[2], yi[2], zi[2];
+        double xw[2], yw[2], zw[2];
+        stencil(ix, fine.sx, coarse.nx, xi, xw);
+        for (int iy = 0; iy < fine.ny; ++iy)
+        {
+            stencil(iy, fine.sy, coarse.ny, yi, yw);
+            for (int k = 0; k < fine.nplane; ++k)
+            {
+                // z is not periodic locally, the last plane is interpolated with the upper halo
+                stencil(k, fine.sz, 0, zi, zw);
+                double sum = 0.0;
+                for (int a = 0; a < 2; ++a)
+                {
+                    for (int b = 0; b < 2; ++b)
+                    {
+                        const double* p = &coarse.u[(xi[a] * coarse.ny + yi[b]) * stc + 1];
+                        sum += xw[a] * yw[b] * (zw[0] * p[zi[0]] + zw[1] * p[zi[1]]);
+                    }
+                }
+                fine.u[(ix * fine.ny + iy) * stf + k + 1] += sum;
+            }
+        }
+    }
+}
+
+void Sol_Multigrid::set_eps(const double* epsilon)
+{
+    for (size_t il = 0; il < this->levels.size(); ++il)
+    {
+        Level& lv = this->levels[il];
+        const int nxy = lv.nx * lv.ny;
+        const int np = lv.nplane;
+        const int st = np + 2;
+        if (il == 0)
+        {
+            for (int ixy = 0; ixy < nxy; ++ixy)
+            {
+                std::copy(epsilon + ixy * np, epsilon + (ixy + 1) * np, &lv.eps[ixy * st + 1]);
+            }
+        }
+        else
+        {
+            this->restrict_to(this->levels[il - 1], this->levels[il - 1].eps, lv, lv.eps);
+        }
+        this->exchange(lv, lv.eps);
+
+        // diagonal of A
+        for (int ix = 0; ix < lv.nx; ++ix)
+        {
+            const int ixm = (ix - 1 + lv.nx) % lv.nx;
+            const int ixp = (ix + 1) % lv.nx;
+            for (int iy = 0; iy < lv.ny; ++iy)
+            {
+                const int iym = (iy - 1 + lv.ny) % lv.ny;
+                const int iyp = (iy + 1) % lv.ny;
+                const double* e0 = &lv.eps[(ix * lv.ny + iy) * st + 1];
+                const double* exn = &lv.eps[(ixm * lv.ny + iy) * st + 1];
+                const double* exq = &lv.eps[(ixp * lv.ny + iy) * st + 1];
+                const double* eym = &lv.eps[(ix * lv.ny + iym) * st + 1];
+                const double* eyp = &lv.eps[(ix * lv.ny + iyp) * st + 1];
+                for (int k = 0; k < np; ++k)
+                {
+                    lv.diag[(ix * lv.ny + iy) * np + k]
+                        = 0.5
+                          * (lv.c[0][0] * (2.0 * e0[k] + exn[k] + exq[k]) + lv.c[1][1] * (2.0 * e0[k] + eym[k] + eyp[k])
+                             + lv.c[2][2] * (2.0 * e0[k] + e0[k - 1] + e0[k + 1]));
+                }
+            }
+        }
+    }
+}
+
+void Sol_Multigrid::cycle(const int il)
+{
+    Level& lv = this->levels[il];
+    std::fill(lv.u.begin(), lv.u.end(), 0.0);
+    if (il == static_cast<int>(this->levels.size()) - 1)
+    {
+        this->smooth(lv, this->ncoarse);
+        return;
+    }
+    this->smooth(lv, this->npre);
+    this->apply(lv, true);
+    this->exchange(lv, lv.r);
+    Level& coarse = this->levels[il + 1];
+    this->restrict_to(lv, lv.r, coarse, coarse.f);
+    this->cycle(il + 1);
+    this->exchange(coarse, coarse.u);
+    this->prolong_add(coarse, lv);
+    this->smooth(lv, this->npost);
+}
+
+void Sol_Multigrid::vcycle(const double* r, double* z)
+{
+    Level& lv = this->levels[0];
+    const int nxy = lv.nx * lv.ny;
+    const int np = lv.nplane;
+    const int st = np + 2;
+    for (int ixy = 0; ixy < nxy; ++ixy)
+    {
+        std::copy(r + ixy * np, r + (ixy + 1) * np, &lv.f[ixy * st + 1]);
+    }
+    this->cycle(0);
+    for (int ixy = 0; ixy < nxy; ++ixy)
+    {
+        std::copy(&lv.u[ixy * st + 1], &lv.u[ixy * st + 1] + np, z + ixy * np);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef SOL_MULTIGRID_H
+#define SOL_MULTIGRID_H
+
+#include "module_basis/module_pw/pw_basis.h"
+
+#include <vector>
+
+/**
+ * @brief Geometric multigrid for A u = f with A = -div(epsilon grad) on the real-space grid of rho_basis.
+ *
+ * The operator is discretized by finite differences in crystal coordinates, so that non-orthogonal cells
+ * are supported. The z planes of every level are distributed in the same way as those of rho_basis, and a
+ * direction is coarsened only if its number of grid points (for z: the number of planes on every process)
+ * is even. It is used as the preconditioner of surchem::minimize_mg.
+ */
+class Sol_Multigrid
+{
+  public:
+    Sol_Multigrid(){};
+    ~Sol_Multigrid(){};
+
+    /// @brief build the hierarchy of grids, memory is kept if the grid of rho_basis is unchanged
+    void init(const ModulePW::PW_Basis* rho_basis);
+
+    /// @brief pass the dielectric function (dim=nrxx) to all levels
+    void set_eps(const double* epsilon);
+
+    /// @brief one V-cycle from zero initial guess: z ~ A^{-1} r, both of dim=nrxx
+    void vcycle(const double* r, double* z);
+
+    int get_nlevel() const
+    {
+        return this->levels.size();
+    }
+
+  private:
+    struct Level
+    {
+        int nx = 0, ny = 0, nz = 0;
+        int nplane = 0;
+        int startz = 0;
+        int sx = 1, sy = 1, sz = 1; // coarsening factors to the next level
+        int lower = 0, upper = 0;   // processes owning the z planes below and above
+        double c[3][3];             // metric of the operator in units of the grid spacing
+        // all of dim=nx*ny*(nplane+2), with one halo plane on each side of z
+        std::vector<double> eps, u, f, r;
+        std::vector<double> diag; // diagonal of A, dim=nx*ny*nplane
+    };
+
+    const int npre = 2;     // number of smoothing sweeps before restriction
+    const int npost = 2;    // number of smoothing sweeps after prolongation
+    const int ncoarse = 20; // number of smoothing sweeps on the coarsest level
+    const double omega = 2.0 / 3.0; // damping of the Jacobi smoother
+
+    std::vector<Level> levels;
+    std::vector<double> sendbuf, recvbuf;
+    int poolrank = 0;
+#ifdef __MPI
+    MPI_Comm pool_world;
+#endif
+
+    void exchange(Level& lv, std::vector<double>& v);
+    // out = A u, or out = f - A u if residual is true
+    void apply(Level& lv, bool residual);
+    void smooth(Level& lv, const int nsweep);
+    void restrict_to(const Level& fine, const std::vector<double>& vf, Level& coarse, std::vector<double>& vc);
+    void prolong_add(const Level& coarse, Level& fine);
+    void cycle(const int il);
+};
+
+#endif
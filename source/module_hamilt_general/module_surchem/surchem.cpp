@@ -41,6 +41,8 @@ void surchem::allocate(const int &nrxx, const int &nspin)
     ModuleBase::GlobalFunc::ZEROS(delta_phi, nrxx);
     ModuleBase::GlobalFunc::ZEROS(TOTN_real, nrxx);
     ModuleBase::GlobalFunc::ZEROS(epspot, nrxx);
+    this->sol_phi_last.clear();
+    this->sol_phi0_last.clear();
     return;
 }
 
@@ -52,6 +54,8 @@ void surchem::clear()
     this->TOTN_real = nullptr;
     this->delta_phi = nullptr;
     this->epspot = nullptr;
+    this->sol_phi_last.clear();
+    this->sol_phi0_last.clear();
 }
 
 surchem::~surchem()
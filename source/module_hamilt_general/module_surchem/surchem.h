@@ -10,6 +10,9 @@
 #include "module_cell/unitcell.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_hamilt_pw/hamilt_pwdft/structure_factor.h"
+#include "sol_multigrid.h"
+
+#include <vector>
 
 class surchem
 {
@@ -84,6 +87,14 @@ class surchem
                      complex<double>* phi,
                      int& ncgsol);
 
+    void minimize_mg(const UnitCell& ucell,
+                     const ModulePW::PW_Basis* rho_basis,
+                     double* d_eps,
+                     const complex<double>* tot_N,
+                     complex<double>* phi,
+                     std::vector<complex<double>>& phi_last,
+                     int& ncgsol);
+
     void Leps2(const UnitCell& ucell,
                const ModulePW::PW_Basis* rho_basis,
                complex<double>* phi,
@@ -99,7 +110,8 @@ class surchem
                                     const int& nspin,
                                     const double* const* const rho,
                                     const double* vlocal,
-                                    Structure_Factor* sf);
+                                    Structure_Factor* sf,
+                                    const complex<double>* rhog_tot = nullptr); // total rho in G space if known
 
     void test_V_to_N(ModuleBase::matrix& v,
                      const UnitCell& cell,
@@ -113,6 +125,10 @@ class surchem
     void induced_charge(const UnitCell& cell, const ModulePW::PW_Basis* rho_basis, double* induced_rho);
 
   private:
+    // multigrid preconditioner and the solutions of the last SCF step for the warm start of minimize_mg
+    Sol_Multigrid sol_mg;
+    std::vector<complex<double>> sol_phi_last;
+    std::vector<complex<double>> sol_phi0_last;
 };
 
 namespace GlobalC
@@ -21,6 +21,9 @@
  *     - calculate the 2nd item of Vel
  *   - cal_vel
  *     - calculate electrostatic potential
+ * - Tested functions in minimize_mg.cpp:
+ *   - minimize_mg
+ *     - solve the generalized Poisson equation with the multigrid preconditioner and the warm start
  */
 
 class cal_vel_test : public testing::Test
@@ -222,6 +225,76 @@ TEST_F(cal_vel_test, cal_vel)
     delete[] TOTN;
 }
 
+TEST_F(cal_vel_test, minimize_mg)
+{
+    Setcell::setupcell(GlobalC::ucell);
+
+    ModulePW::PW_Basis pwtest("cpu", "double");
+    GlobalC::rhopw = &pwtest;
+    double wfcecut = 27;
+    bool gamma_only = false;
+    int distribution_type = 1;
+    bool xprime = false;
+
+#ifdef __MPI
+    MPI_Comm_size(MPI_COMM_WORLD,&GlobalV::NPROC);
+    MPI_Comm_rank(MPI_COMM_WORLD,&GlobalV::MY_RANK);
+    Parallel_Global::split_diag_world(GlobalV::NPROC);
+    Parallel_Global::split_grid_world(GlobalV::NPROC);
+    MPI_Comm_split(MPI_COMM_WORLD,0,1,&POOL_WORLD);
+    GlobalC::rhopw ->initmpi(1, 0, POOL_WORLD);
+#endif
+    GlobalC::rhopw ->initgrids(GlobalC::ucell.lat0,GlobalC::ucell.latvec,wfcecut);
+    GlobalC::rhopw ->initparameters(gamma_only,wfcecut,distribution_type, xprime);
+    GlobalC::rhopw ->setuptransform();
+    GlobalC::rhopw ->collect_local_pw();
+
+    const int npw = GlobalC::rhopw ->npw;
+    const int nrxx = GlobalC::rhopw ->nrxx;
+    const int ny = GlobalC::rhopw->ny;
+    const int nplane = GlobalC::rhopw->nplane;
+
+    // a smooth cavity: epsilon = 1 near the center of the cell and 80 outside
+    double *epsilon = new double[nrxx];
+    for (int ir = 0; ir < nrxx; ir++)
+    {
+        const double x = double(ir / (ny * nplane)) / GlobalC::rhopw->nx;
+        const double y = double(ir / nplane % ny) / ny;
+        const double z = double(ir % nplane + GlobalC::rhopw->startz_current) / GlobalC::rhopw->nz;
+        const double s = (3 - cos(ModuleBase::TWO_PI * x) - cos(ModuleBase::TWO_PI * y) - cos(ModuleBase::TWO_PI * z)) / 6;
+        epsilon[ir] = 1 + 79 * s * s;
+    }
+    complex<double> *B = new complex<double>[npw];
+    for (int ig = 0; ig < npw; ig++)
+    {
+        B[ig] = -4.0 * ModuleBase::PI * 1e-3 * exp(-GlobalC::rhopw->gg[ig] * GlobalC::ucell.tpiba2);
+    }
+
+    complex<double> *phi_cg = new complex<double>[npw];
+    complex<double> *phi_mg = new complex<double>[npw];
+    std::vector<complex<double>> phi_last;
+    int ncg = 0;
+    int nmg = 0;
+    solvent_model.minimize_cg(GlobalC::ucell, GlobalC::rhopw, epsilon, B, phi_cg, ncg);
+    solvent_model.minimize_mg(GlobalC::ucell, GlobalC::rhopw, epsilon, B, phi_mg, phi_last, nmg);
+    EXPECT_LT(nmg, ncg);
+    ASSERT_EQ(phi_last.size(), npw);
+    for (int ig = 0; ig < npw; ig++)
+    {
+        EXPECT_NEAR(phi_mg[ig].real(), phi_cg[ig].real(), 1e-6);
+        EXPECT_NEAR(phi_mg[ig].imag(), phi_cg[ig].imag(), 1e-6);
+    }
+
+    // started from the converged solution
+    solvent_model.minimize_mg(GlobalC::ucell, GlobalC::rhopw, epsilon, B, phi_mg, phi_last, nmg);
+    EXPECT_EQ(nmg, 0);
+
+    delete[] epsilon;
+    delete[] B;
+    delete[] phi_cg;
+    delete[] phi_mg;
+}
+
 int main(int argc, char **argv)
 {
 #ifdef __MPI
@@ -27,6 +27,7 @@
 *       Calculate the VDW (d2, d3_0 and d3_bj types) enerygy, force, stress.    
 *   - Vdwd2Parameters::initial_parameters()
 *   - Vdwd3Parameters::initial_parameters()
+*       The C6 table is built once and kept by the following calls.
 */
 
 pseudo_nc::pseudo_nc()
@@ -455,8 +456,25 @@ TEST_F(vdwd3Test, D30GetStress)
     EXPECT_NEAR(stress.e33, -0.0012740017248971936,1e-12);
 }
 
+TEST_F(vdwd3Test, D3C6TableKept)
+{
+    auto vdw_solver = vdw::make_vdw(ucell, input);
+    const double* c6ab = vdw::Vdwd3Parameters::c6ab_.data();
+    const double ene = vdw_solver->get_energy();
+
+    input.vdw_method = "d3_bj";
+    auto vdw_solver_bj = vdw::make_vdw(ucell, input);
+    EXPECT_EQ(vdw::Vdwd3Parameters::c6ab_.data(), c6ab);
+    EXPECT_NEAR(vdw_solver_bj->get_energy(), -0.047458675421836918, 1E-10);
+
+    input.vdw_method = "d3_0";
+    vdw_solver = vdw::make_vdw(ucell, input);
+    EXPECT_EQ(vdw::Vdwd3Parameters::c6ab_.data(), c6ab);
+    EXPECT_NEAR(vdw_solver->get_energy(), ene, 1E-14);
+}
+
 TEST_F(vdwd3Test, D3bjGetEnergy)
-{  
+{
     input.vdw_method = "d3_bj"; 
     auto vdw_solver = vdw::make_vdw(ucell, input);
     double ene = vdw_solver->get_energy();
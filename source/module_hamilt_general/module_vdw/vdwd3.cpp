@@ -289,11 +289,11 @@ void Vdwd3::get_c6(int iat, int jat, double nci, double ncj, double &c6)
     for (size_t i = 0; i != para_.mxc()[iat]; i++)
         for (size_t j = 0; j != para_.mxc()[jat]; j++)
         {
-            c6 = para_.c6ab()[0][j][i][jat][iat];
+            c6 = para_.c6ab(0, j, i, jat, iat);
             if (c6 > 0)
             {
-                cn1 = para_.c6ab()[1][j][i][jat][iat];
-                cn2 = para_.c6ab()[2][j][i][jat][iat];
+                cn1 = para_.c6ab(1, j, i, jat, iat);
+                cn2 = para_.c6ab(2, j, i, jat, iat);
                 r = std::pow((cn1 - nci), 2) + std::pow((cn2 - ncj), 2);
                 if (r < r_save)
                 {
@@ -640,11 +640,11 @@ void Vdwd3::get_dc6_dcnij(int mxci, int mxcj, double cni, double cnj, int izi, i
     for (size_t a = 0; a != mxci; a++)
         for (size_t b = 0; b != mxcj; b++)
         {
-            c6ref = para_.c6ab()[0][b][a][izj][izi];
+            c6ref = para_.c6ab(0, b, a, izj, izi);
             if (c6ref > 0)
             {
-                cn_refi = para_.c6ab()[1][b][a][izj][izi];
-                cn_refj = para_.c6ab()[2][b][a][izj][izi];
+                cn_refi = para_.c6ab(1, b, a, izj, izi);
+                cn_refj = para_.c6ab(2, b, a, izj, izi);
                 r = (cn_refi - cni) * (cn_refi - cni) + (cn_refj - cnj) * (cn_refj - cnj);
                 if (r < r_save)
                 {
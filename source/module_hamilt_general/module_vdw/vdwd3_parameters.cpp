@@ -11,17 +11,20 @@
 namespace vdw
 {
 
+std::vector<int> Vdwd3Parameters::mxc_;
+ModuleBase::Shared_Memory Vdwd3Parameters::c6ab_;
+
 void Vdwd3Parameters::initial_parameters(const Input &input)
 {
-    mxc_.resize(max_elem_, 1);
     r0ab_.resize(max_elem_, std::vector<double>(max_elem_, 0.0));
 
-    c6ab_.resize(3,
-                 std::vector<std::vector<std::vector<std::vector<double>>>>(
-                     5,
-                     std::vector<std::vector<std::vector<double>>>(
-                         5,
-                         std::vector<std::vector<double>>(max_elem_, std::vector<double>(max_elem_, 0.0)))));
+    // every process takes the same branch, as the collective allocate() requires
+    const bool new_c6ab = (c6ab_.size() != 3 * 5 * 5 * max_elem_ * max_elem_);
+    if (new_c6ab)
+    {
+        mxc_.assign(max_elem_, 1);
+        c6ab_.allocate("Vdwd3::c6ab", 3 * 5 * 5 * max_elem_ * max_elem_);
+    }
 
     s6_ = std::stod(input.vdw_s6);
     s18_ = std::stod(input.vdw_s8);
@@ -53,7 +56,10 @@ void Vdwd3Parameters::initial_parameters(const Input &input)
     {
         period_ = input.vdw_cutoff_period;
     }
-    init_C6();
+    if (new_c6ab)
+    {
+        init_C6();
+    }
     init_r2r4();
     init_rcov();
     init_r0ab();
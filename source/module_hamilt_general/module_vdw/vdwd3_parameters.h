@@ -7,6 +7,7 @@
 #ifndef VDWD3_PARAMETERS_H
 #define VDWD3_PARAMETERS_H
 
+#include "module_base/shared_memory.h"
 #include "module_io/input.h"
 #include "vdw_parameters.h"
 
@@ -34,7 +35,12 @@ class Vdwd3Parameters : public VdwParameters
     inline double rs18() const { return rs18_; }
 
     inline const std::vector<int> &mxc() const { return mxc_; }
-    inline const std::vector<std::vector<std::vector<std::vector<std::vector<double>>>>> &c6ab() const { return c6ab_; }
+    // reference C6 (ic = 0) and the coordination numbers of the two atoms (ic = 1, 2)
+    // of the reference pair (ib, ia) of elements j and i
+    inline double c6ab(const int ic, const int ib, const int ia, const int j, const int i) const
+    {
+        return c6ab_.data()[(((ic * 5 + ib) * 5 + ia) * max_elem_ + j) * max_elem_ + i];
+    }
     inline const std::vector<double> &r2r4() const { return r2r4_; }
     inline const std::vector<double> &rcov() { return rcov_; }
     inline const std::vector<std::vector<double>> &r0ab() { return r0ab_; }
@@ -61,8 +67,11 @@ class Vdwd3Parameters : public VdwParameters
     static constexpr double k1_ = 16.0, k2_ = 4.0 / 3.0, k3_ = -4.0;
     static constexpr double alp6_ = 14.0, alp8_ = alp6_ + 2, alp10_ = alp8_ + 2;
 
-    std::vector<int> mxc_;
-    std::vector<std::vector<std::vector<std::vector<std::vector<double>>>>> c6ab_;
+    // the reference C6 table depends neither on the input nor on the structure, so it is built
+    // by the first call of initial_parameters() and kept for the following calls of make_vdw().
+    static std::vector<int> mxc_;
+    // [3][5][5][max_elem_][max_elem_], identical on all processes, so it is kept once per node
+    static ModuleBase::Shared_Memory c6ab_;
     std::vector<double> r2r4_;
     std::vector<double> rcov_;
     std::vector<std::vector<double>> r0ab_;
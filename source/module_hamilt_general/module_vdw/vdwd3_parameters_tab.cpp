@@ -32413,14 +32413,24 @@ void Vdwd3Parameters::init_C6()
         mxc_[iat] = std::max(mxc_[iat], iatcn);
         mxc_[jat] = std::max(mxc_[jat], jatcn);
 
-        c6ab_[0][jatcn - 1][iatcn - 1][jat][iat] = C6_tmp[k];
-        c6ab_[1][jatcn - 1][iatcn - 1][jat][iat] = C6_tmp[k + 3];
-        c6ab_[2][jatcn - 1][iatcn - 1][jat][iat] = C6_tmp[k + 4];
+        // the shared table is written by one process of each node
+        if (c6ab_.node_rank() != 0)
+        {
+            continue;
+        }
+        double* c6ab = c6ab_.data();
+        const size_t stride = max_elem_ * max_elem_;
+        const size_t ji = (jatcn - 1) * 5 + (iatcn - 1);
+        const size_t ij = (iatcn - 1) * 5 + (jatcn - 1);
+        c6ab[(0 * 25 + ji) * stride + jat * max_elem_ + iat] = C6_tmp[k];
+        c6ab[(1 * 25 + ji) * stride + jat * max_elem_ + iat] = C6_tmp[k + 3];
+        c6ab[(2 * 25 + ji) * stride + jat * max_elem_ + iat] = C6_tmp[k + 4];
 
-        c6ab_[0][iatcn - 1][jatcn - 1][iat][jat] = C6_tmp[k];
-        c6ab_[1][iatcn - 1][jatcn - 1][iat][jat] = C6_tmp[k + 4];
-        c6ab_[2][iatcn - 1][jatcn - 1][iat][jat] = C6_tmp[k + 3];
+        c6ab[(0 * 25 + ij) * stride + iat * max_elem_ + jat] = C6_tmp[k];
+        c6ab[(1 * 25 + ij) * stride + iat * max_elem_ + jat] = C6_tmp[k + 4];
+        c6ab[(2 * 25 + ij) * stride + iat * max_elem_ + jat] = C6_tmp[k + 3];
     }
+    c6ab_.sync();
 }
 
 void Vdwd3Parameters::init_r2r4()
@@ -163,9 +163,9 @@ void XC_Functional::set_xc_type(const std::string xc_func_in)
 		std::cerr << "\n OPTX untested please test,";
 	}
 
-    if((func_type == 4 || func_type == 5) && GlobalV::BASIS_TYPE == "pw")
+    if(func_type == 5 && GlobalV::BASIS_TYPE == "pw")
     {
-        ModuleBase::WARNING_QUIT("set_xc_type","hybrid functional not realized for planewave yet");
+        ModuleBase::WARNING_QUIT("set_xc_type","meta-GGA hybrid functional not realized for planewave yet");
     }
     if((func_type == 3 || func_type == 5) && GlobalV::NSPIN==4)
     {
@@ -46,7 +46,8 @@ class XC_Functional
     static std::tuple<double,double,ModuleBase::matrix> v_xc(
 		const int &nrxx, // number of real-space grid
 		const Charge* const chr,
-		const UnitCell *ucell); // charge density
+		const UnitCell *ucell, // charge density
+		const bool use_rhog = false); // chr->rhog is already rho in G space, used in gradcorr
 
 	// using libxc
     static std::tuple<double,double,ModuleBase::matrix> v_xc_libxc(
@@ -196,7 +197,7 @@ class XC_Functional
 
 	static void gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 		const Charge* const chr, ModulePW::PW_Basis* rhopw, const UnitCell *ucell,
-		std::vector<double> &stress_gga, const bool is_stress = 0);
+		std::vector<double> &stress_gga, const bool is_stress = 0, const bool use_rhog = 0);
 	static void grad_wfc( const std::complex<double> *rhog, const int ik,
 		std::complex<double> **grad, ModulePW::PW_Basis_K *wfc_basis, const double tpiba);
     static void grad_rho(const std::complex<double>* rhog,
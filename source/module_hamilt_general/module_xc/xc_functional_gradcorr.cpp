@@ -14,7 +14,7 @@
 // from gradcorr.f90
 void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 	const Charge* const chr, ModulePW::PW_Basis* rhopw, const UnitCell *ucell,
-	std::vector<double> &stress_gga, const bool is_stress)
+	std::vector<double> &stress_gga, const bool is_stress, const bool use_rhog)
 {
 	ModuleBase::TITLE("XC_Functional","gradcorr");
 	
@@ -40,10 +40,14 @@ void XC_Functional::gradcorr(double &etxc, double &vtxc, ModuleBase::matrix &v,
 	}
 
 	// doing FFT to get rho in G space: rhog1 
-    rhopw->real2recip(chr->rho[0], chr->rhog[0]);
-	if(GlobalV::NSPIN==2)//mohan fix bug 2012-05-28
+	// unless it has been done by the caller, e.g. Potential
+	if(!use_rhog)
 	{
-		rhopw->real2recip(chr->rho[1], chr->rhog[1]);
+		rhopw->real2recip(chr->rho[0], chr->rhog[0]);
+		if(GlobalV::NSPIN==2)//mohan fix bug 2012-05-28
+		{
+			rhopw->real2recip(chr->rho[1], chr->rhog[1]);
+		}
 	}
     rhopw->real2recip(chr->rho_core, chr->rhog_core);
 		
@@ -13,7 +13,8 @@
 std::tuple<double,double,ModuleBase::matrix> XC_Functional::v_xc(
 	const int &nrxx, // number of real-space grid
     const Charge* const chr,
-    const UnitCell *ucell) // core charge density
+    const UnitCell *ucell, // core charge density
+    const bool use_rhog)
 {
     ModuleBase::TITLE("XC_Functional","v_xc");
     ModuleBase::timer::tick("XC_Functional","v_xc");
@@ -160,7 +161,7 @@ std::tuple<double,double,ModuleBase::matrix> XC_Functional::v_xc(
     // the dummy variable dum contains gradient correction to stress
     // which is not used here
     std::vector<double> dum;
-    gradcorr(etxc, vtxc, v, chr, chr->rhopw, ucell, dum);
+    gradcorr(etxc, vtxc, v, chr, chr->rhopw, ucell, dum, false, use_rhog);
 
     // parallel code : collect vtxc,etxc
     // mohan add 2008-06-01
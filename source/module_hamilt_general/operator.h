@@ -16,6 +16,7 @@ enum calculation_type
     pw_nonlocal,
     pw_veff,
     pw_meta,
+    pw_exx,
     lcao_fixed,
     lcao_gint,
     lcao_deepks,
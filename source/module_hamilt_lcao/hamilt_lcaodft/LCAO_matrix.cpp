@@ -111,6 +111,9 @@ void LCAO_Matrix::allocate_HS_k(const long &nloc)
 
 void LCAO_Matrix::allocate_HS_R(const int &nnR)
 {
+    // the adjacent atoms may have changed
+    this->clear_folding_index();
+
     if(GlobalV::NSPIN!=4)
     {	
         this->SlocR.resize(nnR);
@@ -28,6 +28,9 @@ class LCAO_Matrix
                         const std::vector<ModuleBase::Vector3<double>>& kvec_d, 
                         bool cal_syns = false);
 
+    // forget the index of folding_fixedH after the atoms moved
+    void clear_folding_index();
+
     Parallel_Orbitals *ParaV;
     
 #ifdef __EXX
@@ -42,6 +45,32 @@ private:
 
     void allocate_HS_gamma(const long &nloc);
 
+    //------------------------------
+    // index used by folding_fixedH,
+    // one record for each adjacent
+    // atom pair (atom1, atom2, R),
+    // kept during one ionic step.
+    //------------------------------
+    struct Folding_Pair
+    {
+        int start1; // global index of the first orbital of atom1
+        int nw1; // number of orbitals of atom1 (with NPOL)
+        int start2;
+        int nw2;
+        int index; // position of the first element of this pair in SlocR
+        int iR; // index of the cell R in folding_boxes
+    };
+    std::vector<Folding_Pair> folding_pairs;
+    std::vector<int> folding_pair_begin; // pairs of atom iat: [folding_pair_begin[iat], folding_pair_begin[iat+1])
+    std::vector<ModuleBase::Vector3<int>> folding_boxes; // different R of all pairs
+    std::vector<std::complex<double>> folding_phase; // exp(i 2pi k.R), [nks][nR]
+    std::vector<ModuleBase::Vector3<double>> folding_kvec_d; // k points used in folding_phase
+
+    void build_folding_index(std::vector<Folding_Pair> &pairs,
+                        std::vector<int> &pair_begin,
+                        std::vector<ModuleBase::Vector3<int>> &boxes,
+                        bool cal_syns) const;
+
 
     public:
     //------------------------------
@@ -317,222 +317,304 @@ int Grid_Technique::binary_search_find_R2_offset(int val, int iat) const
 }
 
 // be called in LCAO_Hamilt::calculate_Hk.
-void LCAO_Matrix::folding_fixedH(
-						const int &ik, 
-						const std::vector<ModuleBase::Vector3<double>>& kvec_d,
-						bool cal_syns)
-{
-	ModuleBase::TITLE("LCAO_nnr","folding_fixedH");
-    ModuleBase::timer::tick("LCAO_nnr", "folding_fixedH");
-    const Parallel_Orbitals* pv = this->ParaV;
-
-	int tot_index = 0;
-#ifdef _OPENMP
-#pragma omp parallel reduction(+:tot_index)
+// The adjacent atom pairs, their cell index R and the position of
+// their elements in SlocR only depend on the geometry, so they are
+// searched once per ionic step instead of once per k point.
+void LCAO_Matrix::build_folding_index(std::vector<Folding_Pair> &pairs,
+						std::vector<int> &pair_begin,
+						std::vector<ModuleBase::Vector3<int>> &boxes,
+						bool cal_syns) const
 {
-	const int num_threads = omp_get_num_threads();
-	const int thread_id = omp_get_thread_num();
-#else
-	const int num_threads = 1;
-	const int thread_id = 0;
-#endif
-	ModuleBase::Vector3<double> dtau;
-	ModuleBase::Vector3<double> tau1;
-	ModuleBase::Vector3<double> tau2;
+	ModuleBase::TITLE("LCAO_nnr","build_folding_index");
+	ModuleBase::timer::tick("LCAO_nnr", "build_folding_index");
+	const Parallel_Orbitals* pv = this->ParaV;
+	const int nat = GlobalC::ucell.nat;
 
-	ModuleBase::Vector3<double> dtau1;
-	ModuleBase::Vector3<double> dtau2;
-	ModuleBase::Vector3<double> tau0;
-
-#ifdef __DEEPKS
-	if (GlobalV::deepks_scf)
-    {
-		int beg, len;
-		ModuleBase::BLOCK_TASK_DIST_1D(num_threads, thread_id, (int)pv->nloc, 1024, beg, len);
-		ModuleBase::GlobalFunc::ZEROS(GlobalC::ld.H_V_delta_k[ik] + beg, len);
-	}
-#endif
+	std::vector<std::vector<Folding_Pair>> pairs_atom(nat);
+	std::vector<std::vector<ModuleBase::Vector3<int>>> boxes_atom(nat);
 
+	int tot_index = 0;
 #ifdef _OPENMP
-#pragma omp for schedule(dynamic)
+#pragma omp parallel for schedule(dynamic) reduction(+:tot_index)
 #endif
-	for (int iat=0; iat<GlobalC::ucell.nat; ++iat)
+	for (int iat=0; iat<nat; ++iat)
 	{
 		const int T1 = GlobalC::ucell.iat2it[iat];
-		Atom* atom1 = &GlobalC::ucell.atoms[T1];
 		const int I1 = GlobalC::ucell.iat2ia[iat];
+		Atom* atom1 = &GlobalC::ucell.atoms[T1];
+		ModuleBase::Vector3<double> tau1 = atom1->tau[I1];
+		AdjacentAtomInfo adjs;
+		GlobalC::GridD.Find_atom(GlobalC::ucell, tau1, T1, I1, &adjs);
+		const int start = GlobalC::ucell.itiaiw2iwt(T1,I1,0);
+		int index = pv->nlocstart[iat];
+
+		if (cal_syns)
 		{
-			tau1 = atom1->tau[I1];
-			//GlobalC::GridD.Find_atom(tau1);
-			AdjacentAtomInfo adjs;
-			GlobalC::GridD.Find_atom(GlobalC::ucell, tau1, T1, I1, &adjs);
-			Atom* atom1 = &GlobalC::ucell.atoms[T1];
-			const int start = GlobalC::ucell.itiaiw2iwt(T1,I1,0);
-			int index = pv->nlocstart[iat];
-
-			if (cal_syns)
-            {
-                for (int k = 0; k < 3; k++)
-                {
-                    tau1[k] = tau1[k] - atom1->vel[I1][k] * INPUT.mdp.md_dt / GlobalC::ucell.lat0 ;
-                }
-            }
-
-			// (2) search among all adjacent atoms.
-			for (int ad = 0; ad < adjs.adj_num+1; ++ad)
+			for (int k = 0; k < 3; k++)
 			{
-				const int T2 = adjs.ntype[ad];
-				const int I2 = adjs.natom[ad];
-				Atom* atom2 = &GlobalC::ucell.atoms[T2];
+				tau1[k] = tau1[k] - atom1->vel[I1][k] * INPUT.mdp.md_dt / GlobalC::ucell.lat0 ;
+			}
+		}
 
-				tau2 = adjs.adjacent_tau[ad];
-				dtau = tau2 - tau1;
-				double distance = dtau.norm() * GlobalC::ucell.lat0;
-				double rcut = GlobalC::ORB.Phi[T1].getRcut() + GlobalC::ORB.Phi[T2].getRcut();
+		// local rows of atom1 in this processor
+		int nrow1 = 0;
+		for(int ii=0; ii<atom1->nw*GlobalV::NPOL; ii++)
+		{
+			if(pv->trace_loc_row[start + ii] >= 0) ++nrow1;
+		}
 
-				bool adj = false;
+		// (2) search among all adjacent atoms.
+		for (int ad = 0; ad < adjs.adj_num+1; ++ad)
+		{
+			const int T2 = adjs.ntype[ad];
+			const int I2 = adjs.natom[ad];
+			Atom* atom2 = &GlobalC::ucell.atoms[T2];
 
-				if(distance < rcut) 
-				{
-					adj = true;
-				}
-				else if(distance >= rcut)
+			const ModuleBase::Vector3<double> tau2 = adjs.adjacent_tau[ad];
+			const ModuleBase::Vector3<double> dtau = tau2 - tau1;
+			double distance = dtau.norm() * GlobalC::ucell.lat0;
+			double rcut = GlobalC::ORB.Phi[T1].getRcut() + GlobalC::ORB.Phi[T2].getRcut();
+
+			bool adj = false;
+
+			if(distance < rcut) 
+			{
+				adj = true;
+			}
+			else if(distance >= rcut)
+			{
+				for (int ad0 = 0; ad0 < adjs.adj_num+1; ++ad0)
 				{
-					for (int ad0 = 0; ad0 < adjs.adj_num+1; ++ad0)
-					{
-						const int T0 = adjs.ntype[ad0]; 
-						const int I0 = adjs.natom[ad0]; 
-						//const int iat0 = GlobalC::ucell.itia2iat(T0, I0);
-						//const int start0 = GlobalC::ucell.itiaiw2iwt(T0, I0, 0);
+					const int T0 = adjs.ntype[ad0]; 
 
-						tau0 = adjs.adjacent_tau[ad0];
-						dtau1 = tau0 - tau1;
-						dtau2 = tau0 - tau2;
+					const ModuleBase::Vector3<double> tau0 = adjs.adjacent_tau[ad0];
+					const ModuleBase::Vector3<double> dtau1 = tau0 - tau1;
+					const ModuleBase::Vector3<double> dtau2 = tau0 - tau2;
 
-						double distance1 = dtau1.norm() * GlobalC::ucell.lat0;
-						double distance2 = dtau2.norm() * GlobalC::ucell.lat0;
+					double distance1 = dtau1.norm() * GlobalC::ucell.lat0;
+					double distance2 = dtau2.norm() * GlobalC::ucell.lat0;
 
-						double rcut1 = GlobalC::ORB.Phi[T1].getRcut() + GlobalC::ucell.infoNL.Beta[T0].get_rcut_max();
-						double rcut2 = GlobalC::ORB.Phi[T2].getRcut() + GlobalC::ucell.infoNL.Beta[T0].get_rcut_max();
+					double rcut1 = GlobalC::ORB.Phi[T1].getRcut() + GlobalC::ucell.infoNL.Beta[T0].get_rcut_max();
+					double rcut2 = GlobalC::ORB.Phi[T2].getRcut() + GlobalC::ucell.infoNL.Beta[T0].get_rcut_max();
 
-						if( distance1 < rcut1 && distance2 < rcut2 )
-						{
-							adj = true;
-							break;
-						}
+					if( distance1 < rcut1 && distance2 < rcut2 )
+					{
+						adj = true;
+						break;
 					}
 				}
+			}
 
-				if(adj) // mohan fix bug 2011-06-26, should not be '<='
+			if(adj) // mohan fix bug 2011-06-26, should not be '<='
+			{
+				Folding_Pair pair;
+				pair.start1 = start;
+				pair.nw1 = atom1->nw*GlobalV::NPOL;
+				pair.start2 = GlobalC::ucell.itiaiw2iwt(T2,I2,0);
+				pair.nw2 = atom2->nw*GlobalV::NPOL;
+				pair.index = index;
+				pair.iR = -1;
+
+				int ncol2 = 0;
+				for(int jj=0; jj<pair.nw2; jj++)
 				{
-					// (3) calculate the nu of atom (T2, I2)
-					const int start2 = GlobalC::ucell.itiaiw2iwt(T2,I2,0);
-					//------------------------------------------------
-					// exp(k dot dR)
-					// dR is the index of box in Crystal coordinates
-					//------------------------------------------------
-					ModuleBase::Vector3<double> dR(adjs.box[ad].x, adjs.box[ad].y, adjs.box[ad].z); 
-					const double arg = ( kvec_d[ik] * dR ) * ModuleBase::TWO_PI;
-					//const double arg = ( kvec_d[ik] * GlobalC::GridD.getBox(ad) ) * ModuleBase::TWO_PI;
+					if(pv->trace_loc_col[pair.start2 + jj] >= 0) ++ncol2;
+				}
+				index += nrow1 * ncol2;
+				tot_index += nrow1 * ncol2;
+
+				pairs_atom[iat].push_back(pair);
+				boxes_atom[iat].push_back(ModuleBase::Vector3<int>(adjs.box[ad].x, adjs.box[ad].y, adjs.box[ad].z));
+			}
+		}// end ad
+	}// end iat
+	assert(tot_index==this->ParaV->nnr);
+
+	// flatten the pairs and give each different R an index
+	pairs.clear();
+	boxes.clear();
+	pair_begin.assign(nat+1, 0);
+	std::map<Abfs::Vector3_Order<int>, int> box_index;
+	for (int iat=0; iat<nat; ++iat)
+	{
+		for (size_t ip = 0; ip < pairs_atom[iat].size(); ++ip)
+		{
+			const ModuleBase::Vector3<int> &box = boxes_atom[iat][ip];
+			auto it = box_index.find(box);
+			if (it == box_index.end())
+			{
+				it = box_index.insert(std::make_pair(Abfs::Vector3_Order<int>(box), static_cast<int>(boxes.size()))).first;
+				boxes.push_back(box);
+			}
+			pairs.push_back(pairs_atom[iat][ip]);
+			pairs.back().iR = it->second;
+		}
+		pair_begin[iat+1] = pairs.size();
+	}
+
+	ModuleBase::timer::tick("LCAO_nnr", "build_folding_index");
+	return;
+}
+
+
+void LCAO_Matrix::clear_folding_index()
+{
+	this->folding_pairs.clear();
+	this->folding_pair_begin.clear();
+	this->folding_boxes.clear();
+	this->folding_phase.clear();
+	this->folding_kvec_d.clear();
+}
+
+
+void LCAO_Matrix::folding_fixedH(
+						const int &ik, 
+						const std::vector<ModuleBase::Vector3<double>>& kvec_d,
+						bool cal_syns)
+{
+	ModuleBase::TITLE("LCAO_nnr","folding_fixedH");
+    ModuleBase::timer::tick("LCAO_nnr", "folding_fixedH");
+    const Parallel_Orbitals* pv = this->ParaV;
+
+	// the asynchronous overlap uses shifted atoms, its index is not kept
+	std::vector<Folding_Pair> pairs_syns;
+	std::vector<int> pair_begin_syns;
+	std::vector<ModuleBase::Vector3<int>> boxes_syns;
+	if (cal_syns)
+	{
+		this->build_folding_index(pairs_syns, pair_begin_syns, boxes_syns, true);
+	}
+	else if (this->folding_pair_begin.empty())
+	{
+		this->build_folding_index(this->folding_pairs, this->folding_pair_begin, this->folding_boxes, false);
+		this->folding_phase.clear();
+	}
+	const std::vector<Folding_Pair> &pairs = cal_syns ? pairs_syns : this->folding_pairs;
+	const std::vector<int> &pair_begin = cal_syns ? pair_begin_syns : this->folding_pair_begin;
+	const std::vector<ModuleBase::Vector3<int>> &boxes = cal_syns ? boxes_syns : this->folding_boxes;
+
+	//------------------------------------------------
+	// exp(k dot dR) for all the k points and all R,
+	// dR is the index of box in Crystal coordinates
+	//------------------------------------------------
+	const int nR = boxes.size();
+	std::vector<std::complex<double>> phase_syns;
+	const std::complex<double>* kphase_R = nullptr;
+	if (cal_syns)
+	{
+		phase_syns.resize(nR);
+		for (int iR = 0; iR < nR; ++iR)
+		{
+			const ModuleBase::Vector3<double> dR(boxes[iR].x, boxes[iR].y, boxes[iR].z);
+			const double arg = ( kvec_d[ik] * dR ) * ModuleBase::TWO_PI;
+			double sinp, cosp;
+			ModuleBase::libm::sincos(arg, &sinp, &cosp);
+			phase_syns[iR] = std::complex<double>(cosp, sinp);
+		}
+		kphase_R = phase_syns.data();
+	}
+	else
+	{
+		if (this->folding_kvec_d != kvec_d || this->folding_phase.empty())
+		{
+			this->folding_kvec_d = kvec_d;
+			const int nks = kvec_d.size();
+			this->folding_phase.resize(static_cast<size_t>(nks) * nR);
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+			for (int jk = 0; jk < nks; ++jk)
+			{
+				for (int iR = 0; iR < nR; ++iR)
+				{
+					const ModuleBase::Vector3<double> dR(boxes[iR].x, boxes[iR].y, boxes[iR].z);
+					const double arg = ( kvec_d[jk] * dR ) * ModuleBase::TWO_PI;
 					double sinp, cosp;
 					ModuleBase::libm::sincos(arg, &sinp, &cosp);
-					const std::complex<double> kphase = std::complex <double> ( cosp,  sinp );
-
-					//--------------------------------------------------
-					// calculate how many matrix elements are in 
-					// this processor.
-					//--------------------------------------------------
-					//########################### EXPLAIN ###############################
-					// 1. overlap matrix with k point
-					// this->SlocR = < phi_0i | phi_Rj >, where 0, R are the cell index
-					// while i,j are the orbital index.
-
-					// 2. H_fixed=T+Vnl matrix element with k point (if Vna is not used).
-					// H_fixed=T+Vnl+Vna matrix element with k point (if Vna is used).
-					// this->Hloc_fixed = < phi_0i | H_fixed | phi_Rj>
-
-					// 3. H(k) |psi(k)> = S(k) | psi(k)> 
-					// Sloc2 is used to diagonalize for a give k point.
-					// Hloc_fixed2 is used to diagonalize (eliminate index R).
-					//###################################################################
-#define NW_IJ_LOOP_BEGIN() \
-					for(int ii=0; ii<atom1->nw*GlobalV::NPOL; ii++)				\
-					{															\
-						/* the index of orbitals in this processor */			\
-						const int iw1_all = start + ii;							\
-						const int mu = pv->trace_loc_row[iw1_all];				\
-						if(mu<0) {continue;}									\
-						for(int jj=0; jj<atom2->nw*GlobalV::NPOL; jj++)			\
-						{														\
-							int iw2_all = start2 + jj;							\
-							const int nu = pv->trace_loc_col[iw2_all];			\
-							if(nu<0) {continue;}
-
-								// DO STH.
-
-#define NW_IJ_LOOP_END() \
-							++index;											\
-							++tot_index;										\
-						}/*end jj*/												\
-					}/*end ii*/
+					this->folding_phase[static_cast<size_t>(jk) * nR + iR] = std::complex<double>(cosp, sinp);
+				}
+			}
+		}
+		kphase_R = this->folding_phase.data() + static_cast<size_t>(ik) * nR;
+	}
+
+#ifdef __DEEPKS
+	if (GlobalV::deepks_scf)
+    {
+		ModuleBase::GlobalFunc::ZEROS(GlobalC::ld.H_V_delta_k[ik], pv->nloc);
+	}
+#endif
 
+	//########################### EXPLAIN ###############################
+	// 1. overlap matrix with k point
+	// this->SlocR = < phi_0i | phi_Rj >, where 0, R are the cell index
+	// while i,j are the orbital index.
+
+	// 2. H_fixed=T+Vnl matrix element with k point (if Vna is not used).
+	// H_fixed=T+Vnl+Vna matrix element with k point (if Vna is used).
+	// this->Hloc_fixed = < phi_0i | H_fixed | phi_Rj>
+
+	// 3. H(k) |psi(k)> = S(k) | psi(k)> 
+	// Sloc2 is used to diagonalize for a give k point.
+	// Hloc_fixed2 is used to diagonalize (eliminate index R).
+	//###################################################################
+	const bool column_major = ModuleBase::GlobalFunc::IS_COLUMN_MAJOR_KS_SOLVER();
+	const int nat = GlobalC::ucell.nat;
+
+	// different atoms give different rows, the threads never write the same element
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int iat=0; iat<nat; ++iat)
+	{
+		for (int ip = pair_begin[iat]; ip < pair_begin[iat+1]; ++ip)
+		{
+			const Folding_Pair &pair = pairs[ip];
+			const std::complex<double> kphase = kphase_R[pair.iR];
+			int index = pair.index;
+			for(int ii=0; ii<pair.nw1; ii++)
+			{
+				/* the index of orbitals in this processor */
+				const int iw1_all = pair.start1 + ii;
+				const int mu = pv->trace_loc_row[iw1_all];
+				if(mu<0) {continue;}
+				for(int jj=0; jj<pair.nw2; jj++)
+				{
+					const int iw2_all = pair.start2 + jj;
+					const int nu = pv->trace_loc_col[iw2_all];
+					if(nu<0) {continue;}
+
+					const int iic = column_major ? mu+nu*pv->nrow : mu*pv->ncol+nu;
 					if(GlobalV::NSPIN!=4)
 					{
-						auto compute_kernel = [&](int iic, int index) {
-							this->Sloc2[iic] += this->SlocR[index] * kphase;
-							this->Hloc_fixed2[iic] += this->Hloc_fixedR[index] * kphase;
+						this->Sloc2[iic] += this->SlocR[index] * kphase;
+						this->Hloc_fixed2[iic] += this->Hloc_fixedR[index] * kphase;
 #ifdef __DEEPKS
-							if(GlobalV::deepks_scf)
-							{
-								GlobalC::ld.H_V_delta_k[ik][iic] += GlobalC::ld.H_V_deltaR[index] * kphase;
-							}
-#endif
-						};
-						if (ModuleBase::GlobalFunc::IS_COLUMN_MAJOR_KS_SOLVER())
+						if(GlobalV::deepks_scf)
 						{
-							NW_IJ_LOOP_BEGIN()
-							compute_kernel(mu+nu*pv->nrow, index);
-							NW_IJ_LOOP_END()
-						} else {
-							NW_IJ_LOOP_BEGIN()
-							compute_kernel(mu*pv->ncol+nu, index);
-							NW_IJ_LOOP_END()
+							GlobalC::ld.H_V_delta_k[ik][iic] += GlobalC::ld.H_V_deltaR[index] * kphase;
 						}
+#endif
 					}
 					else
 					{
-						auto compute_kernel = [&](int iic, int index, int iw1_all, int iw2_all) {
-							this->Sloc2[iic] += this->SlocR_soc[index] * kphase;
-							this->Hloc_fixed2[iic] += this->Hloc_fixedR_soc[index] * kphase;
+						this->Sloc2[iic] += this->SlocR_soc[index] * kphase;
+						this->Hloc_fixed2[iic] += this->Hloc_fixedR_soc[index] * kphase;
 #ifdef __DEEPKS
-							if(GlobalV::deepks_scf)
+						if(GlobalV::deepks_scf)
+						{
+							if (iw1_all % 2 == iw2_all % 2)
 							{
-								if (iw1_all % 2 == iw2_all % 2)
-								{
-									GlobalC::ld.H_V_delta_k[ik][iic] += GlobalC::ld.H_V_deltaR[index] * kphase;
-								}
+								GlobalC::ld.H_V_delta_k[ik][iic] += GlobalC::ld.H_V_deltaR[index] * kphase;
 							}
-#endif
-						};
-						if (ModuleBase::GlobalFunc::IS_COLUMN_MAJOR_KS_SOLVER())
-						{
-							NW_IJ_LOOP_BEGIN()
-							compute_kernel(mu+nu*pv->nrow, index, iw1_all, iw2_all);
-							NW_IJ_LOOP_END()
-						} else {
-							NW_IJ_LOOP_BEGIN()
-							compute_kernel(mu*pv->ncol+nu, index, iw1_all, iw2_all);
-							NW_IJ_LOOP_END()
 						}
-					}
-				}
-			}// end ad
-		}// end I1
-	} // end T1
-#ifdef _OPENMP
-}
 #endif
-	assert(tot_index==this->ParaV->nnr);
+					}
+					++index;
+				}/*end jj*/
+			}/*end ii*/
+		}// end pairs of iat
+	}// end iat
 
 	ModuleBase::timer::tick("LCAO_nnr","folding_fixedH");
 	return;
@@ -0,0 +1,149 @@
+#include "dm_mixing.h"
+
+#include "module_base/blas_connector.h"
+#include "module_base/global_variable.h"
+#include "module_base/lapack_connector.h"
+#include "module_base/memory.h"
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+#include "module_base/tool_title.h"
+
+#include <algorithm>
+
+void DM_Mixing::reset()
+{
+    this->nhist = 0;
+    this->ihist = -1;
+    this->last_iter = -1;
+}
+
+bool DM_Mixing::mix(const int iter, double** dm, const int nspin, const int n, const int ndim_in, const double beta)
+{
+    ModuleBase::TITLE("DM_Mixing", "mix");
+
+    // the history is only valid if the input density matrix of this step was given by the last call,
+    // which is decided in the same way on all processes
+    if (this->last_iter != iter - 1 || this->ndim != std::max(ndim_in, 1))
+    {
+        this->nelem = nspin * n;
+        this->ndim = std::max(ndim_in, 1);
+        this->dm_in.resize(this->nelem);
+        this->xs.resize(static_cast<size_t>(this->nelem) * this->ndim);
+        this->fs.resize(static_cast<size_t>(this->nelem) * this->ndim);
+        this->ff.create(this->ndim, this->ndim);
+        ModuleBase::Memory::record("DM_Mixing::history", sizeof(double) * this->nelem * (2 * this->ndim + 1));
+        for (int is = 0; is < nspin; ++is)
+        {
+            std::copy(dm[is], dm[is] + n, this->dm_in.data() + is * n);
+        }
+        this->nhist = 0;
+        this->ihist = -1;
+        this->last_iter = iter;
+        return false;
+    }
+
+    ModuleBase::timer::tick("DM_Mixing", "mix");
+
+    this->ihist = (this->ihist + 1) % this->ndim;
+    this->nhist = std::min(this->nhist + 1, this->ndim);
+    double* x = this->xs.data() + static_cast<size_t>(this->ihist) * this->nelem;
+    double* f = this->fs.data() + static_cast<size_t>(this->ihist) * this->nelem;
+    for (int is = 0; is < nspin; ++is)
+    {
+        const double* in = this->dm_in.data() + is * n;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1024)
+#endif
+        for (int i = 0; i < n; ++i)
+        {
+            x[is * n + i] = in[i];
+            f[is * n + i] = dm[is][i] - in[i];
+        }
+    }
+
+    // only the overlaps of the new residual with the history are calculated, the others are kept in ff
+    const int lda = std::max(this->nelem, 1);
+    const int inc = 1;
+    const double one = 1.0, zero = 0.0;
+    std::vector<double> overlap(this->nhist);
+    dgemv_("T", &this->nelem, &this->nhist, &one, this->fs.data(), &lda, f, &inc, &zero, overlap.data(), &inc);
+    Parallel_Reduce::reduce_double_pool(overlap.data(), this->nhist);
+    for (int i = 0; i < this->nhist; ++i)
+    {
+        this->ff(i, this->ihist) = overlap[i];
+        this->ff(this->ihist, i) = overlap[i];
+    }
+
+    // Pulay coefficients c = A^{-1}|1> / <1|A^{-1}|1> with A_ij = <F_i|F_j>
+    std::vector<double> coef(this->nhist, 0.0);
+    ModuleBase::matrix ainv(this->nhist, this->nhist, false);
+    for (int i = 0; i < this->nhist; ++i)
+    {
+        for (int j = 0; j < this->nhist; ++j)
+        {
+            ainv(i, j) = this->ff(i, j);
+        }
+    }
+    std::vector<double> work(this->nhist);
+    std::vector<int> iwork(this->nhist);
+    char uu = 'U';
+    int info = 0;
+    dsytrf_(&uu, &this->nhist, ainv.c, &this->nhist, iwork.data(), work.data(), &this->nhist, &info);
+    if (info == 0)
+    {
+        dsytri_(&uu, &this->nhist, ainv.c, &this->nhist, iwork.data(), work.data(), &info);
+    }
+    double norm = 0.0;
+    if (info == 0)
+    {
+        for (int i = 0; i < this->nhist; ++i)
+        {
+            for (int j = i + 1; j < this->nhist; ++j)
+            {
+                ainv(i, j) = ainv(j, i);
+            }
+        }
+        for (int i = 0; i < this->nhist; ++i)
+        {
+            for (int j = 0; j < this->nhist; ++j)
+            {
+                coef[i] += ainv(i, j);
+            }
+            norm += coef[i];
+        }
+    }
+    const bool singular = (info != 0 || norm == 0.0);
+    if (singular)
+    {
+        // the residuals are linearly dependent, restart the history from a linear mixing of this step
+        GlobalV::ofs_warning << " DM_Mixing: singular Pulay matrix, restart the history" << std::endl;
+        std::fill(coef.begin(), coef.end(), 0.0);
+        coef[this->ihist] = 1.0;
+        norm = 1.0;
+    }
+    for (int i = 0; i < this->nhist; ++i)
+    {
+        coef[i] /= norm;
+    }
+
+    // DM_in = sum_i c_i (X_i + beta F_i)
+    dgemv_("N", &this->nelem, &this->nhist, &one, this->xs.data(), &lda, coef.data(), &inc, &zero, this->dm_in.data(), &inc);
+    for (int i = 0; i < this->nhist; ++i)
+    {
+        coef[i] *= beta;
+    }
+    dgemv_("N", &this->nelem, &this->nhist, &one, this->fs.data(), &lda, coef.data(), &inc, &one, this->dm_in.data(), &inc);
+    for (int is = 0; is < nspin; ++is)
+    {
+        std::copy(this->dm_in.data() + is * n, this->dm_in.data() + (is + 1) * n, dm[is]);
+    }
+
+    if (singular)
+    {
+        this->nhist = 0;
+        this->ihist = -1;
+    }
+    this->last_iter = iter;
+    ModuleBase::timer::tick("DM_Mixing", "mix");
+    return true;
+}
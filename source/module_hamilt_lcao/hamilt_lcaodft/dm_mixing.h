@@ -0,0 +1,45 @@
+#ifndef DM_MIXING_H
+#define DM_MIXING_H
+
+#include "module_base/matrix.h"
+
+#include <vector>
+
+/**
+ * @brief Pulay mixing of the density matrix on the grid, i.e. DM(R) in the atom-pair format of Gint_k for multi-k
+ * and the local DM of Gint_Gamma for gamma_only.
+ *
+ * The history keeps the input density matrices and the residuals DM_out - DM_in of the last mixing_ndim steps.
+ * Only the mixed density matrix has to be integrated on the grid to get the charge density of the next step.
+ */
+class DM_Mixing
+{
+  public:
+    DM_Mixing(){};
+    ~DM_Mixing(){};
+
+    /// @brief clear the history, called at the first step of each SCF
+    void reset();
+
+    /**
+     * @brief replace the output density matrix of step iter by the input one of the next step
+     *
+     * @param dm dm[is] (is < nspin) points to n doubles: the output density matrix on input, the mixed one on output
+     * @return false if the history is restarted, then dm is kept unchanged as the input of the next step
+     */
+    bool mix(const int iter, double** dm, const int nspin, const int n, const int ndim_in, const double beta);
+
+  private:
+    int nelem = 0;      // nspin * n
+    int ndim = 0;       // maximal number of steps in the history
+    int nhist = 0;      // number of steps in the history
+    int ihist = -1;     // the column of the newest step
+    int last_iter = -1; // dm_in is the input density matrix of step last_iter + 1
+
+    std::vector<double> dm_in; // input density matrix of the current step, dim=nelem
+    // input density matrices and residuals of the history, one column of nelem for each step, dim=nelem*ndim
+    std::vector<double> xs, fs;
+    ModuleBase::matrix ff; // <F_i|F_j> of the history, dim=ndim*ndim
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include "module_hsolver/hsolver_lcao.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 
+#include "module_hsolver/diago_blas.h"
 #ifdef __ELPA
 #include "module_hsolver/diago_elpa.h"
 #endif
@@ -38,6 +39,15 @@ void OperatorLCAO<std::complex<double>>::get_hs_pointers()
 {
     this->hmatrix_k = this->LM->Hloc2.data();
     this->smatrix_k = this->LM->Sloc2.data();
+    // a new Hamiltonian is built for each geometry, the saved decomposition of S(k) is out of date
+    if (this->new_e_iteration && ik == 0)
+    {
+#ifdef __ELPA
+        hsolver::DiagoElpa::reset_decomposed_sk();
+#endif
+        hsolver::DiagoBlas::reset_decomposed_sk();
+        this->new_e_iteration = false;
+    }
 }
 
 template<>
@@ -0,0 +1,167 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "module_base/global_variable.h"
+#include "module_base/parallel_global.h"
+#define private public
+#include "module_hamilt_lcao/hamilt_lcaodft/dm_mixing.h"
+#undef private
+
+/************************************************
+ *  unit test of class DM_Mixing
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - mix
+ *     - the first call keeps the density matrix as the input of the next step
+ *     - the Pulay coefficients of a hand-solved case with two steps in the history
+ *     - the history is a ring buffer of mixing_ndim steps, checked against Pulay mixing
+ *       over the last mixing_ndim steps for more steps than mixing_ndim
+ *     - the history is restarted if the overlap matrix of the residuals is singular
+ *       or if a step is skipped
+ *   - reset
+ */
+
+class DMMixingTest : public ::testing::Test
+{
+  protected:
+    // density matrix of nspin = 2 and n = 1
+    double dm_up = 0.0;
+    double dm_dw = 0.0;
+    double* dm[2] = {&dm_up, &dm_dw};
+
+    bool mix(DM_Mixing& mixer, const int iter, const double up, const double dw, const int ndim, const double beta)
+    {
+        dm_up = up;
+        dm_dw = dw;
+        return mixer.mix(iter, dm, 2, 1, ndim, beta);
+    }
+};
+
+TEST_F(DMMixingTest, PulayCoefficients)
+{
+    DM_Mixing mixer;
+    const double beta = 0.5;
+    // the output of the first step is the input of the second one
+    EXPECT_FALSE(this->mix(mixer, 1, 1.0, 1.0, 4, beta));
+    EXPECT_DOUBLE_EQ(dm_up, 1.0);
+    EXPECT_DOUBLE_EQ(dm_dw, 1.0);
+
+    // one step in the history: X1 = (1, 1), F1 = (1, 0), linear mixing
+    EXPECT_TRUE(this->mix(mixer, 2, 2.0, 1.0, 4, beta));
+    EXPECT_DOUBLE_EQ(dm_up, 1.5);
+    EXPECT_DOUBLE_EQ(dm_dw, 1.0);
+
+    // X2 = (1.5, 1), F2 = (0, 2), A = diag(1, 4) and c = A^{-1}|1> / <1|A^{-1}|1> = (0.8, 0.2),
+    // DM = 0.8 * (X1 + beta F1) + 0.2 * (X2 + beta F2) = (1.5, 1.2)
+    EXPECT_TRUE(this->mix(mixer, 3, 1.5, 3.0, 4, beta));
+    EXPECT_EQ(mixer.nhist, 2);
+    EXPECT_NEAR(mixer.ff(0, 0), 1.0, 1e-14);
+    EXPECT_NEAR(mixer.ff(0, 1), 0.0, 1e-14);
+    EXPECT_NEAR(mixer.ff(1, 1), 4.0, 1e-14);
+    EXPECT_NEAR(dm_up, 1.5, 1e-14);
+    EXPECT_NEAR(dm_dw, 1.2, 1e-14);
+}
+
+TEST_F(DMMixingTest, RingBuffer)
+{
+    DM_Mixing mixer;
+    const int ndim = 2;
+    const double beta = 0.3;
+    // model SCF: DM_out = g(DM_in), nonlinear so that the residuals stay independent
+    auto g = [](const double up, const double dw, double& out_up, double& out_dw) {
+        out_up = 0.5 * up + 0.2 * dw * dw + 1.0;
+        out_dw = -0.4 * up * dw + 0.3 * dw + 0.5;
+    };
+    // reference: Pulay mixing over the last ndim steps kept explicitly
+    std::vector<std::vector<double>> xs, fs;
+    double in_up = 0.2, in_dw = -0.1;
+    double out_up = 0.0, out_dw = 0.0;
+    g(in_up, in_dw, out_up, out_dw);
+    EXPECT_FALSE(this->mix(mixer, 1, out_up, out_dw, ndim, beta));
+    in_up = out_up;
+    in_dw = out_dw;
+    for (int iter = 2; iter <= 7; ++iter)
+    {
+        g(in_up, in_dw, out_up, out_dw);
+        xs.push_back({in_up, in_dw});
+        fs.push_back({out_up - in_up, out_dw - in_dw});
+        const int nh = std::min(static_cast<int>(xs.size()), ndim);
+        const int i0 = xs.size() - nh;
+        // c = A^{-1}|1> / <1|A^{-1}|1>
+        std::vector<double> c(nh, 1.0);
+        if (nh == 2)
+        {
+            const double a00 = fs[i0][0] * fs[i0][0] + fs[i0][1] * fs[i0][1];
+            const double a01 = fs[i0][0] * fs[i0 + 1][0] + fs[i0][1] * fs[i0 + 1][1];
+            const double a11 = fs[i0 + 1][0] * fs[i0 + 1][0] + fs[i0 + 1][1] * fs[i0 + 1][1];
+            c[0] = a11 - a01;
+            c[1] = a00 - a01;
+        }
+        const double norm = (nh == 2) ? c[0] + c[1] : 1.0;
+        double ref_up = 0.0, ref_dw = 0.0;
+        for (int i = 0; i < nh; ++i)
+        {
+            ref_up += c[i] / norm * (xs[i0 + i][0] + beta * fs[i0 + i][0]);
+            ref_dw += c[i] / norm * (xs[i0 + i][1] + beta * fs[i0 + i][1]);
+        }
+
+        EXPECT_TRUE(this->mix(mixer, iter, out_up, out_dw, ndim, beta));
+        EXPECT_EQ(mixer.nhist, nh);
+        EXPECT_EQ(mixer.ihist, (iter - 2) % ndim);
+        EXPECT_NEAR(dm_up, ref_up, 1e-12) << "iter = " << iter;
+        EXPECT_NEAR(dm_dw, ref_dw, 1e-12) << "iter = " << iter;
+        in_up = dm_up;
+        in_dw = dm_dw;
+    }
+}
+
+TEST_F(DMMixingTest, SingularRestart)
+{
+    DM_Mixing mixer;
+    const double beta = 0.5;
+    EXPECT_FALSE(this->mix(mixer, 1, 1.0, 1.0, 4, beta));
+    // X1 = (1, 1), F1 = (1, 0)
+    EXPECT_TRUE(this->mix(mixer, 2, 2.0, 1.0, 4, beta));
+    // X2 = (1.5, 1), F2 = (2, 0) is parallel to F1, A = [[1, 2], [2, 4]] is singular,
+    // DM = X2 + beta F2 and the history is cleared
+    EXPECT_TRUE(this->mix(mixer, 3, 3.5, 1.0, 4, beta));
+    EXPECT_DOUBLE_EQ(dm_up, 2.5);
+    EXPECT_DOUBLE_EQ(dm_dw, 1.0);
+    EXPECT_EQ(mixer.nhist, 0);
+    EXPECT_EQ(mixer.ihist, -1);
+
+    // the history starts again from X3 = (2.5, 1), F3 = (1, 2), linear mixing
+    EXPECT_TRUE(this->mix(mixer, 4, 3.5, 3.0, 4, beta));
+    EXPECT_EQ(mixer.nhist, 1);
+    EXPECT_DOUBLE_EQ(dm_up, 3.0);
+    EXPECT_DOUBLE_EQ(dm_dw, 2.0);
+
+    // a skipped step restarts the history, DM is kept as the input of the next step
+    EXPECT_FALSE(this->mix(mixer, 6, 5.0, 6.0, 4, beta));
+    EXPECT_EQ(mixer.nhist, 0);
+    EXPECT_DOUBLE_EQ(dm_up, 5.0);
+    EXPECT_DOUBLE_EQ(dm_dw, 6.0);
+
+    // so does reset() before the first step of the next SCF
+    mixer.reset();
+    EXPECT_FALSE(this->mix(mixer, 1, 1.0, 1.0, 4, beta));
+    EXPECT_TRUE(this->mix(mixer, 2, 2.0, 1.0, 4, beta));
+    EXPECT_DOUBLE_EQ(dm_up, 1.5);
+    EXPECT_DOUBLE_EQ(dm_dw, 1.0);
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_split(MPI_COMM_WORLD, 0, 1, &POOL_WORLD);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
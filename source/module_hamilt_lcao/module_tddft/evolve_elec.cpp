@@ -20,6 +20,7 @@ bool Evolve_elec::out_dipole;
 bool Evolve_elec::out_efield;
 double Evolve_elec::td_print_eij; // the threshold to output Eij elements
 int Evolve_elec::td_edm;          // 0: new edm method   1: old edm method
+Propagator_Workspace Evolve_elec::prop_ws;
 
 // this routine only serves for TDDFT using LCAO basis set
 void Evolve_elec::solve_psi(const int& istep,
@@ -56,7 +57,8 @@ void Evolve_elec::solve_psi(const int& istep,
                        nullptr,
                        &(ekb(ik, 0)),
                        htype,
-                       propagator);
+                       propagator,
+                       prop_ws);
         }
         else if (htype == 1)
         {
@@ -69,7 +71,8 @@ void Evolve_elec::solve_psi(const int& istep,
                        Hk_laststep[ik],
                        &(ekb(ik, 0)),
                        htype,
-                       propagator);
+                       propagator,
+                       prop_ws);
         }
         else
         {
@@ -8,6 +8,7 @@
 #include "module_hamilt_lcao/hamilt_lcaodft/LCAO_hamilt.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
 #include "module_psi/psi.h"
+#include "propagator.h"
 
 //-----------------------------------------------------------
 // mohan add 2021-02-09
@@ -39,6 +40,9 @@ class Evolve_elec
     static int td_edm;          // 0: new edm method   1: old edm method
 
   private:
+    // buffers of the propagator kept across the time steps and k points
+    static Propagator_Workspace prop_ws;
+
     static void solve_psi(const int& istep,
                           const int nband,
                           const int nlocal,
@@ -24,7 +24,8 @@ void evolve_psi(const int nband,
                 std::complex<double>* H_laststep,
                 double* ekb,
                 int htype,
-                int propagator)
+                int propagator,
+                Propagator_Workspace& ws)
 {
     ModuleBase::TITLE("Evolve_psi", "evolve_psi");
     time_t time_start = time(NULL);
@@ -36,45 +37,64 @@ void evolve_psi(const int nband,
     hamilt::MatrixBlock<std::complex<double>> h_mat, s_mat;
     p_hamilt->matrix(h_mat, s_mat);
 
-    std::complex<double>* Stmp = new std::complex<double>[pv->nloc];
-    ModuleBase::GlobalFunc::ZEROS(Stmp, pv->nloc);
-    BlasConnector::copy(pv->nloc, s_mat.p, 1, Stmp, 1);
+    // S is only read below, no copy is needed
+    const std::complex<double>* Stmp = s_mat.p;
 
-    std::complex<double>* Htmp = new std::complex<double>[pv->nloc];
-    ModuleBase::GlobalFunc::ZEROS(Htmp, pv->nloc);
-    BlasConnector::copy(pv->nloc, h_mat.p, 1, Htmp, 1);
+    // h_mat is not changed below, it is used as H(t) for the band energies
+    const std::complex<double>* Hold = h_mat.p;
 
-    std::complex<double>* Hold = new std::complex<double>[pv->nloc];
-    ModuleBase::GlobalFunc::ZEROS(Hold, pv->nloc);
-    BlasConnector::copy(pv->nloc, h_mat.p, 1, Hold, 1);
-
-    std::complex<double>* U_operator = new std::complex<double>[pv->nloc];
-    ModuleBase::GlobalFunc::ZEROS(U_operator, pv->nloc);
-
-    // (1)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-
-    /// @brief compute H(t+dt/2)
-    /// @input H_laststep, Htmp, print_matrix
-    /// @output Htmp
-    if (htype == 1 && propagator != 2)
+    Propagator prop(propagator, pv);
+    if (propagator == 3)
     {
-        half_Hmatrix(pv, nband, nlocal, Htmp, H_laststep, print_matrix);
+        // (1)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+        /// @brief solve the Crank-Nicolson equation for the new wave function,
+        /// the dense propagator is never formed, H(t+dt/2) is built inside from h_mat and H_laststep
+        /// @input Stmp, h_mat, H_laststep, psi_k_laststep, print_matrix
+        /// @output psi_k
+        prop.solve_psi_cn2(nlocal,
+                           nband,
+                           Stmp,
+                           h_mat.p,
+                           (htype == 1) ? H_laststep : nullptr,
+                           psi_k_laststep,
+                           psi_k,
+                           ws,
+                           print_matrix);
+    }
+    else
+    {
+        ws.htmp.resize(pv->nloc);
+        ws.u_operator.resize(pv->nloc);
+        std::complex<double>* Htmp = ws.htmp.data();
+        BlasConnector::copy(pv->nloc, h_mat.p, 1, Htmp, 1);
+
+        // (1)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+        /// @brief compute H(t+dt/2)
+        /// @input H_laststep, Htmp, print_matrix
+        /// @output Htmp
+        if (htype == 1 && propagator != 2)
+        {
+            half_Hmatrix(pv, nband, nlocal, Htmp, H_laststep, print_matrix);
+        }
+
+        // (2)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+        /// @brief compute U_operator
+        /// @input Stmp, Htmp, print_matrix
+        /// @output U_operator
+        std::complex<double>* U_operator = ws.u_operator.data();
+        ModuleBase::GlobalFunc::ZEROS(U_operator, pv->nloc);
+        prop.compute_propagator(nlocal, Stmp, Htmp, H_laststep, U_operator, print_matrix);
+
+        // (3)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+        /// @brief apply U_operator to the wave function of the previous step for new wave function
+        /// @input U_operator, psi_k_laststep, print_matrix
+        /// @output psi_k
+        upsi(pv, nband, nlocal, U_operator, psi_k_laststep, psi_k, print_matrix);
     }
-
-    // (2)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-
-    /// @brief compute U_operator
-    /// @input Stmp, Htmp, print_matrix
-    /// @output U_operator
-    Propagator prop(propagator, pv);
-    prop.compute_propagator(nlocal, Stmp, Htmp, H_laststep, U_operator, print_matrix);
-
-    // (3)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-
-    /// @brief apply U_operator to the wave function of the previous step for new wave function
-    /// @input U_operator, psi_k_laststep, print_matrix
-    /// @output psi_k
-    upsi(pv, nband, nlocal, U_operator, psi_k_laststep, psi_k, print_matrix);
 
     // (4)->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
@@ -90,11 +110,6 @@ void evolve_psi(const int nband,
     /// @output ekb
     compute_ekb(pv, nband, nlocal, Hold, psi_k, ekb);
 
-    delete[] Stmp;
-    delete[] Htmp;
-    delete[] Hold;
-    delete[] U_operator;
-
 #endif
 
     time_t time_end = time(NULL);
@@ -8,6 +8,7 @@
 
 #include "module_basis/module_ao/parallel_orbitals.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
+#include "propagator.h"
 
 namespace module_tddft
 {
@@ -20,7 +21,8 @@ void evolve_psi(const int nband,
                 std::complex<double>* H_laststep,
                 double* ekb,
                 int htype,
-                int propagator);
+                int propagator,
+                Propagator_Workspace& ws);
 }
 
 #endif
\ No newline at end of file
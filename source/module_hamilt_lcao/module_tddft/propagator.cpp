@@ -2,7 +2,9 @@
 
 #include <complex>
 #include <iostream>
+#include <vector>
 
+#include "module_base/blas_connector.h"
 #include "module_base/lapack_connector.h"
 #include "module_base/scalapack_connector.h"
 #include "module_io/input.h"
@@ -13,6 +15,14 @@ Propagator::~Propagator()
 {
 }
 
+void Propagator_Workspace::resize(const Parallel_Orbitals* pv)
+{
+    // std::vector keeps its capacity, nothing is allocated if the size is unchanged
+    this->numerator.resize(pv->nloc);
+    this->denominator.resize(pv->nloc);
+    this->ipiv.resize(pv->nrow + pv->nb);
+}
+
 #ifdef __MPI
 
 inline int globalIndex(int localindex, int nblk, int nprocs, int myproc)
@@ -47,6 +57,12 @@ void Propagator::compute_propagator(const int nlocal,
 
         break;
 
+    case 3:
+        // Crank-Nicolson is applied to psi directly in solve_psi_cn2, but the explicit
+        // propagator is still available, e.g. for printing
+        compute_propagator_cn2(nlocal, Stmp, Htmp, U_operator, print_matrix);
+        break;
+
     default:
         std::cout << "method of propagator is wrong" << std::endl;
         break;
@@ -257,6 +273,129 @@ void Propagator::compute_propagator_cn2(const int nlocal,
     delete[] ipiv;
 }
 
+void Propagator::solve_psi_cn2(const int nlocal,
+                               const int nband,
+                               const std::complex<double>* Stmp,
+                               const std::complex<double>* Htmp,
+                               const std::complex<double>* H_laststep,
+                               const std::complex<double>* psi_k_laststep,
+                               std::complex<double>* psi_k,
+                               Propagator_Workspace& ws,
+                               const int print_matrix) const
+{
+    ws.resize(this->ParaV);
+    std::complex<double>* Numerator = ws.numerator.data();
+    std::complex<double>* Denominator = ws.denominator.data();
+
+    // (1) Numerator = Stmp - i*para * H;     beta1 = - para = -0.25 * INPUT.mdp.md_dt
+    // Denominator = Stmp + i*para * H;   beta2 = para = 0.25 * INPUT.mdp.md_dt
+    // H = (Htmp + H_laststep) / 2 is added term by term, no copy of H is made
+    BlasConnector::copy(this->ParaV->nloc, Stmp, 1, Numerator, 1);
+    BlasConnector::copy(this->ParaV->nloc, Stmp, 1, Denominator, 1);
+
+    const double weight = (H_laststep == nullptr) ? 1.0 : 0.5;
+    std::complex<double> one = {1.0, 0.0};
+    std::complex<double> beta1 = {0.0, -0.25 * INPUT.mdp.md_dt * weight};
+    std::complex<double> beta2 = {0.0, 0.25 * INPUT.mdp.md_dt * weight};
+
+    for (const std::complex<double>* H: {Htmp, H_laststep})
+    {
+        if (H == nullptr)
+        {
+            continue;
+        }
+        ScalapackConnector::geadd('N',
+                                  nlocal,
+                                  nlocal,
+                                  beta1,
+                                  H,
+                                  1,
+                                  1,
+                                  this->ParaV->desc,
+                                  one,
+                                  Numerator,
+                                  1,
+                                  1,
+                                  this->ParaV->desc);
+        ScalapackConnector::geadd('N',
+                                  nlocal,
+                                  nlocal,
+                                  beta2,
+                                  H,
+                                  1,
+                                  1,
+                                  this->ParaV->desc,
+                                  one,
+                                  Denominator,
+                                  1,
+                                  1,
+                                  this->ParaV->desc);
+    }
+
+    // (2) right-hand side: psi_k = Numerator * psi(t), only nlocal*nband*nlocal
+    ScalapackConnector::gemm('N',
+                             'N',
+                             nlocal,
+                             nband,
+                             nlocal,
+                             1.0,
+                             Numerator,
+                             1,
+                             1,
+                             this->ParaV->desc,
+                             psi_k_laststep,
+                             1,
+                             1,
+                             this->ParaV->desc_wfc,
+                             0.0,
+                             psi_k,
+                             1,
+                             1,
+                             this->ParaV->desc_wfc);
+
+    // (3) solve Denominator * psi(t+dt) = psi_k with the LU factors,
+    // which avoids pzgetri and the nlocal^3 product of the inverse
+    int info = 0;
+    ScalapackConnector::getrf(nlocal, nlocal, Denominator, 1, 1, this->ParaV->desc, ws.ipiv.data(), &info);
+    assert(0 == info);
+    ScalapackConnector::getrs('N',
+                              nlocal,
+                              nband,
+                              Denominator,
+                              1,
+                              1,
+                              this->ParaV->desc,
+                              ws.ipiv.data(),
+                              psi_k,
+                              1,
+                              1,
+                              this->ParaV->desc_wfc,
+                              &info);
+    assert(0 == info);
+
+    if (print_matrix)
+    {
+        GlobalV::ofs_running << std::endl;
+        GlobalV::ofs_running << " psi_k:" << std::endl;
+        for (int i = 0; i < this->ParaV->ncol_bands; i++)
+        {
+            for (int j = 0; j < this->ParaV->ncol; j++)
+            {
+                double aa, bb;
+                aa = psi_k[i * this->ParaV->ncol + j].real();
+                bb = psi_k[i * this->ParaV->ncol + j].imag();
+                if (std::abs(aa) < 1e-8)
+                    aa = 0.0;
+                if (std::abs(bb) < 1e-8)
+                    bb = 0.0;
+                GlobalV::ofs_running << aa << "+" << bb << "i ";
+            }
+            GlobalV::ofs_running << std::endl;
+        }
+        GlobalV::ofs_running << std::endl;
+    }
+}
+
 void Propagator::compute_propagator_taylor(const int nlocal,
                                            const std::complex<double>* Stmp,
                                            const std::complex<double>* Htmp,
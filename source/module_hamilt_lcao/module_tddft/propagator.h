@@ -8,8 +8,26 @@
 
 #include "module_basis/module_ao/parallel_orbitals.h"
 
+#include <complex>
+#include <vector>
+
 namespace module_tddft
 {
+/**
+ * @brief buffers of one time step that are kept across the steps,
+ *  they are only reallocated when the local size of the matrices grows
+ */
+struct Propagator_Workspace
+{
+    std::vector<std::complex<double>> numerator;   // S - i*dt/4 H of Crank-Nicolson
+    std::vector<std::complex<double>> denominator; // S + i*dt/4 H of Crank-Nicolson, LU factors after the solve
+    std::vector<std::complex<double>> htmp;        // H(t+dt/2) of the propagators that form U_operator
+    std::vector<std::complex<double>> u_operator;  // propagator of td_propagator 0, 1 and 2
+    std::vector<int> ipiv;
+
+    void resize(const Parallel_Orbitals* pv);
+};
+
 class Propagator
 {
   public:
@@ -37,6 +55,36 @@ class Propagator
                             const std::complex<double>* H_laststep,
                             std::complex<double>* U_operator,
                             const int print_matrix) const;
+
+    /**
+     *  @brief evolve the wave function with Crank-Nicolson without forming the propagator,
+     *  (S + i*dt/4 H) psi(t+dt) = (S - i*dt/4 H) psi(t) is solved by LU factorization.
+     *
+     *  An iterative (GMRES/BiCGSTAB) solver is not used: H and S are dense in the 2D block
+     *  layout here, so every iteration costs a nlocal^2*nband product and O(10) iterations
+     *  are needed for usual time steps, which is not cheaper than one LU factorization shared
+     *  by all bands. The gain of a Krylov solver relies on the sparse H(R) and S(R), which are
+     *  not folded into the 2D block layout of Hk and Sk.
+     *
+     * @param[in] nlocal number of orbitals
+     * @param[in] nband number of bands
+     * @param[in] Stmp overlap matrix
+     * @param[in] Htmp H(t+dt)
+     * @param[in] H_laststep H(t), H(t+dt/2) = (H(t) + H(t+dt)) / 2 is used if it is not nullptr
+     * @param[in] psi_k_laststep psi(t)
+     * @param[in] ws buffers kept across the time steps
+     * @param[in] print_matirx print internal matrix or not
+     * @param[out] psi_k psi(t+dt)
+     */
+    void solve_psi_cn2(const int nlocal,
+                       const int nband,
+                       const std::complex<double>* Stmp,
+                       const std::complex<double>* Htmp,
+                       const std::complex<double>* H_laststep,
+                       const std::complex<double>* psi_k_laststep,
+                       std::complex<double>* psi_k,
+                       Propagator_Workspace& ws,
+                       const int print_matrix) const;
 #endif
 
   private:
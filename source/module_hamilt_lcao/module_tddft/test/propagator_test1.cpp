@@ -2,6 +2,9 @@
 #include <module_base/scalapack_connector.h>
 #include <mpi.h>
 
+#include <cmath>
+#include <vector>
+
 #include "module_basis/module_ao/parallel_orbitals.h"
 #include "module_hamilt_lcao/module_tddft/propagator.h"
 #include "module_io/input.h"
@@ -15,6 +18,10 @@
  * - Tested Function
  *   - Propagator::compute_propagator_cn2
  *     - compute propagator of method Crank-Nicolson.
+ *   - Propagator::solve_psi_cn2
+ *     - evolve psi with Crank-Nicolson by LU solve, psi(t) = I gives the propagator.
+ *     - the same as U_operator of the dense Crank-Nicolson applied to psi(t), for H(t+dt)
+ *       and H(t+dt/2), with the workspace reused between the calls.
  */
 
 Input INPUT;
@@ -112,4 +119,178 @@ TEST(PropagatorTest, testPropagatorCN)
     delete[] U_operator;
     delete[] Htmp;
     delete[] Stmp;
-}
\ No newline at end of file
+}
+
+TEST(PropagatorTest, testPropagatorCNSolve)
+{
+    std::complex<double>* psi_k_laststep;
+    std::complex<double>* psi_k;
+    std::complex<double>* Stmp;
+    std::complex<double>* Htmp;
+    int nlocal = 4;
+    int nband = 4;
+    bool print_matrix = false;
+    Parallel_Orbitals* pv;
+    pv = new Parallel_Orbitals();
+    pv->nloc = nlocal * nlocal;
+    pv->ncol = nlocal;
+    pv->nrow = nlocal;
+    pv->nb = 1;
+    INPUT.mdp.md_dt = 4;
+
+    // Initialize input matrices
+    int info;
+    int mb = 1, nb = 1;
+    int irsrc = 0, icsrc = 0, lld = numroc_(&nlocal, &mb, &myprow, &irsrc, &nprow);
+    descinit_(pv->desc, &nlocal, &nlocal, &mb, &nb, &irsrc, &icsrc, &ictxt, &lld, &info);
+    descinit_(pv->desc_wfc, &nlocal, &nband, &mb, &nb, &irsrc, &icsrc, &ictxt, &lld, &info);
+
+    // Initialize data
+    psi_k_laststep = new std::complex<double>[nlocal * nband];
+    psi_k = new std::complex<double>[nlocal * nband];
+    Stmp = new std::complex<double>[nlocal * nlocal];
+    Htmp = new std::complex<double>[nlocal * nlocal];
+
+    for (int i = 0; i < nlocal; ++i)
+    {
+        for (int j = 0; j < nlocal; ++j)
+        {
+            std::complex<double> diag = (i == j) ? std::complex<double>(1.0, 0.0) : std::complex<double>(0.0, 0.0);
+            Htmp[i * nlocal + j] = diag;
+            Stmp[i * nlocal + j] = diag;
+            psi_k_laststep[i * nlocal + j] = diag;
+            psi_k[i * nlocal + j] = std::complex<double>(0.0, 0.0);
+        }
+    }
+    Stmp[1] = 0.5;
+    Stmp[4] = 0.5;
+
+    // Call the function
+    int propagator = 3;
+    module_tddft::Propagator prop(propagator, pv);
+    module_tddft::Propagator_Workspace ws;
+    prop.solve_psi_cn2(nlocal, nband, Stmp, Htmp, nullptr, psi_k_laststep, psi_k, ws, print_matrix);
+
+    // the same numbers as testPropagatorCN
+    EXPECT_NEAR(psi_k[0].real(), -0.107692307692308, doublethreshold);
+    EXPECT_NEAR(psi_k[0].imag(), -0.861538461538462, doublethreshold);
+    EXPECT_NEAR(psi_k[1].real(), 0.492307692307692, doublethreshold);
+    EXPECT_NEAR(psi_k[1].imag(), -0.0615384615384615, doublethreshold);
+    EXPECT_NEAR(psi_k[4].real(), 0.492307692307692, doublethreshold);
+    EXPECT_NEAR(psi_k[4].imag(), -0.0615384615384615, doublethreshold);
+    EXPECT_NEAR(psi_k[5].real(), -0.107692307692308, doublethreshold);
+    EXPECT_NEAR(psi_k[5].imag(), -0.861538461538462, doublethreshold);
+    EXPECT_NEAR(psi_k[10].real(), 0.0, doublethreshold);
+    EXPECT_NEAR(psi_k[10].imag(), -1.0, doublethreshold);
+    EXPECT_NEAR(psi_k[15].real(), 0.0, doublethreshold);
+    EXPECT_NEAR(psi_k[15].imag(), -1.0, doublethreshold);
+    for (int i : {2, 3, 6, 7, 8, 9, 11, 12, 13, 14})
+    {
+        EXPECT_NEAR(std::abs(psi_k[i]), 0.0, doublethreshold);
+    }
+
+    delete[] psi_k_laststep;
+    delete[] psi_k;
+    delete[] Htmp;
+    delete[] Stmp;
+}
+
+TEST(PropagatorTest, testPropagatorCNSolveVsDense)
+{
+    const int nlocal = 4;
+    const int nband = 2;
+    const bool print_matrix = false;
+    Parallel_Orbitals* pv = new Parallel_Orbitals();
+    pv->nloc = nlocal * nlocal;
+    pv->ncol = nlocal;
+    pv->nrow = nlocal;
+    pv->nb = 1;
+    INPUT.mdp.md_dt = 0.5;
+
+    int info;
+    int n = nlocal, nbd = nband;
+    int mb = 1, nb = 1;
+    int irsrc = 0, icsrc = 0, lld = numroc_(&n, &mb, &myprow, &irsrc, &nprow);
+    descinit_(pv->desc, &n, &n, &mb, &nb, &irsrc, &icsrc, &ictxt, &lld, &info);
+    descinit_(pv->desc_wfc, &n, &nbd, &mb, &nb, &irsrc, &icsrc, &ictxt, &lld, &info);
+
+    // hermitian H(t+dt), H(t) and positive definite S, stored column by column
+    std::vector<std::complex<double>> Hmat(nlocal * nlocal), Hlast(nlocal * nlocal), Smat(nlocal * nlocal);
+    for (int i = 0; i < nlocal; ++i)
+    {
+        for (int j = 0; j <= i; ++j)
+        {
+            const std::complex<double> h = (i == j) ? std::complex<double>(0.3 * i - 0.5, 0.0)
+                                                    : std::complex<double>(0.1 * (i + j), 0.05 * (i - j));
+            const std::complex<double> hl = (i == j) ? std::complex<double>(0.2 * i - 0.4, 0.0)
+                                                     : std::complex<double>(0.08 * (i + 2 * j), -0.03 * (i - j));
+            const std::complex<double> sv = (i == j) ? std::complex<double>(1.0, 0.0)
+                                                     : std::complex<double>(0.1 / (i + j + 1), 0.02 * (i - j));
+            Hmat[j * nlocal + i] = h;
+            Hmat[i * nlocal + j] = std::conj(h);
+            Hlast[j * nlocal + i] = hl;
+            Hlast[i * nlocal + j] = std::conj(hl);
+            Smat[j * nlocal + i] = sv;
+            Smat[i * nlocal + j] = std::conj(sv);
+        }
+    }
+    std::vector<std::complex<double>> psi_last(nlocal * nband);
+    for (int ib = 0; ib < nband; ++ib)
+    {
+        for (int i = 0; i < nlocal; ++i)
+        {
+            psi_last[ib * nlocal + i] = std::complex<double>(std::cos(0.7 * i + ib), std::sin(0.3 * i - ib));
+        }
+    }
+
+    module_tddft::Propagator_Workspace ws;
+    for (const bool half : {true, false})
+    {
+        // dense reference: U_operator of Crank-Nicolson with H(t+dt/2) or H(t+dt), then U * psi(t)
+        std::vector<std::complex<double>> Hdense(Hmat);
+        if (half)
+        {
+            for (int i = 0; i < nlocal * nlocal; ++i)
+            {
+                Hdense[i] = 0.5 * (Hmat[i] + Hlast[i]);
+            }
+        }
+        std::vector<std::complex<double>> U_operator(nlocal * nlocal, 0.0);
+        module_tddft::Propagator prop_dense(0, pv);
+        prop_dense.compute_propagator(nlocal, Smat.data(), Hdense.data(), nullptr, U_operator.data(), print_matrix);
+        std::vector<std::complex<double>> psi_ref(nlocal * nband, 0.0);
+        for (int ib = 0; ib < nband; ++ib)
+        {
+            for (int j = 0; j < nlocal; ++j)
+            {
+                for (int i = 0; i < nlocal; ++i)
+                {
+                    psi_ref[ib * nlocal + i] += U_operator[j * nlocal + i] * psi_last[ib * nlocal + j];
+                }
+            }
+        }
+
+        // solve with the persistent workspace
+        std::vector<std::complex<double>> psi_k(nlocal * nband, 0.0);
+        module_tddft::Propagator prop(3, pv);
+        prop.solve_psi_cn2(nlocal,
+                           nband,
+                           Smat.data(),
+                           Hmat.data(),
+                           half ? Hlast.data() : nullptr,
+                           psi_last.data(),
+                           psi_k.data(),
+                           ws,
+                           print_matrix);
+
+        for (int i = 0; i < nlocal * nband; ++i)
+        {
+            EXPECT_NEAR(psi_k[i].real(), psi_ref[i].real(), doublethreshold);
+            EXPECT_NEAR(psi_k[i].imag(), psi_ref[i].imag(), doublethreshold);
+        }
+        EXPECT_EQ(ws.numerator.size(), nlocal * nlocal);
+        EXPECT_EQ(ws.denominator.size(), nlocal * nlocal);
+    }
+
+    delete pv;
+}
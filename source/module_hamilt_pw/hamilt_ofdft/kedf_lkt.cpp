@@ -16,18 +16,18 @@ void KEDF_LKT::set_para(int nx, double dV, double lkt_a)
 //
 double KEDF_LKT::get_energy(const double *const *prho, ModulePW::PW_Basis *pw_rho)
 {
-    double energy = 0.;                // in Ry
-    double *as = new double[this->nx]; // a*s
-    double **nabla_rho = new double *[3];
-    for (int i = 0; i < 3; ++i)
-    {
-        nabla_rho[i] = new double[this->nx];
-    }
+    double energy = 0.; // in Ry
+    this->allocWork(pw_rho);
+    double *as = this->as_.data(); // a*s
+    double **nabla_rho = this->pnablaRho.data();
 
     if (GlobalV::NSPIN == 1)
     {
         this->nabla(prho[0], pw_rho, nabla_rho);
         this->get_as(prho[0], nabla_rho, as);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:energy)
+#endif
         for (int ir = 0; ir < this->nx; ++ir)
         {
             energy += pow(prho[0][ir], 5. / 3.) / std::cosh(as[ir]);
@@ -41,33 +41,20 @@ double KEDF_LKT::get_energy(const double *const *prho, ModulePW::PW_Basis *pw_rh
     this->LKTenergy = energy;
     Parallel_Reduce::reduce_double_all(this->LKTenergy);
 
-    delete[] as;
-    for (int i = 0; i < 3; ++i)
-        delete[] nabla_rho[i];
-    delete[] nabla_rho;
-
     return energy;
 }
 
 double KEDF_LKT::get_energy_density(const double *const *prho, int is, int ir, ModulePW::PW_Basis *pw_rho)
 {
-    double energy_den = 0.;            // in Ry
-    double *as = new double[this->nx]; // a*s
-    double **nabla_rho = new double *[3];
-    for (int i = 0; i < 3; ++i)
-    {
-        nabla_rho[i] = new double[this->nx];
-    }
+    double energy_den = 0.; // in Ry
+    this->allocWork(pw_rho);
+    double *as = this->as_.data(); // a*s
+    double **nabla_rho = this->pnablaRho.data();
 
     this->nabla(prho[is], pw_rho, nabla_rho);
     this->get_as(prho[is], nabla_rho, as);
     energy_den = this->cTF * pow(prho[is][ir], 5. / 3.) / std::cosh(as[ir]);
 
-    delete[] as;
-    for (int i = 0; i < 3; ++i)
-        delete[] nabla_rho[i];
-    delete[] nabla_rho;
-
     return energy_den;
 }
 
@@ -79,45 +66,44 @@ void KEDF_LKT::lkt_potential(const double *const *prho, ModulePW::PW_Basis *pw_r
 {
     ModuleBase::timer::tick("KEDF_LKT", "LKT_potential");
     this->LKTenergy = 0.;
-    double *as = new double[this->nx]; // a*s
-    double **nabla_rho = new double *[3];
-    for (int i = 0; i < 3; ++i)
-    {
-        nabla_rho[i] = new double[this->nx];
-    }
-    double *nabla_term = new double[this->nx];
+    this->allocWork(pw_rho);
+    double *as = this->as_.data(); // a*s
+    double **nabla_rho = this->pnablaRho.data();
+    double *nabla_term = this->nablaTerm.data();
 
     if (GlobalV::NSPIN == 1)
     {
         this->nabla(prho[0], pw_rho, nabla_rho);
         this->get_as(prho[0], nabla_rho, as);
 
+        const double nabla_coef = this->cTF * std::pow(this->s_coef * this->lkt_a, 2);
+        double energy = 0.;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:energy)
+#endif
         for (int ir = 0; ir < this->nx; ++ir)
         {
-            double coshas = std::cosh(as[ir]);
-            double tanhas = std::tanh(as[ir]);
+            const double coshas = std::cosh(as[ir]);
+            const double tanhas = std::tanh(as[ir]);
+            const double rho23 = std::pow(prho[0][ir], 2. / 3.);
 
-            this->LKTenergy += std::pow(prho[0][ir], 5. / 3.) / coshas;
+            energy += rho23 * prho[0][ir] / coshas;
             // add the first term
-            rpotential(0, ir)
-                += 5.0 / 3.0 * this->cTF * std::pow(prho[0][ir], 2. / 3.) / coshas * (1. + 4.0 / 5.0 * as[ir] * tanhas);
+            rpotential(0, ir) += 5.0 / 3.0 * this->cTF * rho23 / coshas * (1. + 4.0 / 5.0 * as[ir] * tanhas);
             // get the nabla_term
+            const double fac = (as[ir] == 0) ? 0. : tanhas / coshas / as[ir] / prho[0][ir] * nabla_coef;
             for (int i = 0; i < 3; ++i)
             {
-                if (as[ir] == 0)
-                {
-                    nabla_rho[i][ir] = 0;
-                }
-                else
-                {
-                    nabla_rho[i][ir] = nabla_rho[i][ir] * tanhas / coshas / as[ir] / prho[0][ir] * this->cTF
-                                       * std::pow(this->s_coef * this->lkt_a, 2);
-                }
+                nabla_rho[i][ir] *= fac;
             }
         }
+        this->LKTenergy = energy;
 
         this->divergence(nabla_rho, pw_rho, nabla_term);
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (int ir = 0; ir < this->nx; ++ir)
         {
             rpotential(0, ir) += nabla_term[ir];
@@ -131,59 +117,57 @@ void KEDF_LKT::lkt_potential(const double *const *prho, ModulePW::PW_Basis *pw_r
         // Waiting for update
     }
 
-    delete[] as;
-    for (int i = 0; i < 3; ++i)
-        delete[] nabla_rho[i];
-    delete[] nabla_rho;
-    delete[] nabla_term;
-
     ModuleBase::timer::tick("KEDF_LKT", "LKT_potential");
 }
 
 void KEDF_LKT::get_stress(const double cell_vol, const double *const *prho, ModulePW::PW_Basis *pw_rho)
 {
-    double *as = new double[this->nx]; // a*s
-    double **nabla_rho = new double *[3];
-    for (int i = 0; i < 3; ++i)
-    {
-        nabla_rho[i] = new double[this->nx];
-    }
-    double *nabla_term = new double[this->nx];
+    this->allocWork(pw_rho);
+    double *as = this->as_.data(); // a*s
+    double **nabla_rho = this->pnablaRho.data();
 
     if (GlobalV::NSPIN == 1)
     {
         this->nabla(prho[0], pw_rho, nabla_rho);
         this->get_as(prho[0], nabla_rho, as);
 
+        // all six components in one pass over the grid
+        const double coef2 = std::pow(this->s_coef * this->lkt_a, 2);
+        const double *dx = nabla_rho[0];
+        const double *dy = nabla_rho[1];
+        const double *dz = nabla_rho[2];
+        double sxx = 0., sxy = 0., sxz = 0., syy = 0., syz = 0., szz = 0., sdiag = 0.;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:sxx, sxy, sxz, syy, syz, szz, sdiag)
+#endif
+        for (int ir = 0; ir < this->nx; ++ir)
+        {
+            const double coef = std::tanh(as[ir]) / std::cosh(as[ir]);
+            if (as[ir] != 0.)
+            {
+                const double fac = -coef2 * coef / as[ir] / prho[0][ir];
+                sxx += fac * dx[ir] * dx[ir];
+                sxy += fac * dx[ir] * dy[ir];
+                sxz += fac * dx[ir] * dz[ir];
+                syy += fac * dy[ir] * dy[ir];
+                syz += fac * dy[ir] * dz[ir];
+                szz += fac * dz[ir] * dz[ir];
+            }
+            sdiag += 1.0 / 3.0 * as[ir] * std::pow(prho[0][ir], 5.0 / 3.0) * coef;
+        }
+        double integral_term[6] = {sxx + sdiag, sxy, sxz, syy + sdiag, syz, szz + sdiag};
+        Parallel_Reduce::reduce_double_all(integral_term, 6);
+
+        int i = 0;
         for (int alpha = 0; alpha < 3; ++alpha)
         {
             for (int beta = alpha; beta < 3; ++beta)
             {
-                this->stress(alpha, beta) = 0;
-
+                this->stress(alpha, beta) = integral_term[i++] * this->cTF * this->dV / cell_vol;
                 if (alpha == beta)
                 {
-                    this->stress(alpha, beta) = 2.0 / 3.0 / cell_vol * this->LKTenergy;
+                    this->stress(alpha, beta) += 2.0 / 3.0 / cell_vol * this->LKTenergy;
                 }
-
-                double integral_term = 0.;
-                for (int ir = 0; ir < this->nx; ++ir)
-                {
-                    double coef = std::tanh(as[ir]) / std::cosh(as[ir]);
-                    if (as[ir] != 0.)
-                    {
-                        integral_term += -nabla_rho[alpha][ir] * nabla_rho[beta][ir] / as[ir] / prho[0][ir]
-                                         * std::pow(this->s_coef * this->lkt_a, 2) * coef;
-                    }
-                    if (alpha == beta)
-                    {
-                        integral_term += 1.0 / 3.0 * as[ir] * std::pow(prho[0][ir], 5.0 / 3.0) * coef;
-                    }
-                }
-                Parallel_Reduce::reduce_double_all(integral_term);
-                integral_term *= this->cTF * this->dV / cell_vol;
-
-                this->stress(alpha, beta) += integral_term;
             }
         }
         for (int alpha = 1; alpha < 3; ++alpha)
@@ -198,19 +182,13 @@ void KEDF_LKT::get_stress(const double cell_vol, const double *const *prho, Modu
     {
         // Waiting for update
     }
-
-    delete[] as;
-    for (int i = 0; i < 3; ++i)
-        delete[] nabla_rho[i];
-    delete[] nabla_rho;
-    delete[] nabla_term;
 }
 
 // output = nabla input
 void KEDF_LKT::nabla(const double *pinput, ModulePW::PW_Basis *pw_rho, double **routput)
 {
-    std::complex<double> *recip_data = new std::complex<double>[pw_rho->npw];
-    std::complex<double> *recip_nabla = new std::complex<double>[pw_rho->npw];
+    std::complex<double> *recip_data = this->recipData.data();
+    std::complex<double> *recip_nabla = this->recipNabla.data();
     pw_rho->real2recip(pinput, recip_data);
 
     std::complex<double> img {0.0, 1.0};
@@ -222,37 +200,54 @@ void KEDF_LKT::nabla(const double *pinput, ModulePW::PW_Basis *pw_rho, double **
         }
         pw_rho->recip2real(recip_nabla, routput[j]);
     }
-
-    delete[] recip_data;
-    delete[] recip_nabla;
 }
 
-// output = nabla dot input
+// output = nabla dot input, the three components are summed in reciprocal space and transformed back once
 void KEDF_LKT::divergence(const double *const *pinput, ModulePW::PW_Basis *pw_rho, double *routput)
 {
-    std::complex<double> *recip_container = new std::complex<double>[pw_rho->npw];
+    std::complex<double> *recip_container = this->recipData.data();
+    std::complex<double> *recip_div = this->recipNabla.data();
     std::complex<double> img {0.0, 1.0};
-    ModuleBase::GlobalFunc::ZEROS(routput, this->nx);
+    ModuleBase::GlobalFunc::ZEROS(recip_div, pw_rho->npw);
     for (int i = 0; i < 3; ++i)
     {
         pw_rho->real2recip(pinput[i], recip_container);
         for (int ip = 0; ip < pw_rho->npw; ++ip)
         {
-            recip_container[ip] = img * pw_rho->gcar[ip][i] * pw_rho->tpiba * recip_container[ip];
+            recip_div[ip] += img * pw_rho->gcar[ip][i] * pw_rho->tpiba * recip_container[ip];
         }
-        pw_rho->recip2real(recip_container, routput, true);
     }
-
-    delete[] recip_container;
+    pw_rho->recip2real(recip_div, routput);
 }
 
 // lkt_a * s, s = c_s * |nabla rho|/rho^{4/3}
 void KEDF_LKT::get_as(const double *prho, const double *const *pnabla_rho, double *as)
 {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (int ir = 0; ir < this->nx; ++ir)
     {
-        as[ir] = std::sqrt(std::pow(pnabla_rho[0][ir], 2) + std::pow(pnabla_rho[1][ir], 2)
-                           + std::pow(pnabla_rho[2][ir], 2))
+        as[ir] = std::sqrt(pnabla_rho[0][ir] * pnabla_rho[0][ir] + pnabla_rho[1][ir] * pnabla_rho[1][ir]
+                           + pnabla_rho[2][ir] * pnabla_rho[2][ir])
                  / std::pow(prho[ir], 4.0 / 3.0) * this->s_coef * this->lkt_a;
     }
 }
+
+// Allocate the work space, kept until the grid changes
+void KEDF_LKT::allocWork(ModulePW::PW_Basis *pw_rho)
+{
+    if (static_cast<int>(this->as_.size()) != this->nx)
+    {
+        this->as_.resize(this->nx);
+        this->nablaTerm.resize(this->nx);
+        this->nablaRho.resize(3 * this->nx);
+        this->pnablaRho.resize(3);
+        for (int i = 0; i < 3; ++i)
+        {
+            this->pnablaRho[i] = &this->nablaRho[i * this->nx];
+        }
+    }
+    this->recipData.resize(pw_rho->npw);
+    this->recipNabla.resize(pw_rho->npw);
+}
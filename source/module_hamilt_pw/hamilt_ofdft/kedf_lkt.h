@@ -9,6 +9,8 @@
 #include "module_base/timer.h"
 #include "module_basis/module_pw/pw_basis.h"
 
+#include <vector>
+
 /**
  * @brief A class which calculates kinetic energy, potential, and stress with Luo-Karasiev-Trickey (LKT) KEDF.
  * See Luo K, Karasiev V V, Trickey S B. Physical Review B, 2018, 98(4): 041111.
@@ -39,6 +41,7 @@ class KEDF_LKT
     void nabla(const double *pinput, ModulePW::PW_Basis *pw_rho, double **routput);
     void divergence(const double *const *pinput, ModulePW::PW_Basis *pw_rho, double *routput);
     void get_as(const double *prho, const double *const *pnabla_rho, double *as);
+    void allocWork(ModulePW::PW_Basis *pw_rho);
 
     int nx = 0;     // number of real space points in current core
     double dV = 0.; // volume element = V/nxyz
@@ -48,5 +51,13 @@ class KEDF_LKT
     const double s_coef
         = 1.0 / (2. * std::pow(3 * std::pow(M_PI, 2.0), 1.0 / 3.0)); // coef of s, s=s_coef * |nabla rho|/rho^{4/3}
     double lkt_a = 1.3;
+
+    // work space kept between calls
+    std::vector<double> as_;                        // a*s, dim = nx
+    std::vector<double> nablaRho;                   // nabla rho, dim = 3 * nx
+    std::vector<double> nablaTerm;                  // dim = nx
+    std::vector<double *> pnablaRho;                // dim = 3
+    std::vector<std::complex<double>> recipData;    // dim = npw
+    std::vector<std::complex<double>> recipNabla;   // dim = npw
 };
 #endif
\ No newline at end of file
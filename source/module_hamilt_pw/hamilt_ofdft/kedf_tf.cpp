@@ -19,6 +19,9 @@ double KEDF_TF::get_energy(const double *const *prho)
     double energy = 0.; // in Ry
     if (GlobalV::NSPIN == 1)
     {
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:energy)
+#endif
         for (int ir = 0; ir < this->nx; ++ir)
         {
             energy += std::pow(prho[0][ir], 5. / 3.);
@@ -29,6 +32,9 @@ double KEDF_TF::get_energy(const double *const *prho)
     {
         for (int is = 0; is < GlobalV::NSPIN; ++is)
         {
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:energy)
+#endif
             for (int ir = 0; ir < this->nx; ++ir)
             {
                 energy += std::pow(2. * prho[is][ir], 5. / 3.);
@@ -50,29 +56,43 @@ double KEDF_TF::get_energy_density(const double *const *prho, int is, int ir)
 
 //
 // Vtf = delta Etf/delta rho = 5/3 * cTF * rho^{2/3}
+// The energy is accumulated in the same pass, with rho^{5/3} = rho^{2/3} * rho.
 //
 void KEDF_TF::tf_potential(const double *const *prho, ModuleBase::matrix &rpotential)
 {
     ModuleBase::timer::tick("KEDF_TF", "tf_potential");
+    double energy = 0.; // in Ry
     if (GlobalV::NSPIN == 1)
     {
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:energy)
+#endif
         for (int ir = 0; ir < this->nx; ++ir)
         {
-            rpotential(0, ir) += 5.0 / 3.0 * this->cTF * std::pow(prho[0][ir], 2. / 3.) * this->tf_weight;
+            const double rho23 = std::pow(prho[0][ir], 2. / 3.);
+            rpotential(0, ir) += 5.0 / 3.0 * this->cTF * rho23 * this->tf_weight;
+            energy += rho23 * prho[0][ir];
         }
+        energy *= this->dV * this->cTF;
     }
     else if (GlobalV::NSPIN == 2)
     {
         for (int is = 0; is < GlobalV::NSPIN; ++is)
         {
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:energy)
+#endif
             for (int ir = 0; ir < this->nx; ++ir)
             {
-                rpotential(is, ir) += 5.0 / 3.0 * this->cTF * std::pow(2. * prho[is][ir], 2. / 3.) * this->tf_weight;
+                const double rho23 = std::pow(2. * prho[is][ir], 2. / 3.);
+                rpotential(is, ir) += 5.0 / 3.0 * this->cTF * rho23 * this->tf_weight;
+                energy += rho23 * 2. * prho[is][ir];
             }
         }
+        energy *= 0.5 * this->dV * this->cTF * this->tf_weight;
     }
-
-    this->get_energy(prho);
+    this->TFenergy = energy;
+    Parallel_Reduce::reduce_double_all(this->TFenergy);
 
     ModuleBase::timer::tick("KEDF_TF", "tf_potential");
 }
@@ -16,84 +16,23 @@ void KEDF_vW::set_para(int nx, double dV, double vw_weight)
 //
 double KEDF_vW::get_energy(double **pphi, ModulePW::PW_Basis *pw_rho)
 {
-    // since pphi may contain minus element, we define tempPhi = std::abs(phi), which is true sqrt(rho)
-    double **tempPhi = new double *[GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        tempPhi[is] = new double[pw_rho->nrxx];
-        for (int ir = 0; ir < this->nx; ++ir)
-        {
-            tempPhi[is][ir] = std::abs(pphi[is][ir]);
-        }
-    }
-
-    double **LapPhi = new double *[GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-        LapPhi[is] = new double[pw_rho->nrxx];
-    this->laplacianPhi(tempPhi, LapPhi, pw_rho);
+    this->abs_phi(pphi, pw_rho);
+    this->laplacianPhi(this->pabsPhi.data(), this->plapPhi.data(), pw_rho);
 
-    double energy = 0.; // in Ry
-    if (GlobalV::NSPIN == 1)
-    {
-        for (int ir = 0; ir < this->nx; ++ir)
-        {
-            energy += tempPhi[0][ir] * LapPhi[0][ir];
-        }
-        energy *= this->dV * 0.5 * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
-    }
-    else if (GlobalV::NSPIN == 2)
-    {
-        for (int is = 0; is < GlobalV::NSPIN; ++is)
-        {
-            for (int ir = 0; ir < this->nx; ++ir)
-            {
-                energy += 2 * tempPhi[is][ir] * LapPhi[is][ir];
-            }
-        }
-        energy *= 0.5 * this->dV * 0.5 * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
-    }
+    double energy = this->sum_energy();
     this->vWenergy = energy;
     Parallel_Reduce::reduce_double_all(this->vWenergy);
-
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        delete[] tempPhi[is];
-        delete[] LapPhi[is];
-    }
-    delete[] tempPhi;
-    delete[] LapPhi;
-
     return energy;
 }
 
 double KEDF_vW::get_energy_density(double **pphi, int is, int ir, ModulePW::PW_Basis *pw_rho)
 {
-    // since pphi may contain minus element, we define tempPhi = std::abs(phi), which is true sqrt(rho)
-    double **tempPhi = new double *[GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        tempPhi[is] = new double[pw_rho->nrxx];
-        for (int ir = 0; ir < this->nx; ++ir)
-        {
-            tempPhi[is][ir] = std::abs(pphi[is][ir]);
-        }
-    }
-
-    double **LapPhi = new double *[GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-        LapPhi[is] = new double[pw_rho->nrxx];
-    this->laplacianPhi(tempPhi, LapPhi, pw_rho);
-
-    double energyDen = 0.;                                                     // in Ry
-    energyDen = 0.5 * tempPhi[is][ir] * LapPhi[is][ir] * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
+    this->abs_phi(pphi, pw_rho);
+    this->laplacianPhi(this->pabsPhi.data(), this->plapPhi.data(), pw_rho);
 
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        delete[] tempPhi[is];
-        delete[] LapPhi[is];
-    }
-    delete[] tempPhi;
-    delete[] LapPhi;
+    double energyDen = 0.; // in Ry
+    energyDen = 0.5 * this->pabsPhi[is][ir] * this->plapPhi[is][ir] * this->vw_weight
+                * 2.; // vw_weight * 2 to convert Hartree to Ry
     return energyDen;
 }
 
@@ -105,120 +44,102 @@ void KEDF_vW::vW_potential(const double *const *pphi, ModulePW::PW_Basis *pw_rho
 {
     ModuleBase::timer::tick("KEDF_vW", "vw_potential");
 
-    // since pphi may contain minus element, we define tempPhi = std::abs(phi), which is true sqrt(rho)
-    double **tempPhi = new double *[GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        tempPhi[is] = new double[pw_rho->nrxx];
-        for (int ir = 0; ir < this->nx; ++ir)
-        {
-            tempPhi[is][ir] = std::abs(pphi[is][ir]);
-        }
-    }
-
     // calculate the minus \nabla^2 sqrt(rho)
-    double **LapPhi = new double *[GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-        LapPhi[is] = new double[pw_rho->nrxx];
-    this->laplacianPhi(tempPhi, LapPhi, pw_rho);
+    this->abs_phi(pphi, pw_rho);
+    this->laplacianPhi(this->pabsPhi.data(), this->plapPhi.data(), pw_rho);
 
-    // calculate potential
+    // calculate potential and energy in one pass
+    double energy = 0.; // in Ry
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
+        const double *lap = this->plapPhi[is];
+        const double *absphi = this->pabsPhi[is];
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:energy)
+#endif
         for (int ir = 0; ir < this->nx; ++ir)
         {
             if (pphi[is][ir] >= 0)
             {
-                rpotential(is, ir) += LapPhi[is][ir] * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
+                rpotential(is, ir) += lap[ir] * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
             }
             else
             {
-                rpotential(is, ir) += -LapPhi[is][ir] * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
+                rpotential(is, ir) += -lap[ir] * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
             }
+            energy += absphi[ir] * lap[ir];
         }
     }
-
-    // calculate energy
-    double energy = 0.; // in Ry
     if (GlobalV::NSPIN == 1)
     {
-        for (int ir = 0; ir < this->nx; ++ir)
-        {
-            energy += tempPhi[0][ir] * LapPhi[0][ir];
-        }
         energy *= this->dV * 0.5 * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
     }
     else if (GlobalV::NSPIN == 2)
     {
-        for (int is = 0; is < GlobalV::NSPIN; ++is)
-        {
-            for (int ir = 0; ir < this->nx; ++ir)
-            {
-                energy += 2 * tempPhi[is][ir] * LapPhi[is][ir];
-            }
-        }
-        energy *= 0.5 * this->dV * 0.5 * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
+        energy *= 2. * 0.5 * this->dV * 0.5 * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
     }
     this->vWenergy = energy;
     Parallel_Reduce::reduce_double_all(this->vWenergy);
 
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        delete[] tempPhi[is];
-        delete[] LapPhi[is];
-    }
-    delete[] tempPhi;
-    delete[] LapPhi;
-
     ModuleBase::timer::tick("KEDF_vW", "vw_potential");
 }
 
+//
+// sigma_ab = -vw_weight/V \int{sqrt(rho) d_a d_b sqrt(rho)} = vw_weight/V \int{d_a sqrt(rho) d_b sqrt(rho)},
+// so only the three first derivatives are transformed back to real space.
+//
 void KEDF_vW::get_stress(const double *const *pphi, ModulePW::PW_Basis *pw_rho, double inpt_vWenergy)
 {
-    // since pphi may contain minus element, we define tempPhi = std::abs(phi), which is true sqrt(rho)
-    double **tempPhi = new double *[GlobalV::NSPIN];
+    this->abs_phi(pphi, pw_rho);
+
+    std::vector<double> gradPhi(3 * this->nx);
+    std::vector<std::complex<double>> recipGrad(pw_rho->npw);
+    const std::complex<double> img(0.0, 1.0);
+    double sigma[6] = {0., 0., 0., 0., 0., 0.};
+
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
-        tempPhi[is] = new double[pw_rho->nrxx];
-        for (int ir = 0; ir < this->nx; ++ir)
+        pw_rho->real2recip(this->pabsPhi[is], this->recipPhi.data());
+        for (int a = 0; a < 3; ++a)
         {
-            tempPhi[is][ir] = std::abs(pphi[is][ir]);
+            for (int ig = 0; ig < pw_rho->npw; ++ig)
+            {
+                recipGrad[ig] = img * pw_rho->gcar[ig][a] * pw_rho->tpiba * this->recipPhi[ig];
+            }
+            pw_rho->recip2real(recipGrad.data(), &gradPhi[a * this->nx]);
         }
-    }
 
-    std::complex<double> **recipPhi = new std::complex<double> *[GlobalV::NSPIN];
-    std::complex<double> **ggrecipPhi = new std::complex<double> *[GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        recipPhi[is] = new std::complex<double>[pw_rho->npw];
-        ggrecipPhi[is] = new std::complex<double>[pw_rho->npw];
-
-        pw_rho->real2recip(tempPhi[is], recipPhi[is]);
+        const double *dx = &gradPhi[0];
+        const double *dy = &gradPhi[this->nx];
+        const double *dz = &gradPhi[2 * this->nx];
+        double sxx = 0., sxy = 0., sxz = 0., syy = 0., syz = 0., szz = 0.;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:sxx, sxy, sxz, syy, syz, szz)
+#endif
+        for (int ir = 0; ir < this->nx; ++ir)
+        {
+            sxx += dx[ir] * dx[ir];
+            sxy += dx[ir] * dy[ir];
+            sxz += dx[ir] * dz[ir];
+            syy += dy[ir] * dy[ir];
+            syz += dy[ir] * dz[ir];
+            szz += dz[ir] * dz[ir];
+        }
+        sigma[0] += sxx;
+        sigma[1] += sxy;
+        sigma[2] += sxz;
+        sigma[3] += syy;
+        sigma[4] += syz;
+        sigma[5] += szz;
     }
+    Parallel_Reduce::reduce_double_all(sigma, 6);
 
-    double *ggPhi = new double[this->nx];
-
+    int i = 0;
     for (int alpha = 0; alpha < 3; ++alpha)
     {
         for (int beta = alpha; beta < 3; ++beta)
         {
-            this->stress(alpha, beta) = 0;
-            for (int is = 0; is < GlobalV::NSPIN; ++is)
-            {
-                for (int ik = 0; ik < pw_rho->npw; ++ik)
-                {
-                    ggrecipPhi[is][ik]
-                        = -recipPhi[is][ik] * pw_rho->gcar[ik][alpha] * pw_rho->gcar[ik][beta] * pw_rho->tpiba2;
-                }
-                pw_rho->recip2real(ggrecipPhi[is], ggPhi);
-                for (int ir = 0; ir < this->nx; ++ir)
-                {
-                    this->stress(alpha, beta) += tempPhi[is][ir] * ggPhi[ir];
-                }
-            }
-            Parallel_Reduce::reduce_double_all(this->stress(alpha, beta));
-            this->stress(alpha, beta)
-                *= -1. * this->vw_weight * 2. / pw_rho->nxyz; // vw_weight * 2 to convert Hartree to Ry
+            this->stress(alpha, beta) = sigma[i++] * this->vw_weight * 2. / pw_rho->nxyz; // vw_weight * 2 to convert Hartree to Ry
         }
     }
     for (int alpha = 1; alpha < 3; ++alpha)
@@ -228,37 +149,74 @@ void KEDF_vW::get_stress(const double *const *pphi, ModulePW::PW_Basis *pw_rho,
             this->stress(alpha, beta) = this->stress(beta, alpha);
         }
     }
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        delete[] tempPhi[is];
-        delete[] recipPhi[is];
-        delete[] ggrecipPhi[is];
-    }
-    delete[] tempPhi;
-    delete[] recipPhi;
-    delete[] ggrecipPhi;
-    delete[] ggPhi;
 }
 
 // get minus Laplacian phi
 void KEDF_vW::laplacianPhi(const double *const *pphi, double **rLapPhi, ModulePW::PW_Basis *pw_rho)
 {
-    std::complex<double> **recipPhi = new std::complex<double> *[GlobalV::NSPIN];
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
-        recipPhi[is] = new std::complex<double>[pw_rho->npw];
-
-        pw_rho->real2recip(pphi[is], recipPhi[is]);
+        pw_rho->real2recip(pphi[is], this->recipPhi.data());
         for (int ik = 0; ik < pw_rho->npw; ++ik)
         {
-            recipPhi[is][ik] *= pw_rho->gg[ik] * pw_rho->tpiba2;
+            this->recipPhi[ik] *= pw_rho->gg[ik] * pw_rho->tpiba2;
         }
-        pw_rho->recip2real(recipPhi[is], rLapPhi[is]);
+        pw_rho->recip2real(this->recipPhi.data(), rLapPhi[is]);
     }
+}
 
+// since pphi may contain minus element, we define absPhi = std::abs(phi), which is true sqrt(rho)
+void KEDF_vW::abs_phi(const double *const *pphi, ModulePW::PW_Basis *pw_rho)
+{
+    if (static_cast<int>(this->absPhi.size()) != GlobalV::NSPIN * pw_rho->nrxx)
+    {
+        this->absPhi.resize(GlobalV::NSPIN * pw_rho->nrxx);
+        this->lapPhi.resize(GlobalV::NSPIN * pw_rho->nrxx);
+        this->pabsPhi.resize(GlobalV::NSPIN);
+        this->plapPhi.resize(GlobalV::NSPIN);
+        for (int is = 0; is < GlobalV::NSPIN; ++is)
+        {
+            this->pabsPhi[is] = &this->absPhi[is * pw_rho->nrxx];
+            this->plapPhi[is] = &this->lapPhi[is * pw_rho->nrxx];
+        }
+    }
+    this->recipPhi.resize(pw_rho->npw);
+    for (int is = 0; is < GlobalV::NSPIN; ++is)
+    {
+        double *absphi = this->pabsPhi[is];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int ir = 0; ir < this->nx; ++ir)
+        {
+            absphi[ir] = std::abs(pphi[is][ir]);
+        }
+    }
+}
+
+// EvW from absPhi and lapPhi
+double KEDF_vW::sum_energy()
+{
+    double energy = 0.; // in Ry
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
-        delete[] recipPhi[is];
+        const double *absphi = this->pabsPhi[is];
+        const double *lap = this->plapPhi[is];
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:energy)
+#endif
+        for (int ir = 0; ir < this->nx; ++ir)
+        {
+            energy += absphi[ir] * lap[ir];
+        }
+    }
+    if (GlobalV::NSPIN == 1)
+    {
+        energy *= this->dV * 0.5 * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
     }
-    delete[] recipPhi;
-}
\ No newline at end of file
+    else if (GlobalV::NSPIN == 2)
+    {
+        energy *= 2. * 0.5 * this->dV * 0.5 * this->vw_weight * 2.; // vw_weight * 2 to convert Hartree to Ry
+    }
+    return energy;
+}
@@ -9,6 +9,8 @@
 #include "module_base/timer.h"
 #include "module_basis/module_pw/pw_basis.h"
 
+#include <vector>
+
 /**
  * @brief A class which calculates kinetic energy, potential, and stress with von Weizsäcker (vW) KEDF.
  * See Weizsäcker C F. Zeitschrift für Physik, 1935, 96(7): 431-458.
@@ -37,6 +39,15 @@ class KEDF_vW
 
   private:
     void laplacianPhi(const double *const *pphi, double **rLapPhi, ModulePW::PW_Basis *pw_rho);
+    void abs_phi(const double *const *pphi, ModulePW::PW_Basis *pw_rho);
+    double sum_energy();
+
+    // work space kept between calls: |phi|, -nabla^2 |phi| (NSPIN * nrxx) and phi(G) (npw)
+    std::vector<double> absPhi;
+    std::vector<double> lapPhi;
+    std::vector<std::complex<double>> recipPhi;
+    std::vector<double *> pabsPhi;
+    std::vector<double *> plapPhi;
 
     int nx = 0;
     double dV = 0.;
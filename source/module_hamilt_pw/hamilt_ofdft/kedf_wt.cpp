@@ -40,13 +40,16 @@ void KEDF_WT::set_para(int nx, double dV, double alpha, double beta, double nele
 //
 double KEDF_WT::get_energy(const double * const * prho, ModulePW::PW_Basis *pw_rho)
 {
-    double **kernelRhoBeta = new double* [GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is) kernelRhoBeta[is] = new double[pw_rho->nrxx];
+    this->allocWork(pw_rho);
+    double **kernelRhoBeta = this->pkernelRhoBeta.data();
     this->multiKernel(prho, kernelRhoBeta, this->beta, pw_rho);
 
     double energy = 0.; // in Ry
     if (GlobalV::NSPIN == 1)
     {
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:energy)
+#endif
         for (int ir = 0; ir < this->nx; ++ir)
         {
             energy += std::pow(prho[0][ir], this->alpha) * kernelRhoBeta[0][ir];
@@ -67,28 +70,16 @@ double KEDF_WT::get_energy(const double * const * prho, ModulePW::PW_Basis *pw_r
     this->WTenergy = energy;
     Parallel_Reduce::reduce_double_all(this->WTenergy);
 
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        delete[] kernelRhoBeta[is];
-    }
-    delete[] kernelRhoBeta;
-
     return energy;
 }
 
 double KEDF_WT::get_energy_density(const double * const *prho, int is, int ir, ModulePW::PW_Basis *pw_rho)
 {
-    double **kernelRhoBeta = new double* [GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is) kernelRhoBeta[is] = new double[pw_rho->nrxx];
+    this->allocWork(pw_rho);
+    double **kernelRhoBeta = this->pkernelRhoBeta.data();
     this->multiKernel(prho, kernelRhoBeta, this->beta, pw_rho);
 
     double result = this->cTF * std::pow(prho[is][ir], this->alpha) * kernelRhoBeta[is][ir];
-
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        delete[] kernelRhoBeta[is];
-    }
-    delete[] kernelRhoBeta;
     return result;
 }
 
@@ -100,32 +91,45 @@ void KEDF_WT::WT_potential(const double * const *prho, ModulePW::PW_Basis *pw_rh
 {
     ModuleBase::timer::tick("KEDF_WT", "wt_potential");
 
-    double **kernelRhoBeta = new double* [GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is) kernelRhoBeta[is] = new double[pw_rho->nrxx];
+    this->allocWork(pw_rho);
+    double **kernelRhoBeta = this->pkernelRhoBeta.data();
     this->multiKernel(prho, kernelRhoBeta, this->beta, pw_rho);
 
-    double **kernelRhoAlpha = new double* [GlobalV::NSPIN];
-    for (int is = 0; is < GlobalV::NSPIN; ++is) kernelRhoAlpha[is] = new double[pw_rho->nrxx];
-    this->multiKernel(prho, kernelRhoAlpha, this->alpha, pw_rho);
+    // the kernel is even, so both convolutions are the same one if alpha == beta
+    const bool same_exponent = (this->alpha == this->beta);
+    double **kernelRhoAlpha = kernelRhoBeta;
+    if (!same_exponent)
+    {
+        kernelRhoAlpha = this->pkernelRhoAlpha.data();
+        this->multiKernel(prho, kernelRhoAlpha, this->alpha, pw_rho);
+    }
 
+    // calculate potential and energy in one pass, rho^alpha = rho * rho^{alpha-1}
+    double energy = 0.; // in Ry
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
+        const double *rho = prho[is];
+        const double *kRhoBeta = kernelRhoBeta[is];
+        const double *kRhoAlpha = kernelRhoAlpha[is];
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:energy)
+#endif
         for (int ir = 0; ir < this->nx; ++ir)
         {
+            const double rhoAlpha1 = std::pow(rho[ir], this->alpha - 1.);
+            const double rhoBeta1 = same_exponent ? rhoAlpha1 : std::pow(rho[ir], this->beta - 1.);
             rpotential(is, ir) += this->cTF *
-                                    (this->alpha * std::pow(prho[is][ir], this->alpha-1.) * kernelRhoBeta[is][ir]
-                                    + this->beta * std::pow(prho[is][ir], this->beta-1.) * kernelRhoAlpha[is][ir]);
+                                    (this->alpha * rhoAlpha1 * kRhoBeta[ir]
+                                    + this->beta * rhoBeta1 * kRhoAlpha[ir]);
+            if (rho[ir] > 0.)
+            {
+                energy += rho[ir] * rhoAlpha1 * kRhoBeta[ir];
+            }
         }
     }
 
-    // calculate energy
-    double energy = 0.; // in Ry
     if (GlobalV::NSPIN == 1)
     {
-        for (int ir = 0; ir < this->nx; ++ir)
-        {
-            energy += std::pow(prho[0][ir], this->alpha) * kernelRhoBeta[0][ir];
-        }
         energy *= this->dV * this->cTF;
     }
     else if (GlobalV::NSPIN == 2)
@@ -138,17 +142,11 @@ void KEDF_WT::WT_potential(const double * const *prho, ModulePW::PW_Basis *pw_rh
         //     }
         // }
         // energy *= 0.5 * this->dV * 0.5;
+        energy = 0.;
     }
     this->WTenergy = energy;
     Parallel_Reduce::reduce_double_all(this->WTenergy);
 
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        delete[] kernelRhoBeta[is];
-        delete[] kernelRhoAlpha[is];
-    }
-    delete[] kernelRhoBeta;
-    delete[] kernelRhoAlpha;
     ModuleBase::timer::tick("KEDF_WT", "wt_potential");
 }
 
@@ -167,53 +165,74 @@ void KEDF_WT::get_stress(double cellVol, const double * const * prho, ModulePW::
         mult = 2./3.;
     }
 
-    std::complex<double> **recipRhoAlpha = new std::complex<double> *[GlobalV::NSPIN];
-    std::complex<double> **recipRhoBeta = new std::complex<double> *[GlobalV::NSPIN];
-    double *tempRho = new double[this->nx];
+    // rho^alpha and rho^beta in reciprocal space, the latter is not needed if alpha == beta
+    const bool same_exponent = (this->alpha == this->beta);
+    std::vector<std::complex<double>> recipRhoAlpha(pw_rho->npw);
+    std::vector<std::complex<double>> recipRhoBeta(same_exponent ? 0 : pw_rho->npw);
+    std::vector<double> tempRho(this->nx);
+
+    double sigma[6] = {0., 0., 0., 0., 0., 0.};
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
-        recipRhoAlpha[is] = new std::complex<double>[pw_rho->npw];
-        recipRhoBeta[is] = new std::complex<double>[pw_rho->npw];
-
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (int ir = 0; ir < this->nx; ++ir)
         {
             tempRho[ir] = std::pow(prho[is][ir], this->alpha);
         }
-        pw_rho->real2recip(tempRho, recipRhoAlpha[is]);
+        pw_rho->real2recip(tempRho.data(), recipRhoAlpha.data());
 
-        for (int ir = 0; ir < this->nx; ++ir)
+        const std::complex<double> *recipBeta = recipRhoAlpha.data();
+        if (!same_exponent)
         {
-            tempRho[ir] = std::pow(prho[is][ir], this->beta);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int ir = 0; ir < this->nx; ++ir)
+            {
+                tempRho[ir] = std::pow(prho[is][ir], this->beta);
+            }
+            pw_rho->real2recip(tempRho.data(), recipRhoBeta.data());
+            recipBeta = recipRhoBeta.data();
         }
-        pw_rho->real2recip(tempRho, recipRhoBeta[is]);
-    }
 
-    double eta = 0.;
-    double diff = 0.;
-    this->stress.zero_out();
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
+        double sxx = 0., sxy = 0., sxz = 0., syy = 0., syz = 0., szz = 0.;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:sxx, sxy, sxz, syy, syz, szz)
+#endif
         for (int ip = 0; ip < pw_rho->npw; ++ip)
         {
-            eta = sqrt(pw_rho->gg[ip]) * pw_rho->tpiba / this->tkF;
-            diff = this->diffLinhard(eta, vw_weight);
-            diff *= eta * (recipRhoAlpha[is][ip] * std::conj(recipRhoBeta[is][ip])).real();
-            // cout << "diff    " << diff << endl;
-            for (int a = 0; a < 3; ++a)
+            if (pw_rho->gg[ip] == 0.)
             {
-                for (int b = a; b < 3; ++b)
-                {
-                    if (pw_rho->gg[ip] == 0.)
-                    {
-                        continue;
-                    }
-                    else
-                    {
-                        this->stress(a,b) += - diff * pw_rho->gcar[ip][a] * pw_rho->gcar[ip][b] / pw_rho->gg[ip];
-                        if (a == b) this->stress(a,b) += diff * coef;
-                    }
-                }
+                continue;
             }
+            const double eta = sqrt(pw_rho->gg[ip]) * pw_rho->tpiba / this->tkF;
+            double diff = this->diffLinhard(eta, vw_weight);
+            diff *= eta * (recipRhoAlpha[ip] * std::conj(recipBeta[ip])).real();
+            const ModuleBase::Vector3<double> &g = pw_rho->gcar[ip];
+            const double fac = - diff / pw_rho->gg[ip];
+            sxx += fac * g.x * g.x + diff * coef;
+            sxy += fac * g.x * g.y;
+            sxz += fac * g.x * g.z;
+            syy += fac * g.y * g.y + diff * coef;
+            syz += fac * g.y * g.z;
+            szz += fac * g.z * g.z + diff * coef;
+        }
+        sigma[0] += sxx;
+        sigma[1] += sxy;
+        sigma[2] += sxz;
+        sigma[3] += syy;
+        sigma[4] += syz;
+        sigma[5] += szz;
+    }
+
+    int i = 0;
+    for (int a = 0; a < 3; ++a)
+    {
+        for (int b = a; b < 3; ++b)
+        {
+            this->stress(a,b) = sigma[i++];
         }
     }
 
@@ -242,15 +261,6 @@ void KEDF_WT::get_stress(double cellVol, const double * const * prho, ModulePW::
             this->stress(a,b) = this->stress(b,a);
         }
     }
-
-    for (int is = 0; is < GlobalV::NSPIN; ++is)
-    {
-        delete[] recipRhoAlpha[is];
-        delete[] recipRhoBeta[is];
-    }
-    delete[] recipRhoAlpha;
-    delete[] recipRhoBeta;
-    delete[] tempRho;
 }
 
 // Calculate WT kernel according to Lindhard response function
@@ -327,27 +337,39 @@ double KEDF_WT::diffLinhard(double eta, double vw_weight)
 // Calculate \int{W(r-r')rho^{exponent}(r') dr'}
 void KEDF_WT::multiKernel(const double * const * prho, double **rkernelRho, double exponent, ModulePW::PW_Basis *pw_rho)
 {
-    std::complex<double> **recipkernelRho = new std::complex<double> *[GlobalV::NSPIN];
+    this->recipkernelRho.resize(pw_rho->npw);
+    std::complex<double> *recipkernelRho = this->recipkernelRho.data();
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
-        recipkernelRho[is] = new std::complex<double>[pw_rho->npw];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (int ir = 0; ir < this->nx; ++ir)
         {
             rkernelRho[is][ir] = std::pow(prho[is][ir], exponent);
         }
-        pw_rho->real2recip(rkernelRho[is], recipkernelRho[is]);
+        pw_rho->real2recip(rkernelRho[is], recipkernelRho);
         for (int ip = 0; ip < pw_rho->npw; ++ip)
         {
-            recipkernelRho[is][ip] *= this->kernel[ip];
+            recipkernelRho[ip] *= this->kernel[ip];
         }
-        pw_rho->recip2real(recipkernelRho[is], rkernelRho[is]);
+        pw_rho->recip2real(recipkernelRho, rkernelRho[is]);
     }
+}
 
+// Allocate the work space of multiKernel results, kept until the grid changes
+void KEDF_WT::allocWork(ModulePW::PW_Basis *pw_rho)
+{
+    if (static_cast<int>(this->kernelRhoBeta.size()) == GlobalV::NSPIN * pw_rho->nrxx) return;
+    this->kernelRhoBeta.resize(GlobalV::NSPIN * pw_rho->nrxx);
+    this->kernelRhoAlpha.resize(GlobalV::NSPIN * pw_rho->nrxx);
+    this->pkernelRhoBeta.resize(GlobalV::NSPIN);
+    this->pkernelRhoAlpha.resize(GlobalV::NSPIN);
     for (int is = 0; is < GlobalV::NSPIN; ++is)
     {
-        delete[] recipkernelRho[is];
+        this->pkernelRhoBeta[is] = &this->kernelRhoBeta[is * pw_rho->nrxx];
+        this->pkernelRhoAlpha[is] = &this->kernelRhoAlpha[is * pw_rho->nrxx];
     }
-    delete[] recipkernelRho;
 }
 
 void KEDF_WT::fillKernel(double tf_weight, double vw_weight, ModulePW::PW_Basis *pw_rho)
@@ -9,6 +9,8 @@
 #include "module_base/timer.h"
 #include "module_basis/module_pw/pw_basis.h"
 
+#include <vector>
+
 /**
  * @brief A class which calculates kinetic energy, potential, and stress with Wang-Teter (WT) KEDF.
  * See Wang L W, Teter M P. Physical Review B, 1992, 45(23): 13196.
@@ -52,6 +54,7 @@ class KEDF_WT
     void multiKernel(const double *const *prho, double **rkernelRho, double exponent, ModulePW::PW_Basis *pw_rho);
     void readKernel(std::string fileName, ModulePW::PW_Basis *pw_rho);
     void fillKernel(double tf_weight, double vw_weight, ModulePW::PW_Basis *pw_rho);
+    void allocWork(ModulePW::PW_Basis *pw_rho);
 
     int nx = 0;
     double dV = 0.;
@@ -66,5 +69,12 @@ class KEDF_WT
           * 2; // 10/3*(3*pi^2)^{2/3}, multiply by 2 to convert unit from Hartree to Ry, finally in Ry*Bohr^(-2)
     double WTcoef = 0.; // coefficient of WT kernel
     double *kernel;
+
+    // work space kept between calls, \int{W(r-r')rho^{beta}(r') dr'} and \int{W(r-r')rho^{alpha}(r') dr'} (NSPIN * nrxx)
+    std::vector<double> kernelRhoBeta;
+    std::vector<double> kernelRhoAlpha;
+    std::vector<double *> pkernelRhoBeta;
+    std::vector<double *> pkernelRhoAlpha;
+    std::vector<std::complex<double>> recipkernelRho; // dim = npw
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "module_base/global_variable.h"
+#include "module_base/parallel_global.h"
+#include "module_base/parallel_reduce.h"
+#include "module_hamilt_pw/hamilt_ofdft/kedf_lkt.h"
+#include "module_hamilt_pw/hamilt_ofdft/kedf_tf.h"
+#include "module_hamilt_pw/hamilt_ofdft/kedf_vw.h"
+#include "module_hamilt_pw/hamilt_ofdft/kedf_wt.h"
+
+/************************************************
+ *  unit test of KEDF_TF, KEDF_vW, KEDF_WT and KEDF_LKT
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - KEDF_TF::get_energy, tf_potential, get_stress
+ *   - KEDF_vW::get_energy, vW_potential, get_stress
+ *   - KEDF_WT::get_energy, WT_potential, get_stress
+ *     - with alpha == beta and alpha != beta
+ *   - KEDF_LKT::get_energy, lkt_potential, get_stress
+ *
+ * The energy, the integrals \int{V} and \int{V rho} of the potential of each spin, and the
+ * stress are compared with reference values for nspin = 1 and 2. The reference values were
+ * computed by the functionals before they were fused and threaded, on the same grid and density.
+ */
+
+namespace
+{
+double tol(const double ref)
+{
+    return 1e-10 * std::max(1.0, std::abs(ref));
+}
+
+// energy of each nspin, \int{V} and \int{V rho} of each spin, and stress xx, yy, zz, xy, xz, yz
+struct KEDFRef
+{
+    double energy[2];
+    double pot[2][2][2]; // [nspin - 1][is][\int{V}, \int{V rho}]
+    double stress[2][6];
+};
+} // namespace
+
+class KEDFTest : public ::testing::Test
+{
+  protected:
+    ModulePW::PW_Basis rhopw;
+    double dV = 0.0;
+    double omega = 0.0;
+    double nelec = 0.0;
+    std::vector<std::vector<double>> rho;
+    std::vector<std::vector<double>> phi;
+    std::vector<double*> prho;
+    std::vector<double*> pphi;
+
+    void SetUp() override
+    {
+#ifdef __MPI
+        rhopw.initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
+#endif
+        const ModuleBase::Matrix3 latvec(1.0, 0.1, 0.0, 0.0, 1.1, 0.0, 0.2, 0.0, 1.2);
+        rhopw.initgrids(6.0, latvec, 30.0);
+        rhopw.initparameters(false, 30.0);
+        rhopw.setuptransform();
+        rhopw.collect_local_pw();
+        omega = rhopw.omega;
+        dV = omega / rhopw.nxyz;
+        nelec = 0.02 * omega;
+        GlobalV::of_wt_rho0 = 0.0;
+        GlobalV::of_hold_rho0 = false;
+    }
+
+    // a smooth positive density given by the fractional coordinates of the grid points,
+    // so that it does not depend on the distribution of the planes among processes
+    void set_rho(const int nspin)
+    {
+        GlobalV::NSPIN = nspin;
+        rho.assign(nspin, std::vector<double>(rhopw.nrxx));
+        phi.assign(nspin, std::vector<double>(rhopw.nrxx));
+        prho.resize(nspin);
+        pphi.resize(nspin);
+        for (int is = 0; is < nspin; ++is)
+        {
+            for (int ir = 0; ir < rhopw.nrxx; ++ir)
+            {
+                const int ixy = ir / rhopw.nplane;
+                const double x = static_cast<double>(ixy / rhopw.ny) / rhopw.nx;
+                const double y = static_cast<double>(ixy % rhopw.ny) / rhopw.ny;
+                const double z = static_cast<double>(ir % rhopw.nplane + rhopw.startz_current) / rhopw.nz;
+                rho[is][ir] = (0.02 + 0.008 * std::cos(2 * M_PI * x) + 0.005 * std::sin(2 * M_PI * (y + z))
+                               + 0.003 * std::cos(4 * M_PI * (x - z) + is))
+                              / nspin;
+                phi[is][ir] = std::sqrt(rho[is][ir]);
+            }
+            prho[is] = rho[is].data();
+            pphi[is] = phi[is].data();
+        }
+    }
+
+    void check_potential(const ModuleBase::matrix& pot, const KEDFRef& ref, const int nspin)
+    {
+        for (int is = 0; is < nspin; ++is)
+        {
+            double sum[2] = {0.0, 0.0};
+            for (int ir = 0; ir < rhopw.nrxx; ++ir)
+            {
+                sum[0] += pot(is, ir) * dV;
+                sum[1] += pot(is, ir) * rho[is][ir] * dV;
+            }
+            Parallel_Reduce::reduce_double_all(sum, 2);
+            const double* pot_ref = ref.pot[nspin - 1][is];
+            EXPECT_NEAR(sum[0], pot_ref[0], tol(pot_ref[0])) << "nspin = " << nspin << ", is = " << is;
+            EXPECT_NEAR(sum[1], pot_ref[1], tol(pot_ref[1])) << "nspin = " << nspin << ", is = " << is;
+        }
+    }
+
+    void check_stress(const ModuleBase::matrix& stress, const KEDFRef& ref, const int nspin)
+    {
+        const int index[6][2] = {{0, 0}, {1, 1}, {2, 2}, {0, 1}, {0, 2}, {1, 2}};
+        for (int i = 0; i < 6; ++i)
+        {
+            const int a = index[i][0];
+            const int b = index[i][1];
+            const double stress_ref = ref.stress[nspin - 1][i];
+            EXPECT_NEAR(stress(a, b), stress_ref, tol(stress_ref)) << "nspin = " << nspin << ", " << a << b;
+            EXPECT_NEAR(stress(b, a), stress_ref, tol(stress_ref)) << "nspin = " << nspin << ", " << b << a;
+        }
+    }
+
+    void test_wt(const double alpha, const double beta, const KEDFRef& ref)
+    {
+        for (const int nspin: {1, 2})
+        {
+            this->set_rho(nspin);
+            const double energy_ref = ref.energy[nspin - 1];
+            ModuleBase::matrix pot(nspin, rhopw.nrxx);
+            KEDF_WT wt;
+            wt.set_para(rhopw.nrxx, dV, alpha, beta, nelec, 1.0, 1.0, false, "", &rhopw);
+            wt.get_energy(prho.data(), &rhopw);
+            EXPECT_NEAR(wt.WTenergy, energy_ref, tol(energy_ref)) << "nspin = " << nspin;
+            wt.WT_potential(prho.data(), &rhopw, pot);
+            EXPECT_NEAR(wt.WTenergy, energy_ref, tol(energy_ref)) << "nspin = " << nspin;
+            this->check_potential(pot, ref, nspin);
+            wt.get_stress(omega, prho.data(), &rhopw, 1.0);
+            this->check_stress(wt.stress, ref, nspin);
+        }
+    }
+};
+
+TEST_F(KEDFTest, TF)
+{
+    const KEDFRef ref = {{2.57880698190469, 2.57880698190469},
+                         {{{198.081429948542, 4.29801163650782}, {0.0, 0.0}},
+                          {{198.081429948542, 2.14900581825391}, {198.08142994854, 2.14900581825391}}},
+                         {{0.00602975818814228, 0.00602975818814228, 0.00602975818814228,
+                           0.0, 0.0, 0.0},
+                          {0.00602975818814228, 0.00602975818814228, 0.00602975818814228,
+                           0.0, 0.0, 0.0}}};
+    for (const int nspin: {1, 2})
+    {
+        this->set_rho(nspin);
+        const double energy_ref = ref.energy[nspin - 1];
+        ModuleBase::matrix pot(nspin, rhopw.nrxx);
+        KEDF_TF tf;
+        tf.set_para(rhopw.nrxx, dV, 1.0);
+        tf.get_energy(prho.data());
+        EXPECT_NEAR(tf.TFenergy, energy_ref, tol(energy_ref)) << "nspin = " << nspin;
+        tf.tf_potential(prho.data(), pot);
+        EXPECT_NEAR(tf.TFenergy, energy_ref, tol(energy_ref)) << "nspin = " << nspin;
+        this->check_potential(pot, ref, nspin);
+        tf.get_stress(omega);
+        this->check_stress(tf.stress, ref, nspin);
+    }
+}
+
+TEST_F(KEDFTest, vW)
+{
+    const KEDFRef ref = {{0.392347612833596, 0.392347612834134},
+                         {{{2.14966933143046e-14, 0.204513461998887}, {0.0, 0.0}},
+                          {{1.11056996932035e-14, 0.0723064279116751}, {1.19886739424757e-14, 0.0723064279117404}}},
+                         {{0.00154717162238661, 0.000323705919373087, 0.000881280236253753,
+                           -3.22955280059653e-05, -0.00076440700621934, 0.000302067218469251},
+                          {0.00154717162238773, 0.000323705919371583, 0.000881280236257906,
+                           -3.22955280084159e-05, -0.000764407006221617, 0.000302067218470077}}};
+    for (const int nspin: {1, 2})
+    {
+        this->set_rho(nspin);
+        const double energy_ref = ref.energy[nspin - 1];
+        ModuleBase::matrix pot(nspin, rhopw.nrxx);
+        KEDF_vW vw;
+        vw.set_para(rhopw.nrxx, dV, 1.0);
+        vw.get_energy(pphi.data(), &rhopw);
+        EXPECT_NEAR(vw.vWenergy, energy_ref, tol(energy_ref)) << "nspin = " << nspin;
+        vw.vW_potential(pphi.data(), &rhopw, pot);
+        EXPECT_NEAR(vw.vWenergy, energy_ref, tol(energy_ref)) << "nspin = " << nspin;
+        this->check_potential(pot, ref, nspin);
+        vw.get_stress(pphi.data(), &rhopw);
+        this->check_stress(vw.stress, ref, nspin);
+    }
+}
+
+TEST_F(KEDFTest, WTSameExponent)
+{
+    const KEDFRef ref = {{-0.202804851124632, 0.0},
+                         {{{3.94619881417003, -0.33800808520772}, {0.0, 0.0}},
+                          {{2.4859494765215, -0.106465875396967}, {2.4859494765641, -0.106465875396972}}},
+                         {{-0.000820684414044013, -0.000306263135320702, -0.00029564540184623,
+                           2.09242179192854e-05, 0.000137386863739328, -0.000197778835937647},
+                          {-0.000218272983510231, 0.00010579211527845, 0.000112480868231781,
+                           1.3181431304547e-05, 8.65483008021109e-05, -0.000124592859310771}}};
+    this->test_wt(5. / 6., 5. / 6., ref);
+}
+
+TEST_F(KEDFTest, WTDifferentExponent)
+{
+    const KEDFRef ref = {{-0.204288314073504, 0.0},
+                         {{{4.18894869632318, -0.340480523455839}, {0.0, 0.0}},
+                          {{2.63887231971367, -0.107244644645309}, {2.63887231998387, -0.107244644645367}}},
+                         {{-0.000828767278559052, -0.000307259786116143, -0.000296971771418406,
+                           2.26393921782278e-05, 0.000140753785967394, -0.000201208434803142},
+                          {-0.000221179770182179, 0.000107349363521264, 0.000113830406660915,
+                           1.42619233810909e-05, 8.86693288963728e-05, -0.000126753371212448}}};
+    this->test_wt(5. / 6. + std::sqrt(5.) / 6., 5. / 6. - std::sqrt(5.) / 6., ref);
+}
+
+TEST_F(KEDFTest, LKT)
+{
+    const KEDFRef ref = {{2.41445200850615, 0.0},
+                         {{{202.998006009634, 4.11728941081173}, {0.0, 0.0}},
+                          {{0.0, 0.0}, {0.0, 0.0}}},
+                         {{0.00542857719939372, 0.00584447143109303, 0.00566334312390541,
+                           7.5399791957184e-07, 0.0002447671847917, -0.000108458687309264},
+                          {0.0, 0.0, 0.0,
+                           0.0, 0.0, 0.0}}};
+    for (const int nspin: {1, 2})
+    {
+        this->set_rho(nspin);
+        const double energy_ref = ref.energy[nspin - 1];
+        ModuleBase::matrix pot(nspin, rhopw.nrxx);
+        KEDF_LKT lkt;
+        lkt.set_para(rhopw.nrxx, dV, 1.3);
+        lkt.get_energy(prho.data(), &rhopw);
+        EXPECT_NEAR(lkt.LKTenergy, energy_ref, tol(energy_ref)) << "nspin = " << nspin;
+        lkt.lkt_potential(prho.data(), &rhopw, pot);
+        EXPECT_NEAR(lkt.LKTenergy, energy_ref, tol(energy_ref)) << "nspin = " << nspin;
+        this->check_potential(pot, ref, nspin);
+        lkt.get_stress(omega, prho.data(), &rhopw);
+        this->check_stress(lkt.stress, ref, nspin);
+    }
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_split(MPI_COMM_WORLD, 0, 1, &POOL_WORLD);
+    MPI_Comm_size(POOL_WORLD, &GlobalV::NPROC_IN_POOL);
+    MPI_Comm_rank(POOL_WORLD, &GlobalV::RANK_IN_POOL);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
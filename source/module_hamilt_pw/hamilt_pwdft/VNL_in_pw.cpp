@@ -13,6 +13,7 @@
 #include "module_base/memory.h"
 #include "module_psi/kernels/device.h"
 #include "module_hamilt_pw/hamilt_pwdft/kernels/vnl_op.h"
+#include <type_traits>
 
 
 pseudopot_cell_vnl::pseudopot_cell_vnl()
@@ -22,7 +23,7 @@ pseudopot_cell_vnl::pseudopot_cell_vnl()
 pseudopot_cell_vnl::~pseudopot_cell_vnl()
 {
     if (GlobalV::device_flag == "gpu") {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             delmem_sd_op()(gpu_ctx, this->s_deeq);
             delmem_sd_op()(gpu_ctx, this->s_nhtol);
             delmem_sd_op()(gpu_ctx, this->s_nhtolm);
@@ -31,7 +32,7 @@ pseudopot_cell_vnl::~pseudopot_cell_vnl()
             delmem_cd_op()(gpu_ctx, this->c_deeq_nc);
             delmem_cd_op()(gpu_ctx, this->c_vkb);
         }
-        else {
+        if (GlobalV::precision_flag != "single") {
             delmem_zd_op()(gpu_ctx, this->z_deeq_nc);
         }
         delmem_dd_op()(gpu_ctx, this->d_deeq);
@@ -42,7 +43,7 @@ pseudopot_cell_vnl::~pseudopot_cell_vnl()
         delmem_dd_op()(gpu_ctx, this->d_nhtolm);
     }
     else {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             delmem_sh_op()(cpu_ctx, this->s_deeq);
             delmem_sh_op()(cpu_ctx, this->s_nhtol);
             delmem_sh_op()(cpu_ctx, this->s_nhtolm);
@@ -118,14 +119,14 @@ void pseudopot_cell_vnl::init(const int ntype,
 		this->deeq.create(GlobalV::NSPIN, GlobalC::ucell.nat, this->nhm, this->nhm);
 		this->deeq_nc.create(GlobalV::NSPIN, GlobalC::ucell.nat, this->nhm, this->nhm);
         if (GlobalV::device_flag == "gpu") {
-            if (GlobalV::precision_flag == "single") {
+            if (GlobalV::precision_flag != "double") {
                 resmem_sd_op()(gpu_ctx, s_deeq, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm);
                 resmem_sd_op()(gpu_ctx, s_nhtol, ntype * this->nhm);
                 resmem_sd_op()(gpu_ctx, s_nhtolm, ntype * this->nhm);
                 resmem_sd_op()(gpu_ctx, s_indv, ntype * this->nhm);
                 resmem_cd_op()(gpu_ctx, c_deeq_nc, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm);
             }
-            else {
+            if (GlobalV::precision_flag != "single") {
                 resmem_zd_op()(gpu_ctx, z_deeq_nc, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm);
             }
             resmem_dd_op()(gpu_ctx, d_deeq, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm);
@@ -134,14 +135,14 @@ void pseudopot_cell_vnl::init(const int ntype,
             resmem_dd_op()(gpu_ctx, d_nhtolm, ntype * this->nhm);
         }
         else {
-            if (GlobalV::precision_flag == "single") {
+            if (GlobalV::precision_flag != "double") {
                 resmem_sh_op()(cpu_ctx, s_deeq, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm, "VNL::s_deeq");
                 resmem_sh_op()(cpu_ctx, s_nhtol, ntype * this->nhm, "VNL::s_nhtol");
                 resmem_sh_op()(cpu_ctx, s_nhtolm, ntype * this->nhm, "VNL::s_nhtolm");
                 resmem_sh_op()(cpu_ctx, s_indv, ntype * this->nhm, "VNL::s_indv");
                 resmem_ch_op()(cpu_ctx, c_deeq_nc, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm, "VNL::c_deeq_nc");
             }
-            else {
+            if (GlobalV::precision_flag != "single") {
                 this->z_deeq_nc = this->deeq_nc.ptr;
             }
             this->d_deeq = this->deeq.ptr;
@@ -208,7 +209,7 @@ void pseudopot_cell_vnl::init(const int ntype,
 		ModuleBase::Memory::record("VNL::tab_at", ntype * nchix_nc * GlobalV::NQX * sizeof(double));
 	}
     if (GlobalV::device_flag == "gpu") {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             resmem_sd_op()(gpu_ctx, s_tab, this->tab.getSize());
             resmem_cd_op()(gpu_ctx, c_vkb, nkb * npwx);
         }
@@ -216,7 +217,7 @@ void pseudopot_cell_vnl::init(const int ntype,
         resmem_dd_op()(gpu_ctx, d_tab, this->tab.getSize());
     }
     else {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             resmem_sh_op()(cpu_ctx, s_tab, this->tab.getSize());
             resmem_ch_op()(cpu_ctx, c_vkb, nkb * npwx);
         }
@@ -395,7 +396,8 @@ void pseudopot_cell_vnl::getvnl(Device * ctx, const int &ik, std::complex<FPTYPE
         atom_nh = h_atom_nh;
         atom_nb = h_atom_nb;
         atom_na = h_atom_na;
-        if (GlobalV::precision_flag == "single") {
+        // the precision of gk follows FPTYPE, both are used in the mixed precision mode
+        if (std::is_same<FPTYPE, float>::value) {
             resmem_var_op()(ctx, gk, npw * 3);
             castmem_var_h2h_op()(cpu_ctx, cpu_ctx, gk, reinterpret_cast<double *>(_gk), npw * 3);
         }
@@ -432,6 +434,9 @@ void pseudopot_cell_vnl::getvnl(Device * ctx, const int &ik, std::complex<FPTYPE
         delmem_int_op()(ctx, atom_nb);
         delmem_int_op()(ctx, atom_na);
     }
+    else if (std::is_same<FPTYPE, float>::value) {
+        delmem_var_op()(ctx, gk);
+    }
     ModuleBase::timer::tick("pp_cell_vnl","getvnl");
 } // end subroutine getvnl
 
@@ -602,7 +607,7 @@ void pseudopot_cell_vnl::init_vnl(UnitCell &cell)
 		delete[] jl;
 	}
     if (GlobalV::device_flag == "gpu") {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             castmem_d2s_h2d_op()(gpu_ctx, cpu_ctx, this->s_indv, this->indv.c, this->indv.nr * this->indv.nc);
             castmem_d2s_h2d_op()(gpu_ctx, cpu_ctx, this->s_nhtol, this->nhtol.c, this->nhtol.nr * this->nhtol.nc);
             castmem_d2s_h2d_op()(gpu_ctx, cpu_ctx, this->s_nhtolm, this->nhtolm.c, this->nhtolm.nr * this->nhtolm.nc);
@@ -617,7 +622,7 @@ void pseudopot_cell_vnl::init_vnl(UnitCell &cell)
         syncmem_d2d_h2d_op()(gpu_ctx, cpu_ctx, this->d_tab, this->tab.ptr, this->tab.getSize());
     }
     else {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_indv, this->indv.c, this->indv.nr * this->indv.nc);
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_nhtol, this->nhtol.c, this->nhtol.nr * this->nhtol.nc);
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_nhtolm, this->nhtolm.c, this->nhtolm.nr * this->nhtolm.nc);
@@ -946,17 +951,17 @@ void pseudopot_cell_vnl::cal_effective_D(void)
         }
     }
     if (GlobalV::device_flag == "gpu") {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             castmem_d2s_h2d_op()(gpu_ctx, cpu_ctx, this->s_deeq, this->deeq.ptr, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm);
             castmem_z2c_h2d_op()(gpu_ctx, cpu_ctx, this->c_deeq_nc, this->deeq_nc.ptr, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm);
         }
-        else {
+        if (GlobalV::precision_flag != "single") {
             syncmem_z2z_h2d_op()(gpu_ctx, cpu_ctx, this->z_deeq_nc, this->deeq_nc.ptr, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm);
         }
         syncmem_d2d_h2d_op()(gpu_ctx, cpu_ctx, this->d_deeq, this->deeq.ptr, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm);
     }
     else {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_deeq, this->deeq.ptr, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm);
             castmem_z2c_h2h_op()(cpu_ctx, cpu_ctx, this->c_deeq_nc, this->deeq_nc.ptr, GlobalV::NSPIN * GlobalC::ucell.nat * this->nhm * this->nhm);
         }
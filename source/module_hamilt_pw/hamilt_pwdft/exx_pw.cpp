@@ -0,0 +1,278 @@
+#include "exx_pw.h"
+
+#include "module_base/blas_connector.h"
+#include "module_base/constants.h"
+#include "module_base/global_variable.h"
+#include "module_base/lapack_connector.h"
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+#include "module_base/tool_title.h"
+
+#include <algorithm>
+#include <cmath>
+
+Exx_PW::Exx_PW(const Exx_Info::Exx_Info_Global& info_in) : info(info_in)
+{
+}
+
+void Exx_PW::init(const ModulePW::PW_Basis* rho_basis_in,
+                  const ModulePW::PW_Basis_K* wfc_basis_in,
+                  const K_Vectors* kv_in)
+{
+    this->rho_basis = rho_basis_in;
+    this->wfc_basis = wfc_basis_in;
+    this->kv = kv_in;
+    if (this->rho_basis->nrxx != this->wfc_basis->nrxx)
+    {
+        ModuleBase::WARNING_QUIT("Exx_PW::init", "the real space grids of rho and psi should be the same");
+    }
+    this->xi.clear();
+    this->nproj = 0;
+}
+
+void Exx_PW::cal_kernel(const int ik, const int iq, const UnitCell& ucell, std::vector<double>& vq) const
+{
+    const ModuleBase::Vector3<double> dk = this->kv->kvec_c[ik] - this->kv->kvec_c[iq];
+    const double fpi_e2 = ModuleBase::FOUR_PI * ModuleBase::e2;
+    vq.resize(this->rho_basis->npw);
+    if (this->info.ccp_type == Conv_Coulomb_Pot_K::Ccp_Type::Hse)
+    {
+        // erfc(omega r)/r, the limit of q -> 0 is pi e2 / omega^2
+        const double omega2 = this->info.hse_omega * this->info.hse_omega;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1024)
+#endif
+        for (int ig = 0; ig < this->rho_basis->npw; ++ig)
+        {
+            const double q2 = (dk + this->rho_basis->gcar[ig]).norm2() * ucell.tpiba2;
+            vq[ig] = (q2 > 1e-8) ? fpi_e2 / q2 * (1.0 - std::exp(-q2 / (4.0 * omega2)))
+                                 : ModuleBase::PI * ModuleBase::e2 / omega2;
+        }
+    }
+    else
+    {
+        // 1/r truncated at the sphere of the volume of the Born-von Karman supercell,
+        // the limit of q -> 0 is 2 pi e2 rc^2
+        const int nq = (GlobalV::NSPIN == 2) ? this->kv->nks / 2 : this->kv->nks;
+        const double rc = std::cbrt(3.0 * ucell.omega * nq / ModuleBase::FOUR_PI);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1024)
+#endif
+        for (int ig = 0; ig < this->rho_basis->npw; ++ig)
+        {
+            const double q2 = (dk + this->rho_basis->gcar[ig]).norm2() * ucell.tpiba2;
+            vq[ig] = (q2 > 1e-8) ? fpi_e2 / q2 * (1.0 - std::cos(std::sqrt(q2) * rc))
+                                 : 2.0 * ModuleBase::PI * ModuleBase::e2 * rc * rc;
+        }
+    }
+}
+
+void Exx_PW::cal_ace(const psi::Psi<std::complex<double>>& psi, const ModuleBase::matrix& wg, const UnitCell& ucell)
+{
+    ModuleBase::TITLE("Exx_PW", "cal_ace");
+    ModuleBase::timer::tick("Exx_PW", "cal_ace");
+
+    const int nks = this->kv->nks;
+    const int nbands = psi.get_nbands();
+    const int nbasis = psi.get_nbasis();
+    const int nrxx = this->wfc_basis->nrxx;
+    const int npw_rho = this->rho_basis->npw;
+    // wg contains the spin degeneracy for nspin = 1, but exchange only couples bands of the same spin
+    const double spin_fac = (GlobalV::NSPIN == 1) ? 0.5 : 1.0;
+
+    // occupied bands of every q in real space, u_mq(r)
+    std::vector<std::vector<double>> occ(nks);
+    std::vector<std::vector<std::complex<double>>> psir_occ(nks);
+    for (int iq = 0; iq < nks; ++iq)
+    {
+        std::vector<int> bands;
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            if (wg(iq, ib) > 1e-8 * this->kv->wk[iq])
+            {
+                bands.push_back(ib);
+                occ[iq].push_back(spin_fac * wg(iq, ib));
+            }
+        }
+        psir_occ[iq].resize(static_cast<size_t>(bands.size()) * nrxx);
+        for (size_t io = 0; io < bands.size(); ++io)
+        {
+            this->wfc_basis->recip2real(&psi(iq, bands[io], 0), &psir_occ[iq][io * nrxx], iq);
+        }
+    }
+
+    this->nproj = nbands;
+    this->xi.resize(nks);
+    std::vector<std::complex<double>> psir(nrxx);
+    std::vector<std::complex<double>> vxr(nrxx);
+    std::vector<std::complex<double>> pair;
+    std::vector<std::complex<double>> pairg(npw_rho);
+    std::vector<std::vector<double>> vkq(nks);
+    std::vector<std::complex<double>> mat(nbands * nbands);
+    const double inv_omega = 1.0 / ucell.omega;
+    for (int ik = 0; ik < nks; ++ik)
+    {
+        const int npwk = this->wfc_basis->npwk[ik];
+        const int ldw = std::max(1, npwk);
+        std::vector<std::complex<double>>& w = this->xi[ik];
+        w.assign(static_cast<size_t>(nbands) * ldw, std::complex<double>(0.0, 0.0));
+        for (int iq = 0; iq < nks; ++iq)
+        {
+            if (this->kv->isk[iq] == this->kv->isk[ik] && !occ[iq].empty())
+            {
+                this->cal_kernel(ik, iq, ucell, vkq[iq]);
+            }
+        }
+
+        // W = V_x psi, (V_x u_nk)(r) = -1/Omega sum_mq f_mq u_mq(r) IFFT[v(k-q+G) FFT[u_mq^* u_nk]](r)
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            this->wfc_basis->recip2real(&psi(ik, ib, 0), psir.data(), ik);
+            std::fill(vxr.begin(), vxr.end(), std::complex<double>(0.0, 0.0));
+            for (int iq = 0; iq < nks; ++iq)
+            {
+                if (this->kv->isk[iq] != this->kv->isk[ik] || occ[iq].empty())
+                {
+                    continue;
+                }
+                const int nocc = occ[iq].size();
+                const std::complex<double>* uq = psir_occ[iq].data();
+                pair.resize(static_cast<size_t>(nocc) * nrxx);
+                // pair densities of band ib with all occupied bands of q
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static, 4096)
+#endif
+                for (int io = 0; io < nocc; ++io)
+                {
+                    for (int ir = 0; ir < nrxx; ++ir)
+                    {
+                        pair[io * nrxx + ir] = std::conj(uq[io * nrxx + ir]) * psir[ir];
+                    }
+                }
+                // the FFTs of rho_basis are distributed in the pool, so they are done one by one
+                for (int io = 0; io < nocc; ++io)
+                {
+                    this->rho_basis->real2recip(&pair[io * nrxx], pairg.data());
+                    const double fac = occ[iq][io] * inv_omega;
+                    const double* vq = vkq[iq].data();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1024)
+#endif
+                    for (int ig = 0; ig < npw_rho; ++ig)
+                    {
+                        pairg[ig] *= fac * vq[ig];
+                    }
+                    this->rho_basis->recip2real(pairg.data(), &pair[io * nrxx]);
+                }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1024)
+#endif
+                for (int ir = 0; ir < nrxx; ++ir)
+                {
+                    std::complex<double> sum(0.0, 0.0);
+                    for (int io = 0; io < nocc; ++io)
+                    {
+                        sum += uq[io * nrxx + ir] * pair[io * nrxx + ir];
+                    }
+                    vxr[ir] -= sum;
+                }
+            }
+            this->wfc_basis->real2recip(vxr.data(), &w[ib * ldw], ik);
+        }
+
+        // M = psi^+ W
+        const std::complex<double> one(1.0, 0.0);
+        const std::complex<double> zero(0.0, 0.0);
+        const char transa = 'C';
+        const char transb = 'N';
+        zgemm_(&transa, &transb, &nbands, &nbands, &npwk, &one, &psi(ik, 0, 0), &nbasis, w.data(), &ldw, &zero,
+               mat.data(), &nbands);
+        Parallel_Reduce::reduce_complex_double_pool(mat.data(), nbands * nbands);
+
+        // -M = L L^+, xi = W L^{-+}
+        for (auto& m: mat)
+        {
+            m = -m;
+        }
+        const char uplo = 'L';
+        int info_potrf = 0;
+        zpotrf_(&uplo, &nbands, mat.data(), &nbands, &info_potrf);
+        if (info_potrf != 0)
+        {
+            ModuleBase::WARNING_QUIT("Exx_PW::cal_ace", "the exchange matrix of psi is not negative definite");
+        }
+        char side = 'R', uplo_l = 'L', trans_c = 'C', diag = 'N';
+        int m_trsm = npwk, n_trsm = nbands, lda = nbands, ldb = ldw;
+        std::complex<double> alpha_trsm = one;
+        ztrsm_(&side, &uplo_l, &trans_c, &diag, &m_trsm, &n_trsm, &alpha_trsm, mat.data(), &lda, w.data(), &ldb);
+    }
+
+    ModuleBase::timer::tick("Exx_PW", "cal_ace");
+}
+
+void Exx_PW::act(const int ik,
+                 const int nvec,
+                 const int ld,
+                 const std::complex<double>* psi_in,
+                 std::complex<double>* hpsi,
+                 const double factor) const
+{
+    if (this->xi.empty())
+    {
+        return;
+    }
+    ModuleBase::timer::tick("Exx_PW", "act");
+    const int npwk = this->wfc_basis->npwk[ik];
+    const int ldw = std::max(1, npwk);
+    std::vector<std::complex<double>> c(this->nproj * nvec);
+    const std::complex<double> one(1.0, 0.0);
+    const std::complex<double> zero(0.0, 0.0);
+    const std::complex<double> alpha(-factor, 0.0);
+    const char trans_c = 'C';
+    const char trans_n = 'N';
+    // c = xi^+ psi, hpsi -= factor * xi c
+    zgemm_(&trans_c, &trans_n, &this->nproj, &nvec, &npwk, &one, this->xi[ik].data(), &ldw, psi_in, &ld, &zero,
+           c.data(), &this->nproj);
+    Parallel_Reduce::reduce_complex_double_pool(c.data(), this->nproj * nvec);
+    zgemm_(&trans_n, &trans_n, &npwk, &nvec, &this->nproj, &alpha, this->xi[ik].data(), &ldw, c.data(), &this->nproj,
+           &one, hpsi, &ld);
+    ModuleBase::timer::tick("Exx_PW", "act");
+}
+
+double Exx_PW::cal_exx_energy(const psi::Psi<std::complex<double>>& psi, const ModuleBase::matrix& wg) const
+{
+    if (this->xi.empty())
+    {
+        return 0.0;
+    }
+    ModuleBase::timer::tick("Exx_PW", "cal_exx_energy");
+    const int nbands = psi.get_nbands();
+    const int nbasis = psi.get_nbasis();
+    std::vector<std::complex<double>> c(this->nproj * nbands);
+    const std::complex<double> one(1.0, 0.0);
+    const std::complex<double> zero(0.0, 0.0);
+    const char trans_c = 'C';
+    const char trans_n = 'N';
+    double exx_energy = 0.0;
+    for (int ik = 0; ik < this->kv->nks; ++ik)
+    {
+        const int npwk = this->wfc_basis->npwk[ik];
+        const int ldw = std::max(1, npwk);
+        zgemm_(&trans_c, &trans_n, &this->nproj, &nbands, &npwk, &one, this->xi[ik].data(), &ldw, &psi(ik, 0, 0),
+               &nbasis, &zero, c.data(), &this->nproj);
+        Parallel_Reduce::reduce_complex_double_pool(c.data(), this->nproj * nbands);
+        // <psi|V_x|psi> = -|xi^+ psi|^2
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            double sum = 0.0;
+            for (int ip = 0; ip < this->nproj; ++ip)
+            {
+                sum += std::norm(c[ib * this->nproj + ip]);
+            }
+            exx_energy -= 0.5 * wg(ik, ib) * sum;
+        }
+    }
+    ModuleBase::timer::tick("Exx_PW", "cal_exx_energy");
+    return exx_energy;
+}
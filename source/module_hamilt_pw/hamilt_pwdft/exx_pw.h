@@ -0,0 +1,70 @@
+#ifndef EXX_PW_H
+#define EXX_PW_H
+
+#include "module_base/matrix.h"
+#include "module_basis/module_pw/pw_basis.h"
+#include "module_basis/module_pw/pw_basis_k.h"
+#include "module_cell/klist.h"
+#include "module_cell/unitcell.h"
+#include "module_hamilt_general/module_xc/exx_info.h"
+#include "module_psi/psi.h"
+
+#include <complex>
+#include <vector>
+
+/**
+ * Exx_PW gives the exact exchange operator in plane wave basis by the adaptively compressed exchange (ACE).
+ * 1. cal_ace() applies the exchange operator V_x to all bands of psi once:
+ *     a. the occupied bands of every q are brought to real space and kept during the construction;
+ *     b. for each band n of k, the pair densities with all occupied bands of q are formed in one threaded pass,
+ *        and the Poisson equation of each pair density is solved by FFTs on the grid of rho_basis;
+ *     c. W = V_x psi and M = psi^+ W give the projectors xi = W L^{-+} with -M = L L^+;
+ * 2. act() applies V_x ~ -xi xi^+ to any psi as two GEMMs of rank nbands, which is exact on the space of psi;
+ * 3. the Coulomb kernel is spherically truncated for "hf"/"pbe0" and erfc-screened for "hse";
+ * 4. only double precision on CPU with all k points in one pool is supported, and npol must be 1.
+ * The hybrid mixing coefficient is not included here, E_x and V_x are those of Hartree-Fock exchange.
+ */
+class Exx_PW
+{
+  public:
+    Exx_PW(const Exx_Info::Exx_Info_Global& info_in);
+
+    const Exx_Info::Exx_Info_Global& info;
+
+    void init(const ModulePW::PW_Basis* rho_basis_in,
+              const ModulePW::PW_Basis_K* wfc_basis_in,
+              const K_Vectors* kv_in);
+
+    // build the ACE projectors from the current psi and occupations
+    void cal_ace(const psi::Psi<std::complex<double>>& psi, const ModuleBase::matrix& wg, const UnitCell& ucell);
+
+    // hpsi += factor * V_x psi for nvec vectors of k point ik with leading dimension ld
+    void act(const int ik,
+             const int nvec,
+             const int ld,
+             const std::complex<double>* psi_in,
+             std::complex<double>* hpsi,
+             const double factor) const;
+
+    // E_x = 1/2 sum_nk wg_nk <psi_nk|V_x|psi_nk>, V_x is given by the ACE projectors
+    double cal_exx_energy(const psi::Psi<std::complex<double>>& psi, const ModuleBase::matrix& wg) const;
+
+    bool ace_done() const
+    {
+        return !this->xi.empty();
+    }
+
+  private:
+    const ModulePW::PW_Basis* rho_basis = nullptr;
+    const ModulePW::PW_Basis_K* wfc_basis = nullptr;
+    const K_Vectors* kv = nullptr;
+
+    // ACE projectors of each k point, [nproj * npwk]
+    std::vector<std::vector<std::complex<double>>> xi;
+    int nproj = 0;
+
+    // Coulomb kernel of the pair densities of k and q on the G vectors of rho_basis, unit in Ry
+    void cal_kernel(const int ik, const int iq, const UnitCell& ucell, std::vector<double>& vq) const;
+};
+
+#endif
@@ -36,6 +36,7 @@ HamiltPW<FPTYPE, Device>::HamiltPW(elecstate::Potential* pot_in, ModulePW::PW_Ba
             this->ops->add(ekinetic);
         }
     }
+    Veff<OperatorPW<FPTYPE, Device>>* veff = nullptr;
     if (GlobalV::VL_IN_H)
     {
         std::vector<std::string> pot_register_in;
@@ -66,12 +67,11 @@ HamiltPW<FPTYPE, Device>::HamiltPW(elecstate::Potential* pot_in, ModulePW::PW_Ba
         {
             //register Potential by gathered operator
             pot_in->pot_register(pot_register_in);
-            Operator<std::complex<FPTYPE>, Device>* veff
-                = new Veff<OperatorPW<FPTYPE, Device>>(isk,
-                                                       pot_in->get_v_effective_data<FPTYPE>(),
-                                                       pot_in->get_effective_v().nr,
-                                                       pot_in->get_effective_v().nc,
-                                                       wfc_basis);
+            veff = new Veff<OperatorPW<FPTYPE, Device>>(isk,
+                                                        pot_in->get_v_effective_data<FPTYPE>(),
+                                                        pot_in->get_effective_v().nr,
+                                                        pot_in->get_effective_v().nc,
+                                                        wfc_basis);
             if(this->ops == nullptr)
             {
                 this->ops = veff;
@@ -92,8 +92,14 @@ HamiltPW<FPTYPE, Device>::HamiltPW(elecstate::Potential* pot_in, ModulePW::PW_Ba
     }
     if (GlobalV::VNL_IN_H)
     {
-        Operator<std::complex<FPTYPE>, Device>* nonlocal
+        Nonlocal<OperatorPW<FPTYPE, Device>>::VKB_CACHE_MB = GlobalV::PW_VKB_CACHE;
+        Nonlocal<OperatorPW<FPTYPE, Device>>* nonlocal
             = new Nonlocal<OperatorPW<FPTYPE, Device>>(isk, &GlobalC::ppcell, &GlobalC::ucell, wfc_basis);
+        // the real space projectors are applied on psi(r) of Veff, without FFTs of their own
+        if (veff != nullptr)
+        {
+            veff->set_nonlocal_real_space(nonlocal);
+        }
         if(this->ops == nullptr)
         {
             this->ops = nonlocal;
@@ -144,6 +150,8 @@ HamiltPW<FPTYPE, Device>::HamiltPW(const HamiltPW<T_in, Device_in> *hamilt)
     OperatorPW<std::complex<T_in>, Device_in> * node =
             reinterpret_cast<OperatorPW<std::complex<T_in>, Device_in> *>(hamilt->ops);
 
+    Veff<OperatorPW<FPTYPE, Device>>* veff = nullptr;
+    Nonlocal<OperatorPW<FPTYPE, Device>>* nonlocal = nullptr;
     while(node != nullptr) {
         if (node->classname == "Ekinetic") {
             Operator<std::complex<FPTYPE>, Device>* ekinetic =
@@ -158,7 +166,7 @@ HamiltPW<FPTYPE, Device>::HamiltPW(const HamiltPW<T_in, Device_in> *hamilt)
             // this->ops = reinterpret_cast<Operator<std::complex<FPTYPE>, Device>*>(node);
         }
         else if (node->classname == "Nonlocal") {
-            Operator<std::complex<FPTYPE>, Device>* nonlocal =
+            nonlocal =
                     new Nonlocal<OperatorPW<FPTYPE, Device>>(
                             reinterpret_cast<const Nonlocal<OperatorPW<T_in, Device_in>>*>(node));
             if(this->ops == nullptr) {
@@ -169,7 +177,7 @@ HamiltPW<FPTYPE, Device>::HamiltPW(const HamiltPW<T_in, Device_in> *hamilt)
             }
         }
         else if (node->classname == "Veff") {
-            Operator<std::complex<FPTYPE>, Device>* veff =
+            veff =
                     new Veff<OperatorPW<FPTYPE, Device>>(
                             reinterpret_cast<const Veff<OperatorPW<T_in, Device_in>>*>(node));
             if(this->ops == nullptr) {
@@ -195,6 +203,10 @@ HamiltPW<FPTYPE, Device>::HamiltPW(const HamiltPW<T_in, Device_in> *hamilt)
         }
         node = reinterpret_cast<OperatorPW<std::complex<T_in>, Device_in> *>(node->next_op);
     }
+    if (veff != nullptr && nonlocal != nullptr)
+    {
+        veff->set_nonlocal_real_space(nonlocal);
+    }
 }
 
 template class HamiltPW<float, psi::DEVICE_CPU>;
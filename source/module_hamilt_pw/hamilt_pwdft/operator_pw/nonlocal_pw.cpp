@@ -1,11 +1,16 @@
 #include "nonlocal_pw.h"
 
 #include "module_base/blas_connector.h"
+#include "module_base/global_variable.h"
+#include "module_base/memory.h"
 #include "module_base/timer.h"
 #include "module_base/parallel_reduce.h"
 #include "module_base/tool_quit.h"
 #include "module_psi/kernels/device.h"
 
+#include <algorithm>
+#include <cmath>
+
 using hamilt::Nonlocal;
 using hamilt::OperatorPW;
 
@@ -24,6 +29,7 @@ Nonlocal<OperatorPW<FPTYPE, Device>>::Nonlocal(const int* isk_in,
     this->deeq = this->ppcell->template get_deeq_data<FPTYPE>();
     this->deeq_nc = this->ppcell->template get_deeq_nc_data<FPTYPE>();
     this->vkb = this->ppcell->template get_vkb_data<FPTYPE>();
+    this->real_space = GlobalV::NONLOCAL_REAL_SPACE;
     if( this->isk == nullptr || this->ppcell == nullptr || this->ucell == nullptr)
     {
         ModuleBase::WARNING_QUIT("NonlocalPW", "Constuctor of Operator::NonlocalPW is failed, please check your code!");
@@ -32,8 +38,13 @@ Nonlocal<OperatorPW<FPTYPE, Device>>::Nonlocal(const int* isk_in,
 
 template<typename FPTYPE, typename Device>
 Nonlocal<OperatorPW<FPTYPE, Device>>::~Nonlocal() {
+    delmem_complex_op()(this->ctx, this->porter);
     delmem_complex_op()(this->ctx, this->ps);
     delmem_complex_op()(this->ctx, this->becp);
+    for (auto& item: this->vkb_cache)
+    {
+        delmem_complex_op()(this->ctx, item.second);
+    }
 }
 
 template<typename FPTYPE, typename Device>
@@ -44,7 +55,11 @@ void Nonlocal<OperatorPW<FPTYPE, Device>>::init(const int ik_in)
     // Calculate nonlocal pseudopotential vkb
 	if(this->ppcell->nkb > 0) //xiaohui add 2013-09-02. Attention...
 	{
-		this->ppcell->getvnl(this->ctx, this->ik, this->vkb);
+		this->update_vkb();
+        if (this->real_space && this->rs_ik != this->ik)
+        {
+            this->update_real_space();
+        }
 	}
 
     if(this->next_op != nullptr)
@@ -55,14 +70,308 @@ void Nonlocal<OperatorPW<FPTYPE, Device>>::init(const int ik_in)
     ModuleBase::timer::tick("Nonlocal", "getvnl");
 }
 
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::update_vkb()
+{
+    const size_t size = static_cast<size_t>(this->ppcell->nkb) * this->ppcell->vkb.nc;
+    auto cached = std::find_if(this->vkb_cache.begin(),
+                               this->vkb_cache.end(),
+                               [this](const std::pair<int, std::complex<FPTYPE>*>& item) { return item.first == this->ik; });
+    if (cached != this->vkb_cache.end())
+    {
+        syncmem_complex_op()(this->ctx, this->ctx, this->vkb, cached->second, size);
+        this->vkb_cache.splice(this->vkb_cache.begin(), this->vkb_cache, cached);
+        return;
+    }
+
+    this->ppcell->getvnl(this->ctx, this->ik, this->vkb);
+    // gamma_only: the projectors are kept in the same convention as the wave functions
+    if (this->wfcpw->gamma_only)
+    {
+        const FPTYPE sqrt2 = std::sqrt(static_cast<FPTYPE>(2.0));
+        for (int ikb = 0; ikb < this->ppcell->nkb; ikb++)
+        {
+            this->wfcpw->scale_gamma(this->vkb + ikb * this->ppcell->vkb.nc, this->ik, sqrt2);
+        }
+    }
+
+    // keep all k points if the budget allows, otherwise drop the least recently used one
+    const size_t max_nk = static_cast<size_t>(VKB_CACHE_MB * 1024 * 1024 / (size * sizeof(std::complex<FPTYPE>)));
+    if (max_nk == 0)
+    {
+        return;
+    }
+    std::complex<FPTYPE>* buffer = nullptr;
+    if (this->vkb_cache.size() < max_nk)
+    {
+        resmem_complex_op()(this->ctx, buffer, size, "no_record");
+        ModuleBase::Memory::record("Nonlocal<PW>::vkb_cache",
+                                   (this->vkb_cache.size() + 1) * size * sizeof(std::complex<FPTYPE>));
+    }
+    else
+    {
+        buffer = this->vkb_cache.back().second;
+        this->vkb_cache.pop_back();
+    }
+    syncmem_complex_op()(this->ctx, this->ctx, buffer, this->vkb, size);
+    this->vkb_cache.emplace_front(this->ik, buffer);
+}
+
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::init_real_space()
+{
+    ModuleBase::timer::tick("Nonlocal", "init_real_space");
+    const int n[3] = {this->wfcpw->nx, this->wfcpw->ny, this->wfcpw->nz};
+    const int startz = this->wfcpw->startz_current;
+    const int nplane = this->wfcpw->nplane;
+    const double lat0 = this->ucell->lat0;
+    // reciprocal lattice vectors in units of 1/lat0, |b_d| * r / lat0 is the extent of r along direction d
+    const ModuleBase::Matrix3& G = this->ucell->G;
+    const double bnorm[3] = {ModuleBase::Vector3<double>(G.e11, G.e12, G.e13).norm(),
+                             ModuleBase::Vector3<double>(G.e21, G.e22, G.e23).norm(),
+                             ModuleBase::Vector3<double>(G.e31, G.e32, G.e33).norm()};
+
+    this->rs_proj.clear();
+    int ikb0 = 0;
+    size_t npts_tot = 0;
+    for (int it = 0; it < this->ucell->ntype; it++)
+    {
+        const Atom& atom = this->ucell->atoms[it];
+        const int nh = atom.ncpp.nh;
+        const double rcut = atom.ncpp.r[std::max(atom.ncpp.kkbeta - 1, 0)] * RS_RCUT_SCALE;
+        for (int ia = 0; ia < atom.na; ia++)
+        {
+            RealSpaceProjector proj;
+            proj.ikb0 = ikb0;
+            proj.nh = nh;
+            ikb0 += nh;
+
+            // box of grid points around the atom, one period centered at the atom if the sphere is larger
+            int lo[3], len[3];
+            for (int d = 0; d < 3; d++)
+            {
+                const double center = atom.taud[ia][d] * n[d];
+                const double extent = rcut / lat0 * bnorm[d] * n[d];
+                lo[d] = static_cast<int>(std::floor(center - extent));
+                len[d] = static_cast<int>(std::ceil(center + extent)) - lo[d] + 1;
+                if (len[d] >= n[d])
+                {
+                    lo[d] = static_cast<int>(std::floor(center)) - n[d] / 2;
+                    len[d] = n[d];
+                }
+            }
+            for (int iz = lo[2]; iz < lo[2] + len[2]; iz++)
+            {
+                const int izw = (iz % n[2] + n[2]) % n[2];
+                if (izw < startz || izw >= startz + nplane)
+                {
+                    continue;
+                }
+                for (int ix = lo[0]; ix < lo[0] + len[0]; ix++)
+                {
+                    const int ixw = (ix % n[0] + n[0]) % n[0];
+                    for (int iy = lo[1]; iy < lo[1] + len[1]; iy++)
+                    {
+                        const int iyw = (iy % n[1] + n[1]) % n[1];
+                        const ModuleBase::Vector3<double> dr
+                            = (this->ucell->a1 * (static_cast<double>(ix) / n[0] - atom.taud[ia].x)
+                               + this->ucell->a2 * (static_cast<double>(iy) / n[1] - atom.taud[ia].y)
+                               + this->ucell->a3 * (static_cast<double>(iz) / n[2] - atom.taud[ia].z))
+                              * lat0;
+                        if (dr.norm() < rcut)
+                        {
+                            proj.ir.push_back((ixw * n[1] + iyw) * nplane + izw - startz);
+                        }
+                    }
+                }
+            }
+            npts_tot += proj.ir.size() * nh;
+            this->rs_proj.push_back(std::move(proj));
+        }
+    }
+    resmem_complex_op()(this->ctx, this->porter, this->wfcpw->nmaxgr, "Nonlocal<PW>::porter");
+    ModuleBase::Memory::record("Nonlocal<PW>::rs_beta", npts_tot * sizeof(std::complex<FPTYPE>));
+    ModuleBase::timer::tick("Nonlocal", "init_real_space");
+}
+
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::update_real_space()
+{
+    if (this->porter == nullptr)
+    {
+        this->init_real_space();
+    }
+    ModuleBase::timer::tick("Nonlocal", "update_real_space");
+    this->rs_ik = this->ik;
+    const int npwx = this->ppcell->vkb.nc;
+    for (auto& proj: this->rs_proj)
+    {
+        const int npts = proj.ir.size();
+        proj.beta.resize(proj.nh * npts);
+        for (int ih = 0; ih < proj.nh; ih++)
+        {
+            // every process takes part in the FFT, even without grid points in this sphere
+            this->wfcpw->recip_to_real(this->ctx, this->vkb + (proj.ikb0 + ih) * npwx, this->porter, this->ik);
+            for (int ip = 0; ip < npts; ip++)
+            {
+                proj.beta[ih * npts + ip] = this->porter[proj.ir[ip]];
+            }
+        }
+    }
+    ModuleBase::timer::tick("Nonlocal", "update_real_space");
+}
+
 //--------------------------------------------------------------------------
-// this function sum up each non-local pseudopotential located on each atom,
+// becp = sum_G vkb^*(G) psi(G) = 1/nxyz * sum_r beta^*(r) psi(r),
+// where beta(r) and psi(r) are the periodic parts given by recip_to_real.
+// Only r inside the sphere of each atom is summed.
 //--------------------------------------------------------------------------
 template<typename FPTYPE, typename Device>
-void Nonlocal<OperatorPW<FPTYPE, Device>>::add_nonlocal_pp(std::complex<FPTYPE> *hpsi_in, const std::complex<FPTYPE> *becp, const int m) const
+void Nonlocal<OperatorPW<FPTYPE, Device>>::becp_on_grid(const std::complex<FPTYPE>* psi_r,
+                                                        std::complex<FPTYPE>* becp_ib) const
 {
-    ModuleBase::timer::tick("Nonlocal", "add_nonlocal_pp");
+    const FPTYPE factor = static_cast<FPTYPE>(1.0) / static_cast<FPTYPE>(this->wfcpw->nxyz);
+    const int nat = this->rs_proj.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int iat = 0; iat < nat; iat++)
+    {
+        const RealSpaceProjector& proj = this->rs_proj[iat];
+        const int npts = proj.ir.size();
+        for (int ih = 0; ih < proj.nh; ih++)
+        {
+            const std::complex<FPTYPE>* beta = proj.beta.data() + ih * npts;
+            std::complex<FPTYPE> sum = 0;
+            for (int ip = 0; ip < npts; ip++)
+            {
+                sum += std::conj(beta[ip]) * psi_r[proj.ir[ip]];
+            }
+            becp_ib[proj.ikb0 + ih] = sum * factor;
+        }
+    }
+}
+
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::ps_on_grid(const std::complex<FPTYPE>* ps_in,
+                                                      const int m,
+                                                      const int ib,
+                                                      std::complex<FPTYPE>* vpsi_r) const
+{
+    // the spheres of different atoms may overlap, so atoms are done one by one
+    for (const RealSpaceProjector& proj: this->rs_proj)
+    {
+        const int npts = proj.ir.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int ip = 0; ip < npts; ip++)
+        {
+            std::complex<FPTYPE> sum = 0;
+            for (int ih = 0; ih < proj.nh; ih++)
+            {
+                sum += proj.beta[ih * npts + ip] * ps_in[(proj.ikb0 + ih) * m + ib];
+            }
+            vpsi_r[proj.ir[ip]] += sum;
+        }
+    }
+}
+
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::cal_becp_real_space(const std::complex<FPTYPE>* tmpsi_in, const int m) const
+{
+    ModuleBase::timer::tick("Nonlocal", "becp_real_space");
+    for (int ib = 0; ib < m; ib++)
+    {
+        this->wfcpw->recip_to_real(this->ctx, tmpsi_in + ib * this->max_npw, this->porter, this->ik);
+        this->becp_on_grid(this->porter, this->becp + ib * this->ppcell->nkb);
+    }
+    ModuleBase::timer::tick("Nonlocal", "becp_real_space");
+}
+
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::add_ps_real_space(std::complex<FPTYPE>* hpsi_in, const int m) const
+{
+    for (int ib = 0; ib < m; ib++)
+    {
+        setmem_complex_op()(this->ctx, this->porter, 0, this->wfcpw->nrxx);
+        this->ps_on_grid(this->ps, m, ib, this->porter);
+        // real_to_recip includes the factor 1/nxyz, so |beta> ps is recovered exactly in G space
+        this->wfcpw->real_to_recip(this->ctx, this->porter, hpsi_in + ib * this->max_npw, this->ik, true);
+    }
+}
 
+//--------------------------------------------------------------------------
+// The fused path: psi(r) of each band is given by the Veff operator,
+// which adds |beta> ps to V_eff psi(r) before its own transform back to G space.
+//--------------------------------------------------------------------------
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::cal_ps_real_space_band(const std::complex<FPTYPE>* psi_r) const
+{
+    ModuleBase::timer::tick("Nonlocal", "ps_real_space");
+    const int nkb = this->ppcell->nkb;
+    if (this->nkb_m < nkb)
+    {
+        resmem_complex_op()(this->ctx, this->becp, nkb, "Nonlocal<PW>::becp");
+    }
+    // nspin = 4 is not supported in real space
+    this->npol = 1;
+    this->becp_on_grid(psi_r, this->becp);
+    Parallel_Reduce::reduce_complex_double_pool(this->becp, nkb);
+    this->cal_ps(this->becp, 1);
+    ModuleBase::timer::tick("Nonlocal", "ps_real_space");
+}
+
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::add_ps_real_space_band(std::complex<FPTYPE>* vpsi_r) const
+{
+    ModuleBase::timer::tick("Nonlocal", "ps_real_space");
+    this->ps_on_grid(this->ps, 1, 0, vpsi_r);
+    ModuleBase::timer::tick("Nonlocal", "ps_real_space");
+}
+
+//--------------------------------------------------------------------------
+// With more than one process in the pool, becp of all bands is collected
+// from psi(r) of the Veff operator and reduced once, as in act().
+// |beta> ps is then added with one more FFT per band.
+//--------------------------------------------------------------------------
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::cal_becp_real_space_band(const std::complex<FPTYPE>* psi_r,
+                                                                    const int ib,
+                                                                    const int m) const
+{
+    ModuleBase::timer::tick("Nonlocal", "becp_real_space");
+    const int nkb = this->ppcell->nkb;
+    if (ib == 0 && this->nkb_m < m * nkb)
+    {
+        resmem_complex_op()(this->ctx, this->becp, m * nkb, "Nonlocal<PW>::becp");
+    }
+    this->becp_on_grid(psi_r, this->becp + ib * nkb);
+    ModuleBase::timer::tick("Nonlocal", "becp_real_space");
+}
+
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::add_ps_real_space_bands(std::complex<FPTYPE>* hpsi_in,
+                                                                   const int m,
+                                                                   const int max_npw_in) const
+{
+    ModuleBase::timer::tick("Nonlocal", "ps_real_space");
+    const int nkb = this->ppcell->nkb;
+    Parallel_Reduce::reduce_complex_double_pool(this->becp, nkb * m);
+    // nspin = 4 is not supported in real space
+    this->npol = 1;
+    this->max_npw = max_npw_in;
+    this->cal_ps(this->becp, m);
+    this->add_ps_real_space(hpsi_in, m);
+    ModuleBase::timer::tick("Nonlocal", "ps_real_space");
+}
+
+//--------------------------------------------------------------------------
+// this function sum up each non-local pseudopotential located on each atom,
+//--------------------------------------------------------------------------
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::cal_ps(const std::complex<FPTYPE>* becp, const int m) const
+{
     // number of projectors
     int nkb = this->ppcell->nkb;
 
@@ -155,13 +464,25 @@ void Nonlocal<OperatorPW<FPTYPE, Device>>::add_nonlocal_pp(std::complex<FPTYPE>
             // } // end na
         } // end nt
     }
+}
+
+template<typename FPTYPE, typename Device>
+void Nonlocal<OperatorPW<FPTYPE, Device>>::add_nonlocal_pp(std::complex<FPTYPE> *hpsi_in, const std::complex<FPTYPE> *becp, const int m) const
+{
+    ModuleBase::timer::tick("Nonlocal", "add_nonlocal_pp");
+
+    this->cal_ps(becp, m);
 
     // use simple method.
     //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
     // qianrui optimize 2021-3-31
     char transa = 'N';
     char transb = 'T';
-    if (m == 1)
+    if (this->real_space)
+    {
+        this->add_ps_real_space(hpsi_in, m);
+    }
+    else if (m == 1)
     {
         int inc = 1;
         // denghui replace 2022-10-20
@@ -213,6 +534,11 @@ void Nonlocal<OperatorPW<FPTYPE, Device>>::act
     const std::complex<FPTYPE>* tmpsi_in, 
     std::complex<FPTYPE>* tmhpsi)const
 {
+    if (this->fused_with_veff)
+    {
+        // applied by the Veff operator on psi(r), see cal_ps_real_space_band()
+        return;
+    }
     ModuleBase::timer::tick("Operator", "NonlocalPW");
     this->npw = psi_in->get_ngk(this->ik);
     this->max_npw = psi_in->get_nbasis() / psi_in->npol;
@@ -229,7 +555,11 @@ void Nonlocal<OperatorPW<FPTYPE, Device>>::act
         // ModuleBase::ComplexMatrix becp(n_npwx, nkb, false);
         char transa = 'C';
         char transb = 'N';
-        if (n_npwx == 1)
+        if (this->real_space)
+        {
+            this->cal_becp_real_space(tmpsi_in, n_npwx);
+        }
+        else if (n_npwx == 1)
         {
             int inc = 1;
             // denghui replace 2022-10-20
@@ -272,6 +602,14 @@ void Nonlocal<OperatorPW<FPTYPE, Device>>::act
         }
 
         Parallel_Reduce::reduce_complex_double_pool(becp, nkb * n_npwx);
+        // gamma_only: <beta|psi> of real functions is the real part of the plain dot product
+        if (this->wfcpw->gamma_only)
+        {
+            for (int i = 0; i < nkb * n_npwx; i++)
+            {
+                this->becp[i] = std::complex<FPTYPE>(this->becp[i].real(), 0.0);
+            }
+        }
 
         this->add_nonlocal_pp(tmhpsi, becp, n_npwx);
     }
@@ -288,9 +626,11 @@ hamilt::Nonlocal<OperatorPW<FPTYPE, Device>>::Nonlocal(const Nonlocal<OperatorPW
     this->isk = nonlocal->get_isk();
     this->ppcell = nonlocal->get_ppcell();
     this->ucell = nonlocal->get_ucell();
+    this->wfcpw = nonlocal->get_wfcpw();
     this->deeq = this->ppcell->d_deeq;
     this->deeq_nc = this->ppcell->template get_deeq_nc_data<FPTYPE>();
     this->vkb = this->ppcell->template get_vkb_data<FPTYPE>();
+    this->real_space = GlobalV::NONLOCAL_REAL_SPACE;
     if( this->isk == nullptr || this->ppcell == nullptr || this->ucell == nullptr)
     {
         ModuleBase::WARNING_QUIT("NonlocalPW", "Constuctor of Operator::NonlocalPW is failed, please check your code!");
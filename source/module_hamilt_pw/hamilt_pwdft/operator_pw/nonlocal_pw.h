@@ -9,6 +9,10 @@
 
 #include "module_hamilt_pw/hamilt_pwdft/VNL_in_pw.h"
 
+#include <list>
+#include <utility>
+#include <vector>
+
 namespace hamilt {
 
 #ifndef NONLOCALTEMPLATE_H
@@ -47,9 +51,49 @@ class Nonlocal<OperatorPW<FPTYPE, Device>> : public OperatorPW<FPTYPE, Device>
     const int *get_isk() const {return this->isk;}
     const pseudopot_cell_vnl *get_ppcell() const {return this->ppcell;}
     const UnitCell *get_ucell() const {return this->ucell;}
+    const ModulePW::PW_Basis_K *get_wfcpw() const {return this->wfcpw;}
+
+    /// memory budget in MB of the vkb cache of each Nonlocal operator, 0 to disable the cache,
+    /// set from the input pw_vkb_cache
+    static double VKB_CACHE_MB;
+    /// radius of the real space projectors in units of the cutoff radius of beta functions
+    static double RS_RCUT_SCALE;
+
+    bool get_real_space() const {return this->real_space;}
+    /// the real space projectors are applied by the Veff operator on its own psi(r) of each band,
+    /// act() then does nothing, so no FFT is spent on the nonlocal pseudopotential
+    void set_fused_with_veff(const bool fused_in) {this->fused_with_veff = fused_in;}
+    /// ps = D <beta|psi> of one band from its psi(r), reduced over the pool,
+    /// used by Veff with one process per pool, where the reduction costs nothing
+    void cal_ps_real_space_band(const std::complex<FPTYPE>* psi_r) const;
+    /// vpsi_r += |beta> ps of the band given to cal_ps_real_space_band()
+    void add_ps_real_space_band(std::complex<FPTYPE>* vpsi_r) const;
+    /// the local part of <beta|psi> of band ib of m bands from its psi(r), not reduced
+    void cal_becp_real_space_band(const std::complex<FPTYPE>* psi_r, const int ib, const int m) const;
+    /// hpsi += |beta> D <beta|psi> of the m bands given to cal_becp_real_space_band(),
+    /// becp of all bands is reduced over the pool at once
+    void add_ps_real_space_bands(std::complex<FPTYPE>* hpsi_in, const int m, const int max_npw_in) const;
 
   private:
     void add_nonlocal_pp(std::complex<FPTYPE> *hpsi_in, const std::complex<FPTYPE> *becp, const int m) const;
+    /// ps = D becp of m bands
+    void cal_ps(const std::complex<FPTYPE>* becp, const int m) const;
+
+    /// copy vkb of this->ik from the cache, or calculate it by getvnl and cache it
+    void update_vkb();
+
+    /// find the local real space grid points inside the sphere of each atom
+    void init_real_space();
+    /// transform vkb of this->ik to real space and keep its values inside the spheres
+    void update_real_space();
+    /// becp = <beta|psi> summed over the grid points inside the spheres
+    void cal_becp_real_space(const std::complex<FPTYPE>* tmpsi_in, const int m) const;
+    /// hpsi += |beta> ps, added on the grid points inside the spheres and transformed back to G space
+    void add_ps_real_space(std::complex<FPTYPE>* hpsi_in, const int m) const;
+    /// becp of one band from its psi(r), the sum over the local grid points only
+    void becp_on_grid(const std::complex<FPTYPE>* psi_r, std::complex<FPTYPE>* becp_ib) const;
+    /// vpsi_r += |beta> ps of band ib, ps is in the layout [ikb * m + ib]
+    void ps_on_grid(const std::complex<FPTYPE>* ps_in, const int m, const int ib, std::complex<FPTYPE>* vpsi_r) const;
 
     mutable int max_npw = 0;
 
@@ -70,6 +114,30 @@ class Nonlocal<OperatorPW<FPTYPE, Device>> : public OperatorPW<FPTYPE, Device>
     mutable std::complex<FPTYPE> *ps = nullptr;
     mutable std::complex<FPTYPE> *vkb = nullptr;
     mutable std::complex<FPTYPE> *becp = nullptr;
+    /// vkb of the k points calculated before, the most recently used one first.
+    /// vkb only depends on k and the atomic positions, and HamiltPW is rebuilt for each ionic step,
+    /// so the cache never needs to be invalidated during its lifetime.
+    std::list<std::pair<int, std::complex<FPTYPE>*>> vkb_cache;
+
+    /// apply the projectors on the real space grid instead of the dense gemm over all plane waves,
+    /// only the grid points inside the sphere of each atom are used, so the cost is linear in the number of atoms
+    bool real_space = false;
+    bool fused_with_veff = false;
+    /// projectors of one atom on the local real space grid
+    struct RealSpaceProjector
+    {
+        /// index of the first projector of this atom in vkb
+        int ikb0 = 0;
+        /// number of projectors of this atom
+        int nh = 0;
+        /// local real space grid points inside the sphere
+        std::vector<int> ir;
+        /// beta(r) of the k point rs_ik on these grid points, nh * ir.size()
+        std::vector<std::complex<FPTYPE>> beta;
+    };
+    std::vector<RealSpaceProjector> rs_proj;
+    int rs_ik = -1;
+    mutable std::complex<FPTYPE> *porter = nullptr;
     Device* ctx = {};
     psi::DEVICE_CPU* cpu_ctx = {};
     FPTYPE * deeq = nullptr;
@@ -81,12 +149,16 @@ class Nonlocal<OperatorPW<FPTYPE, Device>> : public OperatorPW<FPTYPE, Device>
     using setmem_complex_op = psi::memory::set_memory_op<std::complex<FPTYPE>, Device>;
     using resmem_complex_op = psi::memory::resize_memory_op<std::complex<FPTYPE>, Device>;
     using delmem_complex_op = psi::memory::delete_memory_op<std::complex<FPTYPE>, Device>;
+    using syncmem_complex_op = psi::memory::synchronize_memory_op<std::complex<FPTYPE>, Device, Device>;
     using syncmem_complex_h2d_op = psi::memory::synchronize_memory_op<std::complex<FPTYPE>, Device, psi::DEVICE_CPU>;
 
     std::complex<FPTYPE> one{1, 0};
     std::complex<FPTYPE> zero{0, 0};
 };
 
+template <typename FPTYPE, typename Device> double Nonlocal<OperatorPW<FPTYPE, Device>>::VKB_CACHE_MB = 1024.0;
+template <typename FPTYPE, typename Device> double Nonlocal<OperatorPW<FPTYPE, Device>>::RS_RCUT_SCALE = 2.0;
+
 } // namespace hamilt
 
 #endif
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "op_exx_pw.h"
+
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+
+using hamilt::OperatorEXX;
+using hamilt::OperatorPW;
+
+template <typename FPTYPE, typename Device>
+OperatorEXX<OperatorPW<FPTYPE, Device>>::OperatorEXX(const Exx_PW* exx_in, const double hybrid_alpha_in)
+{
+    this->classname = "OperatorEXX";
+    this->cal_type = pw_exx;
+    this->exx = exx_in;
+    this->hybrid_alpha = hybrid_alpha_in;
+    if (this->exx == nullptr)
+    {
+        ModuleBase::WARNING_QUIT("OperatorEXX", "Constuctor of Operator::OperatorEXX is failed, please check your code!");
+    }
+}
+
+template <typename FPTYPE, typename Device>
+void OperatorEXX<OperatorPW<FPTYPE, Device>>::act(const psi::Psi<std::complex<FPTYPE>, Device>* psi_in,
+                                                  const int n_npwx,
+                                                  const std::complex<FPTYPE>* tmpsi_in,
+                                                  std::complex<FPTYPE>* tmhpsi) const
+{
+    ModuleBase::WARNING_QUIT("OperatorEXX", "exact exchange in plane wave is only implemented for double precision on CPU");
+}
+
+namespace hamilt
+{
+template <>
+void OperatorEXX<OperatorPW<double, psi::DEVICE_CPU>>::act(const psi::Psi<std::complex<double>, psi::DEVICE_CPU>* psi_in,
+                                                           const int n_npwx,
+                                                           const std::complex<double>* tmpsi_in,
+                                                           std::complex<double>* tmhpsi) const
+{
+    ModuleBase::timer::tick("Operator", "EXXPW");
+    // npol is 1, every column of tmpsi_in is a band
+    this->exx->act(this->ik, n_npwx, psi_in->get_nbasis(), tmpsi_in, tmhpsi, this->hybrid_alpha);
+    ModuleBase::timer::tick("Operator", "EXXPW");
+}
+
+template class OperatorEXX<OperatorPW<float, psi::DEVICE_CPU>>;
+template class OperatorEXX<OperatorPW<double, psi::DEVICE_CPU>>;
+#if ((defined __CUDA) || (defined __ROCM))
+template class OperatorEXX<OperatorPW<float, psi::DEVICE_GPU>>;
+template class OperatorEXX<OperatorPW<double, psi::DEVICE_GPU>>;
+#endif
+} // namespace hamilt
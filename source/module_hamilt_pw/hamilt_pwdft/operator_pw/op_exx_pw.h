@@ -0,0 +1,41 @@
+#ifndef OPEXXPW_H
+#define OPEXXPW_H
+
+#include "operator_pw.h"
+#include "module_hamilt_pw/hamilt_pwdft/exx_pw.h"
+
+namespace hamilt
+{
+
+#ifndef __OPEXXTEMPLATE
+#define __OPEXXTEMPLATE
+
+template <class T>
+class OperatorEXX : public T
+{
+};
+
+#endif
+
+// exact exchange of hybrid functionals in plane wave basis, given by the ACE projectors of Exx_PW,
+// it is only implemented for double precision on CPU
+template <typename FPTYPE, typename Device>
+class OperatorEXX<OperatorPW<FPTYPE, Device>> : public OperatorPW<FPTYPE, Device>
+{
+  public:
+    OperatorEXX(const Exx_PW* exx_in, const double hybrid_alpha_in);
+
+    virtual void act(const psi::Psi<std::complex<FPTYPE>, Device>* psi_in,
+                     const int n_npwx,
+                     const std::complex<FPTYPE>* tmpsi_in,
+                     std::complex<FPTYPE>* tmhpsi) const override;
+
+  private:
+    const Exx_PW* exx = nullptr;
+
+    double hybrid_alpha = 0.0;
+};
+
+} // namespace hamilt
+
+#endif
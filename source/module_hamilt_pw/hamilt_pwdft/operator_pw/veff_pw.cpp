@@ -1,9 +1,12 @@
 #include "veff_pw.h"
 
+#include "module_base/global_variable.h"
 #include "module_base/timer.h"
 #include "module_base/tool_quit.h"
 #include "module_psi/kernels/device.h"
 
+#include <cmath>
+
 using hamilt::Veff;
 using hamilt::OperatorPW;
 
@@ -49,14 +52,27 @@ void Veff<OperatorPW<FPTYPE, Device>>::act(
     this->max_npw = psi_in->get_nbasis() / psi_in->npol;
     const int current_spin = this->isk[this->ik];
     this->npol = psi_in->npol;
-    
+    std::complex<FPTYPE>* const tmhpsi0 = tmhpsi;
+
     // std::complex<FPTYPE> *porter = new std::complex<FPTYPE>[wfcpw->nmaxgr];
     for (int ib = 0; ib < n_npwx; ib += this->npol)
     {
-        if (this->npol == 1)
+        if (wfcpw->gamma_only)
+        {
+            this->act_gamma(tmpsi_in, tmhpsi, current_spin);
+        }
+        else if (this->npol == 1)
         {
             // wfcpw->recip2real(tmpsi_in, porter, this->ik);
             wfcpw->recip_to_real(this->ctx, tmpsi_in, this->porter, this->ik);
+            if (this->nonlocal_rs != nullptr && this->nonlocal_rs_batched)
+            {
+                this->nonlocal_rs->cal_becp_real_space_band(this->porter, ib, n_npwx);
+            }
+            else if (this->nonlocal_rs != nullptr)
+            {
+                this->nonlocal_rs->cal_ps_real_space_band(this->porter);
+            }
             // NOTICE: when MPI threads are larger than number of Z grids
             // veff would contain nothing, and nothing should be done in real space
             // but the 3DFFT can not be skipped, it will cause hanging
@@ -69,6 +85,10 @@ void Veff<OperatorPW<FPTYPE, Device>>::act(
                 //     porter[ir] *= current_veff[ir];
                 // }
             }
+            if (this->nonlocal_rs != nullptr && !this->nonlocal_rs_batched)
+            {
+                this->nonlocal_rs->add_ps_real_space_band(this->porter);
+            }
             // wfcpw->real2recip(porter, tmhpsi, this->ik, true);
             wfcpw->real_to_recip(this->ctx, this->porter, tmhpsi, this->ik, true);
         }
@@ -107,9 +127,63 @@ void Veff<OperatorPW<FPTYPE, Device>>::act(
         tmhpsi += this->max_npw * this->npol;
         tmpsi_in += this->max_npw * this->npol;
     }
+    if (this->nonlocal_rs != nullptr && this->nonlocal_rs_batched)
+    {
+        this->nonlocal_rs->add_ps_real_space_bands(tmhpsi0, n_npwx, this->max_npw);
+    }
     ModuleBase::timer::tick("Operator", "VeffPW");
 }
 
+template<typename FPTYPE, typename Device>
+void Veff<OperatorPW<FPTYPE, Device>>::set_nonlocal_real_space(Nonlocal<OperatorPW<FPTYPE, Device>>* nonlocal_in)
+{
+    // only the path of npol = 1 without gamma_only is fused, the same as Nonlocal in real space
+    if (nonlocal_in == nullptr || !nonlocal_in->get_real_space() || this->wfcpw->gamma_only)
+    {
+        return;
+    }
+    this->nonlocal_rs = nonlocal_in;
+    // one reduction of becp per band is only free with one process in the pool,
+    // otherwise becp of all bands is reduced at once after the loop over bands
+    this->nonlocal_rs_batched = (GlobalV::NPROC_IN_POOL > 1);
+    nonlocal_in->set_fused_with_veff(true);
+}
+
+// gamma_only: psi is real in real space, so only the real grid is transformed (r2c and c2r), which is half
+// of the work of a complex band; the coefficients are in the convention of PW_Basis_K::scale_gamma (CPU only)
+template<typename FPTYPE, typename Device>
+void Veff<OperatorPW<FPTYPE, Device>>::act_gamma(const std::complex<FPTYPE>* tmpsi_in,
+                                                 std::complex<FPTYPE>* tmhpsi,
+                                                 const int current_spin) const
+{
+    const int npwk = wfcpw->npwk[this->ik];
+    const FPTYPE sqrt2 = std::sqrt(static_cast<FPTYPE>(2.0));
+    FPTYPE* psir = reinterpret_cast<FPTYPE*>(this->porter);
+    for (int ig = 0; ig < npwk; ++ig)
+    {
+        this->porter1[ig] = tmpsi_in[ig];
+    }
+    wfcpw->scale_gamma(this->porter1, this->ik, static_cast<FPTYPE>(1.0) / sqrt2);
+    wfcpw->recip2real(this->porter1, psir, this->ik);
+    if (this->veff_col != 0)
+    {
+        const FPTYPE* current_veff = this->veff + current_spin * this->veff_col;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 4096 / sizeof(FPTYPE))
+#endif
+        for (int ir = 0; ir < this->veff_col; ++ir)
+        {
+            psir[ir] *= current_veff[ir];
+        }
+    }
+    wfcpw->real2recip(psir, this->porter1, this->ik);
+    wfcpw->scale_gamma(this->porter1, this->ik, sqrt2);
+    for (int ig = 0; ig < npwk; ++ig)
+    {
+        tmhpsi[ig] += this->porter1[ig];
+    }
+}
+
 template<typename FPTYPE, typename Device>
 template<typename T_in, typename Device_in>
 hamilt::Veff<OperatorPW<FPTYPE, Device>>::Veff(const Veff<OperatorPW<T_in, Device_in>> *veff) {
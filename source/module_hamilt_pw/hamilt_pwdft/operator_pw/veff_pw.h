@@ -5,6 +5,7 @@
 #include "module_base/matrix.h"
 #include "module_basis/module_pw/pw_basis_k.h"
 #include "module_hamilt_pw/hamilt_pwdft/kernels/veff_op.h"
+#include "module_hamilt_pw/hamilt_pwdft/operator_pw/nonlocal_pw.h"
 
 namespace hamilt {
 
@@ -40,6 +41,10 @@ class Veff<OperatorPW<FPTYPE, Device>> : public OperatorPW<FPTYPE, Device>
         std::complex<FPTYPE>* tmhpsi
     )const override;
 
+    /// apply the real space projectors of nonlocal_in on psi(r) of each band in act(),
+    /// which saves the two FFTs per band of the Nonlocal operator
+    void set_nonlocal_real_space(Nonlocal<OperatorPW<FPTYPE, Device>>* nonlocal_in);
+
     // denghui added for copy constructor at 20221105
     const FPTYPE *get_veff() const {return this->veff;}
     int get_veff_col() const {return this->veff_col;}
@@ -53,6 +58,8 @@ class Veff<OperatorPW<FPTYPE, Device>> : public OperatorPW<FPTYPE, Device>
 
   private:
 
+    void act_gamma(const std::complex<FPTYPE>* tmpsi_in, std::complex<FPTYPE>* tmhpsi, const int current_spin) const;
+
     mutable int max_npw = 0;
 
     mutable int npol = 0;
@@ -69,6 +76,8 @@ class Veff<OperatorPW<FPTYPE, Device>> : public OperatorPW<FPTYPE, Device>
     const FPTYPE *veff = nullptr, *h_veff = nullptr, *d_veff = nullptr;
     std::complex<FPTYPE> *porter = nullptr;
     std::complex<FPTYPE> *porter1 = nullptr;
+    const Nonlocal<OperatorPW<FPTYPE, Device>>* nonlocal_rs = nullptr;
+    bool nonlocal_rs_batched = false;
     psi::AbacusDevice_t device = {};
     using veff_op = veff_pw_op<FPTYPE, Device>;
 
@@ -21,7 +21,7 @@ Structure_Factor::Structure_Factor()
 Structure_Factor::~Structure_Factor()
 {
     if (GlobalV::device_flag == "gpu") {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             delmem_cd_op()(gpu_ctx, this->c_eigts1);
             delmem_cd_op()(gpu_ctx, this->c_eigts2);
             delmem_cd_op()(gpu_ctx, this->c_eigts3);
@@ -31,7 +31,7 @@ Structure_Factor::~Structure_Factor()
         delmem_zd_op()(gpu_ctx, this->z_eigts3);
     }
     else {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             delmem_ch_op()(cpu_ctx, this->c_eigts1);
             delmem_ch_op()(cpu_ctx, this->c_eigts2);
             delmem_ch_op()(cpu_ctx, this->c_eigts3);
@@ -150,7 +150,7 @@ void Structure_Factor::setup_structure_factor(UnitCell* Ucell, const ModulePW::P
         }
     }
     if (GlobalV::device_flag == "gpu") {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             resmem_cd_op()(gpu_ctx, this->c_eigts1, Ucell->nat * (2 * rho_basis->nx + 1));
             resmem_cd_op()(gpu_ctx, this->c_eigts2, Ucell->nat * (2 * rho_basis->ny + 1));
             resmem_cd_op()(gpu_ctx, this->c_eigts3, Ucell->nat * (2 * rho_basis->nz + 1));
@@ -166,7 +166,7 @@ void Structure_Factor::setup_structure_factor(UnitCell* Ucell, const ModulePW::P
         syncmem_z2z_h2d_op()(gpu_ctx, cpu_ctx, this->z_eigts3, this->eigts3.c, Ucell->nat * (2 * rho_basis->nz + 1));
     }
     else {
-        if (GlobalV::precision_flag == "single") {
+        if (GlobalV::precision_flag != "double") {
             resmem_ch_op()(cpu_ctx, this->c_eigts1, Ucell->nat * (2 * rho_basis->nx + 1));
             resmem_ch_op()(cpu_ctx, this->c_eigts2, Ucell->nat * (2 * rho_basis->ny + 1));
             resmem_ch_op()(cpu_ctx, this->c_eigts3, Ucell->nat * (2 * rho_basis->nz + 1));
@@ -0,0 +1,318 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+#include "module_base/constants.h"
+#include "module_base/global_variable.h"
+#include "module_base/parallel_global.h"
+#include "module_hamilt_pw/hamilt_pwdft/exx_pw.h"
+
+/************************************************
+ *  unit test of class Exx_PW
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - cal_ace() and act()
+ *     - the ACE operator agrees with the explicit V_x on the bands of psi and on their linear combinations
+ *   - cal_exx_energy()
+ *     - E_x agrees with the direct double sum over the occupied bands of k and q
+ *
+ * The bands of each k are unitary rotations of plane waves inside the occupied and the empty subspace.
+ * The density matrix is that of the plane waves, so V_x is diagonal on the plane waves |k+G_b> with
+ * V_x(k, G_b) = -1/2 sum_q sum_m wg_qm / omega * v(k - q + G_b - G_m), m running over the occupied plane waves,
+ * for both the spherically truncated and the erfc-screened kernel v.
+ */
+
+Magnetism::Magnetism()
+{
+}
+Magnetism::~Magnetism()
+{
+}
+UnitCell::UnitCell()
+{
+}
+UnitCell::~UnitCell()
+{
+}
+K_Vectors::K_Vectors()
+{
+}
+K_Vectors::~K_Vectors()
+{
+}
+
+class ExxPWTest : public ::testing::TestWithParam<Conv_Coulomb_Pot_K::Ccp_Type>
+{
+  protected:
+    static const int nks = 2;
+    static const int nbands = 5;
+    static const int nocc = 2;
+    // G_b of band b in units of the reciprocal lattice vectors, the first nocc are occupied
+    const int gb[nbands][3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, -1}, {-1, 1, 0}};
+
+    ModulePW::PW_Basis rhopw;
+    ModulePW::PW_Basis_K wfcpw;
+    UnitCell ucell;
+    K_Vectors kv;
+    ModuleBase::matrix wg;
+    // local ig of the plane wave G_b at each k, -1 if it is on another process
+    std::vector<std::vector<int>> loc;
+    // rotation of the plane waves of each k, u[ik][b * nbands + ib] is the coefficient of G_b in band ib
+    std::vector<std::vector<std::complex<double>>> u;
+
+    void SetUp() override
+    {
+        GlobalV::NSPIN = 1;
+        const ModuleBase::Matrix3 latvec(1.0, 0.0, 0.0, 0.1, 1.1, 0.0, 0.0, 0.2, 0.9);
+        const double lat0 = 6.0;
+#ifdef __MPI
+        rhopw.initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
+        wfcpw.initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
+#endif
+        rhopw.initgrids(lat0, latvec, 16.0);
+        rhopw.initparameters(false, 16.0);
+        rhopw.setuptransform();
+        rhopw.collect_local_pw();
+
+        const std::vector<ModuleBase::Vector3<double>> kvec_d = {{0.0, 0.0, 0.0}, {0.5, 0.0, 0.0}};
+        wfcpw.initgrids(lat0, latvec, rhopw.nx, rhopw.ny, rhopw.nz);
+        wfcpw.initparameters(false, 4.0, nks, kvec_d.data());
+        wfcpw.setuptransform();
+        wfcpw.collect_local_pw();
+
+        ucell.tpiba2 = rhopw.tpiba2;
+        ucell.omega = rhopw.omega;
+        kv.nks = nks;
+        kv.kvec_c.resize(nks);
+        kv.wk.assign(nks, 1.0);
+        kv.isk.assign(nks, 0);
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            kv.kvec_c[ik] = kvec_d[ik] * rhopw.G;
+        }
+
+        wg.create(nks, nbands);
+        loc.assign(nks, std::vector<int>(nbands, -1));
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            for (int ib = 0; ib < nocc; ++ib)
+            {
+                wg(ik, ib) = 1.0;
+            }
+            for (int ig = 0; ig < wfcpw.npwk[ik]; ++ig)
+            {
+                const ModuleBase::Vector3<double> gd = wfcpw.getgdirect(ik, ig);
+                for (int b = 0; b < nbands; ++b)
+                {
+                    if (std::abs(gd.x - gb[b][0]) < 1e-6 && std::abs(gd.y - gb[b][1]) < 1e-6
+                        && std::abs(gd.z - gb[b][2]) < 1e-6)
+                    {
+                        loc[ik][b] = ig;
+                    }
+                }
+            }
+        }
+
+        // random unitary rotations inside the occupied and the empty plane waves, the same on all processes
+        std::mt19937 gen(11);
+        std::uniform_real_distribution<double> rnd(-1.0, 1.0);
+        u.assign(nks, std::vector<std::complex<double>>(nbands * nbands, 0.0));
+        const std::vector<std::pair<int, int>> blocks = {{0, nocc}, {nocc, nbands}};
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            for (const std::pair<int, int>& block: blocks)
+            {
+                for (int ib = block.first; ib < block.second; ++ib)
+                {
+                    std::vector<std::complex<double>> col(nbands, 0.0);
+                    for (int b = block.first; b < block.second; ++b)
+                    {
+                        col[b] = std::complex<double>(rnd(gen), rnd(gen));
+                    }
+                    // Gram-Schmidt against the previous bands of the block
+                    for (int jb = block.first; jb < ib; ++jb)
+                    {
+                        std::complex<double> ov = 0.0;
+                        for (int b = 0; b < nbands; ++b)
+                        {
+                            ov += std::conj(u[ik][b * nbands + jb]) * col[b];
+                        }
+                        for (int b = 0; b < nbands; ++b)
+                        {
+                            col[b] -= ov * u[ik][b * nbands + jb];
+                        }
+                    }
+                    double norm = 0.0;
+                    for (int b = 0; b < nbands; ++b)
+                    {
+                        norm += std::norm(col[b]);
+                    }
+                    for (int b = 0; b < nbands; ++b)
+                    {
+                        u[ik][b * nbands + ib] = col[b] / std::sqrt(norm);
+                    }
+                }
+            }
+        }
+    }
+
+    // the Coulomb kernel of Exx_PW at q in units of tpiba
+    double kernel(const Exx_Info::Exx_Info_Global& info, const ModuleBase::Vector3<double>& q) const
+    {
+        const double q2 = q.norm2() * ucell.tpiba2;
+        if (info.ccp_type == Conv_Coulomb_Pot_K::Ccp_Type::Hse)
+        {
+            const double w2 = info.hse_omega * info.hse_omega;
+            return (q2 > 1e-8) ? ModuleBase::FOUR_PI * ModuleBase::e2 / q2 * (1.0 - std::exp(-q2 / 4.0 / w2))
+                               : ModuleBase::PI * ModuleBase::e2 / w2;
+        }
+        const double rc = std::cbrt(3.0 * ucell.omega * nks / ModuleBase::FOUR_PI);
+        return (q2 > 1e-8) ? ModuleBase::FOUR_PI * ModuleBase::e2 / q2 * (1.0 - std::cos(std::sqrt(q2) * rc))
+                           : ModuleBase::TWO_PI * ModuleBase::e2 * rc * rc;
+    }
+
+    // V_x(k, G_b) of the occupied plane waves
+    double vx_pw(const Exx_Info::Exx_Info_Global& info, const int ik, const int b) const
+    {
+        double vx = 0.0;
+        const ModuleBase::Vector3<double> g_b(gb[b][0], gb[b][1], gb[b][2]);
+        for (int iq = 0; iq < nks; ++iq)
+        {
+            for (int m = 0; m < nocc; ++m)
+            {
+                const ModuleBase::Vector3<double> g_m(gb[m][0], gb[m][1], gb[m][2]);
+                const ModuleBase::Vector3<double> q = kv.kvec_c[ik] - kv.kvec_c[iq] + (g_b - g_m) * rhopw.G;
+                vx -= 0.5 * wg(iq, m) / ucell.omega * this->kernel(info, q);
+            }
+        }
+        return vx;
+    }
+};
+
+TEST_P(ExxPWTest, ActAndEnergy)
+{
+    std::vector<int> ngk(nks);
+    for (int ik = 0; ik < nks; ++ik)
+    {
+        ngk[ik] = wfcpw.npwk[ik];
+    }
+    psi::Psi<std::complex<double>> psi(nks, nbands, wfcpw.npwk_max, ngk.data());
+    ModuleBase::GlobalFunc::ZEROS(psi.get_pointer(), psi.size());
+    for (int ik = 0; ik < nks; ++ik)
+    {
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            for (int b = 0; b < nbands; ++b)
+            {
+                if (loc[ik][b] >= 0)
+                {
+                    psi(ik, ib, loc[ik][b]) = u[ik][b * nbands + ib];
+                }
+            }
+        }
+    }
+
+    Exx_Info::Exx_Info_Global info;
+    info.ccp_type = GetParam();
+    Exx_PW exx(info);
+    exx.init(&rhopw, &wfcpw, &kv);
+    EXPECT_FALSE(exx.ace_done());
+    exx.cal_ace(psi, wg, ucell);
+    EXPECT_TRUE(exx.ace_done());
+
+    double ex_ref = 0.0;
+    double maxerr = 0.0;
+    const int npwx = wfcpw.npwk_max;
+    for (int ik = 0; ik < nks; ++ik)
+    {
+        std::vector<double> vx(nbands);
+        for (int b = 0; b < nbands; ++b)
+        {
+            vx[b] = this->vx_pw(info, ik, b);
+        }
+        for (int b = 0; b < nocc; ++b)
+        {
+            ex_ref += 0.5 * wg(ik, b) * vx[b];
+        }
+
+        // the bands of psi, and a combination of them in one more vector, act() adds to hpsi
+        const int nvec = nbands + 1;
+        std::vector<std::complex<double>> vec(nvec * npwx, 0.0);
+        std::vector<std::complex<double>> coef(nbands * nvec, 0.0);
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            coef[ib * nvec + ib] = 1.0;
+            coef[ib * nvec + nbands] = std::complex<double>(0.3 * ib - 0.5, 0.1 * ib + 0.2);
+        }
+        for (int iv = 0; iv < nvec; ++iv)
+        {
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                for (int ig = 0; ig < wfcpw.npwk[ik]; ++ig)
+                {
+                    vec[iv * npwx + ig] += coef[ib * nvec + iv] * psi(ik, ib, ig);
+                }
+            }
+        }
+        const double factor = 0.7;
+        std::vector<std::complex<double>> hpsi(nvec * npwx, 1.0);
+        exx.act(ik, nvec, npwx, vec.data(), hpsi.data(), factor);
+
+        for (int iv = 0; iv < nvec; ++iv)
+        {
+            std::vector<std::complex<double>> ref(npwx, 1.0);
+            for (int b = 0; b < nbands; ++b)
+            {
+                if (loc[ik][b] < 0)
+                {
+                    continue;
+                }
+                std::complex<double> c = 0.0;
+                for (int ib = 0; ib < nbands; ++ib)
+                {
+                    c += u[ik][b * nbands + ib] * coef[ib * nvec + iv];
+                }
+                ref[loc[ik][b]] += factor * vx[b] * c;
+            }
+            for (int ig = 0; ig < wfcpw.npwk[ik]; ++ig)
+            {
+                maxerr = std::max(maxerr, std::abs(hpsi[iv * npwx + ig] - ref[ig]));
+            }
+        }
+    }
+#ifdef __MPI
+    MPI_Allreduce(MPI_IN_PLACE, &maxerr, 1, MPI_DOUBLE, MPI_MAX, POOL_WORLD);
+#endif
+    EXPECT_LT(maxerr, 1e-10);
+
+    const double ex = exx.cal_exx_energy(psi, wg);
+    EXPECT_LT(ex, 0.0);
+    EXPECT_NEAR(ex, ex_ref, 1e-10 * std::abs(ex_ref));
+}
+
+INSTANTIATE_TEST_SUITE_P(Kernel,
+                         ExxPWTest,
+                         ::testing::Values(Conv_Coulomb_Pot_K::Ccp_Type::Hf, Conv_Coulomb_Pot_K::Ccp_Type::Hse));
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &GlobalV::NPROC);
+    MPI_Comm_rank(MPI_COMM_WORLD, &GlobalV::MY_RANK);
+    GlobalV::NPROC_IN_POOL = GlobalV::NPROC;
+    GlobalV::RANK_IN_POOL = GlobalV::MY_RANK;
+    MPI_Comm_split(MPI_COMM_WORLD, 0, 1, &POOL_WORLD);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
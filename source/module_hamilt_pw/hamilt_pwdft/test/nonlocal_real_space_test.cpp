@@ -0,0 +1,395 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#define private public
+#include "module_hamilt_pw/hamilt_pwdft/operator_pw/nonlocal_pw.h"
+#include "module_hamilt_pw/hamilt_pwdft/operator_pw/veff_pw.h"
+#undef private
+#include "module_base/global_variable.h"
+#include "module_base/parallel_global.h"
+
+/************************************************
+ *  unit test of the real space Nonlocal<OperatorPW>
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Nonlocal::act() with nonlocal_real_space
+ *     - becp and V_NL psi on the real space grid agree with the dense products over plane waves
+ *   - Veff::set_nonlocal_real_space()
+ *     - Veff applies V_eff + V_NL on its own psi(r), Nonlocal::act() adds nothing,
+ *       the sum agrees with Veff and Nonlocal in G space, both with becp reduced per band
+ *       and with becp of all bands reduced once after the loop over bands
+ *
+ *   - Nonlocal::init() with the vkb cache of budget VKB_CACHE_MB
+ *     - a cached k point gives the same vkb as a fresh getvnl() without calling it
+ *     - the least recently used k point is dropped when the budget is exceeded
+ *     - a budget of 0 disables the cache
+ *
+ * The projectors are Gaussians of s and p symmetry, which decay fast enough both in G space
+ * and in real space that the truncation to the spheres is far below the tolerance.
+ */
+
+pseudo_nc::pseudo_nc(){}
+pseudo_nc::~pseudo_nc(){}
+Atom_pseudo::Atom_pseudo(){}
+Atom_pseudo::~Atom_pseudo(){}
+Atom::Atom(){}
+Atom::~Atom(){}
+Magnetism::Magnetism(){}
+Magnetism::~Magnetism(){}
+UnitCell::UnitCell(){}
+UnitCell::~UnitCell(){}
+pseudopot_cell_vl::pseudopot_cell_vl(){}
+pseudopot_cell_vl::~pseudopot_cell_vl(){}
+pseudopot_cell_vnl::pseudopot_cell_vnl(){}
+pseudopot_cell_vnl::~pseudopot_cell_vnl(){}
+
+namespace
+{
+const UnitCell* test_ucell = nullptr;
+const double sigma = 1.0;
+int getvnl_calls = 0;
+} // namespace
+
+// beta_ih(q) of each atom: ih = 0 is s, ih = 1, 2, 3 are p_x, p_y, p_z, all with the Gaussian exp(-sigma^2 q^2 / 2)
+template <typename FPTYPE, typename Device>
+void pseudopot_cell_vnl::getvnl(Device* ctx, const int& ik, std::complex<FPTYPE>* vkb_in) const
+{
+    ++getvnl_calls;
+    const int npw = this->wfcpw->npwk[ik];
+    const int npwx = this->vkb.nc;
+    const double tpiba = ModuleBase::TWO_PI / test_ucell->lat0;
+    int ikb = 0;
+    for (int it = 0; it < test_ucell->ntype; it++)
+    {
+        const Atom& atom = test_ucell->atoms[it];
+        for (int ia = 0; ia < atom.na; ia++)
+        {
+            const ModuleBase::Vector3<double> tau = test_ucell->a1 * atom.taud[ia].x + test_ucell->a2 * atom.taud[ia].y
+                                                    + test_ucell->a3 * atom.taud[ia].z;
+            for (int ih = 0; ih < atom.ncpp.nh; ih++)
+            {
+                for (int ig = 0; ig < npw; ig++)
+                {
+                    const ModuleBase::Vector3<double> gk = this->wfcpw->getgpluskcar(ik, ig);
+                    const ModuleBase::Vector3<double> q = gk * tpiba;
+                    const double arg = -ModuleBase::TWO_PI * (gk * tau);
+                    std::complex<double> f = std::exp(-0.5 * sigma * sigma * q.norm2());
+                    if (ih > 0)
+                    {
+                        f *= std::complex<double>(0.0, -q[ih - 1]);
+                    }
+                    vkb_in[ikb * npwx + ig] = f * std::complex<double>(std::cos(arg), std::sin(arg));
+                }
+                ++ikb;
+            }
+        }
+    }
+}
+template void pseudopot_cell_vnl::getvnl<float, psi::DEVICE_CPU>(psi::DEVICE_CPU*, int const&, std::complex<float>*) const;
+template void pseudopot_cell_vnl::getvnl<double, psi::DEVICE_CPU>(psi::DEVICE_CPU*, int const&, std::complex<double>*) const;
+
+template <>
+float* pseudopot_cell_vnl::get_deeq_data() const
+{
+    return this->s_deeq;
+}
+template <>
+double* pseudopot_cell_vnl::get_deeq_data() const
+{
+    return this->d_deeq;
+}
+template <>
+std::complex<float>* pseudopot_cell_vnl::get_vkb_data() const
+{
+    return this->c_vkb;
+}
+template <>
+std::complex<double>* pseudopot_cell_vnl::get_vkb_data() const
+{
+    return this->z_vkb;
+}
+template <>
+std::complex<float>* pseudopot_cell_vnl::get_deeq_nc_data() const
+{
+    return this->c_deeq_nc;
+}
+template <>
+std::complex<double>* pseudopot_cell_vnl::get_deeq_nc_data() const
+{
+    return this->z_deeq_nc;
+}
+
+class NonlocalRealSpaceTest : public testing::Test
+{
+  protected:
+    using NonlocalPW = hamilt::Nonlocal<hamilt::OperatorPW<double, psi::DEVICE_CPU>>;
+    using VeffPW = hamilt::Veff<hamilt::OperatorPW<double, psi::DEVICE_CPU>>;
+
+    ModulePW::PW_Basis_K wfcpw;
+    UnitCell ucell;
+    pseudopot_cell_vnl ppcell;
+    std::vector<double> rmesh;
+    std::vector<ModuleBase::Vector3<double>> taud;
+    std::vector<double> veff;
+    psi::Psi<std::complex<double>>* psi = nullptr;
+    int isk[3] = {0, 0, 0};
+    int ngk[1] = {0};
+    const int nbands = 3;
+
+    void SetUp() override
+    {
+        const double lat0 = 14.0;
+        const ModuleBase::Matrix3 latvec(1.0, 0.0, 0.0, 0.1, 1.0, 0.0, 0.0, 0.0, 1.0);
+        const double ecutwfc = 30.0;
+        // psi and the real space projectors use the first k point, the others are for the vkb cache
+        const ModuleBase::Vector3<double> kvec_d[3]
+            = {{0.1, 0.2, -0.3}, {0.0, 0.0, 0.0}, {0.5, -0.25, 0.0}};
+#ifdef __MPI
+        wfcpw.initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
+#endif
+        wfcpw.initgrids(lat0, latvec, 4.0 * ecutwfc);
+        wfcpw.initparameters(false, ecutwfc, 3, kvec_d);
+        wfcpw.setuptransform();
+        wfcpw.collect_local_pw();
+
+        // two atoms of one type, the spheres overlap across the periodic boundary
+        taud = {ModuleBase::Vector3<double>(0.1, 0.2, 0.3), ModuleBase::Vector3<double>(0.6, 0.45, 0.95)};
+        rmesh = {0.0, 1.0, 2.0, 3.0};
+        ucell.ntype = 1;
+        ucell.lat0 = lat0;
+        ucell.latvec = latvec;
+        ucell.a1 = ModuleBase::Vector3<double>(latvec.e11, latvec.e12, latvec.e13);
+        ucell.a2 = ModuleBase::Vector3<double>(latvec.e21, latvec.e22, latvec.e23);
+        ucell.a3 = ModuleBase::Vector3<double>(latvec.e31, latvec.e32, latvec.e33);
+        ucell.G = wfcpw.G;
+        ucell.atoms = new Atom[1];
+        ucell.atoms[0].na = 2;
+        ucell.atoms[0].taud = taud.data();
+        ucell.atoms[0].ncpp.nh = 4;
+        // the spheres have the radius RS_RCUT_SCALE * r[kkbeta - 1] = 6 bohr
+        ucell.atoms[0].ncpp.r = rmesh.data();
+        ucell.atoms[0].ncpp.kkbeta = rmesh.size();
+        test_ucell = &ucell;
+
+        const int nat = 2;
+        const int nh = 4;
+        ppcell.wfcpw = &wfcpw;
+        ppcell.nkb = nat * nh;
+        ppcell.nhm = nh;
+        ppcell.vkb.create(ppcell.nkb, wfcpw.npwk_max);
+        ppcell.z_vkb = ppcell.vkb.c;
+        ppcell.deeq.create(1, nat, nh, nh);
+        for (int iat = 0; iat < nat; iat++)
+        {
+            for (int ih = 0; ih < nh; ih++)
+            {
+                for (int jh = 0; jh < nh; jh++)
+                {
+                    ppcell.deeq(0, iat, ih, jh) = (ih == jh) ? (ih == 0 ? 1.5 : -0.7 + 0.1 * iat) : 0.1 / (1 + ih + jh);
+                }
+            }
+        }
+        ppcell.d_deeq = ppcell.deeq.ptr;
+
+        veff.resize(wfcpw.nrxx);
+        for (int ir = 0; ir < wfcpw.nrxx; ir++)
+        {
+            veff[ir] = std::sin(0.37 * (ir + wfcpw.startz_current));
+        }
+
+        ngk[0] = wfcpw.npwk[0];
+        psi = new psi::Psi<std::complex<double>>(1, nbands, wfcpw.npwk_max, ngk);
+        psi->fix_k(0);
+        for (int ib = 0; ib < nbands; ib++)
+        {
+            for (int ig = 0; ig < wfcpw.npwk_max; ig++)
+            {
+                const double g2 = wfcpw.getgk2(0, std::min(ig, wfcpw.npwk[0] - 1));
+                (*psi)(ib, ig) = (ig < wfcpw.npwk[0])
+                                     ? std::complex<double>(std::cos(1.3 * ig + ib), std::sin(0.7 * ig * (ib + 1)))
+                                           / (1.0 + g2)
+                                     : 0.0;
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        delete psi;
+        delete[] ucell.atoms;
+    }
+
+    std::vector<std::complex<double>> apply(const hamilt::OperatorPW<double, psi::DEVICE_CPU>& op)
+    {
+        std::vector<std::complex<double>> hpsi(nbands * wfcpw.npwk_max, 0.0);
+        op.act(psi, nbands, psi->get_pointer(), hpsi.data());
+        return hpsi;
+    }
+
+    static double max_diff(const std::vector<std::complex<double>>& a, const std::complex<double>* b)
+    {
+        double diff = 0.0;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            diff = std::max(diff, std::abs(a[i] - b[i]));
+        }
+        return diff;
+    }
+
+    static double max_abs(const std::vector<std::complex<double>>& a)
+    {
+        double amax = 0.0;
+        for (const auto& x: a)
+        {
+            amax = std::max(amax, std::abs(x));
+        }
+        return amax;
+    }
+};
+
+TEST_F(NonlocalRealSpaceTest, BecpAndVnl)
+{
+    GlobalV::NONLOCAL_REAL_SPACE = false;
+    NonlocalPW nl_g(isk, &ppcell, &ucell, &wfcpw);
+    nl_g.init(0);
+    const std::vector<std::complex<double>> hpsi_g = apply(nl_g);
+    const std::vector<std::complex<double>> becp_g(nl_g.becp, nl_g.becp + ppcell.nkb * nbands);
+
+    GlobalV::NONLOCAL_REAL_SPACE = true;
+    NonlocalPW nl_r(isk, &ppcell, &ucell, &wfcpw);
+    nl_r.init(0);
+    EXPECT_EQ(nl_r.rs_proj.size(), 2);
+    const std::vector<std::complex<double>> hpsi_r = apply(nl_r);
+
+    EXPECT_GT(max_abs(becp_g), 1e-3);
+    EXPECT_LT(max_diff(becp_g, nl_r.becp), 1e-6 * max_abs(becp_g));
+    EXPECT_GT(max_abs(hpsi_g), 1e-3);
+    EXPECT_LT(max_diff(hpsi_g, hpsi_r.data()), 1e-6 * max_abs(hpsi_g));
+    GlobalV::NONLOCAL_REAL_SPACE = false;
+}
+
+TEST_F(NonlocalRealSpaceTest, FusedWithVeff)
+{
+    GlobalV::NONLOCAL_REAL_SPACE = false;
+    NonlocalPW nl_g(isk, &ppcell, &ucell, &wfcpw);
+    VeffPW veff_g(isk, veff.data(), 1, wfcpw.nrxx, &wfcpw);
+    nl_g.init(0);
+    veff_g.init(0);
+    std::vector<std::complex<double>> hpsi_g = apply(nl_g);
+    const std::vector<std::complex<double>> vpsi_g = apply(veff_g);
+    for (size_t i = 0; i < hpsi_g.size(); i++)
+    {
+        hpsi_g[i] += vpsi_g[i];
+    }
+
+    GlobalV::NONLOCAL_REAL_SPACE = true;
+    NonlocalPW nl_r(isk, &ppcell, &ucell, &wfcpw);
+    VeffPW veff_r(isk, veff.data(), 1, wfcpw.nrxx, &wfcpw);
+    veff_r.set_nonlocal_real_space(&nl_r);
+    nl_r.init(0);
+    veff_r.init(0);
+    // the projectors are applied by Veff, Nonlocal itself adds nothing
+    EXPECT_EQ(max_abs(apply(nl_r)), 0.0);
+    EXPECT_EQ(veff_r.nonlocal_rs_batched, GlobalV::NPROC_IN_POOL > 1);
+    // both the per-band reduction and the one reduction of becp of all bands after the loop
+    for (const bool batched: {false, true})
+    {
+        veff_r.nonlocal_rs_batched = batched;
+        const std::vector<std::complex<double>> hpsi_r = apply(veff_r);
+        EXPECT_LT(max_diff(hpsi_g, hpsi_r.data()), 1e-6 * max_abs(hpsi_g)) << "batched = " << batched;
+    }
+    GlobalV::NONLOCAL_REAL_SPACE = false;
+}
+
+TEST_F(NonlocalRealSpaceTest, VkbCache)
+{
+    GlobalV::NONLOCAL_REAL_SPACE = false;
+    const double cache_mb = NonlocalPW::VKB_CACHE_MB;
+    const size_t size = ppcell.nkb * ppcell.vkb.nc;
+    std::vector<std::vector<std::complex<double>>> vkb_ref(3, std::vector<std::complex<double>>(size));
+    for (int ik = 0; ik < 3; ik++)
+    {
+        ppcell.getvnl(static_cast<psi::DEVICE_CPU*>(nullptr), ik, vkb_ref[ik].data());
+    }
+    // only the plane waves of each k point are compared, the padding up to npwk_max is not set by getvnl
+    auto vkb_diff = [&](const int ik) {
+        double diff = 0.0;
+        for (int ikb = 0; ikb < ppcell.nkb; ikb++)
+        {
+            for (int ig = 0; ig < wfcpw.npwk[ik]; ig++)
+            {
+                const int i = ikb * ppcell.vkb.nc + ig;
+                diff = std::max(diff, std::abs(vkb_ref[ik][i] - ppcell.vkb.c[i]));
+            }
+        }
+        return diff;
+    };
+    auto cached_k = [](const NonlocalPW& nl) {
+        std::vector<int> ks;
+        for (const auto& item: nl.vkb_cache)
+        {
+            ks.push_back(item.first);
+        }
+        return ks;
+    };
+
+    // room for two k points
+    NonlocalPW::VKB_CACHE_MB = 2.5 * size * sizeof(std::complex<double>) / 1024.0 / 1024.0;
+    {
+        NonlocalPW nl(isk, &ppcell, &ucell, &wfcpw);
+        // k point, whether it is calculated by getvnl, and the cached k points after init()
+        const std::vector<std::tuple<int, bool, std::vector<int>>> steps = {{0, true, {0}},
+                                                                             {1, true, {1, 0}},
+                                                                             {0, false, {0, 1}},
+                                                                             {2, true, {2, 0}},
+                                                                             {0, false, {0, 2}},
+                                                                             {1, true, {1, 0}}};
+        for (const auto& step: steps)
+        {
+            const int ik = std::get<0>(step);
+            const int calls = getvnl_calls;
+            nl.init(ik);
+            EXPECT_EQ(getvnl_calls - calls, std::get<1>(step) ? 1 : 0) << "ik = " << ik;
+            EXPECT_EQ(cached_k(nl), std::get<2>(step)) << "ik = " << ik;
+            EXPECT_EQ(vkb_diff(ik), 0.0) << "ik = " << ik;
+        }
+    }
+
+    // no cache
+    NonlocalPW::VKB_CACHE_MB = 0.0;
+    {
+        NonlocalPW nl(isk, &ppcell, &ucell, &wfcpw);
+        for (const int ik: {0, 1, 0, 0})
+        {
+            const int calls = getvnl_calls;
+            nl.init(ik);
+            EXPECT_EQ(getvnl_calls - calls, 1) << "ik = " << ik;
+            EXPECT_TRUE(nl.vkb_cache.empty());
+            EXPECT_EQ(vkb_diff(ik), 0.0) << "ik = " << ik;
+        }
+    }
+    NonlocalPW::VKB_CACHE_MB = cache_mb;
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &GlobalV::NPROC);
+    MPI_Comm_rank(MPI_COMM_WORLD, &GlobalV::MY_RANK);
+    GlobalV::NPROC_IN_POOL = GlobalV::NPROC;
+    GlobalV::RANK_IN_POOL = GlobalV::MY_RANK;
+    MPI_Comm_split(MPI_COMM_WORLD, 0, 1, &POOL_WORLD);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
@@ -260,6 +260,23 @@ void diago_PAO_in_pw_k2(const int &ik,
 	}
 }
 
+// gamma_only: the starting wave functions are made real by a round trip through the real grid,
+// and stored in the convention of PW_Basis_K::scale_gamma
+static void wfc_to_gamma(const int &ik,
+                         std::complex<double>* wfc,
+                         const int nwfc,
+                         const int ld,
+                         ModulePW::PW_Basis_K *wfc_basis)
+{
+	std::vector<double> wfcr(wfc_basis->nrxx);
+	for (int ib = 0; ib < nwfc; ib++)
+	{
+		wfc_basis->recip2real(wfc + ib * ld, wfcr.data(), ik);
+		wfc_basis->real2recip(wfcr.data(), wfc + ib * ld, ik);
+		wfc_basis->scale_gamma(wfc + ib * ld, ik, std::sqrt(2.0));
+	}
+}
+
 void diago_PAO_in_pw_k2(const int &ik,
                         psi::Psi<std::complex<double>> &wvf,
                         ModulePW::PW_Basis_K *wfc_basis,
@@ -297,6 +314,10 @@ void diago_PAO_in_pw_k2(const int &ik,
 	if( p_wf->init_wfc=="random" || ( p_wf->init_wfc.substr(0,6)=="atomic" && GlobalC::ucell.natomwfc == 0 ))
 	{
 		p_wf->random(wvf.get_pointer(),0,nbands,ik, wfc_basis);
+		if(wfc_basis->gamma_only)
+		{
+			wfc_to_gamma(ik, wvf.get_pointer(), nbands, nbasis, wfc_basis);
+		}
 
 		if(GlobalV::KS_SOLVER=="cg") //xiaohui add 2013-09-02
 		{
@@ -335,6 +356,10 @@ void diago_PAO_in_pw_k2(const int &ik,
         // with random wfcs
         //====================================================
         p_wf->random(wfcatom.c, GlobalC::ucell.natomwfc, nbands, ik, wfc_basis);
+        if(wfc_basis->gamma_only)
+        {
+            wfc_to_gamma(ik, wfcatom.c, starting_nw, nbasis, wfc_basis);
+        }
 
         // (7) Diago with cg method.
 		//if(GlobalV::DIAGO_TYPE == "cg") xiaohui modify 2013-09-02
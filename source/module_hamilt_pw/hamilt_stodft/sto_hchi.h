@@ -2,6 +2,8 @@
 #define STO_HCHI_H
 #include "module_basis/module_pw/pw_basis_k.h"
 #include "module_cell/klist.h"
+#include "module_hamilt_general/hamilt.h"
+#include "module_psi/psi.h"
 
 //-----------------------------------------------------
 // h * chi
@@ -12,6 +14,8 @@
 // and the non-local pseudopotentials.
 // The effective potential = Local pseudopotential +
 // Hartree potential + Exchange-correlation potential
+// H is applied by the operator chain of p_hamilt, which
+// should have been updated to current_ik by updateHk().
 //------------------------------------------------------
 class Stochastic_hchi
 {
@@ -48,10 +52,16 @@ class Stochastic_hchi
 	int current_ik = 0;
 	ModulePW::PW_Basis_K* wfcpw = nullptr;
 	K_Vectors* pkv = nullptr;
+	hamilt::Hamilt<double>* p_hamilt = nullptr;
 
 	// chi should be orthogonal to psi (generated by diaganolization methods,
 	// such as CG)
 
+	private:
+	// persistent workspace wrapping chi for the operator chain,
+	// it is reallocated only when more stochastic orbitals are passed
+	psi::Psi<std::complex<double>>* chi_work = nullptr;
+
 };
 
 #endif// Eelectrons_hchi
@@ -1,12 +1,16 @@
 #include "sto_iter.h"
 #include "module_base/blas_connector.h"
+#include "module_base/lapack_connector.h"
 #include "module_base/timer.h"
 #include "module_base/tool_quit.h"
 #include "module_base/tool_title.h"
+#include "module_base/memory.h"
 #include "module_base/parallel_reduce.h"
 #include "module_base/blas_connector.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_elecstate/occupy.h"
+#include <cstdlib>
+#include <limits>
 
 double Stochastic_Iter::vTMv(const double *v, const double * M, const int n)
 {
@@ -34,42 +38,90 @@ Stochastic_Iter::~Stochastic_Iter()
     delete p_che;
     delete[] spolyv;
     delete[] chiallorder;
+    delete[] chiallorder_sp;
 }
 
 void Stochastic_Iter::init(int* nchip_in, const int method_in, K_Vectors* pkv_in, ModulePW::PW_Basis_K* wfc_basis, Stochastic_WF& stowf)
 {
-    p_che = new ModuleBase::Chebyshev<double>(INPUT.nche_sto);
     nchip = nchip_in;
     targetne = GlobalV::nelec;
     this->pkv = pkv_in;
     stohchi.init(wfc_basis, pkv);
-    delete[] spolyv;
-    const int norder = p_che->norder;
-    const int nks = wfc_basis->nks;
     this->method = method_in;
-    if(method == 1)                 spolyv = new double [norder];
-    else                            spolyv = new double [norder*norder];
     stofunc.Emin = INPUT.emin_sto;
     stofunc.Emax = INPUT.emax_sto;
+    this->che_thr = INPUT.che_thr_sto;
+    this->storage = INPUT.storage_sto;
+    this->set_norder(INPUT.nche_sto, stowf);
+}
+
+void Stochastic_Iter::set_norder(const int norder, Stochastic_WF& stowf)
+{
+    delete p_che;
+    p_che = new ModuleBase::Chebyshev<double>(norder);
+    const int nks = stowf.nks;
+    delete[] spolyv;
+    if(method == 1)                 spolyv = new double [norder];
+    else                            spolyv = new double [norder*norder];
     
     if(this->method == 2)
     {
-        double tot = 0;
+        const size_t nbyte = (this->storage == "single") ? sizeof(std::complex<float>) : sizeof(std::complex<double>);
+        // memory of one order of T_n(\hat{h})|\chi> in this process
+        double mem_order = 0;
         for (int ik = 0; ik < nks; ++ik)
         {
-            tot += stowf.chi0[ik].nr * stowf.chi0[ik].nc * norder * 4; // each complex cost 4B memory
+            mem_order += double(stowf.chi0[ik].nr) * stowf.chi0[ik].nc * nbyte;
+        }
+        mem_order /= double(1073741824); //convert B to GB
+        this->nstore = (this->storage == "recompute") ? 0 : norder;
+        if (INPUT.memory_sto > 0 && this->nstore * mem_order > INPUT.memory_sto)
+        {
+            this->nstore = static_cast<int>(INPUT.memory_sto / mem_order);
+        }
+        // two successive orders are needed to restart the recurrence
+        if (this->nstore < 2)
+            this->nstore = 0;
+        if (this->nstore < norder)
+        {
+            GlobalV::ofs_running << " Keep " << this->nstore << " of " << norder
+                                 << " orders of T_n(h)|chi> in memory, the others are recomputed." << std::endl;
         }
+
+        double tot = mem_order * this->nstore;
 #ifdef __MPI
         MPI_Allreduce(MPI_IN_PLACE, &tot, 1, MPI_DOUBLE, MPI_SUM, POOL_WORLD);
 #endif
-        tot /= double(1073741824); //convert B to GB
         if(tot > 64)    std::cout<<" WARNING: POOL 0 uses memories of over "<<tot<<" GB."<<std::endl;
-        this->chiallorder = new ModuleBase::ComplexMatrix[stowf.nks];
-        for (int ik = 0; ik < nks; ++ik)
+        delete[] this->chiallorder;
+        delete[] this->chiallorder_sp;
+        this->chiallorder = nullptr;
+        this->chiallorder_sp = nullptr;
+        if (this->nstore > 0)
         {
-            const int nchip = stowf.chi0[ik].nr;
-            const int npwx = stowf.chi0[ik].nc;
-            chiallorder[ik].create(nchip * npwx, norder,true);
+            if (this->storage == "single")
+            {
+                this->chiallorder_sp = new std::vector<std::complex<float>>[stowf.nks];
+            }
+            else
+            {
+                this->chiallorder = new ModuleBase::ComplexMatrix[stowf.nks];
+            }
+            for (int ik = 0; ik < nks; ++ik)
+            {
+                const int nchip = stowf.chi0[ik].nr;
+                const int npwx = stowf.chi0[ik].nc;
+                if (this->storage == "single")
+                {
+                    chiallorder_sp[ik].resize(size_t(nchip) * npwx * this->nstore);
+                }
+                else
+                {
+                    chiallorder[ik].create(nchip * npwx, this->nstore, true);
+                }
+            }
+            ModuleBase::Memory::record("Stochastic_Iter::chiallorder",
+                                       static_cast<size_t>(mem_order * this->nstore * 1073741824));
         }
     }
 }
@@ -131,6 +183,38 @@ void Stochastic_Iter::checkemm(const int& ik, const int istep, const int iter, S
         ntest = nchip[ik];
     }
 
+    if (this->che_thr > 0)
+    {
+        // the bounds of all k points are collected from scratch
+        if (ik == 0)
+        {
+            this->emin_k = std::numeric_limits<double>::max();
+            this->emax_k = std::numeric_limits<double>::lowest();
+        }
+        if (ntest > 0)
+        {
+            pchi = (GlobalV::NBANDS > 0) ? stowf.chiortho[ik].c : stowf.chi0[ik].c;
+            double emin = 0, emax = 0;
+            this->lanczos_emm(pchi, npw, stowf.npwx, emin, emax);
+            this->emin_k = std::min(this->emin_k, emin);
+            this->emax_k = std::max(this->emax_k, emax);
+        }
+        ntest = 0;
+        if (ik == nks - 1)
+        {
+#ifdef __MPI
+            MPI_Allreduce(MPI_IN_PLACE, &this->emax_k, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+            MPI_Allreduce(MPI_IN_PLACE, &this->emin_k, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+#endif
+            if (this->emin_k < this->emax_k)
+            {
+                change = (this->emin_k != stohchi.Emin || this->emax_k != stohchi.Emax);
+                stohchi.Emin = this->emin_k;
+                stohchi.Emax = this->emax_k;
+            }
+        }
+    }
+
     for (int ichi = 0; ichi < ntest; ++ichi)
     {
         if (GlobalV::NBANDS > 0)
@@ -181,7 +265,110 @@ void Stochastic_Iter::checkemm(const int& ik, const int istep, const int iter, S
     }
 }
 
-void Stochastic_Iter::check_precision(const double ref, const double thr, const std::string info)
+// Lanczos steps on H starting from chi; the extreme Ritz values widened by the last
+// off-diagonal element bound the spectrum of H
+void Stochastic_Iter::lanczos_emm(const std::complex<double>* pchi,
+                                  const int npw,
+                                  const int npwx,
+                                  double& emin,
+                                  double& emax)
+{
+    ModuleBase::timer::tick("Stochastic_Iter", "lanczos_emm");
+    const int nstep_max = 20;
+    std::vector<std::complex<double>> work(3 * size_t(npwx));
+    std::complex<double>* v_1 = work.data();
+    std::complex<double>* v = v_1 + npwx;
+    std::complex<double>* w = v + npwx;
+    std::vector<double> alpha(nstep_max, 0), beta(nstep_max, 0);
+
+    const double norm = sqrt(ModuleBase::GlobalFunc::ddot_real(npw, pchi, pchi));
+    for (int ig = 0; ig < npwx; ++ig)
+    {
+        v[ig] = (ig < npw) ? pchi[ig] / norm : 0;
+    }
+    int nstep = 0;
+    for (int istep = 0; istep < nstep_max; ++istep)
+    {
+        stohchi.hchi(v, w, 1);
+        alpha[istep] = ModuleBase::GlobalFunc::ddot_real(npw, v, w);
+        const double beta_1 = (istep > 0) ? beta[istep - 1] : 0;
+        for (int ig = 0; ig < npw; ++ig)
+        {
+            w[ig] -= alpha[istep] * v[ig] + beta_1 * v_1[ig];
+        }
+        beta[istep] = sqrt(ModuleBase::GlobalFunc::ddot_real(npw, w, w));
+        ++nstep;
+        if (beta[istep] < 1e-10)
+            break;
+        for (int ig = 0; ig < npw; ++ig)
+        {
+            v_1[ig] = v[ig];
+            v[ig] = w[ig] / beta[istep];
+        }
+    }
+
+    // eigenvalues of the tridiagonal matrix in ascending order
+    std::vector<double> offdiag(beta.begin(), beta.begin() + nstep);
+    int info = 0;
+    dsterf_(&nstep, alpha.data(), offdiag.data(), &info);
+    if (info != 0)
+    {
+        ModuleBase::WARNING_QUIT("Stochastic_Iter", "Lanczos estimation of Emin and Emax failed!");
+    }
+    emin = alpha[0] - beta[nstep - 1];
+    emax = alpha[nstep - 1] + beta[nstep - 1];
+    ModuleBase::timer::tick("Stochastic_Iter", "lanczos_emm");
+}
+
+// the smallest order whose neglected Chebyshev coefficients of the occupation
+// sum up to less than che_thr, which bounds the error of the expansion in [-1, 1]
+void Stochastic_Iter::select_norder(Stochastic_WF& stowf)
+{
+    const double mu_bak = stofunc.mu;
+    // before mu is known, mu in the middle of the spectrum needs the highest order
+    stofunc.mu = this->mu_known ? mu0 : (stofunc.Emin + stofunc.Emax) / 2;
+    const int nprobe_max = 16384;
+    int nprobe = 2 * std::max(p_che->norder, std::max(this->norder_min, 8));
+    int norder_new = nprobe;
+    while (true)
+    {
+        ModuleBase::Chebyshev<double> che(nprobe);
+        if (this->method == 1)
+            che.calcoef_real(&stofunc, &Sto_Func<double>::nfd);
+        else
+            che.calcoef_real(&stofunc, &Sto_Func<double>::nroot_fd);
+        double tail = 0;
+        norder_new = 2;
+        for (int n = nprobe - 1; n >= 2; --n)
+        {
+            tail += std::abs(che.coef_real[n]);
+            if (tail >= this->che_thr)
+            {
+                norder_new = n + 1;
+                break;
+            }
+        }
+        // coefficients decay exponentially, so the orders beyond nprobe are negligible
+        // only if the selected order is well below nprobe
+        if (norder_new <= nprobe / 2 || nprobe >= nprobe_max)
+            break;
+        nprobe *= 2;
+    }
+    stofunc.mu = mu_bak;
+    if (norder_new > nprobe_max / 2)
+    {
+        ModuleBase::WARNING("Stochastic_Iter", "che_thr_sto can not be reached, please check emin_sto and emax_sto.");
+    }
+    norder_new = std::max(norder_new, this->norder_min);
+    if (norder_new != p_che->norder)
+    {
+        GlobalV::ofs_running << " Chebyshev order changes from " << p_che->norder << " to " << norder_new
+                             << " for che_thr_sto = " << this->che_thr << std::endl;
+        this->set_norder(norder_new, stowf);
+    }
+}
+
+bool Stochastic_Iter::check_precision(const double ref, const double thr, const std::string info)
 {
     //==============================
     //precision check
@@ -216,8 +403,10 @@ void Stochastic_Iter::check_precision(const double ref, const double thr, const
         ss>>tartxt;
         std::string warningtxt = "( "+info+" relative Chebyshev error = "+fractxt+" > threshold = "+tartxt+" ) Maybe you should increase the parameter \"nche_sto\" for more accuracy.";
         ModuleBase::WARNING("Stochastic_Chebychev", warningtxt);
+        return false;
     }
     //===============================
+    return true;
 }
 
 void Stochastic_Iter::itermu(const int iter, elecstate::ElecState* pes) 
@@ -293,8 +482,14 @@ void Stochastic_Iter::itermu(const int iter, elecstate::ElecState* pes)
         }
     }
     pes->eferm.ef = this->stofunc.mu = mu0 = mu3;
+    this->mu_known = true;
     GlobalV::ofs_running<<"Converge fermi energy = "<<mu3<<" Ry in "<<count<<" steps."<<std::endl;
-    this->check_precision(targetne,10*GlobalV::SCF_THR,"Ne");
+    const bool precise = this->check_precision(targetne,10*GlobalV::SCF_THR,"Ne");
+    // re-expand with a higher order from the next calPn
+    if (this->che_thr > 0 && !precise)
+    {
+        this->norder_min = p_che->norder * 3 / 2;
+    }
     
     //Set wf.wg 
     if(GlobalV::NBANDS > 0)
@@ -317,6 +512,10 @@ void Stochastic_Iter::calPn(const int& ik, Stochastic_WF& stowf)
     ModuleBase::TITLE("Stochastic_Iter", "calPn");
     ModuleBase::timer::tick("Stochastic_Iter", "calPn");
 
+    if (ik == 0 && this->che_thr > 0)
+    {
+        this->select_norder(stowf);
+    }
     const int norder = p_che->norder;
     const int nchip_ik = nchip[ik];
     const int npw = stowf.ngk[ik];
@@ -340,7 +539,7 @@ void Stochastic_Iter::calPn(const int& ik, Stochastic_WF& stowf)
             spolyv[i] += p_che->polytrace[i] * this->pkv->wk[ik];
         }
     }
-    else
+    else if (this->storage == "double" && this->nstore == norder)
     {
         p_che->calpolyvec_complex(&stohchi, &Stochastic_hchi::hchi_norm, pchi, this->chiallorder[ik].c, npw, npwx, nchip_ik);
         double* vec_all= (double *) this->chiallorder[ik].c;
@@ -353,10 +552,112 @@ void Stochastic_Iter::calPn(const int& ik, Stochastic_WF& stowf)
         double kweight = this->pkv->wk[ik];
         dgemm_(&trans,&normal, &N,&N,&M,&kweight,vec_all,&LDA,vec_all,&LDA,&one,spolyv,&N);
     }
+    else
+    {
+        this->calPn_lean(ik, pchi, npw, npwx, nchip_ik);
+    }
     ModuleBase::timer::tick("Stochastic_Iter", "calPn");
     return;
 }
 
+// Re<chi_L|chi_R> of the m stochastic orbitals in this process
+static double dot_chi(const std::complex<double>* chi_L,
+                      const std::complex<double>* chi_R,
+                      const int npw,
+                      const int npwx,
+                      const int m)
+{
+    double result = 0;
+    for (int ichi = 0; ichi < m; ++ichi)
+    {
+        result += ModuleBase::GlobalFunc::ddot_real(npw, chi_L + ichi * npwx, chi_R + ichi * npwx, false);
+    }
+    return result;
+}
+
+// Since T_m*T_n = (T_{m+n} + T_{|m-n|})/2, Pn_{mn} = (t_{m+n} + t_{|m-n|})/2 with t_k = <chi|T_k(h)|chi>.
+// t_{2n} = 2<T_n chi|T_n chi> - t_0 and t_{2n+1} = 2<T_{n+1} chi|T_n chi> - t_1 are obtained
+// while the orders are generated, so that only the first nstore orders are kept.
+void Stochastic_Iter::calPn_lean(const int& ik,
+                                 std::complex<double>* pchi,
+                                 const int npw,
+                                 const int npwx,
+                                 const int nchip_ik)
+{
+    const int norder = p_che->norder;
+    const int ndim = npwx * nchip_ik;
+    std::vector<double> tk(2 * norder - 1, 0);
+    std::vector<std::complex<double>> work(3 * size_t(ndim));
+    std::complex<double>* arrayn_1 = work.data();
+    std::complex<double>* arrayn = arrayn_1 + ndim;
+    std::complex<double>* arraynp1 = arrayn + ndim;
+
+    ModuleBase::GlobalFunc::COPYARRAY(pchi, arrayn_1, ndim);
+    stohchi.hchi_norm(arrayn_1, arrayn, nchip_ik);
+    this->store_order(ik, 0, arrayn_1);
+    this->store_order(ik, 1, arrayn);
+    tk[0] = dot_chi(arrayn_1, arrayn_1, npw, npwx, nchip_ik);
+    tk[1] = dot_chi(arrayn_1, arrayn, npw, npwx, nchip_ik);
+    for (int n = 1; n < norder; ++n)
+    {
+        tk[2 * n] = 2 * dot_chi(arrayn, arrayn, npw, npwx, nchip_ik) - tk[0];
+        if (n == norder - 1)
+            break;
+        p_che->recurs_complex(&stohchi, &Stochastic_hchi::hchi_norm, arraynp1, arrayn, arrayn_1, npw, npwx, nchip_ik);
+        this->store_order(ik, n + 1, arraynp1);
+        tk[2 * n + 1] = 2 * dot_chi(arraynp1, arrayn, npw, npwx, nchip_ik) - tk[1];
+        std::complex<double>* tem = arrayn_1;
+        arrayn_1 = arrayn;
+        arrayn = arraynp1;
+        arraynp1 = tem;
+    }
+
+    const double kweight = this->pkv->wk[ik];
+    for (int m = 0; m < norder; ++m)
+    {
+        for (int n = 0; n < norder; ++n)
+        {
+            spolyv[m * norder + n] += kweight * 0.5 * (tk[m + n] + tk[std::abs(m - n)]);
+        }
+    }
+}
+
+void Stochastic_Iter::store_order(const int& ik, const int n, const std::complex<double>* tnchi)
+{
+    if (n >= this->nstore)
+        return;
+    const int ndim = stohchi.wfcpw->npwk_max * nchip[ik];
+    if (this->storage == "single")
+    {
+        std::complex<float>* pstore = this->chiallorder_sp[ik].data() + size_t(n) * ndim;
+        for (int i = 0; i < ndim; ++i)
+        {
+            pstore[i] = static_cast<std::complex<float>>(tnchi[i]);
+        }
+    }
+    else
+    {
+        ModuleBase::GlobalFunc::COPYARRAY(tnchi, this->chiallorder[ik].c + size_t(n) * ndim, ndim);
+    }
+}
+
+void Stochastic_Iter::load_order(const int& ik, const int n, std::complex<double>* tnchi)
+{
+    const int ndim = stohchi.wfcpw->npwk_max * nchip[ik];
+    if (this->storage == "single")
+    {
+        const std::complex<float>* pstore = this->chiallorder_sp[ik].data() + size_t(n) * ndim;
+        for (int i = 0; i < ndim; ++i)
+        {
+            tnchi[i] = static_cast<std::complex<double>>(pstore[i]);
+        }
+    }
+    else
+    {
+        ModuleBase::GlobalFunc::COPYARRAY(this->chiallorder[ik].c + size_t(n) * ndim, tnchi, ndim);
+    }
+}
+
 double Stochastic_Iter::calne(elecstate::ElecState* pes)
 {  
     ModuleBase::timer::tick("Stochastic_Iter","calne");
@@ -405,19 +706,7 @@ void Stochastic_Iter::calHsqrtchi(Stochastic_WF& stowf)
         //init k
         if(this->pkv->nks > 1)
         {
-
-            if(GlobalV::NSPIN==2)
-            {
-                GlobalV::CURRENT_SPIN = this->pkv->isk[ik];
-            }
-
-            if(GlobalC::ppcell.nkb > 0 && (GlobalV::BASIS_TYPE=="pw" || GlobalV::BASIS_TYPE=="lcao_in_pw")) //xiaohui add 2013-09-02. Attention...
-            {
-                GlobalC::ppcell.getvnl(ik, GlobalC::ppcell.vkb);
-            }
-
-            GlobalV::CURRENT_K = ik;
-
+            stohchi.p_hamilt->updateHk(ik);
         }
         stohchi.current_ik = ik;
 
@@ -599,22 +888,64 @@ void Stochastic_Iter::calTnchi_ik(const int& ik, Stochastic_WF& stowf)
         pchi = stowf.chiortho[ik].c;
     else
         pchi = stowf.chi0[ik].c;
-    if(this->method==2)
-    {
-        char transa = 'N';
-        std::complex<double> one = 1;
-        int inc = 1;
-        std::complex<double> zero = 0;
-        int LDA = npwx * nchip[ik];
-        int M = npwx * nchip[ik];
-        int N = p_che->norder;
-        std::complex<double>* coef_real = new std::complex<double>[p_che->norder];
-        for (int i = 0; i < p_che->norder; ++i)
+    if(this->method == 2 && this->nstore > 0)
+    {
+        const int norder = p_che->norder;
+        const int ndim = npwx * nchip[ik];
+        if (this->storage == "single")
+        {
+            ModuleBase::GlobalFunc::ZEROS(out, ndim);
+            for (int n = 0; n < this->nstore; ++n)
+            {
+                const std::complex<float>* pstore = this->chiallorder_sp[ik].data() + size_t(n) * ndim;
+                const double coef = p_che->coef_real[n];
+                for (int i = 0; i < ndim; ++i)
+                {
+                    out[i] += coef * static_cast<std::complex<double>>(pstore[i]);
+                }
+            }
+        }
+        else
         {
-            coef_real[i] = p_che->coef_real[i];
+            char transa = 'N';
+            std::complex<double> one = 1;
+            int inc = 1;
+            std::complex<double> zero = 0;
+            int LDA = ndim;
+            int M = ndim;
+            int N = this->nstore;
+            std::complex<double>* coef_real = new std::complex<double>[this->nstore];
+            for (int i = 0; i < this->nstore; ++i)
+            {
+                coef_real[i] = p_che->coef_real[i];
+            }
+            zgemv_(&transa, &M, &N, &one, this->chiallorder[ik].c, &LDA, coef_real, &inc, &zero, out, &inc);
+            delete[] coef_real;
+        }
+
+        // restart the recurrence from the last two orders kept in memory
+        if (this->nstore < norder)
+        {
+            std::vector<std::complex<double>> work(3 * size_t(ndim));
+            std::complex<double>* arrayn_1 = work.data();
+            std::complex<double>* arrayn = arrayn_1 + ndim;
+            std::complex<double>* arraynp1 = arrayn + ndim;
+            this->load_order(ik, this->nstore - 2, arrayn_1);
+            this->load_order(ik, this->nstore - 1, arrayn);
+            for (int ior = this->nstore; ior < norder; ++ior)
+            {
+                p_che->recurs_complex(&stohchi, &Stochastic_hchi::hchi_norm, arraynp1, arrayn, arrayn_1, npw, npwx, nchip[ik]);
+                const double coef = p_che->coef_real[ior];
+                for (int i = 0; i < ndim; ++i)
+                {
+                    out[i] += coef * arraynp1[i];
+                }
+                std::complex<double>* tem = arrayn_1;
+                arrayn_1 = arrayn;
+                arrayn = arraynp1;
+                arraynp1 = tem;
+            }
         }
-        zgemv_(&transa, &M, &N, &one, this->chiallorder[ik].c, &LDA, coef_real, &inc, &zero, out, &inc);
-        delete[] coef_real;
     }
     else
     {
@@ -628,6 +959,9 @@ void Stochastic_Iter::cleanchiallorder()
     {
         delete[] chiallorder;
         chiallorder = nullptr;
+        delete[] chiallorder_sp;
+        chiallorder_sp = nullptr;
+        nstore = 0;
     }
 }
 
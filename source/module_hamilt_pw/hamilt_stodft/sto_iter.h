@@ -7,6 +7,7 @@
 #include "module_psi/psi.h"
 #include "module_elecstate/elecstate.h"
 #include "module_hamilt_general/hamilt.h"
+#include <vector>
 
 //----------------------------------------------
 // Solve for the new electron density and iterate 
@@ -40,7 +41,11 @@ class Stochastic_Iter
 
     void checkemm(const int &ik, const int istep, const int iter, Stochastic_WF& stowf);
 
-    void check_precision(const double ref,const double thr, const std::string info);
+    //return false if the relative Chebyshev error is larger than thr
+    bool check_precision(const double ref,const double thr, const std::string info);
+
+    //set the order of Chebyshev expansion and allocate the memory depending on it
+    void set_norder(const int norder, Stochastic_WF& stowf);
 
     ModuleBase::Chebyshev<double>* p_che = nullptr;
 
@@ -56,11 +61,21 @@ class Stochastic_Iter
     
     int * nchip = nullptr;
     bool check = false;
+    //error threshold of the Chebyshev expansion of the occupation, > 0: choose the order adaptively
+    double che_thr = 0;
+    //lower limit of the adaptive order, raised when the precision check fails
+    int norder_min = 0;
+    bool mu_known = false;
     double th_ne;
     double KS_ne;
     public:
     int method; //different methods 1: slow, less memory  2: fast, more memory
+    //storage of T_n(\hat{h})|\chi> for method 2: "double", "single" or "recompute"
+    std::string storage = "double";
+    //number of orders of T_n(\hat{h})|\chi> kept in memory, the others are recomputed
+    int nstore = 0;
     ModuleBase::ComplexMatrix* chiallorder = nullptr;
+    std::vector<std::complex<float>>* chiallorder_sp = nullptr; // used when storage = "single"
     //chiallorder cost too much memories and should be cleaned after scf.
     void cleanchiallorder();
     //cal shchi = \sqrt{f(\hat{H})}|\chi>
@@ -73,6 +88,19 @@ class Stochastic_Iter
     double vTMv(const double *v, const double * M, const int n);
   private:
     K_Vectors* pkv;
+    //Emin and Emax of H collected over k points by Lanczos steps
+    double emin_k = 0;
+    double emax_k = 0;
+    //estimate Emin and Emax of H with a few Lanczos steps starting from chi
+    void lanczos_emm(const std::complex<double>* pchi, const int npw, const int npwx, double& emin, double& emax);
+    //choose the smallest order meeting che_thr
+    void select_norder(Stochastic_WF& stowf);
+    //cal Pn_{mn} = <T_m(\hat{h})\chi|T_n(\hat{h})\chi> with only two successive orders at a time
+    void calPn_lean(const int& ik, std::complex<double>* pchi, const int npw, const int npwx, const int nchip_ik);
+    //keep the n-th order T_n(\hat{h})|\chi> if n < nstore
+    void store_order(const int& ik, const int n, const std::complex<double>* tnchi);
+    //get the n-th order T_n(\hat{h})|\chi> kept in memory
+    void load_order(const int& ik, const int n, std::complex<double>* tnchi);
 
 };
 
@@ -0,0 +1,478 @@
+#include <cmath>
+#include <complex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "module_base/lapack_connector.h"
+#include "module_elecstate/occupy.h"
+#include "module_hamilt_pw/hamilt_pwdft/global.h"
+#include "module_io/input.h"
+#define private public
+#include "module_hamilt_pw/hamilt_stodft/sto_iter.h"
+#undef private
+
+/************************************************
+ *  unit test of class Stochastic_Iter
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - calPn
+ *     - Pn_{mn} = \sum_k wk \sum_\chi <T_m(h)\chi|T_n(h)\chi> is the same when all orders of T_n(h)|\chi> are kept
+ *       in double or single precision, when only a part of them is kept and when none is kept (calPn_lean)
+ *   - calTnchi_ik
+ *     - \sum_n C_n T_n(h)|\chi> is the same for the kept orders and for the orders recomputed from the last two kept
+ *   - lanczos_emm
+ *     - [emin, emax] given by the Lanczos steps encloses the exact eigenvalues of H
+ *   - select_norder
+ *     - the order is the smallest one whose neglected Chebyshev coefficients of the occupation sum up to less than
+ *       che_thr, the coefficients are given by a Gauss-Chebyshev quadrature here
+ *
+ * H of each k point is a small dense Hermitian matrix applied by a mocked Stochastic_hchi,
+ * and the reference T_n(h)|\chi> are given by the Chebyshev recurrence with this matrix.
+ */
+
+Input INPUT;
+namespace GlobalC
+{
+UnitCell ucell;
+}
+Magnetism::Magnetism()
+{
+}
+Magnetism::~Magnetism()
+{
+}
+UnitCell::UnitCell()
+{
+}
+UnitCell::~UnitCell()
+{
+}
+double Occupy::gaussian_parameter = 0.01;
+void Charge::rho_mpi(const int& nbz, const int& bz)
+{
+}
+
+K_Vectors::K_Vectors()
+{
+}
+K_Vectors::~K_Vectors()
+{
+}
+Stochastic_WF::Stochastic_WF()
+{
+}
+Stochastic_WF::~Stochastic_WF()
+{
+    delete[] chi0;
+    delete[] chiortho;
+    delete[] shchi;
+}
+
+// dense H of each k point, [npwx * npwx]
+std::vector<std::vector<std::complex<double>>> mock_hk;
+
+Stochastic_hchi::Stochastic_hchi()
+{
+}
+Stochastic_hchi::~Stochastic_hchi()
+{
+}
+void Stochastic_hchi::init(ModulePW::PW_Basis_K* wfc_basis, K_Vectors* pkv_in)
+{
+    wfcpw = wfc_basis;
+    pkv = pkv_in;
+}
+void Stochastic_hchi::orthogonal_to_psi_reciprocal(std::complex<double>* wfin,
+                                                   std::complex<double>* wfout,
+                                                   const int& ikk)
+{
+}
+void Stochastic_hchi::hchi(std::complex<double>* chig, std::complex<double>* hchig, const int m)
+{
+    const int npwx = this->wfcpw->npwk_max;
+    const int npw = this->wfcpw->npwk[this->current_ik];
+    const std::vector<std::complex<double>>& h = mock_hk[this->current_ik];
+    for (int ib = 0; ib < m; ++ib)
+    {
+        for (int ig = 0; ig < npwx; ++ig)
+        {
+            std::complex<double> sum = 0;
+            if (ig < npw)
+            {
+                for (int jg = 0; jg < npw; ++jg)
+                {
+                    sum += h[ig * npwx + jg] * chig[ib * npwx + jg];
+                }
+            }
+            hchig[ib * npwx + ig] = sum;
+        }
+    }
+}
+void Stochastic_hchi::hchi_norm(std::complex<double>* chig, std::complex<double>* hchig, const int m)
+{
+    this->hchi(chig, hchig, m);
+    const int npwx = this->wfcpw->npwk_max;
+    const int npw = this->wfcpw->npwk[this->current_ik];
+    const double Ebar = (Emin + Emax) / 2;
+    const double DeltaE = (Emax - Emin) / 2;
+    for (int ib = 0; ib < m; ++ib)
+    {
+        for (int ig = 0; ig < npw; ++ig)
+        {
+            hchig[ib * npwx + ig] = (hchig[ib * npwx + ig] - Ebar * chig[ib * npwx + ig]) / DeltaE;
+        }
+    }
+}
+
+class StoIterTest : public ::testing::Test
+{
+  protected:
+    static const int nks = 2;
+    const int npwx = 10;
+    const int ngk[nks] = {10, 7};
+    int nchip[nks] = {3, 2};
+    const int norder = 12;
+    // exact eigenvalues of H of each k point in ascending order
+    std::vector<std::vector<double>> eig;
+    double emin = 0;
+    double emax = 0;
+
+    K_Vectors kv;
+    ModulePW::PW_Basis_K wfcpw;
+    Stochastic_WF stowf;
+    // T_n(h)|\chi> of all orders, [norder][nchip * npwx]
+    std::vector<std::vector<std::vector<std::complex<double>>>> tnchi_ref;
+
+    void SetUp() override
+    {
+        GlobalV::NBANDS = 0;
+        INPUT.memory_sto = 0;
+        kv.nks = nks;
+        kv.wk = {0.75, 1.25};
+        kv.ngk = {ngk[0], ngk[1]};
+        wfcpw.npwk_max = npwx;
+        wfcpw.npwk = new int[nks];
+        stowf.nks = nks;
+        stowf.npwx = npwx;
+        stowf.ngk = kv.ngk.data();
+        stowf.chi0 = new ModuleBase::ComplexMatrix[nks];
+        stowf.shchi = new ModuleBase::ComplexMatrix[nks];
+
+        std::mt19937 gen(2024);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        mock_hk.assign(nks, std::vector<std::complex<double>>(npwx * npwx, 0));
+        eig.assign(nks, std::vector<double>());
+        emin = 1e10;
+        emax = -1e10;
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            const int npw = ngk[ik];
+            wfcpw.npwk[ik] = npw;
+            std::vector<std::complex<double>>& h = mock_hk[ik];
+            for (int ig = 0; ig < npw; ++ig)
+            {
+                h[ig * npwx + ig] = 2.0 * dist(gen) + ig;
+                for (int jg = 0; jg < ig; ++jg)
+                {
+                    h[ig * npwx + jg] = std::complex<double>(dist(gen), dist(gen)) * 0.5;
+                    h[jg * npwx + ig] = std::conj(h[ig * npwx + jg]);
+                }
+            }
+            std::vector<std::complex<double>> a(h);
+            eig[ik].resize(npw);
+            const int lwork = 2 * npw;
+            std::vector<std::complex<double>> work(lwork);
+            std::vector<double> rwork(3 * npw);
+            int info = 0;
+            zheev_("N", "U", &npw, a.data(), &npwx, eig[ik].data(), work.data(), &lwork, rwork.data(), &info);
+            EXPECT_EQ(info, 0);
+            emin = std::min(emin, eig[ik][0]);
+            emax = std::max(emax, eig[ik][npw - 1]);
+
+            stowf.chi0[ik].create(nchip[ik], npwx);
+            stowf.shchi[ik].create(nchip[ik], npwx);
+            for (int ichi = 0; ichi < nchip[ik]; ++ichi)
+            {
+                for (int ig = 0; ig < npw; ++ig)
+                {
+                    stowf.chi0[ik](ichi, ig) = std::complex<double>(dist(gen), dist(gen));
+                }
+            }
+        }
+        // the spectrum is mapped into [-1, 1] with some margin
+        emin -= 0.5;
+        emax += 0.5;
+
+        tnchi_ref.assign(nks, std::vector<std::vector<std::complex<double>>>());
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            const int ndim = nchip[ik] * npwx;
+            std::vector<std::vector<std::complex<double>>>& tn = tnchi_ref[ik];
+            tn.assign(norder, std::vector<std::complex<double>>(ndim, 0));
+            for (int i = 0; i < ndim; ++i)
+            {
+                tn[0][i] = stowf.chi0[ik].c[i];
+            }
+            for (int n = 1; n < norder; ++n)
+            {
+                // T_1 = h T_0, T_{n+1} = 2 h T_n - T_{n-1}
+                const double fac = (n == 1) ? 1.0 : 2.0;
+                for (int ichi = 0; ichi < nchip[ik]; ++ichi)
+                {
+                    for (int ig = 0; ig < ngk[ik]; ++ig)
+                    {
+                        std::complex<double> sum = 0;
+                        for (int jg = 0; jg < ngk[ik]; ++jg)
+                        {
+                            sum += mock_hk[ik][ig * npwx + jg] * tn[n - 1][ichi * npwx + jg];
+                        }
+                        sum = (sum - (emax + emin) / 2 * tn[n - 1][ichi * npwx + ig]) / ((emax - emin) / 2);
+                        tn[n][ichi * npwx + ig] = fac * sum - ((n == 1) ? 0.0 : tn[n - 2][ichi * npwx + ig]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Stochastic_Iter with the orders of T_n(h)|\chi> kept as given by storage and memory_sto
+    void init_iter(Stochastic_Iter& stoiter, const std::string& storage, const double memory_sto)
+    {
+        INPUT.memory_sto = memory_sto;
+        stoiter.nchip = nchip;
+        stoiter.pkv = &kv;
+        stoiter.method = 2;
+        stoiter.storage = storage;
+        stoiter.stohchi.init(&wfcpw, &kv);
+        stoiter.stohchi.Emin = emin;
+        stoiter.stohchi.Emax = emax;
+        stoiter.set_norder(norder, stowf);
+    }
+
+    // memory of one order of T_n(h)|\chi> in GB
+    double mem_order() const
+    {
+        double mem = 0;
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            mem += double(nchip[ik]) * npwx * sizeof(std::complex<double>);
+        }
+        return mem / 1073741824;
+    }
+
+    void check_pn(Stochastic_Iter& stoiter)
+    {
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            stoiter.stohchi.current_ik = ik;
+            stoiter.calPn(ik, stowf);
+        }
+        for (int m = 0; m < norder; ++m)
+        {
+            for (int n = 0; n < norder; ++n)
+            {
+                double ref = 0;
+                for (int ik = 0; ik < nks; ++ik)
+                {
+                    for (int i = 0; i < nchip[ik] * npwx; ++i)
+                    {
+                        ref += kv.wk[ik] * (std::conj(tnchi_ref[ik][m][i]) * tnchi_ref[ik][n][i]).real();
+                    }
+                }
+                EXPECT_NEAR(stoiter.spolyv[m * norder + n], ref, 1e-10 * std::max(1.0, std::abs(ref)));
+            }
+        }
+    }
+
+    void check_tnchi(Stochastic_Iter& stoiter, const double thr)
+    {
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        for (int n = 0; n < norder; ++n)
+        {
+            stoiter.p_che->coef_real[n] = dist(gen) / (n + 1);
+        }
+        stoiter.p_che->getcoef_real = true;
+        for (int ik = 0; ik < nks; ++ik)
+        {
+            stoiter.stohchi.current_ik = ik;
+            stoiter.calTnchi_ik(ik, stowf);
+            for (int ichi = 0; ichi < nchip[ik]; ++ichi)
+            {
+                for (int ig = 0; ig < ngk[ik]; ++ig)
+                {
+                    std::complex<double> ref = 0;
+                    for (int n = 0; n < norder; ++n)
+                    {
+                        ref += stoiter.p_che->coef_real[n] * tnchi_ref[ik][n][ichi * npwx + ig];
+                    }
+                    EXPECT_NEAR(std::abs(stowf.shchi[ik](ichi, ig) - ref), 0.0, thr * std::max(1.0, std::abs(ref)));
+                }
+            }
+        }
+    }
+
+    // the smallest order n + 1 with \sum_{k>=n} |C_k[f]| >= thr, C_k[f] = 2/pi \int_0^pi f(cos t) cos(kt) dt
+    int expected_norder(Sto_Func<double>& stofunc, double (Sto_Func<double>::*fun)(double), const double thr)
+    {
+        const int ncut = 512;
+        const int nquad = 8 * ncut;
+        std::vector<double> fval(nquad);
+        for (int j = 0; j < nquad; ++j)
+        {
+            fval[j] = (stofunc.*fun)(cos((j + 0.5) * M_PI / nquad));
+        }
+        double tail = 0;
+        for (int n = ncut - 1; n >= 2; --n)
+        {
+            double coef = 0;
+            for (int j = 0; j < nquad; ++j)
+            {
+                coef += fval[j] * cos(n * (j + 0.5) * M_PI / nquad);
+            }
+            tail += std::abs(2.0 / nquad * coef);
+            if (tail >= thr)
+            {
+                return n + 1;
+            }
+        }
+        return 2;
+    }
+};
+
+TEST_F(StoIterTest, CalPnDouble)
+{
+    Stochastic_Iter stoiter;
+    this->init_iter(stoiter, "double", 0);
+    EXPECT_EQ(stoiter.nstore, norder);
+    this->check_pn(stoiter);
+    this->check_tnchi(stoiter, 1e-10);
+}
+
+TEST_F(StoIterTest, CalPnSingle)
+{
+    Stochastic_Iter stoiter;
+    this->init_iter(stoiter, "single", 0);
+    EXPECT_EQ(stoiter.nstore, norder);
+    this->check_pn(stoiter);
+    this->check_tnchi(stoiter, 1e-5);
+}
+
+TEST_F(StoIterTest, CalPnPartial)
+{
+    Stochastic_Iter stoiter;
+    // only 4 of the 12 orders fit into memory_sto
+    this->init_iter(stoiter, "double", 4.5 * this->mem_order());
+    EXPECT_EQ(stoiter.nstore, 4);
+    this->check_pn(stoiter);
+    this->check_tnchi(stoiter, 1e-10);
+}
+
+TEST_F(StoIterTest, CalPnRecompute)
+{
+    Stochastic_Iter stoiter;
+    this->init_iter(stoiter, "recompute", 0);
+    EXPECT_EQ(stoiter.nstore, 0);
+    EXPECT_EQ(stoiter.chiallorder, nullptr);
+    this->check_pn(stoiter);
+    this->check_tnchi(stoiter, 1e-10);
+}
+
+TEST_F(StoIterTest, LanczosEmm)
+{
+    Stochastic_Iter stoiter;
+    this->init_iter(stoiter, "double", 0);
+    for (int ik = 0; ik < nks; ++ik)
+    {
+        stoiter.stohchi.current_ik = ik;
+        double lo = 0;
+        double hi = 0;
+        stoiter.lanczos_emm(stowf.chi0[ik].c, ngk[ik], npwx, lo, hi);
+        const double eig_lo = eig[ik][0];
+        const double eig_hi = eig[ik][ngk[ik] - 1];
+        EXPECT_LE(lo, eig_lo);
+        EXPECT_GE(hi, eig_hi);
+        // the Krylov space of chi is the whole space here, so the bounds are tight
+        EXPECT_NEAR(lo, eig_lo, 1e-6);
+        EXPECT_NEAR(hi, eig_hi, 1e-6);
+    }
+}
+
+TEST_F(StoIterTest, SelectNorder)
+{
+    Stochastic_Iter stoiter;
+    this->init_iter(stoiter, "double", 0);
+    stoiter.stofunc.Emin = -2.0;
+    stoiter.stofunc.Emax = 2.0;
+    stoiter.stofunc.tem = 0.05;
+    stoiter.stofunc.mu = 0.7;
+    stoiter.che_thr = 1e-6;
+
+    // mu is not known yet, the middle of the spectrum is used
+    stoiter.mu_known = false;
+    stoiter.stofunc.mu = 0.0;
+    const int norder_mid = this->expected_norder(stoiter.stofunc, &Sto_Func<double>::nroot_fd, stoiter.che_thr);
+    stoiter.stofunc.mu = 0.7;
+    stoiter.select_norder(stowf);
+    EXPECT_EQ(stoiter.p_che->norder, norder_mid);
+    EXPECT_GT(norder_mid, norder);
+    // mu of stofunc is not changed
+    EXPECT_DOUBLE_EQ(stoiter.stofunc.mu, 0.7);
+
+    // a tighter threshold needs a higher order
+    stoiter.che_thr = 1e-9;
+    stoiter.stofunc.mu = 0.0;
+    const int norder_tight = this->expected_norder(stoiter.stofunc, &Sto_Func<double>::nroot_fd, 1e-9);
+    stoiter.stofunc.mu = 0.7;
+    stoiter.select_norder(stowf);
+    EXPECT_EQ(stoiter.p_che->norder, norder_tight);
+    EXPECT_GT(norder_tight, norder_mid);
+
+    // mu0 is used once mu is known
+    stoiter.che_thr = 1e-6;
+    stoiter.mu_known = true;
+    stoiter.mu0 = 1.9;
+    stoiter.stofunc.mu = 1.9;
+    const int norder_edge = this->expected_norder(stoiter.stofunc, &Sto_Func<double>::nroot_fd, 1e-6);
+    stoiter.stofunc.mu = 0.7;
+    stoiter.select_norder(stowf);
+    EXPECT_EQ(stoiter.p_che->norder, norder_edge);
+
+    // norder_min is the lower limit
+    stoiter.norder_min = norder_edge + 10;
+    stoiter.select_norder(stowf);
+    EXPECT_EQ(stoiter.p_che->norder, norder_edge + 10);
+    EXPECT_EQ(stoiter.nstore, norder_edge + 10);
+}
+
+TEST_F(StoIterTest, SelectNorderMethod1)
+{
+    Stochastic_Iter stoiter;
+    this->init_iter(stoiter, "double", 0);
+    stoiter.method = 1;
+    stoiter.stofunc.Emin = -2.0;
+    stoiter.stofunc.Emax = 2.0;
+    stoiter.stofunc.tem = 0.05;
+    stoiter.stofunc.mu = 0.0;
+    stoiter.che_thr = 1e-6;
+    const int norder_fd = this->expected_norder(stoiter.stofunc, &Sto_Func<double>::nfd, stoiter.che_thr);
+    stoiter.select_norder(stowf);
+    EXPECT_EQ(stoiter.p_che->norder, norder_fd);
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_split(MPI_COMM_WORLD, 0, 1, &POOL_WORLD);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
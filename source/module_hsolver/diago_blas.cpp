@@ -9,6 +9,7 @@
 
 #include "module_base/global_function.h"
 #include "module_base/global_variable.h"
+#include "module_base/memory.h"
 #include "module_base/scalapack_connector.h"
 #include "module_hamilt_general/matrixblock.h"
 
@@ -21,6 +22,28 @@ typedef hamilt::MatrixBlock<std::complex<double>> matcd;
 namespace hsolver
 {
 
+namespace
+{
+// whether the decomposed S(k) of k point ik fits in the budget GlobalV::LCAO_SK_CACHE,
+// it is decided with the largest local block of the BLACS grid, so all processes take the same branch
+bool sk_cached(const int ik, const int *const desc)
+{
+    int nprow = 0, npcol = 0, myprow = 0, mypcol = 0;
+    blacs_gridinfo_(&desc[1], &nprow, &npcol, &myprow, &mypcol);
+    const int zero = 0;
+    const double nloc_max = static_cast<double>(numroc_(&desc[2], &desc[4], &zero, &zero, &nprow))
+                            * numroc_(&desc[3], &desc[5], &zero, &zero, &npcol);
+    return (ik + 1) * nloc_max * sizeof(std::complex<double>) <= GlobalV::LCAO_SK_CACHE * 1024 * 1024;
+}
+} // namespace
+
+std::vector<std::vector<std::complex<double>>> DiagoBlas::DecomposedSk;
+
+void DiagoBlas::reset_decomposed_sk()
+{
+    std::vector<std::vector<std::complex<double>>>().swap(DecomposedSk);
+}
+
 void DiagoBlas::diag(hamilt::Hamilt<double> *phm_in, psi::Psi<double> &psi, double *eigenvalue_in)
 {
     ModuleBase::TITLE("DiagoElpa", "diag");
@@ -40,7 +63,10 @@ void DiagoBlas::diag(hamilt::Hamilt<double> *phm_in, psi::Psi<std::complex<doubl
     phm_in->matrix(h_mat, s_mat);
     assert(h_mat.col == s_mat.col && h_mat.row == s_mat.row && h_mat.desc == s_mat.desc);
     std::vector<double> eigen(GlobalV::NLOCAL, 0.0);
-    this->pzhegvx_diag(h_mat.desc, h_mat.col, h_mat.row, h_mat.p, s_mat.p, eigen.data(), psi);
+    std::vector<std::complex<double>> u_tmp;
+    const std::complex<double>* u_mat
+        = this->decomposed_sk(psi.get_current_k(), h_mat.desc, h_mat.col, h_mat.row, s_mat.p, u_tmp);
+    this->pzheevx_diag(h_mat.desc, h_mat.col, h_mat.row, h_mat.p, u_mat, eigen.data(), psi);
     const int inc = 1;
     BlasConnector::copy(GlobalV::NBANDS, eigen.data(), inc, eigenvalue_in, inc);
 }
@@ -168,24 +194,75 @@ std::pair<int, std::vector<int>> DiagoBlas::pdsygvx_once(const int *const desc,
                                  + ModuleBase::GlobalFunc::TO_STRING(__LINE__));
 }
 
-std::pair<int, std::vector<int>> DiagoBlas::pzhegvx_once(const int *const desc,
+const std::complex<double>* DiagoBlas::decomposed_sk(const int ik,
+                                                     const int *const desc,
+                                                     const int ncol,
+                                                     const int nrow,
+                                                     const std::complex<double> *const s_mat,
+                                                     std::vector<std::complex<double>> &u_tmp)
+{
+    const size_t nloc = ncol * nrow;
+    const bool cached = sk_cached(ik, desc);
+    if (cached)
+    {
+        if (ik >= DecomposedSk.size())
+            DecomposedSk.resize(ik + 1);
+        if (DecomposedSk[ik].size() == nloc)
+            return DecomposedSk[ik].data();
+    }
+
+    // beyond the budget, S(k) is decomposed again in u_tmp every time
+    std::vector<std::complex<double>> &u_mat = cached ? DecomposedSk[ik] : u_tmp;
+    u_mat.assign(s_mat, s_mat + nloc);
+    if (cached)
+    {
+        size_t ncached = 0;
+        for (const auto &sk: DecomposedSk)
+            ncached += sk.size();
+        ModuleBase::Memory::record("DiagoBlas::DecomposedSk", sizeof(std::complex<double>) * ncached);
+    }
+
+    const char uplo = 'U';
+    const int one = 1;
+    int info = 0;
+    pzpotrf_(&uplo, &GlobalV::NLOCAL, u_mat.data(), &one, &one, desc, &info);
+    if (info)
+    {
+        u_mat.clear();
+        throw std::runtime_error("info = " + ModuleBase::GlobalFunc::TO_STRING(info) + ".\n"
+                                 + ModuleBase::GlobalFunc::TO_STRING(__FILE__) + " line "
+                                 + ModuleBase::GlobalFunc::TO_STRING(__LINE__) + ".\n"
+                                 + "not positive definite = " + ModuleBase::GlobalFunc::TO_STRING(info) + ".\n");
+    }
+    return u_mat.data();
+}
+
+std::pair<int, std::vector<int>> DiagoBlas::pzheevx_once(const int *const desc,
                                                          const int ncol,
                                                          const int nrow,
                                                          const std::complex<double> *const h_mat,
-                                                         const std::complex<double> *const s_mat,
+                                                         const std::complex<double> *const u_mat,
                                                          double *const ekb,
                                                          psi::Psi<std::complex<double>> &wfc_2d) const
 {
     ModuleBase::ComplexMatrix h_tmp(ncol, nrow, false);
     memcpy(h_tmp.c, h_mat, sizeof(std::complex<double>) * ncol * nrow);
-    ModuleBase::ComplexMatrix s_tmp(ncol, nrow, false);
-    memcpy(s_tmp.c, s_mat, sizeof(std::complex<double>) * ncol * nrow);
 
     const char jobz = 'V', range = 'I', uplo = 'U';
-    const int itype = 1, il = 1, iu = GlobalV::NBANDS, one = 1;
+    const int ibtype = 1, il = 1, iu = GlobalV::NBANDS, one = 1;
     int M = 0, NZ = 0, lwork = -1, lrwork = -1, liwork = -1, info = 0;
     const double abstol = 0, orfac = -1;
-    //Note: pzhegvx_ has a bug
+    double scale = 1.0;
+
+    // reduce H*x = e*S*x to the standard form U^-H*H*U^-1 * y = e*y with the saved factor S = U^H*U,
+    // this is what pzhegvx_ does inside, except that S(k) is not decomposed again in every iteration.
+    pzhegst_(&ibtype, &uplo, &GlobalV::NLOCAL, h_tmp.c, &one, &one, desc, u_mat, &one, &one, desc, &scale, &info);
+    if (info)
+        throw std::runtime_error("info=" + ModuleBase::GlobalFunc::TO_STRING(info) + ". "
+                                 + ModuleBase::GlobalFunc::TO_STRING(__FILE__) + " line "
+                                 + ModuleBase::GlobalFunc::TO_STRING(__LINE__));
+
+    //Note: pzheevx_ has the same bug as pzhegvx_
     //      We must give vl,vu a value, although we do not use range 'V'
     //      We must give rwork at least a memory of sizeof(double) * 3
     const double vl = 0, vu = 0;
@@ -196,8 +273,7 @@ std::pair<int, std::vector<int>> DiagoBlas::pzhegvx_once(const int *const desc,
     std::vector<int> iclustr(2 * GlobalV::DSIZE);
     std::vector<double> gap(GlobalV::DSIZE);
 
-    pzhegvx_(&itype,
-             &jobz,
+    pzheevx_(&jobz,
              &range,
              &uplo,
              &GlobalV::NLOCAL,
@@ -205,10 +281,6 @@ std::pair<int, std::vector<int>> DiagoBlas::pzhegvx_once(const int *const desc,
              &one,
              &one,
              desc,
-             s_tmp.c,
-             &one,
-             &one,
-             desc,
              &vl,
              &vu,
              &il,
@@ -237,7 +309,6 @@ std::pair<int, std::vector<int>> DiagoBlas::pzhegvx_once(const int *const desc,
                                  + ModuleBase::GlobalFunc::TO_STRING(__FILE__) + " line "
                                  + ModuleBase::GlobalFunc::TO_STRING(__LINE__));
 
-    //	GlobalV::ofs_running<<"lwork="<<work[0]<<"\t"<<"lrwork="<<rwork[0]<<"\t"<<"liwork="<<iwork[0]<<std::endl;
     lwork = work[0].real();
     work.resize(lwork, 0);
     lrwork = rwork[0] + this->degeneracy_max * GlobalV::NLOCAL;
@@ -246,8 +317,7 @@ std::pair<int, std::vector<int>> DiagoBlas::pzhegvx_once(const int *const desc,
     liwork = iwork[0];
     iwork.resize(liwork, 0);
 
-    pzhegvx_(&itype,
-             &jobz,
+    pzheevx_(&jobz,
              &range,
              &uplo,
              &GlobalV::NLOCAL,
@@ -255,10 +325,6 @@ std::pair<int, std::vector<int>> DiagoBlas::pzhegvx_once(const int *const desc,
              &one,
              &one,
              desc,
-             s_tmp.c,
-             &one,
-             &one,
-             desc,
              &vl,
              &vu,
              &il,
@@ -282,10 +348,19 @@ std::pair<int, std::vector<int>> DiagoBlas::pzhegvx_once(const int *const desc,
              iclustr.data(),
              gap.data(),
              &info);
-    //	GlobalV::ofs_running<<"M="<<M<<"\t"<<"NZ="<<NZ<<std::endl;
 
     if (info == 0)
+    {
+        // back transform the eigenvectors, x = U^-1 * y
+        const char side = 'L', transa = 'N', diag = 'N';
+        const std::complex<double> alpha = 1.0;
+        pztrsm_(&side, &uplo, &transa, &diag, &GlobalV::NLOCAL, &GlobalV::NBANDS, &alpha,
+                u_mat, &one, &one, desc, wfc_2d.get_pointer(), &one, &one, desc);
+        if (scale != 1.0)
+            for (int ib = 0; ib < GlobalV::NBANDS; ++ib)
+                ekb[ib] *= scale;
         return std::make_pair(info, std::vector<int>{});
+    }
     else if (info < 0)
         return std::make_pair(info, std::vector<int>{});
     else if (info % 2)
@@ -294,8 +369,6 @@ std::pair<int, std::vector<int>> DiagoBlas::pzhegvx_once(const int *const desc,
         return std::make_pair(info, iclustr);
     else if (info / 4 % 2)
         return std::make_pair(info, std::vector<int>{M, NZ});
-    else if (info / 16 % 2)
-        return std::make_pair(info, ifail);
     else
         throw std::runtime_error("info = " + ModuleBase::GlobalFunc::TO_STRING(info) + ".\n"
                                  + ModuleBase::GlobalFunc::TO_STRING(__FILE__) + " line "
@@ -319,17 +392,17 @@ void DiagoBlas::pdsygvx_diag(const int *const desc,
     }
 }
 
-void DiagoBlas::pzhegvx_diag(const int *const desc,
+void DiagoBlas::pzheevx_diag(const int *const desc,
                              const int ncol,
                              const int nrow,
                              const std::complex<double> *const h_mat,
-                             const std::complex<double> *const s_mat,
+                             const std::complex<double> *const u_mat,
                              double *const ekb,
                              psi::Psi<std::complex<double>> &wfc_2d)
 {
     while (true)
     {
-        const std::pair<int, std::vector<int>> info_vec = pzhegvx_once(desc, ncol, nrow, h_mat, s_mat, ekb, wfc_2d);
+        const std::pair<int, std::vector<int>> info_vec = pzheevx_once(desc, ncol, nrow, h_mat, u_mat, ekb, wfc_2d);
         post_processing(info_vec.first, info_vec.second);
         if (info_vec.first == 0)
             break;
@@ -28,6 +28,11 @@ class DiagoBlas : public DiagH<double>
 
     void diag(hamilt::Hamilt<double> *phm_in, psi::Psi<std::complex<double>> &psi, double *eigenvalue_in) override;
 
+    // S(k) does not change during one SCF loop, its Cholesky factor of each k point is kept
+    // and reused by the following iterations, it should be reset once the geometry changes.
+    // Only the k points within the memory budget GlobalV::LCAO_SK_CACHE (MB) are kept.
+    static void reset_decomposed_sk();
+
   private:
     void pdsygvx_diag(const int *const desc,
                       const int ncol,
@@ -36,11 +41,11 @@ class DiagoBlas : public DiagH<double>
                       const double *const s_mat,
                       double *const ekb,
                       psi::Psi<double> &wfc_2d);
-    void pzhegvx_diag(const int *const desc,
+    void pzheevx_diag(const int *const desc,
                       const int ncol,
                       const int nrow,
                       const std::complex<double> *const h_mat,
-                      const std::complex<double> *const s_mat,
+                      const std::complex<double> *const u_mat,
                       double *const ekb,
                       psi::Psi<std::complex<double>> &wfc_2d);
 
@@ -51,14 +56,24 @@ class DiagoBlas : public DiagH<double>
                                                   const double *const s_mat,
                                                   double *const ekb,
                                                   psi::Psi<double> &wfc_2d) const;
-    std::pair<int, std::vector<int>> pzhegvx_once(const int *const desc,
+    std::pair<int, std::vector<int>> pzheevx_once(const int *const desc,
                                                   const int ncol,
                                                   const int nrow,
                                                   const std::complex<double> *const h_mat,
-                                                  const std::complex<double> *const s_mat,
+                                                  const std::complex<double> *const u_mat,
                                                   double *const ekb,
                                                   psi::Psi<std::complex<double>> &wfc_2d) const;
 
+    // Cholesky factor U (S = U^H * U) of S(k) for k point ik, computed once and saved until reset_decomposed_sk()
+    // while the saved factors fit in GlobalV::LCAO_SK_CACHE, otherwise computed in u_tmp on each call
+    const std::complex<double>* decomposed_sk(const int ik,
+                                              const int *const desc,
+                                              const int ncol,
+                                              const int nrow,
+                                              const std::complex<double> *const s_mat,
+                                              std::vector<std::complex<double>> &u_tmp);
+    static std::vector<std::vector<std::complex<double>>> DecomposedSk;
+
     int degeneracy_max = 12; // For reorthogonalized memory. 12 followes siesta.
 
     void post_processing(const int info, const std::vector<int> &vec);
@@ -280,6 +280,7 @@ void DiagoCG<FPTYPE, Device>::orthogonal_gradient(hamilt::Hamilt<FPTYPE, Device>
         1);
 
     Parallel_Reduce::reduce_complex_double_pool(this->lagrange, m);
+    DiagoIterAssist<FPTYPE, Device>::gamma_real(this->lagrange, m);
 
     // (3) orthogonal |g> and |scg> to all states (0~m-1)
     //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -498,6 +499,7 @@ void DiagoCG<FPTYPE, Device>::schmit_orth(
 
     // be careful , here reduce m+1
     Parallel_Reduce::reduce_complex_double_pool(lagrange_so, m + 1);
+    DiagoIterAssist<FPTYPE, Device>::gamma_real(lagrange_so, m + 1);
 
     std::complex<FPTYPE> var(0, 0);
     syncmem_complex_d2h_op()(this->cpu_ctx, this->ctx, &var, lagrange_so + m, 1);
@@ -0,0 +1,225 @@
+#include "diago_chebyshev.h"
+
+#include "diago_iter_assist.h"
+#include "module_base/memory.h"
+#include "module_base/parallel_global.h"
+#include "module_base/timer.h"
+#include "module_base/tool_title.h"
+#include "module_hsolver/kernels/math_kernel_op.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace hsolver;
+
+template <typename FPTYPE, typename Device>
+DiagoChebyshev<FPTYPE, Device>::DiagoChebyshev()
+{
+}
+
+template <typename FPTYPE, typename Device>
+DiagoChebyshev<FPTYPE, Device>::~DiagoChebyshev()
+{
+    delmem_complex_op()(this->ctx, this->hphi);
+}
+
+template <typename FPTYPE, typename Device>
+FPTYPE DiagoChebyshev<FPTYPE, Device>::estimate_upper_bound(hamilt::Hamilt<FPTYPE, Device>* phm_in,
+                                                             const psi::Psi<std::complex<FPTYPE>, Device>& psi)
+{
+    ModuleBase::timer::tick("DiagoChebyshev", "upper_bound");
+    const psi::Range first_band(1, psi.get_current_k(), 0, 0);
+
+    // v: current Lanczos vector, v_last: the last one, f: residual
+    psi::Psi<std::complex<FPTYPE>, Device> v(1, 1, this->dmx, psi.get_ngk_pointer());
+    std::complex<FPTYPE>* v_last = nullptr;
+    std::complex<FPTYPE>* f = nullptr;
+    resmem_complex_op()(this->ctx, v_last, this->dmx, "ChFSI::v_last");
+    resmem_complex_op()(this->ctx, f, this->dmx, "ChFSI::f");
+    setmem_complex_op()(this->ctx, v_last, 0, this->dmx);
+
+    // start from the first band, it is never a zero vector
+    syncmem_complex_op()(this->ctx, this->ctx, v.get_pointer(), psi.get_pointer(), this->dmx);
+    FPTYPE beta = std::sqrt(zdot_real_op<FPTYPE, Device>()(this->ctx, this->dmx, v.get_pointer(), v.get_pointer()));
+    vector_div_constant_op<FPTYPE, Device>()(this->ctx, this->dmx, v.get_pointer(), v.get_pointer(), beta);
+    beta = 0.0;
+
+    // Gershgorin bound of the Lanczos tridiagonal matrix T, including the residual |f| of the last step,
+    // is an upper bound of all eigenvalues of H as long as v is not orthogonal to the top eigenvector.
+    FPTYPE upper = std::numeric_limits<FPTYPE>::lowest();
+    const int nstep = std::min(DiagoChebyshev::LANCZOS_NSTEP, this->dim);
+    for (int istep = 0; istep < nstep; ++istep)
+    {
+        hpsi_info lanczos_in(&v, first_band, f);
+        phm_in->ops->hPsi(lanczos_in);
+
+        const FPTYPE alpha = zdot_real_op<FPTYPE, Device>()(this->ctx, this->dmx, v.get_pointer(), f);
+        // f = Hv - alpha * v - beta * v_last
+        constantvector_addORsub_constantVector_op<FPTYPE, Device>()(this->ctx, this->dmx, f, f, 1.0, v.get_pointer(), -alpha);
+        constantvector_addORsub_constantVector_op<FPTYPE, Device>()(this->ctx, this->dmx, f, f, 1.0, v_last, -beta);
+        const FPTYPE beta_next = std::sqrt(zdot_real_op<FPTYPE, Device>()(this->ctx, this->dmx, f, f));
+
+        upper = std::max(upper, alpha + beta + beta_next);
+        if (beta_next < 1.0e-10)
+        {
+            break;
+        }
+        syncmem_complex_op()(this->ctx, this->ctx, v_last, v.get_pointer(), this->dmx);
+        vector_div_constant_op<FPTYPE, Device>()(this->ctx, this->dmx, v.get_pointer(), f, beta_next);
+        beta = beta_next;
+    }
+
+    delmem_complex_op()(this->ctx, v_last);
+    delmem_complex_op()(this->ctx, f);
+    ModuleBase::timer::tick("DiagoChebyshev", "upper_bound");
+    return upper;
+}
+
+template <typename FPTYPE, typename Device>
+void DiagoChebyshev<FPTYPE, Device>::chebyshev_filter(hamilt::Hamilt<FPTYPE, Device>* phm_in,
+                                                      psi::Psi<std::complex<FPTYPE>, Device>& psi,
+                                                      psi::Psi<std::complex<FPTYPE>, Device>& phi_next,
+                                                      const int degree,
+                                                      const FPTYPE a,
+                                                      const FPTYPE b,
+                                                      const FPTYPE a0)
+{
+    ModuleBase::timer::tick("DiagoChebyshev", "filter");
+    // the filter acts on each band independently, with band groups each group
+    // filters its own slice of bands and the slices are gathered at the end
+    int start = 0, num = this->n_band;
+    if (Parallel_Global::ks_band_groups())
+    {
+        Parallel_Global::divide_bands(this->n_band, start, num);
+    }
+    // phi_next has only one k point, the k index of the range is ignored for it
+    const psi::Range bands(1, psi.get_current_k(), start, start + num - 1);
+    const int size = num * this->dmx;
+    const int bias = start * this->dmx;
+
+    // map [a, b] to [-1, 1], and scale the polynomial with its value at a0
+    const FPTYPE e = (b - a) / 2;
+    const FPTYPE c = (b + a) / 2;
+    FPTYPE sigma = e / (a0 - c);
+    const FPTYPE tau = 2 / sigma;
+
+    // Y_1 = (H - c) * X * sigma / e
+    if (num > 0)
+    {
+        hpsi_info filter_in(&psi, bands, this->hphi);
+        phm_in->ops->hPsi(filter_in);
+        constantvector_addORsub_constantVector_op<FPTYPE, Device>()(this->ctx,
+                                                                    size,
+                                                                    phi_next.get_pointer() + bias,
+                                                                    this->hphi,
+                                                                    sigma / e,
+                                                                    psi.get_pointer() + bias,
+                                                                    -c * sigma / e);
+    }
+
+    // Y_{i+1} = 2 * (H - c) * Y_i * sigma_{i+1} / e - sigma_i * sigma_{i+1} * Y_{i-1}
+    // the new block overwrites Y_{i-1}, so only two blocks are kept
+    psi::Psi<std::complex<FPTYPE>, Device>* older = &psi;
+    psi::Psi<std::complex<FPTYPE>, Device>* newer = &phi_next;
+    for (int i = 2; i <= degree && num > 0; ++i)
+    {
+        const FPTYPE sigma_new = 1 / (tau - sigma);
+        hpsi_info recurs_in(newer, bands, this->hphi);
+        phm_in->ops->hPsi(recurs_in);
+        constantvector_addORsub_constantVector_op<FPTYPE, Device>()(this->ctx,
+                                                                    size,
+                                                                    this->hphi,
+                                                                    this->hphi,
+                                                                    2 * sigma_new / e,
+                                                                    newer->get_pointer() + bias,
+                                                                    -2 * c * sigma_new / e);
+        constantvector_addORsub_constantVector_op<FPTYPE, Device>()(this->ctx,
+                                                                    size,
+                                                                    older->get_pointer() + bias,
+                                                                    this->hphi,
+                                                                    1.0,
+                                                                    older->get_pointer() + bias,
+                                                                    -sigma * sigma_new);
+        std::swap(older, newer);
+        sigma = sigma_new;
+    }
+    if (newer != &psi && num > 0)
+    {
+        syncmem_complex_op()(this->ctx, this->ctx, psi.get_pointer() + bias, newer->get_pointer() + bias, size);
+    }
+    if (Parallel_Global::ks_band_groups())
+    {
+        Parallel_Global::gather_bands(psi.get_pointer(), this->n_band, this->dmx);
+    }
+    ModuleBase::timer::tick("DiagoChebyshev", "filter");
+}
+
+template <typename FPTYPE, typename Device>
+void DiagoChebyshev<FPTYPE, Device>::diag(hamilt::Hamilt<FPTYPE, Device>* phm_in,
+                                          psi::Psi<std::complex<FPTYPE>, Device>& psi,
+                                          FPTYPE* eigenvalue_in)
+{
+    ModuleBase::TITLE("DiagoChebyshev", "diag");
+    ModuleBase::timer::tick("DiagoChebyshev", "diag");
+
+    /// initialize variables
+    this->dim = psi.get_current_nbas();
+    this->dmx = psi.get_nbasis();
+    this->n_band = psi.get_nbands();
+    assert(DiagoChebyshev::PW_DIAG_NDEGREE > 0);
+
+    resmem_complex_op()(this->ctx, this->hphi, this->n_band * this->dmx, "ChFSI::hphi");
+    psi::Psi<std::complex<FPTYPE>, Device> phi_next(1, this->n_band, this->dmx, psi.get_ngk_pointer());
+    ModuleBase::Memory::record("ChFSI::block", 2 * this->n_band * this->dmx * sizeof(std::complex<FPTYPE>));
+
+    const FPTYPE upper = this->estimate_upper_bound(phm_in, psi);
+
+    // Ritz values of the starting block give the first filter interval
+    DiagoIterAssist<FPTYPE, Device>::diagH_subspace(phm_in, psi, psi, eigenvalue_in);
+
+    std::vector<FPTYPE> eigen_last(this->n_band);
+    int iter = 0;
+    do
+    {
+        ++iter;
+        std::copy(eigenvalue_in, eigenvalue_in + this->n_band, eigen_last.begin());
+
+        const FPTYPE a0 = eigenvalue_in[0];
+        const FPTYPE a = eigenvalue_in[this->n_band - 1];
+        // the block covers (nearly) the whole spectrum, keep a finite interval to damp
+        const FPTYPE b = std::max(upper, a + (a - a0) + static_cast<FPTYPE>(1.0e-3));
+
+        this->chebyshev_filter(phm_in, psi, phi_next, DiagoChebyshev::PW_DIAG_NDEGREE, a, b, a0);
+        DiagoIterAssist<FPTYPE, Device>::diagH_subspace(phm_in, psi, psi, eigenvalue_in);
+
+        this->notconv = 0;
+        for (int m = 0; m < this->n_band; m++)
+        {
+            if (std::abs(eigenvalue_in[m] - eigen_last[m]) >= DiagoIterAssist<FPTYPE, Device>::PW_DIAG_THR)
+            {
+                ++this->notconv;
+            }
+        }
+    } while (this->notconv > 0 && iter < DiagoIterAssist<FPTYPE, Device>::PW_DIAG_NMAX);
+
+    DiagoIterAssist<FPTYPE, Device>::avg_iter += static_cast<double>(iter);
+
+    if (this->notconv > std::max(5, this->n_band / 4))
+    {
+        std::cout << "\n notconv = " << this->notconv;
+        std::cout << "\n DiagoChebyshev::diag', too many bands are not converged! \n";
+    }
+    ModuleBase::timer::tick("DiagoChebyshev", "diag");
+}
+
+namespace hsolver {
+template class DiagoChebyshev<float, psi::DEVICE_CPU>;
+template class DiagoChebyshev<double, psi::DEVICE_CPU>;
+#if ((defined __CUDA) || (defined __ROCM))
+template class DiagoChebyshev<float, psi::DEVICE_GPU>;
+template class DiagoChebyshev<double, psi::DEVICE_GPU>;
+#endif
+} // namespace hsolver
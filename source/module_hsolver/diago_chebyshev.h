@@ -0,0 +1,81 @@
+#ifndef DIAGOCHEBYSHEV_H
+#define DIAGOCHEBYSHEV_H
+
+#include "diagh.h"
+#include "module_psi/kernels/device.h"
+#include "module_psi/kernels/memory_op.h"
+
+namespace hsolver
+{
+
+/**
+ * @brief Chebyshev-filtered subspace iteration (ChFSI) for plane waves.
+ *
+ * Each iteration applies a degree-m Chebyshev polynomial of H to the whole block of bands,
+ * which damps the unwanted part of the spectrum [a, b] and magnifies the wanted part below a,
+ * and then does a Rayleigh-Ritz step in the filtered subspace with DiagoIterAssist::diagH_subspace.
+ *  - b, upper bound of the spectrum of H, is estimated by a few Lanczos steps.
+ *  - a, lower bound of the damped interval, is the largest Ritz value of the last step.
+ *  - a0, the lowest Ritz value, is used to scale the filter and avoid overflow (Zhou, JCP 219, 172 (2006)).
+ * All Hamiltonian applications act on the whole block at once, so the number of sequential hPsi
+ * calls is m+1 per iteration instead of one per band and per step.
+ */
+template <typename FPTYPE = double, typename Device = psi::DEVICE_CPU>
+class DiagoChebyshev : public DiagH<FPTYPE, Device>
+{
+  public:
+    DiagoChebyshev();
+    ~DiagoChebyshev();
+
+    void diag(hamilt::Hamilt<FPTYPE, Device>* phm_in,
+              psi::Psi<std::complex<FPTYPE>, Device>& psi,
+              FPTYPE* eigenvalue_in) override;
+
+    /// degree of the Chebyshev filter, set from the input pw_diag_ndegree
+    static int PW_DIAG_NDEGREE;
+    /// number of Lanczos steps used to estimate the upper bound of the spectrum, set from pw_diag_nlanczos
+    static int LANCZOS_NSTEP;
+
+  private:
+    /// record for how many bands not have convergence eigenvalues
+    int notconv = 0;
+    /// row size for input psi matrix
+    int n_band = 0;
+    /// col size for input psi matrix
+    int dmx = 0;
+    /// non-zero col size for inputted psi matrix
+    int dim = 0;
+
+    /// H|psi> of the whole block, size n_band * dmx
+    std::complex<FPTYPE>* hphi = nullptr;
+
+    Device* ctx = {};
+    psi::DEVICE_CPU* cpu_ctx = {};
+
+    /// upper bound of the spectrum of H from a Lanczos tridiagonal matrix and its residual
+    FPTYPE estimate_upper_bound(hamilt::Hamilt<FPTYPE, Device>* phm_in, const psi::Psi<std::complex<FPTYPE>, Device>& psi);
+
+    /// psi <- p_m(H) psi, where p_m is the scaled Chebyshev polynomial of degree m on [a, b]
+    /// phi_next is the second block of the three-term recurrence, it has the same size as psi
+    void chebyshev_filter(hamilt::Hamilt<FPTYPE, Device>* phm_in,
+                          psi::Psi<std::complex<FPTYPE>, Device>& psi,
+                          psi::Psi<std::complex<FPTYPE>, Device>& phi_next,
+                          const int degree,
+                          const FPTYPE a,
+                          const FPTYPE b,
+                          const FPTYPE a0);
+
+    using hpsi_info = typename hamilt::Operator<std::complex<FPTYPE>, Device>::hpsi_info;
+
+    using resmem_complex_op = psi::memory::resize_memory_op<std::complex<FPTYPE>, Device>;
+    using delmem_complex_op = psi::memory::delete_memory_op<std::complex<FPTYPE>, Device>;
+    using setmem_complex_op = psi::memory::set_memory_op<std::complex<FPTYPE>, Device>;
+    using syncmem_complex_op = psi::memory::synchronize_memory_op<std::complex<FPTYPE>, Device, Device>;
+};
+
+template <typename FPTYPE, typename Device> int DiagoChebyshev<FPTYPE, Device>::PW_DIAG_NDEGREE = 8;
+template <typename FPTYPE, typename Device> int DiagoChebyshev<FPTYPE, Device>::LANCZOS_NSTEP = 10;
+
+} // namespace hsolver
+
+#endif
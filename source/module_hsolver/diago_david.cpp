@@ -144,6 +144,10 @@ void DiagoDavid<FPTYPE, Device>::diag_mock(hamilt::Hamilt<FPTYPE, Device>* phm_i
 
         phm_in->sPsi(&basis(m, 0), &this->sphi[m * this->dim], (size_t)this->dim);
     }
+    if (DiagoDavid::PW_DIAG_TPA)
+    {
+        this->cal_ekin_band(basis);
+    }
 
     // end of SchmitOrth and calculate H|psi>
     hpsi_info dav_hpsi_in(&basis, psi::Range(1, 0, 0, this->n_band - 1), this->hphi);
@@ -249,6 +253,10 @@ void DiagoDavid<FPTYPE, Device>::diag_mock(hamilt::Hamilt<FPTYPE, Device>* phm_i
                               this->hcc,
                               this->scc,
                               this->vcc);
+                if (DiagoDavid::PW_DIAG_TPA)
+                {
+                    this->cal_ekin_band(basis);
+                }
                 ModuleBase::timer::tick("DiagoDavid", "last");
             }
 
@@ -408,6 +416,18 @@ void DiagoDavid<FPTYPE, Device>::cal_grad(hamilt::Hamilt<FPTYPE, Device>* phm_in
                                                    this->d_precondition);
 #endif
         }
+        else if (DiagoDavid::PW_DIAG_TPA)
+        {
+            // Teter-Payne-Allan, x is the kinetic energy of the plane wave over that of the band
+            const FPTYPE ekin = this->ekin_band[unconv[m]];
+            std::complex<FPTYPE>* res = &basis(nbase + m, 0);
+            for (int ig = 0; ig < this->dim; ig++)
+            {
+                const FPTYPE x = this->precondition[ig] / ekin;
+                const FPTYPE poly = 27 + x * (18 + x * (12 + 8 * x));
+                res[ig] *= poly / (poly + 16 * x * x * x * x);
+            }
+        }
         else
         {
             vector_div_vector_op<FPTYPE, Device>()(this->ctx,
@@ -608,6 +628,7 @@ void DiagoDavid<FPTYPE, Device>::diag_zhegvx(const int& nbase,
         }
         else
         {
+            DiagoIterAssist<FPTYPE, Device>::gamma_real(this->hcc, this->nbase_x * this->nbase_x);
             dnevx_op<FPTYPE, Device>()(this->ctx, nbase, this->nbase_x, this->hcc, nband, this->eigenvalue, this->vcc);
         }
     }
@@ -835,6 +856,7 @@ void DiagoDavid<FPTYPE, Device>::SchmitOrth(const int& dim,
     //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
     Parallel_Reduce::reduce_complex_double_pool(lagrange_m, m + 1);
+    DiagoIterAssist<FPTYPE, Device>::gamma_real(lagrange_m, m + 1);
 
     std::complex<FPTYPE> var = {0, 0};
     syncmem_complex_d2h_op()(this->cpu_ctx, this->ctx, &var, lagrange_m + m, 1);
@@ -958,6 +980,31 @@ void DiagoDavid<FPTYPE, Device>::planSchmitOrth(const int nband, int* pre_matrix
     }
 }
 
+template <typename FPTYPE, typename Device>
+void DiagoDavid<FPTYPE, Device>::cal_ekin_band(const psi::Psi<std::complex<FPTYPE>, Device>& basis)
+{
+    // the tpa preconditioner is only used on cpu, see Input::Check
+    std::vector<double> ekin_norm(2 * this->n_band, 0.0);
+    for (int m = 0; m < this->n_band; m++)
+    {
+        const std::complex<FPTYPE>* phi = &basis(m, 0);
+        for (int ig = 0; ig < this->dim; ig++)
+        {
+            const double norm2 = std::norm(phi[ig]);
+            ekin_norm[2 * m] += this->precondition[ig] * norm2;
+            ekin_norm[2 * m + 1] += norm2;
+        }
+    }
+    Parallel_Reduce::reduce_double_pool(ekin_norm.data(), 2 * this->n_band);
+
+    this->ekin_band.resize(this->n_band);
+    for (int m = 0; m < this->n_band; m++)
+    {
+        const double ekin = (ekin_norm[2 * m + 1] > 0.0) ? ekin_norm[2 * m] / ekin_norm[2 * m + 1] : 0.0;
+        this->ekin_band[m] = static_cast<FPTYPE>(std::max(ekin, 1.0e-8));
+    }
+}
+
 template <typename FPTYPE, typename Device>
 void DiagoDavid<FPTYPE, Device>::diag(hamilt::Hamilt<FPTYPE, Device>* phm_in,
                                       psi::Psi<std::complex<FPTYPE>, Device>& psi,
@@ -15,6 +15,8 @@
 #include "module_psi/kernels/device.h"
 #include "module_hamilt_pw/hamilt_pwdft/structure_factor.h"
 
+#include <vector>
+
 namespace hsolver
 {
 
@@ -30,6 +32,8 @@ template <typename FPTYPE = double, typename Device = psi::DEVICE_CPU> class Dia
               FPTYPE* eigenvalue_in);
 
     static int PW_DIAG_NDIM;
+    /// use the Teter-Payne-Allan preconditioner, precondition is then the kinetic energy of each plane wave
+    static bool PW_DIAG_TPA;
 
   private:
     int test_david = 0;
@@ -52,6 +56,9 @@ template <typename FPTYPE = double, typename Device = psi::DEVICE_CPU> class Dia
     /// eigenvalue results
     FPTYPE* eigenvalue = nullptr;
 
+    /// kinetic energy of each band, only used by the tpa preconditioner
+    std::vector<FPTYPE> ekin_band;
+
     std::complex<FPTYPE>* hphi = nullptr; // the product of H and psi in the reduced basis set
 
     std::complex<FPTYPE>* sphi = nullptr; // the Product of S and psi in the reduced basis set
@@ -112,6 +119,9 @@ template <typename FPTYPE = double, typename Device = psi::DEVICE_CPU> class Dia
 
     void planSchmitOrth(const int nband, int* pre_matrix_mm_m, int* pre_matrix_mv_m);
 
+    /// kinetic energy of the first nband vectors of the basis for the tpa preconditioner
+    void cal_ekin_band(const psi::Psi<std::complex<FPTYPE>, Device>& basis);
+
     void diag_zhegvx(const int& nbase,
                      const int& nband,
                      const std::complex<FPTYPE>* hcc,
@@ -143,6 +153,7 @@ template <typename FPTYPE = double, typename Device = psi::DEVICE_CPU> class Dia
     const std::complex<FPTYPE> * one = nullptr, * zero = nullptr, * neg_one = nullptr;
 };
 template <typename FPTYPE, typename Device> int DiagoDavid<FPTYPE, Device>::PW_DIAG_NDIM = 4;
+template <typename FPTYPE, typename Device> bool DiagoDavid<FPTYPE, Device>::PW_DIAG_TPA = false;
 } // namespace hsolver
 
 #endif
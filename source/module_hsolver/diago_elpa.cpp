@@ -2,6 +2,7 @@
 
 #include "module_base/global_variable.h"
 #include "module_base/lapack_connector.h"
+#include "module_base/memory.h"
 #include "module_base/timer.h"
 #include "module_base/tool_quit.h"
 extern "C"
@@ -16,7 +17,31 @@ typedef hamilt::MatrixBlock<std::complex<double>> matcd;
 
 namespace hsolver
 {
+namespace
+{
+// whether the decomposed S(k) of k point ik fits in the budget GlobalV::LCAO_SK_CACHE,
+// it is decided with the largest local block of the BLACS grid, so all processes take the same branch
+bool sk_cached(const int ik, const int* const desc)
+{
+    int nprow = 0, npcol = 0, myprow = 0, mypcol = 0;
+    blacs_gridinfo_(&desc[1], &nprow, &npcol, &myprow, &mypcol);
+    const int zero = 0;
+    const double nloc_max = static_cast<double>(numroc_(&desc[2], &desc[4], &zero, &zero, &nprow))
+                            * numroc_(&desc[3], &desc[5], &zero, &zero, &npcol);
+    return (ik + 1) * nloc_max * sizeof(std::complex<double>) <= GlobalV::LCAO_SK_CACHE * 1024 * 1024;
+}
+} // namespace
+
 int DiagoElpa::DecomposedState = 0;
+std::vector<std::vector<std::complex<double>>> DiagoElpa::DecomposedSk;
+std::vector<int> DiagoElpa::DecomposedStateK;
+
+void DiagoElpa::reset_decomposed_sk()
+{
+    std::vector<std::vector<std::complex<double>>>().swap(DecomposedSk);
+    std::vector<int>().swap(DecomposedStateK);
+}
+
 void DiagoElpa::diag(hamilt::Hamilt<double> *phm_in, psi::Psi<std::complex<double>> &psi, double *eigenvalue_in)
 {
     ModuleBase::TITLE("DiagoElpa", "diag");
@@ -29,9 +54,44 @@ void DiagoElpa::diag(hamilt::Hamilt<double> *phm_in, psi::Psi<std::complex<doubl
     bool isReal=false;
     const MPI_Comm COMM_DIAG=MPI_COMM_WORLD; // use all processes
     ELPA_Solver es((const bool)isReal, COMM_DIAG, (const int)GlobalV::NBANDS, (const int)h_mat.row, (const int)h_mat.col, (const int*)h_mat.desc);
-    this->DecomposedState=0; // for k pointer, the decomposed s_mat can not be reused
+
+    // for k points, the decomposed s_mat of each k is saved in DecomposedSk while it fits in
+    // GlobalV::LCAO_SK_CACHE, s_mat itself is refolded from S(R) in every iteration and is left untouched.
+    // Beyond the budget, a copy of s_mat is decomposed again every time.
+    const int ik = psi.get_current_k();
+    const size_t nloc = h_mat.row * h_mat.col;
+    std::vector<std::complex<double>> s_tmp;
+    int state_tmp = 0;
+    std::complex<double>* s_decomposed = nullptr;
+    int* state = &state_tmp;
+    if (sk_cached(ik, h_mat.desc))
+    {
+        if (ik >= DecomposedSk.size())
+        {
+            DecomposedSk.resize(ik + 1);
+            DecomposedStateK.resize(ik + 1, 0);
+        }
+        if (DecomposedSk[ik].size() != nloc)
+        {
+            DecomposedSk[ik].assign(s_mat.p, s_mat.p + nloc);
+            DecomposedStateK[ik] = 0;
+            size_t ncached = 0;
+            for (const auto& sk: DecomposedSk)
+            {
+                ncached += sk.size();
+            }
+            ModuleBase::Memory::record("DiagoElpa::DecomposedSk", sizeof(std::complex<double>) * ncached);
+        }
+        s_decomposed = DecomposedSk[ik].data();
+        state = &DecomposedStateK[ik];
+    }
+    else
+    {
+        s_tmp.assign(s_mat.p, s_mat.p + nloc);
+        s_decomposed = s_tmp.data();
+    }
     ModuleBase::timer::tick("DiagoElpa", "elpa_solve");
-    es.generalized_eigenvector(h_mat.p, s_mat.p, this->DecomposedState, eigen.data(), psi.get_pointer());
+    es.generalized_eigenvector(h_mat.p, s_decomposed, *state, eigen.data(), psi.get_pointer());
     ModuleBase::timer::tick("DiagoElpa", "elpa_solve");
     es.exit();
 
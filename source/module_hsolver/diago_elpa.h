@@ -4,6 +4,9 @@
 #include "diagh.h"
 #include "module_basis/module_ao/parallel_orbitals.h"
 
+#include <complex>
+#include <vector>
+
 namespace hsolver
 {
 
@@ -17,7 +20,15 @@ class DiagoElpa : public DiagH<double>
     
     static int DecomposedState;
 
+    // S(k) does not change during one SCF loop, so the decomposed S(k) of each k point is kept
+    // and reused by the following iterations, it should be reset once the geometry changes.
+    // Only the k points within the memory budget GlobalV::LCAO_SK_CACHE (MB) are kept.
+    static void reset_decomposed_sk();
+
   private:
+    static std::vector<std::vector<std::complex<double>>> DecomposedSk;
+    static std::vector<int> DecomposedStateK;
+
 #ifdef __MPI
     bool ifElpaHandle(const bool& newIteration, const bool& ifNSCF);
 #endif
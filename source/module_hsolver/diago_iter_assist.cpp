@@ -6,6 +6,7 @@
 #include "module_base/global_variable.h"
 #include "module_base/lapack_connector.h"
 #include "module_base/timer.h"
+#include "module_base/parallel_global.h"
 #include "module_base/parallel_reduce.h"
 #include "module_hsolver/kernels/math_kernel_op.h"
 #include "module_hsolver/kernels/dngvd_op.h"
@@ -56,50 +57,67 @@ void DiagoIterAssist<FPTYPE, Device>::diagH_subspace(
     std::complex<FPTYPE>* hphi = nullptr;
     resmem_complex_op()(ctx, hphi, psi.get_nbands() * psi.get_nbasis(), "DiagSub::hpsi");
     setmem_complex_op()(ctx, hphi, 0, psi.get_nbands() * psi.get_nbasis());
-    // do hPsi for all bands
-    psi::Range all_bands_range(1, psi.get_current_k(), 0, psi.get_nbands()-1);
-    hpsi_info hpsi_in(&psi, all_bands_range, hphi);
-    pHamilt->ops->hPsi(hpsi_in);
+    // with band groups, each group does hPsi on its own slice of bands and
+    // calculates the same columns of hcc and scc, which are gathered afterwards
+    const bool band_groups = Parallel_Global::ks_band_groups();
+    int start = 0, num = nstart;
+    if (band_groups)
+    {
+        Parallel_Global::divide_bands(nstart, start, num);
+    }
+    if (num > 0)
+    {
+        psi::Range bands_range(1, psi.get_current_k(), start, start + num - 1);
+        hpsi_info hpsi_in(&psi, bands_range, hphi + start * dmax);
+        pHamilt->ops->hPsi(hpsi_in);
 
-    gemm_op<FPTYPE, Device>()(
-        ctx,
-        'C',
-        'N',
-        nstart,
-        nstart,
-        dmin,
-        &one,
-        ppsi,
-        dmax,
-        hphi,
-        dmax,
-        &zero,
-        hcc,
-        nstart
-    );
+        gemm_op<FPTYPE, Device>()(
+            ctx,
+            'C',
+            'N',
+            nstart,
+            num,
+            dmin,
+            &one,
+            ppsi,
+            dmax,
+            hphi + start * dmax,
+            dmax,
+            &zero,
+            hcc + start * nstart,
+            nstart
+        );
 
-    gemm_op<FPTYPE, Device>()(
-        ctx,
-        'C',
-        'N',
-        nstart,
-        nstart,
-        dmin,
-        &one,
-        ppsi,
-        dmax,
-        ppsi,
-        dmax,
-        &zero,
-        scc,
-        nstart
-    );
+        gemm_op<FPTYPE, Device>()(
+            ctx,
+            'C',
+            'N',
+            nstart,
+            num,
+            dmin,
+            &one,
+            ppsi,
+            dmax,
+            ppsi + start * dmax,
+            dmax,
+            &zero,
+            scc + start * nstart,
+            nstart
+        );
+    }
 
     if (GlobalV::NPROC_IN_POOL > 1)
     {
-        Parallel_Reduce::reduce_complex_double_pool(hcc, nstart * nstart);
-        Parallel_Reduce::reduce_complex_double_pool(scc, nstart * nstart);
+        Parallel_Reduce::reduce_complex_double_pool(hcc + start * nstart, num * nstart);
+        Parallel_Reduce::reduce_complex_double_pool(scc + start * nstart, num * nstart);
+    }
+    if (band_groups)
+    {
+        Parallel_Global::gather_bands(hcc, nstart, nstart);
+        Parallel_Global::gather_bands(scc, nstart, nstart);
     }
+    DiagoIterAssist::gamma_real(hcc, nstart * nstart);
+    DiagoIterAssist::gamma_real(scc, nstart * nstart);
 
     // after generation of H and S matrix, diag them
     DiagoIterAssist::diagH_LAPACK(nstart, n_band, hcc, scc, nstart, en, vcc);
@@ -144,22 +162,35 @@ void DiagoIterAssist<FPTYPE, Device>::diagH_subspace(
         resmem_complex_op()(ctx, evctemp, n_band * dmin, "DiagSub::evctemp");
         setmem_complex_op()(ctx, evctemp, 0, n_band * dmin);
 
-        gemm_op<FPTYPE, Device>()(
-            ctx,
-            'N',
-            'N',
-            dmin,
-            n_band,
-            nstart,
-            &one,
-            ppsi, // dmin * nstart
-            dmax,
-            vcc,  // nstart * n_band
-            nstart,
-            &zero,
-            evctemp,
-            dmin
-        );
+        // with band groups, each group rotates its own slice of the output bands
+        int rstart = 0, rnum = n_band;
+        if (band_groups)
+        {
+            Parallel_Global::divide_bands(n_band, rstart, rnum);
+        }
+        if (rnum > 0)
+        {
+            gemm_op<FPTYPE, Device>()(
+                ctx,
+                'N',
+                'N',
+                dmin,
+                rnum,
+                nstart,
+                &one,
+                ppsi, // dmin * nstart
+                dmax,
+                vcc + rstart * nstart,  // nstart * rnum
+                nstart,
+                &zero,
+                evctemp + rstart * dmin,
+                dmin
+            );
+        }
+        if (band_groups)
+        {
+            Parallel_Global::gather_bands(evctemp, n_band, dmin);
+        }
 
         matrixSetToAnother<FPTYPE, Device>()(ctx, n_band, evctemp, dmin, evc.get_pointer(), dmax);
         // for (int ib = 0; ib < n_band; ib++)
@@ -276,6 +307,8 @@ void DiagoIterAssist<FPTYPE, Device>::diagH_subspace_init(
         Parallel_Reduce::reduce_complex_double_pool(hcc, nstart * nstart);
         Parallel_Reduce::reduce_complex_double_pool(scc, nstart * nstart);
     }
+    DiagoIterAssist::gamma_real(hcc, nstart * nstart);
+    DiagoIterAssist::gamma_real(scc, nstart * nstart);
 
     // after generation of H and S matrix, diag them
     ///this part only for test, eigenvector would have different phase caused by micro numerical perturbation
@@ -362,6 +395,19 @@ void DiagoIterAssist<FPTYPE, Device>::diagH_subspace_init(
     ModuleBase::timer::tick("DiagoIterAssist", "diagH_subspace");
 }
 
+template<typename FPTYPE, typename Device>
+void DiagoIterAssist<FPTYPE, Device>::gamma_real(std::complex<FPTYPE>* mat, const int n)
+{
+    if (!GlobalV::GAMMA_ONLY_PW)
+    {
+        return;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        mat[i] = std::complex<FPTYPE>(mat[i].real(), 0.0);
+    }
+}
+
 template<typename FPTYPE, typename Device>
 void DiagoIterAssist<FPTYPE, Device>::diagH_LAPACK(
     const int nstart,
@@ -46,6 +46,10 @@ class DiagoIterAssist
 
     static bool test_exit_cond(const int &ntry, const int &notconv);
 
+    /// gamma_only plane waves: the overlaps of real wave functions are the real parts of the plain dot
+    /// products (see PW_Basis_K::scale_gamma), so the imaginary parts of the n entries are dropped
+    static void gamma_real(std::complex<FPTYPE>* mat, const int n);
+
   private:
     constexpr static const Device * ctx = {};
 
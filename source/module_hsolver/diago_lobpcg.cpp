@@ -0,0 +1,354 @@
+#include "diago_lobpcg.h"
+
+#include "diago_iter_assist.h"
+#include "module_base/lapack_connector.h"
+#include "module_base/memory.h"
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+#include "module_base/tool_title.h"
+#include "module_hsolver/kernels/dngvd_op.h"
+#include "module_hsolver/kernels/math_kernel_op.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+using namespace hsolver;
+
+template <typename FPTYPE, typename Device>
+DiagoLOBPCG<FPTYPE, Device>::DiagoLOBPCG(const FPTYPE* precondition_in)
+{
+    this->device = psi::device::get_device_type<Device>(this->ctx);
+    this->precondition = precondition_in;
+}
+
+template <typename FPTYPE, typename Device>
+DiagoLOBPCG<FPTYPE, Device>::~DiagoLOBPCG()
+{
+    delmem_complex_op()(this->ctx, this->hx);
+    delmem_complex_op()(this->ctx, this->hw);
+    delmem_complex_op()(this->ctx, this->p);
+    delmem_complex_op()(this->ctx, this->hp);
+    delmem_complex_op()(this->ctx, this->tmp);
+    delmem_complex_op()(this->ctx, this->hcc);
+    delmem_complex_op()(this->ctx, this->scc);
+    delmem_complex_op()(this->ctx, this->vcc);
+    if (this->device == psi::GpuDevice)
+    {
+        delmem_var_op()(this->ctx, this->d_precondition);
+    }
+}
+
+template <typename FPTYPE, typename Device>
+void DiagoLOBPCG<FPTYPE, Device>::combine(std::complex<FPTYPE>* out,
+                                          const int nout,
+                                          const std::complex<FPTYPE>* const* blocks,
+                                          const int* ncol,
+                                          const int nblock,
+                                          const std::complex<FPTYPE>* coef,
+                                          const int ldc)
+{
+    int row = 0;
+    for (int i = 0; i < nblock; i++)
+    {
+        if (ncol[i] == 0)
+        {
+            continue;
+        }
+        gemm_op<FPTYPE, Device>()(this->ctx,
+                                  'N',
+                                  'N',
+                                  this->dim,
+                                  nout,
+                                  ncol[i],
+                                  &this->one,
+                                  blocks[i],
+                                  this->dmx,
+                                  coef + row,
+                                  ldc,
+                                  row == 0 ? &this->zero : &this->one,
+                                  out,
+                                  this->dmx);
+        row += ncol[i];
+    }
+}
+
+template <typename FPTYPE, typename Device>
+bool DiagoLOBPCG<FPTYPE, Device>::cal_elem(const psi::Psi<std::complex<FPTYPE>, Device>& x,
+                                           const psi::Psi<std::complex<FPTYPE>, Device>& w,
+                                           const int na,
+                                           const int np,
+                                           std::vector<std::complex<FPTYPE>>& h_host,
+                                           std::vector<std::complex<FPTYPE>>& s_host)
+{
+    ModuleBase::timer::tick("DiagoLOBPCG", "cal_elem");
+    const std::complex<FPTYPE>* blocks[3] = {x.get_pointer(), w.get_pointer(), this->p};
+    const std::complex<FPTYPE>* hblocks[3] = {this->hx, this->hw, this->hp};
+    const int ncol[3] = {this->n_band, na, np};
+    const int offset[3] = {0, this->n_band, this->n_band + na};
+    const int nbase = this->n_band + na + np;
+
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            if (ncol[i] == 0 || ncol[j] == 0)
+            {
+                continue;
+            }
+            gemm_op<FPTYPE, Device>()(this->ctx,
+                                      'C',
+                                      'N',
+                                      ncol[i],
+                                      ncol[j],
+                                      this->dim,
+                                      &this->one,
+                                      blocks[i],
+                                      this->dmx,
+                                      hblocks[j],
+                                      this->dmx,
+                                      &this->zero,
+                                      this->hcc + offset[i] + offset[j] * nbase,
+                                      nbase);
+            gemm_op<FPTYPE, Device>()(this->ctx,
+                                      'C',
+                                      'N',
+                                      ncol[i],
+                                      ncol[j],
+                                      this->dim,
+                                      &this->one,
+                                      blocks[i],
+                                      this->dmx,
+                                      blocks[j],
+                                      this->dmx,
+                                      &this->zero,
+                                      this->scc + offset[i] + offset[j] * nbase,
+                                      nbase);
+        }
+    }
+    syncmem_complex_d2h_op()(this->cpu_ctx, this->ctx, h_host.data(), this->hcc, nbase * nbase);
+    syncmem_complex_d2h_op()(this->cpu_ctx, this->ctx, s_host.data(), this->scc, nbase * nbase);
+    if (GlobalV::NPROC_IN_POOL > 1)
+    {
+        Parallel_Reduce::reduce_complex_double_pool(h_host.data(), nbase * nbase);
+        Parallel_Reduce::reduce_complex_double_pool(s_host.data(), nbase * nbase);
+    }
+
+    // W and P are normalized, so the Cholesky factor of S tells how far each vector is from the
+    // span of the former ones. A tiny pivot means [X, W, P] is nearly linearly dependent.
+    std::vector<std::complex<FPTYPE>> chol(s_host.begin(), s_host.begin() + nbase * nbase);
+    int info = 0;
+    LapackConnector::potrf('U', nbase, chol.data(), nbase, info);
+    bool well_conditioned = (info == 0);
+    const FPTYPE pivot_thr = std::sqrt(std::numeric_limits<FPTYPE>::epsilon());
+    for (int i = 0; i < nbase && well_conditioned; i++)
+    {
+        well_conditioned = std::norm(chol[i + i * nbase]) > pivot_thr;
+    }
+    ModuleBase::timer::tick("DiagoLOBPCG", "cal_elem");
+    return well_conditioned;
+}
+
+template <typename FPTYPE, typename Device>
+void DiagoLOBPCG<FPTYPE, Device>::refresh(psi::Psi<std::complex<FPTYPE>, Device>& x,
+                                          const psi::Psi<std::complex<FPTYPE>, Device>& w,
+                                          const int na,
+                                          const int np,
+                                          const std::vector<std::complex<FPTYPE>>& vcc_host)
+{
+    ModuleBase::timer::tick("DiagoLOBPCG", "refresh");
+    const int nbase = this->n_band + na + np;
+    const int ncol[3] = {this->n_band, na, np};
+
+    // X <- [X, W, P] * C(:, 0:n_band), and the same for H * X
+    syncmem_complex_h2d_op()(this->ctx, this->cpu_ctx, this->vcc, vcc_host.data(), nbase * this->n_band);
+    const std::complex<FPTYPE>* blocks[3] = {x.get_pointer(), w.get_pointer(), this->p};
+    this->combine(this->tmp, this->n_band, blocks, ncol, 3, this->vcc, nbase);
+    syncmem_complex_op()(this->ctx, this->ctx, x.get_pointer(), this->tmp, this->n_band * this->dmx);
+
+    const std::complex<FPTYPE>* hblocks[3] = {this->hx, this->hw, this->hp};
+    this->combine(this->tmp, this->n_band, hblocks, ncol, 3, this->vcc, nbase);
+    syncmem_complex_op()(this->ctx, this->ctx, this->hx, this->tmp, this->n_band * this->dmx);
+
+    // P <- [W, P] * C(n_band:, act), the active bands are the first na columns of W
+    // the coefficients of the X block are dropped, so P is the new direction within the step
+    const int ld_p = na + np;
+    std::vector<std::complex<FPTYPE>> cp_host(ld_p * na);
+    for (int k = 0; k < na; k++)
+    {
+        const int band = this->act[k];
+        std::copy(vcc_host.begin() + band * nbase + this->n_band,
+                  vcc_host.begin() + band * nbase + nbase,
+                  cp_host.begin() + k * ld_p);
+    }
+    syncmem_complex_h2d_op()(this->ctx, this->cpu_ctx, this->vcc, cp_host.data(), ld_p * na);
+    this->combine(this->tmp, na, blocks + 1, ncol + 1, 2, this->vcc, ld_p);
+    std::swap(this->tmp, this->p);
+    this->combine(this->tmp, na, hblocks + 1, ncol + 1, 2, this->vcc, ld_p);
+    std::swap(this->tmp, this->hp);
+
+    for (int k = 0; k < na; k++)
+    {
+        const FPTYPE norm = std::sqrt(zdot_real_op<FPTYPE, Device>()(this->ctx,
+                                                                      this->dim,
+                                                                      this->p + k * this->dmx,
+                                                                      this->p + k * this->dmx));
+        if (norm > 0)
+        {
+            vector_div_constant_op<FPTYPE, Device>()(this->ctx,
+                                                     this->dim,
+                                                     this->p + k * this->dmx,
+                                                     this->p + k * this->dmx,
+                                                     norm);
+            vector_div_constant_op<FPTYPE, Device>()(this->ctx,
+                                                     this->dim,
+                                                     this->hp + k * this->dmx,
+                                                     this->hp + k * this->dmx,
+                                                     norm);
+        }
+    }
+    ModuleBase::timer::tick("DiagoLOBPCG", "refresh");
+}
+
+template <typename FPTYPE, typename Device>
+void DiagoLOBPCG<FPTYPE, Device>::diag(hamilt::Hamilt<FPTYPE, Device>* phm_in,
+                                       psi::Psi<std::complex<FPTYPE>, Device>& psi,
+                                       FPTYPE* eigenvalue_in)
+{
+    ModuleBase::TITLE("DiagoLOBPCG", "diag");
+    ModuleBase::timer::tick("DiagoLOBPCG", "diag");
+
+    /// initialize variables
+    this->dim = psi.get_current_nbas();
+    this->dmx = psi.get_nbasis();
+    this->n_band = psi.get_nbands();
+    const int size = this->n_band * this->dmx;
+    const int nbase_x = 3 * this->n_band;
+
+    std::complex<FPTYPE>** buffers[5] = {&this->hx, &this->hw, &this->p, &this->hp, &this->tmp};
+    for (auto buffer: buffers)
+    {
+        resmem_complex_op()(this->ctx, *buffer, size, "LOBPCG::block");
+        setmem_complex_op()(this->ctx, *buffer, 0, size);
+    }
+    resmem_complex_op()(this->ctx, this->hcc, nbase_x * nbase_x, "LOBPCG::hcc");
+    resmem_complex_op()(this->ctx, this->scc, nbase_x * nbase_x, "LOBPCG::scc");
+    resmem_complex_op()(this->ctx, this->vcc, nbase_x * nbase_x, "LOBPCG::vcc");
+    // W is the input of hPsi, so it is a Psi object
+    psi::Psi<std::complex<FPTYPE>, Device> w(1, this->n_band, this->dmx, psi.get_ngk_pointer());
+    ModuleBase::Memory::record("LOBPCG::block", 6 * size * sizeof(std::complex<FPTYPE>));
+
+    if (this->device == psi::GpuDevice)
+    {
+        resmem_var_op()(this->ctx, this->d_precondition, this->dmx);
+        syncmem_var_h2d_op()(this->ctx, this->cpu_ctx, this->d_precondition, this->precondition, this->dmx);
+    }
+    const FPTYPE* precond = this->device == psi::GpuDevice ? this->d_precondition : this->precondition;
+
+    std::vector<std::complex<FPTYPE>> h_host(nbase_x * nbase_x);
+    std::vector<std::complex<FPTYPE>> s_host(nbase_x * nbase_x);
+    std::vector<std::complex<FPTYPE>> v_host(nbase_x * nbase_x);
+    std::vector<FPTYPE> e_host(nbase_x);
+
+    // Rayleigh-Ritz on the starting block, then H * X
+    DiagoIterAssist<FPTYPE, Device>::diagH_subspace(phm_in, psi, psi, eigenvalue_in);
+    hpsi_info hx_in(&psi, psi::Range(1, psi.get_current_k(), 0, this->n_band - 1), this->hx);
+    phm_in->ops->hPsi(hx_in);
+
+    this->act.resize(this->n_band);
+    std::iota(this->act.begin(), this->act.end(), 0);
+    int np = 0;
+    int iter = 0;
+    bool breakdown = false;
+    while (iter < DiagoIterAssist<FPTYPE, Device>::PW_DIAG_NMAX)
+    {
+        ++iter;
+        // residuals of the active bands, a band is locked once its residual is converged
+        // and the search directions of the remaining bands are moved to the front
+        int na = 0;
+        for (int k = 0; k < this->act.size(); k++)
+        {
+            const int band = this->act[k];
+            constantvector_addORsub_constantVector_op<FPTYPE, Device>()(this->ctx,
+                                                                        this->dim,
+                                                                        &w(na, 0),
+                                                                        this->hx + band * this->dmx,
+                                                                        1.0,
+                                                                        &psi(band, 0),
+                                                                        -eigenvalue_in[band]);
+            const FPTYPE rnorm2 = zdot_real_op<FPTYPE, Device>()(this->ctx, this->dim, &w(na, 0), &w(na, 0));
+            if (rnorm2 < DiagoIterAssist<FPTYPE, Device>::PW_DIAG_THR)
+            {
+                continue;
+            }
+            if (np > 0 && na != k)
+            {
+                syncmem_complex_op()(this->ctx, this->ctx, this->p + na * this->dmx, this->p + k * this->dmx, this->dmx);
+                syncmem_complex_op()(this->ctx, this->ctx, this->hp + na * this->dmx, this->hp + k * this->dmx, this->dmx);
+            }
+            this->act[na++] = band;
+        }
+        this->act.resize(na);
+        np = np > 0 ? na : 0;
+        this->notconv = na;
+        if (na == 0)
+        {
+            break;
+        }
+
+        for (int k = 0; k < na; k++)
+        {
+            vector_div_vector_op<FPTYPE, Device>()(this->ctx, this->dim, &w(k, 0), &w(k, 0), precond);
+            const FPTYPE norm = std::sqrt(zdot_real_op<FPTYPE, Device>()(this->ctx, this->dim, &w(k, 0), &w(k, 0)));
+            vector_div_constant_op<FPTYPE, Device>()(this->ctx, this->dim, &w(k, 0), &w(k, 0), norm);
+        }
+        // w holds one k point, the k index of the range is ignored for it
+        hpsi_info hw_in(&w, psi::Range(1, psi.get_current_k(), 0, na - 1), this->hw);
+        phm_in->ops->hPsi(hw_in);
+
+        // drop P and restart from the steepest descent step if [X, W, P] is ill conditioned
+        bool well_conditioned = this->cal_elem(psi, w, na, np, h_host, s_host);
+        if (!well_conditioned && np > 0)
+        {
+            np = 0;
+            well_conditioned = this->cal_elem(psi, w, na, np, h_host, s_host);
+        }
+        if (!well_conditioned)
+        {
+            breakdown = true;
+            break;
+        }
+
+        const int nbase = this->n_band + na + np;
+        dngvd_op<FPTYPE, psi::DEVICE_CPU>()(this->cpu_ctx,
+                                            nbase,
+                                            nbase,
+                                            h_host.data(),
+                                            s_host.data(),
+                                            e_host.data(),
+                                            v_host.data());
+        this->refresh(psi, w, na, np, v_host);
+        std::copy(e_host.begin(), e_host.begin() + this->n_band, eigenvalue_in);
+        np = na;
+    }
+
+    DiagoIterAssist<FPTYPE, Device>::avg_iter += static_cast<double>(iter);
+
+    if (breakdown || this->notconv > std::max(5, this->n_band / 4))
+    {
+        std::cout << "\n notconv = " << this->notconv;
+        std::cout << "\n DiagoLOBPCG::diag', too many bands are not converged! \n";
+    }
+    ModuleBase::timer::tick("DiagoLOBPCG", "diag");
+}
+
+namespace hsolver {
+template class DiagoLOBPCG<float, psi::DEVICE_CPU>;
+template class DiagoLOBPCG<double, psi::DEVICE_CPU>;
+#if ((defined __CUDA) || (defined __ROCM))
+template class DiagoLOBPCG<float, psi::DEVICE_GPU>;
+template class DiagoLOBPCG<double, psi::DEVICE_GPU>;
+#endif
+} // namespace hsolver
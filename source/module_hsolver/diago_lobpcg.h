@@ -0,0 +1,111 @@
+#ifndef DIAGOLOBPCG_H
+#define DIAGOLOBPCG_H
+
+#include "diagh.h"
+#include "module_psi/kernels/device.h"
+#include "module_psi/kernels/memory_op.h"
+
+#include <vector>
+
+namespace hsolver
+{
+
+/**
+ * @brief Block LOBPCG with soft locking for plane waves (Knyazev, SIAM J. Sci. Comput. 23, 517 (2001)).
+ *
+ * All bands are iterated together in the trial subspace [X, W, P]:
+ *  - X, the current approximation, is psi itself;
+ *  - W, the preconditioned residuals of the active bands;
+ *  - P, the search directions of the active bands from the last step.
+ * The workspace is fixed to 3*nband vectors for [W, P] and their H products plus one block of scratch,
+ * it never grows with the number of iterations as the Davidson basis does.
+ * The Rayleigh-Ritz step is done by gemm on the 3x3 blocks of the projected matrices.
+ * A band is locked once its residual norm is converged: it stays in X and keeps being rotated by the
+ * Rayleigh-Ritz step (soft locking), but it gets no W and P, so hPsi is only applied to active bands.
+ */
+template <typename FPTYPE = double, typename Device = psi::DEVICE_CPU>
+class DiagoLOBPCG : public DiagH<FPTYPE, Device>
+{
+  public:
+    DiagoLOBPCG(const FPTYPE* precondition_in);
+    ~DiagoLOBPCG();
+
+    void diag(hamilt::Hamilt<FPTYPE, Device>* phm_in,
+              psi::Psi<std::complex<FPTYPE>, Device>& psi,
+              FPTYPE* eigenvalue_in) override;
+
+  private:
+    /// record for how many bands not have convergence eigenvalues
+    int notconv = 0;
+    /// row size for input psi matrix
+    int n_band = 0;
+    /// col size for input psi matrix
+    int dmx = 0;
+    /// non-zero col size for inputted psi matrix
+    int dim = 0;
+    /// indices of the bands not locked yet, W and P are stored in this order
+    std::vector<int> act;
+
+    /// precondition for the residuals
+    const FPTYPE* precondition = nullptr;
+    FPTYPE* d_precondition = nullptr;
+
+    /// H * X, H * W, H * P, search directions P and the scratch block, each n_band * dmx
+    std::complex<FPTYPE>* hx = nullptr;
+    std::complex<FPTYPE>* hw = nullptr;
+    std::complex<FPTYPE>* p = nullptr;
+    std::complex<FPTYPE>* hp = nullptr;
+    std::complex<FPTYPE>* tmp = nullptr;
+
+    /// projected H and S on [X, W, P], at most (3 * n_band)^2, and the Ritz vectors
+    std::complex<FPTYPE>* hcc = nullptr;
+    std::complex<FPTYPE>* scc = nullptr;
+    std::complex<FPTYPE>* vcc = nullptr;
+
+    Device* ctx = {};
+    psi::DEVICE_CPU* cpu_ctx = {};
+    psi::AbacusDevice_t device = {};
+
+    const std::complex<FPTYPE> one = {1.0, 0.0};
+    const std::complex<FPTYPE> zero = {0.0, 0.0};
+
+    /// build the projected matrices on [X, W(0:na), P(0:np)] and check that S is well conditioned
+    bool cal_elem(const psi::Psi<std::complex<FPTYPE>, Device>& x,
+                  const psi::Psi<std::complex<FPTYPE>, Device>& w,
+                  const int na,
+                  const int np,
+                  std::vector<std::complex<FPTYPE>>& h_host,
+                  std::vector<std::complex<FPTYPE>>& s_host);
+
+    /// X <- [X, W, P] * C(:, 0:n_band), P <- [W, P] * C(n_band:, act), and the same for the H products
+    void refresh(psi::Psi<std::complex<FPTYPE>, Device>& x,
+                 const psi::Psi<std::complex<FPTYPE>, Device>& w,
+                 const int na,
+                 const int np,
+                 const std::vector<std::complex<FPTYPE>>& vcc_host);
+
+    /// out = sum of blocks[i] * coef[i], blocks[i] has ncol[i] columns and coef[i] has ldc rows
+    void combine(std::complex<FPTYPE>* out,
+                 const int nout,
+                 const std::complex<FPTYPE>* const* blocks,
+                 const int* ncol,
+                 const int nblock,
+                 const std::complex<FPTYPE>* coef,
+                 const int ldc);
+
+    using hpsi_info = typename hamilt::Operator<std::complex<FPTYPE>, Device>::hpsi_info;
+
+    using resmem_complex_op = psi::memory::resize_memory_op<std::complex<FPTYPE>, Device>;
+    using delmem_complex_op = psi::memory::delete_memory_op<std::complex<FPTYPE>, Device>;
+    using setmem_complex_op = psi::memory::set_memory_op<std::complex<FPTYPE>, Device>;
+    using resmem_var_op = psi::memory::resize_memory_op<FPTYPE, Device>;
+    using delmem_var_op = psi::memory::delete_memory_op<FPTYPE, Device>;
+    using syncmem_var_h2d_op = psi::memory::synchronize_memory_op<FPTYPE, Device, psi::DEVICE_CPU>;
+    using syncmem_complex_op = psi::memory::synchronize_memory_op<std::complex<FPTYPE>, Device, Device>;
+    using syncmem_complex_h2d_op = psi::memory::synchronize_memory_op<std::complex<FPTYPE>, Device, psi::DEVICE_CPU>;
+    using syncmem_complex_d2h_op = psi::memory::synchronize_memory_op<std::complex<FPTYPE>, psi::DEVICE_CPU, Device>;
+};
+
+} // namespace hsolver
+
+#endif
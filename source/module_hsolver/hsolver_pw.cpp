@@ -1,7 +1,9 @@
 #include "hsolver_pw.h"
 
 #include "diago_cg.h"
+#include "diago_chebyshev.h"
 #include "diago_david.h"
+#include "diago_lobpcg.h"
 #include "diago_iter_assist.h"
 #include "module_base/tool_quit.h"
 #include "module_base/timer.h"
@@ -54,6 +56,7 @@ void HSolverPW<FPTYPE, Device>::initDiagh()
     else if (this->method == "dav")
     {
         DiagoDavid<double>::PW_DIAG_NDIM = GlobalV::PW_DIAG_NDIM;
+        DiagoDavid<FPTYPE, Device>::PW_DIAG_TPA = (GlobalV::PW_DIAG_PRECOND == "tpa");
         if (this->pdiagh != nullptr)
         {
             if (this->pdiagh->method != this->method)
@@ -69,6 +72,42 @@ void HSolverPW<FPTYPE, Device>::initDiagh()
             this->pdiagh->method = this->method;
         }
     }
+    else if (this->method == "chfsi")
+    {
+        DiagoChebyshev<FPTYPE, Device>::PW_DIAG_NDEGREE = GlobalV::PW_DIAG_NDEGREE;
+        DiagoChebyshev<FPTYPE, Device>::LANCZOS_NSTEP = GlobalV::PW_DIAG_NLANCZOS;
+        if (this->pdiagh != nullptr)
+        {
+            if (this->pdiagh->method != this->method)
+            {
+                delete (DiagoChebyshev<FPTYPE, Device>*)this->pdiagh;
+                this->pdiagh = new DiagoChebyshev<FPTYPE, Device>();
+                this->pdiagh->method = this->method;
+            }
+        }
+        else
+        {
+            this->pdiagh = new DiagoChebyshev<FPTYPE, Device>();
+            this->pdiagh->method = this->method;
+        }
+    }
+    else if (this->method == "lobpcg")
+    {
+        if (this->pdiagh != nullptr)
+        {
+            if (this->pdiagh->method != this->method)
+            {
+                delete (DiagoLOBPCG<FPTYPE, Device>*)this->pdiagh;
+                this->pdiagh = new DiagoLOBPCG<FPTYPE, Device>(precondition.data());
+                this->pdiagh->method = this->method;
+            }
+        }
+        else
+        {
+            this->pdiagh = new DiagoLOBPCG<FPTYPE, Device>(precondition.data());
+            this->pdiagh->method = this->method;
+        }
+    }
     else
     {
         ModuleBase::WARNING_QUIT("HSolverPW::solve", "This method of DiagH is not supported!");
@@ -142,6 +181,16 @@ void HSolverPW<FPTYPE, Device>::endDiagh()
         delete (DiagoDavid<FPTYPE, Device>*)this->pdiagh;
         this->pdiagh = nullptr;
     }
+    if(this->method == "chfsi")
+    {
+        delete (DiagoChebyshev<FPTYPE, Device>*)this->pdiagh;
+        this->pdiagh = nullptr;
+    }
+    if(this->method == "lobpcg")
+    {
+        delete (DiagoLOBPCG<FPTYPE, Device>*)this->pdiagh;
+        this->pdiagh = nullptr;
+    }
 
     //in PW base, average iteration steps for each band and k-point should be printing
     if(DiagoIterAssist<FPTYPE, Device>::avg_iter > 0.0)
@@ -189,28 +238,28 @@ template<typename FPTYPE, typename Device>
 void HSolverPW<FPTYPE, Device>::update_precondition(std::vector<FPTYPE> &h_diag, const int ik, const int npw)
 {
     h_diag.assign(h_diag.size(), 1.0);
-    int precondition_type = 2;
-    const auto tpiba2 = static_cast<FPTYPE>(this->wfc_basis->tpiba2);
 
     //===========================================
-    // Conjugate-Gradient diagonalization
     // h_diag is the precondition matrix
-    // h_diag(1:npw) = MAX( 1.0, g2kin(1:npw) );
+    // h_diag(1:npw) = 1 + g2kin + sqrt(1 + (g2kin - 1)^2)
+    // it only depends on the basis and is kept in wfc_basis,
+    // for tpa it is g2kin itself and DiagoDavid scales it
+    // with the kinetic energy of each band
     //===========================================
-    if (precondition_type == 1)
+    if (GlobalV::PW_DIAG_PRECOND == "tpa")
     {
+        const auto tpiba2 = static_cast<FPTYPE>(this->wfc_basis->tpiba2);
         for (int ig = 0; ig < npw; ig++)
         {
-            FPTYPE g2kin = static_cast<FPTYPE>(this->wfc_basis->getgk2(ik,ig)) * tpiba2;
-            h_diag[ig] = std::max(static_cast<FPTYPE>(1.0), g2kin);
+            h_diag[ig] = static_cast<FPTYPE>(this->wfc_basis->getgk2(ik, ig)) * tpiba2;
         }
     }
-    else if (precondition_type == 2)
+    else
     {
+        const double* precond_ik = this->wfc_basis->gk2_precond + ik * this->wfc_basis->npwk_max;
         for (int ig = 0; ig < npw; ig++)
         {
-            FPTYPE g2kin = static_cast<FPTYPE>(this->wfc_basis->getgk2(ik,ig)) * tpiba2;
-            h_diag[ig] = 1 + g2kin + sqrt(1 + (g2kin - 1) * (g2kin - 1));
+            h_diag[ig] = static_cast<FPTYPE>(precond_ik[ig]);
         }
     }
     if(GlobalV::NSPIN==4)
@@ -273,7 +322,7 @@ FPTYPE HSolverPW<FPTYPE, Device>::set_diagethr(const int istep, const int iter,
     // less or equal to the single-precision limit of convergence(0.5e-4).
     // modified by denghuilu at 2023-05-15
     if (GlobalV::precision_flag == "single") {
-        this->diag_ethr = std::max(this->diag_ethr, static_cast<FPTYPE>(0.5e-4));
+        this->diag_ethr = std::max(this->diag_ethr, static_cast<FPTYPE>(DIAG_ETHR_SINGLE));
     }
     return this->diag_ethr;
 }
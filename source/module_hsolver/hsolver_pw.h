@@ -29,6 +29,14 @@ class HSolverPW: public HSolver<FPTYPE, Device>
     virtual FPTYPE cal_hsolerror() override;
     virtual FPTYPE set_diagethr(const int istep, const int iter, const FPTYPE drho) override;
     virtual FPTYPE reset_diagethr(std::ofstream& ofs_running, const FPTYPE hsover_error, const FPTYPE drho) override;
+
+    /// the lowest diag_ethr that can be reached in single precision
+    static constexpr double DIAG_ETHR_SINGLE = 0.5e-4;
+
+    /// psi only should be initialed once for PW, it is set from outside when
+    /// psi has been prepared by another HSolverPW, e.g. in the mixed precision mode
+    bool initialed_psi = false;
+
   protected:
     void initDiagh();
     void endDiagh();
@@ -46,8 +54,6 @@ class HSolverPW: public HSolver<FPTYPE, Device>
 
     std::vector<FPTYPE> precondition;
 
-    bool initialed_psi = false;
-
     Device * ctx = {};
     using resmem_var_op = psi::memory::resize_memory_op<FPTYPE, psi::DEVICE_CPU>;
     using delmem_var_op = psi::memory::delete_memory_op<FPTYPE, psi::DEVICE_CPU>;
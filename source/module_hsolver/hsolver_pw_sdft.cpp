@@ -22,6 +22,7 @@ void HSolverPW_SDFT::solve(hamilt::Hamilt<double>* pHamilt,
     const int npwx = psi.get_nbasis();
     const int nbands = psi.get_nbands();
     const int nks = psi.get_nk();
+    stoiter.stohchi.p_hamilt = pHamilt;
 
     // prepare for the precondition of diagonalization
     this->precondition.resize(psi.get_nbasis());
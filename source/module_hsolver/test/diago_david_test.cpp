@@ -25,6 +25,7 @@
  *  - the hamilt matrix (npw=100,500,1000) produced by random with sparsity of 50%
  *  - the hamilt matrix (npw=100,500,1000) produced by random with sparsity of 0%
  *  - the hamilt matrix read from "data-H"
+ *  - the random hamilt matrices above with the Teter-Payne-Allan preconditioner
  * 
  * The test is passed when the eignvalues are closed to these calculated by LAPACK.
  *  
@@ -154,6 +155,38 @@ TEST_P(DiagoDavTest,RandomHamilt)
 	delete [] precondition_local;
 }
 
+TEST_P(DiagoDavTest,RandomHamiltTPA)
+{
+	DiagoDavPrepare ddp = GetParam();
+
+	HPsi hpsi(ddp.nband,ddp.npw,ddp.sparsity);
+	DIAGOTEST::hmatrix = hpsi.hamilt();
+	DIAGOTEST::npw = ddp.npw;
+	DIAGOTEST::npw_local = new int[ddp.nprocs];
+	psi::Psi<std::complex<double>> psi = hpsi.psi();
+	psi::Psi<std::complex<double>> psi_local;
+	// the precondition between 1.0 and 2.0 plays the kinetic energy of plane waves
+	double* precondition_local;
+
+#ifdef __MPI				
+	DIAGOTEST::cal_division(DIAGOTEST::npw);
+	DIAGOTEST::divide_hpsi(psi,psi_local);
+	precondition_local = new double[DIAGOTEST::npw_local[ddp.mypnum]];
+	DIAGOTEST::divide_psi<double>(hpsi.precond(),precondition_local);	
+#else
+	DIAGOTEST::hmatrix_local = DIAGOTEST::hmatrix;
+	DIAGOTEST::npw_local[0] = DIAGOTEST::npw;
+	psi_local = psi;
+	precondition_local = new double[DIAGOTEST::npw];
+	for(int i=0;i<DIAGOTEST::npw;i++) precondition_local[i] = (hpsi.precond())[i];
+#endif
+
+	hsolver::DiagoDavid<double>::PW_DIAG_TPA = true;
+	ddp.CompareEigen(psi_local,precondition_local);
+	hsolver::DiagoDavid<double>::PW_DIAG_TPA = false;
+	delete [] DIAGOTEST::npw_local;
+	delete [] precondition_local;
+}
 
 INSTANTIATE_TEST_SUITE_P(VerifyDiag,DiagoDavTest,::testing::Values(
 		//DiagoDavPrepare(int nband, int npw, int sparsity, int order,double eps,int maxiter)
@@ -182,6 +182,12 @@ template<class T> class DiagoPrepare
         this->print_hs();
         this->set_env();
 
+        // H/S of a new system, the decomposed S(k) saved by the solvers can not be reused
+        hsolver::DiagoBlas::reset_decomposed_sk();
+#ifdef __ELPA
+        hsolver::DiagoElpa::reset_decomposed_sk();
+#endif
+
         double starttime = 0.0, endtime = 0.0;
         MPI_Barrier(MPI_COMM_WORLD);
         starttime = MPI_Wtime();
@@ -0,0 +1,198 @@
+#include"module_hsolver/diago_lobpcg.h"
+#include"module_hsolver/diago_iter_assist.h"
+#include"module_hamilt_pw/hamilt_pwdft/hamilt_pw.h"
+#include"diago_mock.h"
+#include "module_psi/psi.h"
+#include"gtest/gtest.h"
+#include "module_base/inverse_matrix.h"
+#include "module_base/lapack_connector.h"
+#include "module_basis/module_pw/test/test_tool.h"
+#include"mpi.h"
+
+#define CONVTHRESHOLD 1e-3
+#define DETAILINFO false
+
+
+/************************************************
+*  unit test of class DiagoLOBPCG
+***********************************************/
+
+/**
+ * Class DiagoLOBPCG is used to solve the eigenvalues
+ * This unittest test the function DiagoLOBPCG::diag() for FPTYPE=double and Device=cpu
+ * with different examples.
+ * 	- the hamilt matrix (npw=100,500) produced by random with sparsity of 0% and 70%
+ *  - the hamilt matrix read from "H-KPoints-Si2.dat"
+ *
+ * The test is passed when the eignvalues are closed to these calculated by LAPACK.
+ *
+ */
+
+//use lapack to calcualte eigenvalue of matrix hm
+void lapackEigen(int &npw, std::vector<std::complex<double>> &hm, double * e)
+{
+	int lwork = 2 * npw;
+	std::complex<double> *work2= new std::complex<double>[lwork];
+	double* rwork = new double[3*npw-2];
+	int info = 0;
+
+	auto tmp = hm;
+
+	char tmp_c1 = 'V', tmp_c2 = 'U';
+	zheev_(&tmp_c1, &tmp_c2, &npw, tmp.data(), &npw, e, work2, &lwork, rwork, &info);
+	if(info) std::cout << "ERROR: Lapack solver, info=" << info <<std::endl;
+
+	delete [] rwork;
+	delete [] work2;
+}
+
+class DiagoLOBPCGPrepare
+{
+public:
+	DiagoLOBPCGPrepare(int nband, int npw, int sparsity, double eps,int maxiter):
+		nband(nband),npw(npw),sparsity(sparsity),eps(eps),maxiter(maxiter)
+	{
+#ifdef __MPI
+		MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+        MPI_Comm_rank(MPI_COMM_WORLD, &mypnum);
+#endif
+	}
+
+	int nband, npw, sparsity, maxiter;
+	double eps;
+	int nprocs=1, mypnum=0;
+
+	void CompareEigen(psi::Psi<std::complex<double>> &phi, double *precondition)
+	{
+		//calculate eigenvalues by LAPACK;
+		double* e_lapack = new double[npw];
+		if(mypnum == 0) lapackEigen(npw, DIAGOTEST::hmatrix, e_lapack);
+
+		//do DiagoLOBPCG::diag()
+		double* en = new double[npw];
+		hamilt::Hamilt<double> *phm;
+		phm = new hamilt::HamiltPW<double>(nullptr, nullptr, nullptr);
+		hsolver::DiagoLOBPCG<double> lobpcg(precondition);
+		hsolver::DiagoIterAssist<double>::PW_DIAG_NMAX = maxiter;
+		hsolver::DiagoIterAssist<double>::PW_DIAG_THR = eps;
+		GlobalV::NPROC_IN_POOL = nprocs;
+		phi.fix_k(0);
+
+		lobpcg.diag(phm,phi,en);
+
+		if(mypnum == 0)
+		{
+			for(int i=0;i<nband;i++)
+			{
+				EXPECT_NEAR(en[i],e_lapack[i],CONVTHRESHOLD);
+			}
+		}
+		delete [] en;
+		delete phm;
+		delete [] e_lapack;
+	}
+};
+
+class DiagoLOBPCGTest : public ::testing::TestWithParam<DiagoLOBPCGPrepare> {};
+
+TEST_P(DiagoLOBPCGTest,RandomHamilt)
+{
+	DiagoLOBPCGPrepare dcp = GetParam();
+	if (DETAILINFO&&dcp.mypnum==0) std::cout << "npw=" << dcp.npw << ", nband=" << dcp.nband << ", sparsity="
+			  << dcp.sparsity << ", eps=" << dcp.eps << std::endl;
+
+	HPsi hpsi(dcp.nband,dcp.npw,dcp.sparsity);
+	DIAGOTEST::hmatrix = hpsi.hamilt();
+	DIAGOTEST::npw = dcp.npw;
+	DIAGOTEST::npw_local = new int[dcp.nprocs];
+	psi::Psi<std::complex<double>> psi = hpsi.psi();
+	psi::Psi<std::complex<double>> psi_local;
+	double* precondition_local;
+
+#ifdef __MPI
+	DIAGOTEST::cal_division(DIAGOTEST::npw);
+	DIAGOTEST::divide_hpsi(psi,psi_local);
+	precondition_local = new double[DIAGOTEST::npw_local[dcp.mypnum]];
+	DIAGOTEST::divide_psi<double>(hpsi.precond(),precondition_local);
+#else
+	DIAGOTEST::hmatrix_local = DIAGOTEST::hmatrix;
+	DIAGOTEST::npw_local[0] = DIAGOTEST::npw;
+	psi_local = psi;
+	precondition_local = new double[DIAGOTEST::npw];
+	for(int i=0;i<DIAGOTEST::npw;i++) precondition_local[i] = (hpsi.precond())[i];
+#endif
+
+	dcp.CompareEigen(psi_local,precondition_local);
+	delete [] DIAGOTEST::npw_local;
+	delete [] precondition_local;
+}
+
+
+INSTANTIATE_TEST_SUITE_P(VerifyDiag,DiagoLOBPCGTest,::testing::Values(
+		//DiagoLOBPCGPrepare(int nband, int npw, int sparsity, double eps,int maxiter)
+        DiagoLOBPCGPrepare(10,100,0,1e-7,500),
+        DiagoLOBPCGPrepare(20,500,7,1e-7,500)
+));
+
+TEST(DiagoLOBPCGRealSystemTest,dataH)
+{
+	std::vector<std::complex<double>> hmatrix;
+	std::ifstream ifs("H-KPoints-Si2.dat");
+	DIAGOTEST::readh(ifs,hmatrix);
+	ifs.close();
+	DIAGOTEST::hmatrix = hmatrix;
+	int nband = std::max(DIAGOTEST::npw/6,1);
+
+	DiagoLOBPCGPrepare dcp(nband,DIAGOTEST::npw,0,1e-7,500);
+
+	HPsi hpsi(nband,DIAGOTEST::npw);
+	psi::Psi<std::complex<double>> psi = hpsi.psi();
+	DIAGOTEST::npw_local = new int[dcp.nprocs];
+	psi::Psi<std::complex<double>> psi_local;
+	double* precondition_local;
+
+#ifdef __MPI
+	DIAGOTEST::cal_division(DIAGOTEST::npw);
+	DIAGOTEST::divide_hpsi(psi,psi_local);
+	precondition_local = new double[DIAGOTEST::npw_local[dcp.mypnum]];
+	DIAGOTEST::divide_psi<double>(hpsi.precond(),precondition_local);
+#else
+	DIAGOTEST::hmatrix_local = DIAGOTEST::hmatrix;
+	DIAGOTEST::npw_local[0] = DIAGOTEST::npw;
+	psi_local = psi;
+	precondition_local = new double[DIAGOTEST::npw];
+	for(int i=0;i<DIAGOTEST::npw;i++) precondition_local[i] = (hpsi.precond())[i];
+#endif
+
+	dcp.CompareEigen(psi_local,precondition_local);
+
+	delete [] DIAGOTEST::npw_local;
+	delete [] precondition_local;
+}
+
+int main(int argc, char **argv)
+{
+	int nproc = 1, myrank = 0;
+
+#ifdef __MPI
+	int nproc_in_pool, kpar=1, mypool, rank_in_pool;
+    setupmpi(argc,argv,nproc, myrank);
+    divide_pools(nproc, myrank, nproc_in_pool, kpar, mypool, rank_in_pool);
+#else
+	MPI_Init(&argc, &argv);
+#endif
+
+    testing::InitGoogleTest(&argc, argv);
+    ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+    if (myrank != 0) delete listeners.Release(listeners.default_result_printer());
+
+    int result = RUN_ALL_TESTS();
+    if (myrank == 0 && result != 0)
+    {
+        std::cout << "ERROR:some tests are not passed" << std::endl;
+        return result;
+	}
+
+    MPI_Finalize();
+	return 0;
+}
@@ -159,12 +159,16 @@ void Input::Default(void)
     emin_sto = 0.0;
     emax_sto = 0.0;
     nche_sto = 100;
+    che_thr_sto = 0.0;
     seed_sto = 0;
     bndpar = 1;
+    fft_nchunk = 1;
     kpar = 1;
     initsto_freq = 0;
     method_sto = 2;
     npart_sto = 1;
+    storage_sto = "double";
+    memory_sto = 0.0;
     cal_cond = false;
     dos_nche = 100;
     cond_nche = 20;
@@ -231,6 +235,7 @@ void Input::Default(void)
     gamma_only_local = false;
     ecutwfc = 50.0;
     ecutrho = 0.0;
+    ecut_xc = 0.0;
     ncx = 0;
     ncy = 0;
     ncz = 0;
@@ -248,8 +253,14 @@ void Input::Default(void)
     pw_diag_nmax = 50;
     diago_cg_prec = 1; // mohan add 2012-03-31
     pw_diag_ndim = 4;
+    pw_diag_precond = "default";
+    pw_diag_ndegree = 8;
+    pw_diag_nlanczos = 10;
     pw_diag_thr = 1.0e-2;
+    nonlocal_real_space = false;
+    pw_vkb_cache = 1024.0;
     nb2d = 0;
+    lcao_sk_cache = 1024.0;
     nurse = 0;
     colour = 0;
     t_in_h = 1;
@@ -280,8 +291,10 @@ void Input::Default(void)
     mixing_beta = -10.0;
     mixing_ndim = 8;
     mixing_gg0 = 0.00; // used in kerker method. mohan add 2014-09-27
+    mixing_lowg = 0.0;
     mixing_tau = false;
     mixing_dftu = false;
+    mixing_dm = false;
     //----------------------------------------------------------
     // potential / charge / wavefunction / energy
     //----------------------------------------------------------
@@ -537,6 +550,7 @@ void Input::Default(void)
     tau = 1.0798 * 1e-5;
     sigma_k = 0.6;
     nc_k = 0.00037;
+    sol_solver = "cg";
 
     //==========================================================
     //    OFDFT sunliang added on 2022-05-05
@@ -722,6 +736,10 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, nche_sto);
         }
+        else if (strcmp("che_thr_sto", word) == 0)
+        {
+            read_value(ifs, che_thr_sto);
+        }
         else if (strcmp("seed_sto", word) == 0)
         {
             read_value(ifs, seed_sto);
@@ -750,6 +768,14 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, npart_sto);
         }
+        else if (strcmp("storage_sto", word) == 0)
+        {
+            read_value(ifs, storage_sto);
+        }
+        else if (strcmp("memory_sto", word) == 0)
+        {
+            read_value(ifs, memory_sto);
+        }
         else if (strcmp("cal_cond", word) == 0)
         {
             read_bool(ifs, cal_cond);
@@ -786,6 +812,10 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, bndpar);
         }
+        else if (strcmp("fft_nchunk", word) == 0)
+        {
+            read_value(ifs, fft_nchunk);
+        }
         else if (strcmp("kpar", word) == 0) // number of pools
         {
             read_value(ifs, kpar);
@@ -975,6 +1005,10 @@ bool Input::Read(const std::string &fn)
             read_value(ifs, ecutwfc);
             ecutrho = 4.0 * ecutwfc;
         }
+        else if (strcmp("ecut_xc", word) == 0)
+        {
+            read_value(ifs, ecut_xc);
+        }
         else if (strcmp("nx", word) == 0)
         {
             read_value(ifs, nx);
@@ -1025,14 +1059,38 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, pw_diag_ndim);
         }
+        else if (strcmp("pw_diag_precond", word) == 0)
+        {
+            read_value(ifs, pw_diag_precond);
+        }
+        else if (strcmp("pw_diag_ndegree", word) == 0)
+        {
+            read_value(ifs, pw_diag_ndegree);
+        }
+        else if (strcmp("pw_diag_nlanczos", word) == 0)
+        {
+            read_value(ifs, pw_diag_nlanczos);
+        }
         else if (strcmp("pw_diag_thr", word) == 0)
         {
             read_value(ifs, pw_diag_thr);
         }
+        else if (strcmp("nonlocal_real_space", word) == 0)
+        {
+            read_bool(ifs, nonlocal_real_space);
+        }
+        else if (strcmp("pw_vkb_cache", word) == 0)
+        {
+            read_value(ifs, pw_vkb_cache);
+        }
         else if (strcmp("nb2d", word) == 0)
         {
             read_value(ifs, nb2d);
         }
+        else if (strcmp("lcao_sk_cache", word) == 0)
+        {
+            read_value(ifs, lcao_sk_cache);
+        }
         else if (strcmp("nurse", word) == 0)
         {
             read_value(ifs, nurse);
@@ -1136,6 +1194,10 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, mixing_gg0);
         }
+        else if (strcmp("mixing_lowg", word) == 0)
+        {
+            read_value(ifs, mixing_lowg);
+        }
         else if (strcmp("mixing_tau", word) == 0)
         {
             read_bool(ifs, mixing_tau);
@@ -1144,6 +1206,10 @@ bool Input::Read(const std::string &fn)
         {
             read_bool(ifs, mixing_dftu);
         }
+        else if (strcmp("mixing_dm", word) == 0)
+        {
+            read_bool(ifs, mixing_dm);
+        }
         //----------------------------------------------------------
         // charge / potential / wavefunction
         //----------------------------------------------------------
@@ -1971,6 +2037,10 @@ bool Input::Read(const std::string &fn)
         {
             read_value(ifs, nc_k);
         }
+        else if (strcmp("sol_solver", word) == 0)
+        {
+            read_value(ifs, sol_solver);
+        }
         //----------------------------------------------------------------------------------
         //    OFDFT sunliang added on 2022-05-05
         //----------------------------------------------------------------------------------
@@ -2349,10 +2419,8 @@ bool Input::Read(const std::string &fn)
 
     if (basis_type == "pw" && gamma_only != 0) // pengfei Li add 2015-1-31
     {
-        gamma_only = 0;
-        GlobalV::ofs_running << " WARNING : gamma_only has not been implemented for pw yet" << std::endl;
-        GlobalV::ofs_running << " the INPUT parameter gamma_only has been reset to 0" << std::endl;
-        GlobalV::ofs_running << " and a new KPT is generated with gamma point as the only k point" << std::endl;
+        // the wave functions are real in gamma_only, only half of the plane waves are stored
+        GlobalV::ofs_running << " a new KPT is generated with gamma point as the only k point" << std::endl;
 
         GlobalV::ofs_warning << " Auto generating k-points file: " << GlobalV::global_kpoint_card << std::endl;
         std::ofstream ofs(GlobalV::global_kpoint_card.c_str());
@@ -2458,10 +2526,13 @@ void Input::Default_2(void) // jiyy add 2019-08-04
     {
         esolver_type = "ksdft";
     }
-    if (esolver_type != "sdft")
+    // band groups are used by sdft, and by the chfsi solver of ksdft in plane waves
+    if (esolver_type != "sdft" && !(esolver_type == "ksdft" && basis_type == "pw" && ks_solver == "chfsi"))
         bndpar = 1;
     if (bndpar > GlobalV::NPROC)
         bndpar = GlobalV::NPROC;
+    if (fft_nchunk < 1)
+        fft_nchunk = 1;
     if (method_sto != 1 && method_sto != 2)
     {
         method_sto = 2;
@@ -2684,6 +2755,14 @@ void Input::Default_2(void) // jiyy add 2019-08-04
         {
             GlobalV::ofs_warning << " It's ok to use dav." << std::endl;
         }
+        else if (ks_solver == "chfsi")
+        {
+            GlobalV::ofs_warning << " It's ok to use chfsi." << std::endl;
+        }
+        else if (ks_solver == "lobpcg")
+        {
+            GlobalV::ofs_warning << " It's ok to use lobpcg." << std::endl;
+        }
         //
         bx = 1;
         by = 1;
@@ -2801,6 +2880,7 @@ void Input::Bcast()
     {Parallel_Common::bcast_double(kspacing[i]);}
     Parallel_Common::bcast_double(min_dist_coef);
     Parallel_Common::bcast_int(nche_sto);
+    Parallel_Common::bcast_double(che_thr_sto);
     Parallel_Common::bcast_int(seed_sto);
     Parallel_Common::bcast_int(pw_seed);
     Parallel_Common::bcast_double(emax_sto);
@@ -2808,6 +2888,8 @@ void Input::Bcast()
     Parallel_Common::bcast_int(initsto_freq);
     Parallel_Common::bcast_int(method_sto);
     Parallel_Common::bcast_int(npart_sto);
+    Parallel_Common::bcast_string(storage_sto);
+    Parallel_Common::bcast_double(memory_sto);
     Parallel_Common::bcast_bool(cal_cond);
     Parallel_Common::bcast_int(cond_nche);
     Parallel_Common::bcast_double(cond_dw);
@@ -2817,6 +2899,7 @@ void Input::Bcast()
     Parallel_Common::bcast_double(cond_fwhm);
     Parallel_Common::bcast_bool(cond_nonlocal);
     Parallel_Common::bcast_int(bndpar);
+    Parallel_Common::bcast_int(fft_nchunk);
     Parallel_Common::bcast_int(kpar);
     Parallel_Common::bcast_bool(berry_phase);
     Parallel_Common::bcast_int(gdir);
@@ -2867,6 +2950,7 @@ void Input::Bcast()
     Parallel_Common::bcast_bool(gamma_only_local);
     Parallel_Common::bcast_double(ecutwfc);
     Parallel_Common::bcast_double(ecutrho);
+    Parallel_Common::bcast_double(ecut_xc);
     Parallel_Common::bcast_int(ncx);
     Parallel_Common::bcast_int(ncy);
     Parallel_Common::bcast_int(ncz);
@@ -2881,8 +2965,14 @@ void Input::Bcast()
     Parallel_Common::bcast_int(pw_diag_nmax);
     Parallel_Common::bcast_int(diago_cg_prec);
     Parallel_Common::bcast_int(pw_diag_ndim);
+    Parallel_Common::bcast_string(pw_diag_precond);
+    Parallel_Common::bcast_int(pw_diag_ndegree);
+    Parallel_Common::bcast_int(pw_diag_nlanczos);
     Parallel_Common::bcast_double(pw_diag_thr);
+    Parallel_Common::bcast_bool(nonlocal_real_space);
+    Parallel_Common::bcast_double(pw_vkb_cache);
     Parallel_Common::bcast_int(nb2d);
+    Parallel_Common::bcast_double(lcao_sk_cache);
     Parallel_Common::bcast_int(nurse);
     Parallel_Common::bcast_bool(colour);
     Parallel_Common::bcast_int(nbspline);
@@ -2909,8 +2999,10 @@ void Input::Bcast()
     Parallel_Common::bcast_double(mixing_beta);
     Parallel_Common::bcast_int(mixing_ndim);
     Parallel_Common::bcast_double(mixing_gg0); // mohan add 2014-09-27
+    Parallel_Common::bcast_double(mixing_lowg);
     Parallel_Common::bcast_bool(mixing_tau);
     Parallel_Common::bcast_bool(mixing_dftu);
+    Parallel_Common::bcast_bool(mixing_dm);
 
     Parallel_Common::bcast_string(read_file_dir);
     Parallel_Common::bcast_string(init_wfc);
@@ -3168,6 +3260,7 @@ void Input::Bcast()
     Parallel_Common::bcast_double(tau);
     Parallel_Common::bcast_double(sigma_k);
     Parallel_Common::bcast_double(nc_k);
+    Parallel_Common::bcast_string(sol_solver);
 
     //----------------------------------------------------------------------------------
     //    OFDFT sunliang added on 2022-05-05
@@ -3221,6 +3314,17 @@ void Input::Check(void)
     //	if(nbands_istate < 0) ModuleBase::WARNING_QUIT("Input","NBANDS_ISTATE must > 0");
     if (nb2d < 0)
         ModuleBase::WARNING_QUIT("Input", "nb2d must > 0");
+    if (lcao_sk_cache < 0)
+        ModuleBase::WARNING_QUIT("Input", "lcao_sk_cache must >= 0");
+    if (mixing_lowg < 0)
+        ModuleBase::WARNING_QUIT("Input", "mixing_lowg must >= 0");
+    if (mixing_dm && basis_type != "lcao")
+        ModuleBase::WARNING_QUIT("Input", "mixing_dm is only available for basis_type lcao");
+    if (ecut_xc < 0)
+        ModuleBase::WARNING_QUIT("Input", "ecut_xc must >= 0");
+    // the core correction and GGA terms of forces and stress still use xc on the dense grid
+    if (ecut_xc > 0 && (cal_force || cal_stress))
+        ModuleBase::WARNING_QUIT("Input", "ecut_xc > 0 is not implemented for cal_force and cal_stress now");
     if (ntype <= 0)
         ModuleBase::WARNING_QUIT("Input", "ntype must > 0");
 
@@ -3388,6 +3492,14 @@ void Input::Check(void)
     {
         ModuleBase::WARNING_QUIT("Input", "nspin does not equal to 1, 2, or 4!");
     }
+    if (precision != "single" && precision != "double" && precision != "mixed")
+    {
+        ModuleBase::WARNING_QUIT("Input", "precision should be single, double or mixed!");
+    }
+    if (precision == "mixed" && (basis_type != "pw" || esolver_type != "ksdft"))
+    {
+        ModuleBase::WARNING_QUIT("Input", "mixed precision is only supported with pw basis and ksdft.");
+    }
     if (basis_type == "pw") // xiaohui add 2013-09-01
     {
         if (ks_solver == "genelpa") // yshen add 2016-07-20
@@ -3402,14 +3514,83 @@ void Input::Check(void)
         {
             ModuleBase::WARNING_QUIT("Input", "lapack can not be used with plane wave basis.");
         }
-        else if (ks_solver != "default" && ks_solver != "cg" && ks_solver != "dav")
+        else if (ks_solver != "default" && ks_solver != "cg" && ks_solver != "dav" && ks_solver != "chfsi"
+                 && ks_solver != "lobpcg")
         {
             ModuleBase::WARNING_QUIT("Input", "please check the ks_solver parameter!");
         }
 
         if (gamma_only)
         {
-            ModuleBase::WARNING_QUIT("Input", "gamma_only not implemented for plane wave now.");
+            if (esolver_type != "ksdft" || calculation != "scf")
+            {
+                ModuleBase::WARNING_QUIT("Input", "gamma_only is only implemented for scf calculation of ksdft in plane wave.");
+            }
+            if (nspin == 4 || device == "gpu" || precision != "double")
+            {
+                ModuleBase::WARNING_QUIT("Input", "gamma_only not implemented for nspin = 4, gpu or single precision in plane wave now.");
+            }
+            if (ks_solver != "default" && ks_solver != "cg" && ks_solver != "dav")
+            {
+                ModuleBase::WARNING_QUIT("Input", "gamma_only in plane wave can only be used with cg or dav.");
+            }
+            if (cal_force || cal_stress || nonlocal_real_space || bndpar > 1 || init_wfc == "file"
+                || out_wfc_pw || out_wfc_r)
+            {
+                ModuleBase::WARNING_QUIT("Input", "force, stress, nonlocal_real_space, bndpar, reading or writing wave functions are not implemented for gamma_only in plane wave now.");
+            }
+        }
+
+        if (pw_diag_precond != "default" && pw_diag_precond != "tpa")
+        {
+            ModuleBase::WARNING_QUIT("Input", "pw_diag_precond should be default or tpa!");
+        }
+        if (pw_diag_precond == "tpa" && (ks_solver != "dav" || device == "gpu"))
+        {
+            ModuleBase::WARNING_QUIT("Input", "pw_diag_precond = tpa is only implemented for dav on cpu now.");
+        }
+        if (pw_diag_ndegree <= 0)
+        {
+            ModuleBase::WARNING_QUIT("Input", "pw_diag_ndegree must > 0");
+        }
+        if (pw_diag_nlanczos <= 0)
+        {
+            ModuleBase::WARNING_QUIT("Input", "pw_diag_nlanczos must > 0");
+        }
+
+        if (esolver_type == "sdft")
+        {
+            if (storage_sto != "double" && storage_sto != "single" && storage_sto != "recompute")
+            {
+                ModuleBase::WARNING_QUIT("Input", "storage_sto should be double, single or recompute!");
+            }
+            if (memory_sto < 0)
+            {
+                ModuleBase::WARNING_QUIT("Input", "memory_sto should be no less than 0!");
+            }
+            if (che_thr_sto < 0)
+            {
+                ModuleBase::WARNING_QUIT("Input", "che_thr_sto should be no less than 0!");
+            }
+        }
+
+        if (imp_sol && sol_solver != "cg" && sol_solver != "mg")
+        {
+            ModuleBase::WARNING_QUIT("Input", "sol_solver should be cg or mg!");
+        }
+
+        if (nonlocal_real_space && (nspin == 4 || device == "gpu"))
+        {
+            ModuleBase::WARNING_QUIT("Input", "nonlocal_real_space not implemented for nspin = 4 or gpu now.");
+        }
+        if (pw_vkb_cache < 0)
+        {
+            ModuleBase::WARNING_QUIT("Input", "pw_vkb_cache must >= 0");
+        }
+        // the band slices of the groups are gathered by MPI on the host memory
+        if (esolver_type == "ksdft" && bndpar > 1 && device == "gpu")
+        {
+            ModuleBase::WARNING_QUIT("Input", "bndpar > 1 not implemented for ksdft on gpu now.");
         }
 
         if (out_proj_band == 1)
@@ -3568,6 +3749,29 @@ void Input::Check(void)
         {
             ModuleBase::WARNING_QUIT("INPUT", "exx_distribute_type must be htime or kmeans2 or kmeans1");
         }
+        if (basis_type == "pw")
+        {
+            if (dft_functional == "scan0")
+            {
+                ModuleBase::WARNING_QUIT("INPUT", "scan0 is not supported in plane wave basis");
+            }
+            if (kpar > 1)
+            {
+                ModuleBase::WARNING_QUIT("INPUT", "hybrid functional in plane wave basis only supports kpar = 1");
+            }
+            if (nspin == 4)
+            {
+                ModuleBase::WARNING_QUIT("INPUT", "hybrid functional in plane wave basis does not support nspin = 4");
+            }
+            if (gamma_only)
+            {
+                ModuleBase::WARNING_QUIT("INPUT", "hybrid functional in plane wave basis does not support gamma_only");
+            }
+            if (precision != "double")
+            {
+                ModuleBase::WARNING_QUIT("INPUT", "hybrid functional in plane wave basis only supports double precision");
+            }
+        }
     }
     if (dft_functional == "opt_orb")
     {
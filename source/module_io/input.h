@@ -75,15 +75,19 @@ class Input
     // Stochastic DFT
     //==========================================================
     int nche_sto; // number of orders for Chebyshev expansion in stochastic DFT //qinarui 2021-2-5
+    double che_thr_sto; // error threshold of the Chebyshev expansion of the occupation, > 0: choose the order adaptively
     int nbands_sto;			// number of stochastic bands //qianrui 2021-2-5
     std::string nbndsto_str; // string parameter for stochastic bands
     int seed_sto; // random seed for sDFT
     double emax_sto; // Emax & Emin to normalize H
     double emin_sto;
     int bndpar; //parallel for stochastic/deterministic bands
+    int fft_nchunk; //number of chunks to pipeline the stick/plane exchange of pw fft
     int initsto_freq; //frequency to init stochastic orbitals when running md
     int method_sto; //different methods for sdft, 1: slow, less memory  2: fast, more memory
     int npart_sto; //for method_sto = 2, reduce memory
+    std::string storage_sto; //for method_sto = 2, storage of T_n(H)|chi>: double, single or recompute
+    double memory_sto; //for method_sto = 2, memory budget (GB) of T_n(H)|chi> in each process, 0: no limit
     bool cal_cond; //calculate electronic conductivities
     int cond_nche; //orders of Chebyshev expansions for conductivities
     double cond_dw; //d\omega for conductivities
@@ -156,6 +160,7 @@ class Input
 
     double ecutwfc; // energy cutoff for wavefunctions
     double ecutrho; // energy cutoff for charge/potential
+    double ecut_xc; // cutoff (Ry) of the smooth grid for xc, 0: xc on the grid of rho
 
     int ncx, ncy, ncz; // three dimension of FFT charge/grid
     int nx, ny, nz; // three dimension of FFT wavefunc
@@ -168,9 +173,15 @@ class Input
     int pw_diag_nmax;
     int diago_cg_prec; // mohan add 2012-03-31
     int pw_diag_ndim;
+    std::string pw_diag_precond; // preconditioner of davidson, default or tpa (Teter-Payne-Allan)
+    int pw_diag_ndegree; // degree of the Chebyshev filter of chfsi
+    int pw_diag_nlanczos; // number of Lanczos steps to bound the spectrum in chfsi
     double pw_diag_thr; // used in cg method
+    bool nonlocal_real_space; // apply the nonlocal pseudopotential on the real space grid in PW
+    double pw_vkb_cache; // memory budget in MB to keep the nonlocal projectors of the k points in PW, 0: no cache
 
     int nb2d; // matrix 2d division.
+    double lcao_sk_cache; // memory budget in MB to keep the decomposed S(k) of the k points in LCAO, 0: no cache
 
     int nurse; // used for debug.
     int nbspline; // the order of B-spline basis(>=0) if it is -1 (default), B-spline for Sturcture Factor isnot used.
@@ -217,8 +228,10 @@ class Input
     double mixing_beta; // 0 : no_mixing
     int mixing_ndim; // used in Broyden method
     double mixing_gg0; // used in kerker method. mohan add 2014-09-27
+    double mixing_lowg; // radius of the low-G sphere kept in the Broyden history
     bool mixing_tau; // whether to mix tau in mgga
     bool mixing_dftu; //whether to mix locale in DFT+U
+    bool mixing_dm; // whether to mix the density matrix instead of the charge density in LCAO
 
     //==========================================================
     // potential / charge / wavefunction / energy
@@ -493,6 +506,7 @@ class Input
     double tau;
     double sigma_k;
     double nc_k;
+    std::string sol_solver; // solver of the generalized Poisson equation: cg or mg
 
     //==========================================================
     // OFDFT  sunliang added on 2022-05-05
@@ -326,6 +326,7 @@ void Input_Conv::Convert(void)
     // planewave (8/8)
     //----------------------------------------------------------
     GlobalV::GAMMA_ONLY_LOCAL = INPUT.gamma_only_local;
+    GlobalV::GAMMA_ONLY_PW = (INPUT.gamma_only && INPUT.basis_type == "pw");
 
     //----------------------------------------------------------
     // diagonalization  (5/5)
@@ -334,15 +335,22 @@ void Input_Conv::Convert(void)
     GlobalV::PW_DIAG_NMAX = INPUT.pw_diag_nmax;
     GlobalV::DIAGO_CG_PREC = INPUT.diago_cg_prec;
     GlobalV::PW_DIAG_NDIM = INPUT.pw_diag_ndim;
+    GlobalV::PW_DIAG_PRECOND = INPUT.pw_diag_precond;
+    GlobalV::PW_DIAG_NDEGREE = INPUT.pw_diag_ndegree;
+    GlobalV::PW_DIAG_NLANCZOS = INPUT.pw_diag_nlanczos;
     GlobalV::PW_DIAG_THR = INPUT.pw_diag_thr;
     GlobalV::NB2D = INPUT.nb2d;
+    GlobalV::LCAO_SK_CACHE = INPUT.lcao_sk_cache;
     GlobalV::NURSE = INPUT.nurse;
     GlobalV::COLOUR = INPUT.colour;
     GlobalV::T_IN_H = INPUT.t_in_h;
     GlobalV::VL_IN_H = INPUT.vl_in_h;
     GlobalV::VNL_IN_H = INPUT.vnl_in_h;
+    GlobalV::NONLOCAL_REAL_SPACE = INPUT.nonlocal_real_space;
+    GlobalV::PW_VKB_CACHE = INPUT.pw_vkb_cache;
     GlobalV::VH_IN_H = INPUT.vh_in_h;
     GlobalV::VION_IN_H = INPUT.vion_in_h;
+    GlobalV::ECUT_XC = INPUT.ecut_xc;
     GlobalV::TEST_FORCE = INPUT.test_force;
     GlobalV::TEST_STRESS = INPUT.test_stress;
     GlobalV::test_skip_ewald = INPUT.test_skip_ewald;
@@ -514,8 +522,6 @@ void Input_Conv::Convert(void)
 // about exx, Peize Lin add 2018-06-20
 //----------------------------------------------------------
 #ifdef __EXX
-#ifdef __LCAO
-
     if (INPUT.dft_functional == "hf" || INPUT.dft_functional == "pbe0" || INPUT.dft_functional == "scan0")
     {
         GlobalC::exx_info.info_global.cal_exx = true;
@@ -573,7 +579,6 @@ void Input_Conv::Convert(void)
         if (INPUT.calculation != "nscf")
             ModuleSymmetry::Symmetry::symm_flag = -1;
     }
-#endif // __LCAO
 #endif // __EXX
     GlobalC::ppcell.cell_factor = INPUT.cell_factor; // LiuXh add 20180619
 
@@ -674,6 +679,7 @@ void Input_Conv::Convert(void)
     GlobalV::tau = INPUT.tau;
     GlobalV::sigma_k = INPUT.sigma_k;
     GlobalV::nc_k = INPUT.nc_k;
+    GlobalV::sol_solver = INPUT.sol_solver;
 
     //-----------------------------------------------
     // sunliang add for ofdft 2022-05-11
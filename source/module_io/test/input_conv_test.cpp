@@ -84,10 +84,14 @@ TEST_F(InputConvTest, Conv)
 	EXPECT_EQ(GlobalV::SEARCH_RADIUS,-1);
 	EXPECT_EQ(GlobalV::SEARCH_PBC,1);
 	EXPECT_EQ(GlobalV::GAMMA_ONLY_LOCAL,true);
+	EXPECT_EQ(GlobalV::GAMMA_ONLY_PW,false);
 	EXPECT_EQ(GlobalV::DIAGO_PROC,4);
 	EXPECT_EQ(GlobalV::PW_DIAG_NMAX,50);
 	EXPECT_EQ(GlobalV::DIAGO_CG_PREC,1);
 	EXPECT_EQ(GlobalV::PW_DIAG_NDIM,4);
+	EXPECT_EQ(GlobalV::PW_DIAG_PRECOND,"default");
+	EXPECT_EQ(GlobalV::PW_DIAG_NDEGREE,8);
+	EXPECT_EQ(GlobalV::PW_DIAG_NLANCZOS,10);
 	EXPECT_DOUBLE_EQ(GlobalV::PW_DIAG_THR,0.01);
 	EXPECT_EQ(GlobalV::NB2D,0);
 	EXPECT_EQ(GlobalV::NURSE,0);
@@ -157,6 +161,7 @@ TEST_F(InputConvTest, Conv)
 	EXPECT_EQ(GlobalV::sigma_k,0.6);
 	EXPECT_EQ(GlobalV::sigma_k,0.6);
 	EXPECT_EQ( GlobalV::nc_k,0.00037);
+	EXPECT_EQ( GlobalV::sol_solver,"cg");
 	EXPECT_EQ( GlobalV::of_kinetic,"vw");
 	EXPECT_EQ(GlobalV::of_method,"tn");
 	EXPECT_EQ(GlobalV::of_conv,"energy");
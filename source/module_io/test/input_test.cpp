@@ -46,12 +46,16 @@ TEST_F(InputTest, Default)
 	EXPECT_EQ(INPUT.emin_sto,0.0);
 	EXPECT_EQ(INPUT.emax_sto,0.0);
 	EXPECT_EQ(INPUT.nche_sto,100);
+	EXPECT_DOUBLE_EQ(INPUT.che_thr_sto,0.0);
         EXPECT_EQ(INPUT.seed_sto,0);
         EXPECT_EQ(INPUT.bndpar,1);
+        EXPECT_EQ(INPUT.fft_nchunk,1);
         EXPECT_EQ(INPUT.kpar,1);
         EXPECT_EQ(INPUT.initsto_freq,0);
         EXPECT_EQ(INPUT.method_sto,2);
         EXPECT_EQ(INPUT.npart_sto,1);
+        EXPECT_EQ(INPUT.storage_sto,"double");
+        EXPECT_DOUBLE_EQ(INPUT.memory_sto,0.0);
         EXPECT_FALSE(INPUT.cal_cond);
         EXPECT_EQ(INPUT.dos_nche,100);
         EXPECT_EQ(INPUT.cond_nche,20);
@@ -119,8 +123,14 @@ TEST_F(InputTest, Default)
         EXPECT_EQ(INPUT.pw_diag_nmax,50);
         EXPECT_EQ(INPUT.diago_cg_prec,1);
         EXPECT_EQ(INPUT.pw_diag_ndim,4);
+        EXPECT_EQ(INPUT.pw_diag_precond,"default");
+        EXPECT_EQ(INPUT.pw_diag_ndegree,8);
+        EXPECT_EQ(INPUT.pw_diag_nlanczos,10);
         EXPECT_DOUBLE_EQ(INPUT.pw_diag_thr,1.0e-2);
+        EXPECT_FALSE(INPUT.nonlocal_real_space);
+        EXPECT_DOUBLE_EQ(INPUT.pw_vkb_cache,1024.0);
         EXPECT_EQ(INPUT.nb2d,0);
+        EXPECT_DOUBLE_EQ(INPUT.lcao_sk_cache,1024.0);
         EXPECT_EQ(INPUT.nurse,0);
         EXPECT_EQ(INPUT.colour,0);
         EXPECT_EQ(INPUT.t_in_h,1);
@@ -142,6 +152,8 @@ TEST_F(InputTest, Default)
         EXPECT_DOUBLE_EQ(INPUT.mixing_beta,-10.0);
         EXPECT_EQ(INPUT.mixing_ndim,8);
         EXPECT_DOUBLE_EQ(INPUT.mixing_gg0,0.00);
+        EXPECT_DOUBLE_EQ(INPUT.mixing_lowg,0.0);
+        EXPECT_FALSE(INPUT.mixing_dm);
         EXPECT_EQ(INPUT.init_wfc,"atomic");
         EXPECT_EQ(INPUT.mem_saver,0);
         EXPECT_EQ(INPUT.printe,100);
@@ -299,6 +311,7 @@ TEST_F(InputTest, Default)
         EXPECT_DOUBLE_EQ(INPUT.tau,1.0798 * 1e-5);
         EXPECT_DOUBLE_EQ(INPUT.sigma_k,0.6);
         EXPECT_DOUBLE_EQ(INPUT.nc_k,0.00037);
+        EXPECT_EQ(INPUT.sol_solver,"cg");
         EXPECT_EQ(INPUT.of_kinetic,"wt");
         EXPECT_EQ(INPUT.of_method,"tn");
         EXPECT_EQ(INPUT.of_conv,"energy");
@@ -317,6 +330,7 @@ TEST_F(InputTest, Default)
         EXPECT_EQ(INPUT.of_kernel_file,"WTkernel.txt");
         EXPECT_EQ(INPUT.device,"cpu");
         EXPECT_DOUBLE_EQ(INPUT.ecutrho,0.0);
+        EXPECT_DOUBLE_EQ(INPUT.ecut_xc,0.0);
         EXPECT_EQ(INPUT.ncx,0);
         EXPECT_EQ(INPUT.ncy,0);
         EXPECT_EQ(INPUT.ncz,0);
@@ -382,12 +396,16 @@ TEST_F(InputTest, Read)
 	EXPECT_EQ(INPUT.emin_sto,0.0);
 	EXPECT_EQ(INPUT.emax_sto,0.0);
 	EXPECT_EQ(INPUT.nche_sto,100);
+	EXPECT_DOUBLE_EQ(INPUT.che_thr_sto,0.0);
         EXPECT_EQ(INPUT.seed_sto,0);
         EXPECT_EQ(INPUT.bndpar,1);
+        EXPECT_EQ(INPUT.fft_nchunk,1);
         EXPECT_EQ(INPUT.kpar,1);
         EXPECT_EQ(INPUT.initsto_freq,0);
         EXPECT_EQ(INPUT.method_sto,3);
         EXPECT_EQ(INPUT.npart_sto,1);
+        EXPECT_EQ(INPUT.storage_sto,"double");
+        EXPECT_DOUBLE_EQ(INPUT.memory_sto,0.0);
         EXPECT_FALSE(INPUT.cal_cond);
         EXPECT_EQ(INPUT.dos_nche,100);
         EXPECT_EQ(INPUT.cond_nche,20);
@@ -445,6 +463,7 @@ TEST_F(InputTest, Read)
         EXPECT_TRUE(INPUT.gamma_only_local);
         EXPECT_DOUBLE_EQ(INPUT.ecutwfc,20.0);
         EXPECT_DOUBLE_EQ(INPUT.ecutrho,80.0);
+        EXPECT_DOUBLE_EQ(INPUT.ecut_xc,0.0);
         EXPECT_EQ(INPUT.ncx,0);
         EXPECT_EQ(INPUT.ncy,0);
         EXPECT_EQ(INPUT.ncz,0);
@@ -458,8 +477,14 @@ TEST_F(InputTest, Read)
         EXPECT_EQ(INPUT.pw_diag_nmax,50);
         EXPECT_EQ(INPUT.diago_cg_prec,1);
         EXPECT_EQ(INPUT.pw_diag_ndim,4);
+        EXPECT_EQ(INPUT.pw_diag_precond,"default");
+        EXPECT_EQ(INPUT.pw_diag_ndegree,8);
+        EXPECT_EQ(INPUT.pw_diag_nlanczos,10);
         EXPECT_DOUBLE_EQ(INPUT.pw_diag_thr,1.0e-2);
+        EXPECT_FALSE(INPUT.nonlocal_real_space);
+        EXPECT_DOUBLE_EQ(INPUT.pw_vkb_cache,1024.0);
         EXPECT_EQ(INPUT.nb2d,0);
+        EXPECT_DOUBLE_EQ(INPUT.lcao_sk_cache,1024.0);
         EXPECT_EQ(INPUT.nurse,0);
         EXPECT_EQ(INPUT.colour,0);
         EXPECT_EQ(INPUT.t_in_h,1);
@@ -480,6 +505,8 @@ TEST_F(InputTest, Read)
         EXPECT_DOUBLE_EQ(INPUT.mixing_beta,0.7);
         EXPECT_EQ(INPUT.mixing_ndim,8);
         EXPECT_DOUBLE_EQ(INPUT.mixing_gg0,0.00);
+        EXPECT_DOUBLE_EQ(INPUT.mixing_lowg,0.0);
+        EXPECT_FALSE(INPUT.mixing_dm);
         EXPECT_EQ(INPUT.init_wfc,"atomic");
         EXPECT_EQ(INPUT.mem_saver,0);
         EXPECT_EQ(INPUT.printe,100);
@@ -636,6 +663,7 @@ TEST_F(InputTest, Read)
         EXPECT_DOUBLE_EQ(INPUT.tau,1.0798 * 1e-5);
         EXPECT_DOUBLE_EQ(INPUT.sigma_k,0.6);
         EXPECT_DOUBLE_EQ(INPUT.nc_k,0.00037);
+        EXPECT_EQ(INPUT.sol_solver,"cg");
         EXPECT_EQ(INPUT.of_kinetic,"vw");
         EXPECT_EQ(INPUT.of_method,"tn");
         EXPECT_EQ(INPUT.of_conv,"energy");
@@ -654,6 +682,7 @@ TEST_F(InputTest, Read)
         EXPECT_EQ(INPUT.of_kernel_file,"WTkernel.txt");
         EXPECT_EQ(INPUT.device,"cpu");
         EXPECT_DOUBLE_EQ(INPUT.ecutrho,80.0);
+        EXPECT_DOUBLE_EQ(INPUT.ecut_xc,0.0);
         EXPECT_EQ(INPUT.ncx,0);
         EXPECT_EQ(INPUT.ncy,0);
         EXPECT_EQ(INPUT.ncz,0);
@@ -950,6 +979,55 @@ TEST_F(InputTest, Check)
 	EXPECT_THAT(output,testing::HasSubstr("nb2d must > 0"));
 	INPUT.nb2d = 1;
 	//
+	INPUT.lcao_sk_cache = -1.0;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("lcao_sk_cache must >= 0"));
+	INPUT.lcao_sk_cache = 1024.0;
+	//
+	INPUT.mixing_lowg = -1.0;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("mixing_lowg must >= 0"));
+	INPUT.mixing_lowg = 0.0;
+	//
+	INPUT.mixing_dm = true;
+	INPUT.basis_type = "pw";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("mixing_dm is only available for basis_type lcao"));
+	INPUT.mixing_dm = false;
+	INPUT.basis_type = "lcao";
+	//
+	INPUT.ecut_xc = -1.0;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("ecut_xc must >= 0"));
+	INPUT.ecut_xc = 0.0;
+	//
+	bool cal_force_bak = INPUT.cal_force;
+	bool cal_stress_bak = INPUT.cal_stress;
+	INPUT.ecut_xc = 100.0;
+	INPUT.cal_force = true;
+	INPUT.cal_stress = false;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("ecut_xc > 0 is not implemented for cal_force and cal_stress now"));
+	INPUT.cal_force = false;
+	INPUT.cal_stress = true;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("ecut_xc > 0 is not implemented for cal_force and cal_stress now"));
+	INPUT.ecut_xc = 0.0;
+	INPUT.cal_force = cal_force_bak;
+	INPUT.cal_stress = cal_stress_bak;
+	//
 	INPUT.ntype = -1;
 	testing::internal::CaptureStdout();
 	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
@@ -1131,6 +1209,22 @@ TEST_F(InputTest, Check)
 	EXPECT_THAT(output,testing::HasSubstr("nspin does not equal to 1, 2, or 4!"));
 	INPUT.nspin = 1;
 	//
+	INPUT.precision = "half";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("precision should be single, double or mixed!"));
+	//
+	std::string basis_type = INPUT.basis_type;
+	INPUT.precision = "mixed";
+	INPUT.basis_type = "lcao";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("mixed precision is only supported with pw basis and ksdft."));
+	INPUT.precision = "double";
+	INPUT.basis_type = basis_type;
+	//
 	INPUT.basis_type = "pw";
 	INPUT.ks_solver = "genelpa";
 	testing::internal::CaptureStdout();
@@ -1162,13 +1256,101 @@ TEST_F(InputTest, Check)
 	//
 	INPUT.basis_type = "pw";
 	INPUT.gamma_only = 1;
+	std::string calculation_in = INPUT.calculation;
+	INPUT.calculation = "relax";
 	testing::internal::CaptureStdout();
 	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
 	output = testing::internal::GetCapturedStdout();
-	EXPECT_THAT(output,testing::HasSubstr("gamma_only not implemented for plane wave now."));
+	EXPECT_THAT(output,testing::HasSubstr("gamma_only is only implemented for scf calculation of ksdft in plane wave."));
+	INPUT.calculation = calculation_in;
 	INPUT.gamma_only = 0;
 	//
 	INPUT.basis_type = "pw";
+	INPUT.pw_diag_precond = "arbitrary";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("pw_diag_precond should be default or tpa!"));
+	INPUT.pw_diag_precond = "tpa";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("pw_diag_precond = tpa is only implemented for dav on cpu now."));
+	INPUT.pw_diag_precond = "default";
+	INPUT.pw_diag_ndegree = 0;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("pw_diag_ndegree must > 0"));
+	INPUT.pw_diag_ndegree = 8;
+	INPUT.pw_diag_nlanczos = 0;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("pw_diag_nlanczos must > 0"));
+	INPUT.pw_diag_nlanczos = 10;
+	//
+	std::string esolver_type_in = INPUT.esolver_type;
+	INPUT.esolver_type = "sdft";
+	INPUT.storage_sto = "arbitrary";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("storage_sto should be double, single or recompute!"));
+	INPUT.storage_sto = "single";
+	INPUT.memory_sto = -1;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("memory_sto should be no less than 0!"));
+	INPUT.storage_sto = "double";
+	INPUT.memory_sto = 0;
+	INPUT.che_thr_sto = -1;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("che_thr_sto should be no less than 0!"));
+	INPUT.che_thr_sto = 0;
+	INPUT.esolver_type = esolver_type_in;
+	//
+	INPUT.imp_sol = true;
+	INPUT.sol_solver = "arbitrary";
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("sol_solver should be cg or mg!"));
+	INPUT.sol_solver = "cg";
+	INPUT.imp_sol = false;
+	//
+	INPUT.basis_type = "pw";
+	INPUT.nonlocal_real_space = 1;
+	INPUT.nspin = 4;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("nonlocal_real_space not implemented for nspin = 4 or gpu now."));
+	INPUT.nonlocal_real_space = 0;
+	INPUT.nspin = 1;
+	INPUT.pw_vkb_cache = -1.0;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("pw_vkb_cache must >= 0"));
+	INPUT.pw_vkb_cache = 1024.0;
+	std::string esolver_type = INPUT.esolver_type;
+	std::string device = INPUT.device;
+	INPUT.esolver_type = "ksdft";
+	INPUT.device = "gpu";
+	INPUT.bndpar = 2;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("bndpar > 1 not implemented for ksdft on gpu now."));
+	INPUT.esolver_type = esolver_type;
+	INPUT.device = device;
+	INPUT.bndpar = 1;
+	//
+	INPUT.basis_type = "pw";
 	INPUT.out_proj_band = 1;
 	testing::internal::CaptureStdout();
 	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
@@ -1364,6 +1546,20 @@ TEST_F(InputTest, Check)
 	EXPECT_THAT(output,testing::HasSubstr("exx_distribute_type must be htime or kmeans2 or kmeans1"));
 	INPUT.exx_distribute_type = "htime";
 	//
+	basis_type = INPUT.basis_type;
+	std::string ks_solver = INPUT.ks_solver;
+	INPUT.basis_type = "pw";
+	INPUT.ks_solver = "cg";
+	INPUT.dft_functional = "pbe0";
+	INPUT.kpar = 2;
+	testing::internal::CaptureStdout();
+	EXPECT_EXIT(INPUT.Check(),::testing::ExitedWithCode(0), "");
+	output = testing::internal::GetCapturedStdout();
+	EXPECT_THAT(output,testing::HasSubstr("hybrid functional in plane wave basis only supports kpar = 1"));
+	INPUT.kpar = 1;
+	INPUT.basis_type = basis_type;
+	INPUT.ks_solver = ks_solver;
+	//
 	INPUT.dft_functional = "opt_orb";
 	INPUT.exx_opt_orb_lmax = -1;
 	testing::internal::CaptureStdout();
@@ -53,12 +53,16 @@ TEST_F(InputParaTest,Bcast)
 	    EXPECT_EQ(INPUT.emin_sto,0.0);
 	    EXPECT_EQ(INPUT.emax_sto,0.0);
 	    EXPECT_EQ(INPUT.nche_sto,100);
+	    EXPECT_DOUBLE_EQ(INPUT.che_thr_sto,0.0);
         EXPECT_EQ(INPUT.seed_sto,0);
         EXPECT_EQ(INPUT.bndpar,1);
+        EXPECT_EQ(INPUT.fft_nchunk,1);
         EXPECT_EQ(INPUT.kpar,1);
         EXPECT_EQ(INPUT.initsto_freq,0);
         EXPECT_EQ(INPUT.method_sto,2);
         EXPECT_EQ(INPUT.npart_sto,1);
+        EXPECT_EQ(INPUT.storage_sto,"double");
+        EXPECT_DOUBLE_EQ(INPUT.memory_sto,0.0);
         EXPECT_FALSE(INPUT.cal_cond);
         EXPECT_EQ(INPUT.dos_nche,100);
         EXPECT_EQ(INPUT.cond_nche,20);
@@ -125,8 +129,13 @@ TEST_F(InputParaTest,Bcast)
         EXPECT_EQ(INPUT.pw_diag_nmax,50);
         EXPECT_EQ(INPUT.diago_cg_prec,1);
         EXPECT_EQ(INPUT.pw_diag_ndim,4);
+        EXPECT_EQ(INPUT.pw_diag_precond,"default");
+        EXPECT_EQ(INPUT.pw_diag_ndegree,8);
+        EXPECT_EQ(INPUT.pw_diag_nlanczos,10);
+        EXPECT_DOUBLE_EQ(INPUT.pw_vkb_cache,1024.0);
         EXPECT_DOUBLE_EQ(INPUT.pw_diag_thr,1.0e-2);
         EXPECT_EQ(INPUT.nb2d,0);
+        EXPECT_DOUBLE_EQ(INPUT.lcao_sk_cache,1024.0);
         EXPECT_EQ(INPUT.nurse,0);
         EXPECT_EQ(INPUT.colour,0);
         EXPECT_EQ(INPUT.t_in_h,1);
@@ -148,6 +157,8 @@ TEST_F(InputParaTest,Bcast)
         EXPECT_DOUBLE_EQ(INPUT.mixing_beta,-10.0);
         EXPECT_EQ(INPUT.mixing_ndim,8);
         EXPECT_DOUBLE_EQ(INPUT.mixing_gg0,0.00);
+        EXPECT_DOUBLE_EQ(INPUT.mixing_lowg,0.0);
+        EXPECT_FALSE(INPUT.mixing_dm);
         EXPECT_EQ(INPUT.init_wfc,"atomic");
         EXPECT_EQ(INPUT.mem_saver,0);
         EXPECT_EQ(INPUT.printe,100);
@@ -305,6 +316,7 @@ TEST_F(InputParaTest,Bcast)
         EXPECT_DOUBLE_EQ(INPUT.tau,1.0798 * 1e-5);
         EXPECT_DOUBLE_EQ(INPUT.sigma_k,0.6);
         EXPECT_DOUBLE_EQ(INPUT.nc_k,0.00037);
+        EXPECT_EQ(INPUT.sol_solver,"cg");
         EXPECT_EQ(INPUT.of_kinetic,"wt");
         EXPECT_EQ(INPUT.of_method,"tn");
         EXPECT_EQ(INPUT.of_conv,"energy");
@@ -323,6 +335,7 @@ TEST_F(InputParaTest,Bcast)
         EXPECT_EQ(INPUT.of_kernel_file,"WTkernel.txt");
         EXPECT_EQ(INPUT.device,"cpu");
         EXPECT_DOUBLE_EQ(INPUT.ecutrho,0.0);
+        EXPECT_DOUBLE_EQ(INPUT.ecut_xc,0.0);
         EXPECT_EQ(INPUT.ncx,0);
         EXPECT_EQ(INPUT.ncy,0);
         EXPECT_EQ(INPUT.ncz,0);
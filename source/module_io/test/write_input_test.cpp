@@ -58,6 +58,7 @@ TEST_F(write_input,print)
         EXPECT_THAT(output,testing::HasSubstr("lspinorb                       0 #consider the spin-orbit interaction"));
         EXPECT_THAT(output,testing::HasSubstr("kpar                           1 #devide all processors into kpar groups and k points will be distributed among each group"));
         EXPECT_THAT(output,testing::HasSubstr("bndpar                         1 #devide all processors into bndpar groups and bands will be distributed among each group"));
+        EXPECT_THAT(output,testing::HasSubstr("fft_nchunk                     1 #number of chunks to overlap the stick/plane exchange with the 1D FFTs in pw"));
         EXPECT_THAT(output,testing::HasSubstr("out_freq_elec                  0 #the frequency ( >= 0) of electronic iter to output charge density and wavefunction. 0: output only when converged"));
         EXPECT_THAT(output,testing::HasSubstr("dft_plus_dmft                  0 #true:DFT+DMFT; false: standard DFT calcullation(default)"));
         EXPECT_THAT(output,testing::HasSubstr("rpa                            0 #true:generate output files used in rpa calculation; false:(default)"));
@@ -73,7 +74,9 @@ TEST_F(write_input,print)
         EXPECT_THAT(output,testing::HasSubstr(""));
         EXPECT_THAT(output,testing::HasSubstr("#Parameters (2.PW)"));
         EXPECT_THAT(output,testing::HasSubstr("ecutwfc                        20 ##energy cutoff for wave functions"));
+        EXPECT_THAT(output,testing::HasSubstr("ecut_xc                        0 #energy cutoff of the smooth grid for xc, 0: xc on the grid of charge density"));
         EXPECT_THAT(output,testing::HasSubstr("pw_diag_thr                    0.01 #threshold for eigenvalues is cg electron iterations"));
+        EXPECT_THAT(output,testing::HasSubstr("pw_vkb_cache                   1024 #memory in MB to keep the nonlocal projectors of k points, 0: no cache"));
         EXPECT_THAT(output,testing::HasSubstr("scf_thr                        1e-08 #charge density error"));
         EXPECT_THAT(output,testing::HasSubstr("scf_thr_type                   2 #type of the criterion of scf_thr, 1: reci drho for pw, 2: real drho for lcao"));
         EXPECT_THAT(output,testing::HasSubstr("init_wfc                       atomic #start wave functions are from 'atomic', 'atomic+random', 'random' or 'file'"));
@@ -98,8 +101,11 @@ TEST_F(write_input,print)
         EXPECT_THAT(output,testing::HasSubstr("#Parameters (3.Stochastic DFT)"));
         EXPECT_THAT(output,testing::HasSubstr("method_sto                     3 #1: slow and save memory, 2: fast and waste memory"));
         EXPECT_THAT(output,testing::HasSubstr("npart_sto                      1 #Reduce memory when calculating Stochastic DOS"));
+        EXPECT_THAT(output,testing::HasSubstr("storage_sto                    double #storage of T_n(H)|chi> for method_sto = 2: double, single or recompute"));
+        EXPECT_THAT(output,testing::HasSubstr("memory_sto                     0 #memory budget (GB) of T_n(H)|chi> in each process, 0: no limit"));
         EXPECT_THAT(output,testing::HasSubstr("nbands_sto                     256 #number of stochstic orbitals"));
         EXPECT_THAT(output,testing::HasSubstr("nche_sto                       100 #Chebyshev expansion orders"));
+        EXPECT_THAT(output,testing::HasSubstr("che_thr_sto                    0 #error threshold of the Chebyshev expansion of the occupation, > 0: adaptive order"));
         EXPECT_THAT(output,testing::HasSubstr("emin_sto                       0 #trial energy to guess the lower bound of eigen energies of the Hamitonian operator"));
         EXPECT_THAT(output,testing::HasSubstr("emax_sto                       0 #trial energy to guess the upper bound of eigen energies of the Hamitonian operator"));
         EXPECT_THAT(output,testing::HasSubstr("seed_sto                       0 #the random seed to generate stochastic orbitals"));
@@ -150,6 +156,7 @@ TEST_F(write_input,print)
         EXPECT_THAT(output,testing::HasSubstr("#Parameters (5.LCAO)"));
         EXPECT_THAT(output,testing::HasSubstr("basis_type                     lcao #PW; LCAO in pw; LCAO"));
         EXPECT_THAT(output,testing::HasSubstr("nb2d                           0 #2d distribution of atoms"));
+        EXPECT_THAT(output,testing::HasSubstr("lcao_sk_cache                  1024 #memory in MB to keep the decomposed S(k) of k points, 0: no cache"));
         EXPECT_THAT(output,testing::HasSubstr("gamma_only                     0 #Only for localized orbitals set and gamma point. If set to 1, a fast algorithm is used"));
         EXPECT_THAT(output,testing::HasSubstr("search_radius                  -1 #input search radius (Bohr)"));
         EXPECT_THAT(output,testing::HasSubstr("search_pbc                     1 #input periodic boundary condition"));
@@ -179,8 +186,10 @@ TEST_F(write_input,print)
         EXPECT_THAT(output,testing::HasSubstr("mixing_beta                    0.7 #mixing parameter: 0 means no new charge"));
         EXPECT_THAT(output,testing::HasSubstr("mixing_ndim                    8 #mixing dimension in pulay"));
         EXPECT_THAT(output,testing::HasSubstr("mixing_gg0                     0 #mixing parameter in kerker"));
+        EXPECT_THAT(output,testing::HasSubstr("mixing_lowg                    0 #radius of the low-G sphere kept in broyden history"));
         EXPECT_THAT(output,testing::HasSubstr("mixing_tau                     0 #whether to mix tau in mGGA calculation"));
         EXPECT_THAT(output,testing::HasSubstr("mixing_dftu                    0 #whether to mix locale in DFT+U calculation"));
+        EXPECT_THAT(output,testing::HasSubstr("mixing_dm                      0 #whether to mix density matrix instead of charge density in LCAO"));
         EXPECT_THAT(output,testing::HasSubstr(""));
         EXPECT_THAT(output,testing::HasSubstr("#Parameters (8.DOS)"));
         EXPECT_THAT(output,testing::HasSubstr("dos_emin_ev                    -15 #minimal range for dos"));
@@ -316,6 +325,7 @@ TEST_F(write_input,print)
         EXPECT_THAT(output,testing::HasSubstr("tau                            1.0798e-05 #the effective surface tension parameter"));
         EXPECT_THAT(output,testing::HasSubstr("sigma_k                        0.6 # the width of the diffuse cavity"));
         EXPECT_THAT(output,testing::HasSubstr("nc_k                           0.00037 # the cut-off charge density"));
+        EXPECT_THAT(output,testing::HasSubstr("sol_solver                     cg #solver of the generalized Poisson equation: cg or mg"));
         EXPECT_THAT(output,testing::HasSubstr(""));
         EXPECT_THAT(output,testing::HasSubstr("#Parameters (19.orbital free density functional theory)"));
         EXPECT_THAT(output,testing::HasSubstr("of_kinetic                     vw #kinetic energy functional, such as tf, vw, wt"));
@@ -72,6 +72,7 @@ void Input::Print(const std::string &fn) const
     ModuleBase::GlobalFunc::OUTP(ofs, "lspinorb", lspinorb, "consider the spin-orbit interaction");
     ModuleBase::GlobalFunc::OUTP(ofs, "kpar", kpar, "devide all processors into kpar groups and k points will be distributed among each group");
     ModuleBase::GlobalFunc::OUTP(ofs, "bndpar", bndpar, "devide all processors into bndpar groups and bands will be distributed among each group");
+    ModuleBase::GlobalFunc::OUTP(ofs, "fft_nchunk", fft_nchunk, "number of chunks to overlap the stick/plane exchange with the 1D FFTs in pw");
     ModuleBase::GlobalFunc::OUTP(ofs, "out_freq_elec", out_freq_elec, "the frequency ( >= 0) of electronic iter to output charge density and wavefunction. 0: output only when converged");
     ModuleBase::GlobalFunc::OUTP(ofs, "dft_plus_dmft", dft_plus_dmft, "true:DFT+DMFT; false: standard DFT calcullation(default)");
     ModuleBase::GlobalFunc::OUTP(ofs, "rpa", rpa, "true:generate output files used in rpa calculation; false:(default)");
@@ -87,6 +88,7 @@ void Input::Print(const std::string &fn) const
 
     ofs << "\n#Parameters (2.PW)" << std::endl;
     ModuleBase::GlobalFunc::OUTP(ofs, "ecutwfc", ecutwfc, "#energy cutoff for wave functions");
+    ModuleBase::GlobalFunc::OUTP(ofs, "ecut_xc", ecut_xc, "energy cutoff of the smooth grid for xc, 0: xc on the grid of charge density");
     if (ks_solver == "cg")
     {
         ModuleBase::GlobalFunc::OUTP(ofs, "pw_diag_nmax", pw_diag_nmax, "max iteration number for cg");
@@ -95,11 +97,19 @@ void Input::Print(const std::string &fn) const
     else if (ks_solver == "dav")
     {
         ModuleBase::GlobalFunc::OUTP(ofs, "pw_diag_ndim", pw_diag_ndim, "max dimension for davidson");
+        ModuleBase::GlobalFunc::OUTP(ofs, "pw_diag_precond", pw_diag_precond, "preconditioner for davidson, default or tpa");
+    }
+    else if (ks_solver == "chfsi")
+    {
+        ModuleBase::GlobalFunc::OUTP(ofs, "pw_diag_ndegree", pw_diag_ndegree, "degree of the chebyshev filter");
+        ModuleBase::GlobalFunc::OUTP(ofs, "pw_diag_nlanczos", pw_diag_nlanczos, "lanczos steps to bound the spectrum for chfsi");
     }
     ModuleBase::GlobalFunc::OUTP(ofs,
                                  "pw_diag_thr",
                                  pw_diag_thr,
                                  "threshold for eigenvalues is cg electron iterations");
+    ModuleBase::GlobalFunc::OUTP(ofs, "nonlocal_real_space", nonlocal_real_space, "apply the nonlocal pseudopotential in real space");
+    ModuleBase::GlobalFunc::OUTP(ofs, "pw_vkb_cache", pw_vkb_cache, "memory in MB to keep the nonlocal projectors of k points, 0: no cache");
     ModuleBase::GlobalFunc::OUTP(ofs, "scf_thr", scf_thr, "charge density error");
     ModuleBase::GlobalFunc::OUTP(ofs, "scf_thr_type", scf_thr_type, "type of the criterion of scf_thr, 1: reci drho for pw, 2: real drho for lcao");
     ModuleBase::GlobalFunc::OUTP(ofs, "init_wfc", init_wfc, "start wave functions are from 'atomic', 'atomic+random', 'random' or 'file'");
@@ -130,8 +140,11 @@ void Input::Print(const std::string &fn) const
     ofs << "\n#Parameters (3.Stochastic DFT)" << std::endl;
     ModuleBase::GlobalFunc::OUTP(ofs, "method_sto", method_sto, "1: slow and save memory, 2: fast and waste memory");
     ModuleBase::GlobalFunc::OUTP(ofs, "npart_sto", npart_sto, "Reduce memory when calculating Stochastic DOS");
+    ModuleBase::GlobalFunc::OUTP(ofs, "storage_sto", storage_sto, "storage of T_n(H)|chi> for method_sto = 2: double, single or recompute");
+    ModuleBase::GlobalFunc::OUTP(ofs, "memory_sto", memory_sto, "memory budget (GB) of T_n(H)|chi> in each process, 0: no limit");
     ModuleBase::GlobalFunc::OUTP(ofs, "nbands_sto", nbands_sto, "number of stochstic orbitals");
     ModuleBase::GlobalFunc::OUTP(ofs, "nche_sto", nche_sto, "Chebyshev expansion orders");
+    ModuleBase::GlobalFunc::OUTP(ofs, "che_thr_sto", che_thr_sto, "error threshold of the Chebyshev expansion of the occupation, > 0: adaptive order");
     ModuleBase::GlobalFunc::OUTP(ofs, "emin_sto", emin_sto, "trial energy to guess the lower bound of eigen energies of the Hamitonian operator");
     ModuleBase::GlobalFunc::OUTP(ofs, "emax_sto", emax_sto, "trial energy to guess the upper bound of eigen energies of the Hamitonian operator");
     ModuleBase::GlobalFunc::OUTP(ofs, "seed_sto", seed_sto, "the random seed to generate stochastic orbitals");
@@ -198,6 +211,7 @@ ModuleBase::GlobalFunc::OUTP(ofs, "out_bandgap", out_bandgap, "if true, print ou
     if (ks_solver == "HPSEPS" || ks_solver == "genelpa" || ks_solver == "scalapack_gvx" || ks_solver == "cusolver")
     {
         ModuleBase::GlobalFunc::OUTP(ofs, "nb2d", nb2d, "2d distribution of atoms");
+        ModuleBase::GlobalFunc::OUTP(ofs, "lcao_sk_cache", lcao_sk_cache, "memory in MB to keep the decomposed S(k) of k points, 0: no cache");
     }
     ModuleBase::GlobalFunc::OUTP(ofs, "gamma_only", gamma_only, "Only for localized orbitals set and gamma point. If set to 1, a fast algorithm is used");
     ModuleBase::GlobalFunc::OUTP(ofs, "search_radius", search_radius, "input search radius (Bohr)");
@@ -231,8 +245,10 @@ ModuleBase::GlobalFunc::OUTP(ofs, "out_bandgap", out_bandgap, "if true, print ou
     ModuleBase::GlobalFunc::OUTP(ofs, "mixing_beta", mixing_beta, "mixing parameter: 0 means no new charge");
     ModuleBase::GlobalFunc::OUTP(ofs, "mixing_ndim", mixing_ndim, "mixing dimension in pulay");
     ModuleBase::GlobalFunc::OUTP(ofs, "mixing_gg0", mixing_gg0, "mixing parameter in kerker");
+    ModuleBase::GlobalFunc::OUTP(ofs, "mixing_lowg", mixing_lowg, "radius of the low-G sphere kept in broyden history");
     ModuleBase::GlobalFunc::OUTP(ofs, "mixing_tau", mixing_tau, "whether to mix tau in mGGA calculation");
     ModuleBase::GlobalFunc::OUTP(ofs, "mixing_dftu", mixing_dftu, "whether to mix locale in DFT+U calculation");
+    ModuleBase::GlobalFunc::OUTP(ofs, "mixing_dm", mixing_dm, "whether to mix density matrix instead of charge density in LCAO");
 
     ofs << "\n#Parameters (8.DOS)" << std::endl;
     ModuleBase::GlobalFunc::OUTP(ofs, "dos_emin_ev", dos_emin_ev, "minimal range for dos");
@@ -399,6 +415,7 @@ ModuleBase::GlobalFunc::OUTP(ofs, "out_bandgap", out_bandgap, "if true, print ou
     ModuleBase::GlobalFunc::OUTP(ofs, "tau", tau, "the effective surface tension parameter");
     ModuleBase::GlobalFunc::OUTP(ofs, "sigma_k", sigma_k, " the width of the diffuse cavity");
     ModuleBase::GlobalFunc::OUTP(ofs, "nc_k", nc_k, " the cut-off charge density");
+    ModuleBase::GlobalFunc::OUTP(ofs, "sol_solver", sol_solver, "solver of the generalized Poisson equation: cg or mg");
 
     ofs << "\n#Parameters (19.orbital free density functional theory)" << std::endl;
     ModuleBase::GlobalFunc::OUTP(ofs, "of_kinetic", of_kinetic, "kinetic energy functional, such as tf, vw, wt");
@@ -333,6 +333,7 @@ template Psi<double, DEVICE_GPU>::Psi(const Psi<double, DEVICE_CPU>&);
 template Psi<std::complex<double>, DEVICE_CPU>::Psi(const Psi<std::complex<double>, DEVICE_GPU>&);
 template Psi<std::complex<double>, DEVICE_GPU>::Psi(const Psi<std::complex<double>, DEVICE_CPU>&);
 template Psi<std::complex<float>, DEVICE_GPU>::Psi(const Psi<std::complex<double>, DEVICE_CPU>&);
+template Psi<std::complex<float>, DEVICE_GPU>::Psi(const Psi<std::complex<double>, DEVICE_GPU>&);
 template Psi<std::complex<double>, DEVICE_GPU>::Psi(const Psi<std::complex<float>, DEVICE_GPU>&);
 #endif
 } // namespace psi
\ No newline at end of file